@@ -8,7 +8,7 @@
 /* Support console output, and buffer it so we don't unnecessarily
  * delay the alarm interrupts */
 #define configBSP430_CONSOLE 1
-#define BSP430_CONSOLE_TX_BUFFER_SIZE 80
+#define BSP430_CONSOLE_TX_BUFFER_SIZE 64
 
 /* Monitor uptime and provide generic ACLK-driven timer so we can see
  * how long we've been running. */
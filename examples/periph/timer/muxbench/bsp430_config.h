@@ -0,0 +1,29 @@
+/* Use a crystal if one is installed.  Much more accurate timing
+ * results. */
+#define BSP430_PLATFORM_BOOT_CONFIGURE_LFXT1 1
+
+/* Application does output: support spin-for-jumper */
+#define configBSP430_PLATFORM_SPIN_FOR_JUMPER 1
+
+/* Support console output */
+#define configBSP430_CONSOLE 1
+
+/* Monitor uptime and provide generic ACLK-driven timer */
+#define configBSP430_UPTIME 1
+#define configBSP430_UPTIME_DELAY 1
+
+/* The largest number of alarms measured */
+#ifndef APP_MAX_ALARMS
+#define APP_MAX_ALARMS 1000
+#endif /* APP_MAX_ALARMS */
+
+/* Select the multiplexed alarm backend */
+#define configBSP430_TIMER_MUX_ALARM_HEAP (APP_HEAP - 0)
+#define BSP430_TIMER_MUX_ALARM_HEAP_CAPACITY APP_MAX_ALARMS
+
+/* Use a secondary timer for high-resolution timing */
+#define configBSP430_TIMER_CCACLK 1
+#define HRT_PERIPH_HANDLE BSP430_TIMER_CCACLK_PERIPH_HANDLE
+
+/* Get platform defaults */
+#include <bsp430/platform/bsp430_config.h>
@@ -0,0 +1,182 @@
+/** This file is in the public domain.
+ *
+ * Measure the cost of multiplexed timer alarms as the number of
+ * pending alarms grows, to compare the sorted list with the binary
+ * heap selected by #configBSP430_TIMER_MUX_ALARM_HEAP.  Build once
+ * with <tt>HEAP=0</tt> (the default) and once with <tt>HEAP=1</tt>.
+ *
+ * For each of 10, 100, and 1000 alarms (limited by
+ * <tt>MAX_ALARMS</tt>) the application reports, in SMCLK cycles:
+ *
+ * @li the mean and maximum cost of iBSP430timerMuxAlarmAdd_ni() while
+ * filling the queue with alarms at random times;
+ *
+ * @li the mean and maximum cost of iBSP430timerMuxAlarmRemove_ni()
+ * while emptying it in a scattered order;
+ *
+ * @li the cost per alarm of the shared alarm callback when every
+ * alarm is due, including a callback that does nothing.
+ *
+ * Each add and remove is timed separately with interrupts disabled,
+ * so the maximum is the interrupt latency it introduces.  The shared
+ * alarm is driven by the uptime timer; the high-resolution timer runs
+ * at SMCLK/8, so individual measurements are multiples of 8 cycles.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/clock.h>
+#include <bsp430/periph/timer.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/console.h>
+
+/* Need a CCIDX on the uptime clock that isn't used for something
+ * else. */
+#ifndef UPTIME_MUXALARM_CCIDX
+#define UPTIME_MUXALARM_CCIDX 2
+#endif /* UPTIME_MUXALARM_CCIDX */
+
+/* The high-resolution timer counts SMCLK divided by 1 << HRT_SHIFT */
+#define HRT_SHIFT 3
+
+static volatile sBSP430hplTIMER * hrt;
+static unsigned int hrt_overhead;
+static sBSP430timerMuxSharedAlarm mux_base;
+static sBSP430timerMuxAlarm alarms[APP_MAX_ALARMS];
+static unsigned long lcg_state = 1;
+
+static const unsigned int counts[] = { 10, 100, 1000 };
+
+typedef struct sCost {
+  unsigned long sum;
+  unsigned long max;
+} sCost;
+
+static unsigned int
+lcg_next (void)
+{
+  lcg_state = 1103515245UL * lcg_state + 12345;
+  return (unsigned int)(lcg_state >> 16);
+}
+
+static unsigned int
+hrt_since (unsigned int t0)
+{
+  return uiBSP430timerSyncCounterRead_ni(hrt) - t0 - hrt_overhead;
+}
+
+static void
+cost_add (sCost * cp,
+          unsigned int ticks)
+{
+  unsigned long cycles = (unsigned long)ticks << HRT_SHIFT;
+
+  cp->sum += cycles;
+  if (cycles > cp->max) {
+    cp->max = cycles;
+  }
+}
+
+static int
+noop_cb_ni (sBSP430timerMuxSharedAlarm * shared,
+            sBSP430timerMuxAlarm * alarm)
+{
+  return 0;
+}
+
+static void
+measure (hBSP430timerMuxSharedAlarm map,
+         unsigned int n)
+{
+  sCost add = { 0, 0 };
+  sCost rem = { 0, 0 };
+  unsigned long fire_cycles;
+  unsigned long base_tck;
+  unsigned int t0;
+  unsigned int i;
+  int rc = 0;
+
+  /* Fill with alarms due at random times far enough in the future
+   * that none fires before it is removed. */
+  base_tck = ulBSP430timerMuxSharedAlarmCounter(map) + BSP430_UPTIME_MS_TO_UTT(10000);
+  for (i = 0; i < n; ++i) {
+    alarms[i].setting_tck = base_tck + (lcg_next() & 0xFFFF);
+    alarms[i].callback_ni = noop_cb_ni;
+    BSP430_CORE_DISABLE_INTERRUPT();
+    t0 = uiBSP430timerSyncCounterRead_ni(hrt);
+    rc |= iBSP430timerMuxAlarmAdd_ni(map, alarms + i);
+    cost_add(&add, hrt_since(t0));
+    BSP430_CORE_ENABLE_INTERRUPT();
+  }
+
+  /* Remove with a stride coprime to n, visiting every alarm in an
+   * order unrelated to their times. */
+  for (i = 0; i < n; ++i) {
+    BSP430_CORE_DISABLE_INTERRUPT();
+    t0 = uiBSP430timerSyncCounterRead_ni(hrt);
+    rc |= iBSP430timerMuxAlarmRemove_ni(map, alarms + ((7UL * i) % n));
+    cost_add(&rem, hrt_since(t0));
+    BSP430_CORE_ENABLE_INTERRUPT();
+  }
+
+  /* Queue alarms that are all overdue, latest first so the list
+   * backend inserts each at its head, then fire them as the timer
+   * interrupt would.  Interrupts remain disabled so the overdue alarm
+   * is not taken before the measurement. */
+  BSP430_CORE_DISABLE_INTERRUPT();
+  base_tck = ulBSP430timerMuxSharedAlarmCounter(map) - BSP430_UPTIME_MS_TO_UTT(100);
+  for (i = 0; i < n; ++i) {
+    alarms[i].setting_tck = base_tck - (i * 4UL) - (lcg_next() & 3);
+    (void)iBSP430timerMuxAlarmAdd_ni(map, alarms + i);
+  }
+  (void)iBSP430timerAlarmCancel_ni(&map->dedicated);
+  t0 = uiBSP430timerSyncCounterRead_ni(hrt);
+  (void)map->dedicated.callback_ni(&map->dedicated);
+  fire_cycles = (unsigned long)hrt_since(t0) << HRT_SHIFT;
+  BSP430_CORE_ENABLE_INTERRUPT();
+
+  cprintf("%4u alarms: add %5lu max %5lu ; remove %5lu max %5lu ; fire %4lu/alarm%s\n",
+          n, add.sum / n, add.max, rem.sum / n, rem.max,
+          fire_cycles / n, (0 > rc) ? " ERR" : "");
+}
+
+void main ()
+{
+  hBSP430timerMuxSharedAlarm map;
+  unsigned int i;
+
+  vBSP430platformInitialize_ni();
+  (void)iBSP430consoleInitialize();
+  BSP430_CORE_ENABLE_INTERRUPT();
+
+  cprintf("\n\nmuxbench " __DATE__ " " __TIME__ "\n");
+  cprintf("Multiplexed alarms kept in a %s\n",
+          (configBSP430_TIMER_MUX_ALARM_HEAP - 0) ? "binary heap" : "sorted list");
+
+  hrt = xBSP430hplLookupTIMER(HRT_PERIPH_HANDLE);
+  map = hBSP430timerMuxAlarmStartup(&mux_base, BSP430_UPTIME_TIMER_PERIPH_HANDLE, UPTIME_MUXALARM_CCIDX);
+  if ((NULL == hrt) || (NULL == map)) {
+    cprintf("ERR: timer initialization failed\n");
+    return;
+  }
+  hrt->ctl = TASSEL_2 | ID_3 | MC_2 | TACLR;
+  cprintf("Cycles are SMCLK at %lu Hz\n", ulBSP430clockSMCLK_Hz());
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  i = uiBSP430timerSyncCounterRead_ni(hrt);
+  hrt_overhead = uiBSP430timerSyncCounterRead_ni(hrt) - i;
+  BSP430_CORE_ENABLE_INTERRUPT();
+
+  while (1) {
+    for (i = 0; i < sizeof(counts)/sizeof(*counts); ++i) {
+      if (counts[i] <= APP_MAX_ALARMS) {
+        measure(map, counts[i]);
+      }
+    }
+    cputchar('\n');
+    BSP430_CORE_DISABLE_INTERRUPT();
+    BSP430_UPTIME_DELAY_MS_NI(5000, LPM0_bits, 0);
+    BSP430_CORE_ENABLE_INTERRUPT();
+  }
+}
@@ -7,7 +7,7 @@
 
 /* Support console output */
 #define configBSP430_CONSOLE 1
-#define BSP430_CONSOLE_TX_BUFFER_SIZE 80
+#define BSP430_CONSOLE_TX_BUFFER_SIZE 64
 
 /* Monitor uptime and provide generic ACLK-driven timer with
  * uptime-based delay and epoch support. */
@@ -8,7 +8,7 @@
 /* Support console buffered input and output at a higher-than-normal
  * data rate. */
 #define configBSP430_CONSOLE 1
-#define BSP430_CONSOLE_TX_BUFFER_SIZE 100
+#define BSP430_CONSOLE_TX_BUFFER_SIZE 128
 #define BSP430_CONSOLE_RX_BUFFER_SIZE 16
 #define BSP430_CONSOLE_BAUD_RATE 115200
 
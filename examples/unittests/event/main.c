@@ -0,0 +1,142 @@
+/** This file is in the public domain.
+ *
+ * Stress the tagged event buffer in bsp430/utility/event.h with a
+ * producer in a timer overflow interrupt that preempts the consumer
+ * at arbitrary points, including partway through copying a record.
+ *
+ * The producer stores in each record a value derived from its tag
+ * sequence number, so a record that was overwritten while being
+ * copied is detected as inconsistent.  The consumer drains in small
+ * batches and periodically stalls so the buffer overflows.  At the
+ * end every produced record must have been either received intact,
+ * in order, or counted in a LostEventRecord.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/clock.h>
+#include <bsp430/periph/timer.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/event.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/utility/unittest.h>
+#include <string.h>
+
+/* SMCLK cycles between producer interrupts.  Short enough that most
+ * batches are interrupted at least once. */
+#define PRODUCER_PERIOD 300
+
+/* Number of records to produce before checking the totals */
+#define PRODUCER_LIMIT 20000U
+
+static unsigned char stress_tag;
+static volatile unsigned int produced_v;
+static volatile sBSP430hplTIMER * timer;
+
+/* The value the producer stores with the record of sequence number
+ * seqno.  Both halves change with every record. */
+#define CHECK_VALUE(seqno_) ((((unsigned long)(seqno_)) << 16) | (0xFFFFU & ~(seqno_)))
+
+static int
+producer_isr_ni (const struct sBSP430halISRVoidChainNode * cb,
+                 void * context)
+{
+  uBSP430eventAnyType u;
+  const volatile sBSP430eventTagRecord * ep;
+
+  u.ul = 0;
+  ep = xBSP430eventRecordEvent_ni(stress_tag, 0, &u);
+  /* Fill in the check value now the sequence number is known.  The
+   * consumer cannot run until this returns. */
+  ((volatile sBSP430eventTagRecord *)ep)->u.ul = CHECK_VALUE(ep->seqno);
+  if (PRODUCER_LIMIT <= ++produced_v) {
+    return BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT;
+  }
+  return 0;
+}
+
+static sBSP430halISRVoidChainNode producer_cb = {
+  .callback_ni = producer_isr_ni
+};
+
+void
+testPreemptedDrain (void)
+{
+  sBSP430eventTagRecord evts[4];
+  hBSP430halTIMER hal = hBSP430timerLookup(BSP430_TIMER_CCACLK_PERIPH_HANDLE);
+  unsigned long received = 0;
+  unsigned long lost = 0;
+  unsigned int next_seqno = 0;
+  unsigned int torn = 0;
+  unsigned int misordered = 0;
+  unsigned int stalls = 0;
+  unsigned int iterations = 0;
+  int active = 1;
+
+  BSP430_UNITTEST_ASSERT_TRUE(NULL != hal);
+  if (NULL == hal) {
+    return;
+  }
+  stress_tag = ucBSP430eventTagAllocate("Stress");
+  timer = hal->hpl;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRVoidChainNode,
+                                  hal->overflow_cbchain_ni,
+                                  producer_cb, next_ni);
+  timer->ccr[0] = PRODUCER_PERIOD - 1;
+  timer->ctl = TASSEL_2 | MC_1 | TACLR | TAIE;
+  BSP430_CORE_ENABLE_INTERRUPT();
+
+  while (active) {
+    int nevt;
+    int i;
+
+    /* Once the producer has finished, drain what remains. */
+    active = (timer->ctl & TAIE) || !iBSP430eventFlagsEmpty();
+    (void)uiBSP430eventFlagsGet();
+    nevt = iBSP430eventTagGetRecords(evts, sizeof(evts) / sizeof(*evts));
+    for (i = 0; i < nevt; ++i) {
+      const sBSP430eventTagRecord * ep = evts + i;
+
+      if (ucBSP430eventTag_LostEventRecord == ep->tag) {
+        lost += ep->u.sz;
+        next_seqno += ep->u.sz;
+        continue;
+      }
+      misordered += (ep->seqno != next_seqno);
+      torn += (ep->u.ul != CHECK_VALUE(ep->seqno));
+      next_seqno = ep->seqno + 1;
+      ++received;
+    }
+    /* Periodically fall far enough behind that records are lost */
+    if (0 == (++iterations % 64)) {
+      ++stalls;
+      __delay_cycles(50UL * PRODUCER_PERIOD);
+    }
+  }
+  BSP430_CORE_DISABLE_INTERRUPT();
+  timer->ctl = 0;
+  BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRVoidChainNode,
+                                    hal->overflow_cbchain_ni,
+                                    producer_cb, next_ni);
+  BSP430_CORE_ENABLE_INTERRUPT();
+
+  cprintf("%u stalls: %lu received, %lu lost\n", stalls, received, lost);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(PRODUCER_LIMIT, produced_v);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu((unsigned long)PRODUCER_LIMIT, received + lost);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, torn);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, misordered);
+  BSP430_UNITTEST_ASSERT_TRUE(0 < lost);
+}
+
+void main ()
+{
+  vBSP430platformInitialize_ni();
+  vBSP430unittestInitialize();
+
+  testPreemptedDrain();
+
+  vBSP430unittestFinalize();
+}
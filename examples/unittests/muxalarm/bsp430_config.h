@@ -15,5 +15,8 @@
 #define configBSP430_TIMER_CCACLK 1
 #define configBSP430_TIMER_CCACLK_HAL 1
 
+/* Select the multiplexed alarm backend */
+#define configBSP430_TIMER_MUX_ALARM_HEAP (APP_HEAP - 0)
+
 /* Get platform defaults */
 #include <bsp430/platform/bsp430_config.h>
@@ -21,13 +21,85 @@ testOnOff (void)
   memset(&sd, 0x96, sizeof(sd));
   hs = hBSP430timerMuxAlarmStartup(&sd, BSP430_TIMER_CCACLK_PERIPH_HANDLE, 1);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTp(&sd, hs);
+#if (configBSP430_TIMER_MUX_ALARM_HEAP - 0)
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, hs->heap_count);
+#else /* configBSP430_TIMER_MUX_ALARM_HEAP */
   BSP430_UNITTEST_ASSERT_EQUAL_FMTp(NULL, hs->alarms);
+#endif /* configBSP430_TIMER_MUX_ALARM_HEAP */
   BSP430_UNITTEST_ASSERT_EQUAL_FMTd(sd.dedicated.ccidx, 1);
 
   rc = iBSP430timerMuxAlarmShutdown(hs);
   BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
 }
 
+#if (configBSP430_TIMER_MUX_ALARM_HEAP - 0)
+
+/* Verify the heap property and the recorded positions */
+static void
+checkHeap (hBSP430timerMuxSharedAlarm hs)
+{
+  unsigned int i;
+
+  for (i = 0; i < hs->heap_count; ++i) {
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTu(i, hs->heap[i]->heap_idx);
+    if (0 < i) {
+      BSP430_UNITTEST_ASSERT_TRUE(0 <= (long)(hs->heap[i]->setting_tck - hs->heap[(i-1)/2]->setting_tck));
+    }
+  }
+  if (0 < hs->heap_count) {
+    BSP430_UNITTEST_ASSERT_TRUE(BSP430_TIMER_ALARM_FLAG_SET & hs->dedicated.flags);
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(hs->heap[0]->setting_tck, hs->dedicated.setting_tck);
+  } else {
+    BSP430_UNITTEST_ASSERT_FALSE(BSP430_TIMER_ALARM_FLAG_SET & hs->dedicated.flags);
+  }
+}
+
+void
+testHeap (void)
+{
+  sBSP430timerMuxSharedAlarm sd;
+  hBSP430timerMuxSharedAlarm hs;
+  sBSP430timerMuxAlarm alarms[BSP430_TIMER_MUX_ALARM_HEAP_CAPACITY];
+  sBSP430timerMuxAlarm extra;
+  static const unsigned int order[] = { 3, 1, 4, 0, 5, 9, 2, 6, 8, 7 };
+  unsigned int i;
+  int rc;
+
+  memset(&sd, 0x96, sizeof(sd));
+  hs = hBSP430timerMuxAlarmStartup(&sd, BSP430_TIMER_CCACLK_PERIPH_HANDLE, 1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(&sd, hs);
+  hs->dedicated.timer->hpl->ctl &= ~(MC0 | MC1);
+  vBSP430timerResetCounter_ni(hs->dedicated.timer);
+
+  /* Fill the heap with settings added out of order */
+  for (i = 0; i < sizeof(alarms)/sizeof(*alarms); ++i) {
+    alarms[i].setting_tck = 100 * (1 + order[i % (sizeof(order)/sizeof(*order))]) + i;
+    rc = iBSP430timerMuxAlarmAdd_ni(hs, alarms + i);
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+    checkHeap(hs);
+  }
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(sizeof(alarms)/sizeof(*alarms), hs->heap_count);
+  extra.setting_tck = 50;
+  rc = iBSP430timerMuxAlarmAdd_ni(hs, &extra);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-1, rc);
+
+  /* Removing an alarm that is not pending changes nothing */
+  rc = iBSP430timerMuxAlarmRemove_ni(hs, &extra);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(sizeof(alarms)/sizeof(*alarms), hs->heap_count);
+
+  /* Remove from the middle, then the earliest, until empty */
+  for (i = 0; i < sizeof(alarms)/sizeof(*alarms); ++i) {
+    hBSP430timerMuxAlarm mp = (i & 1) ? hs->heap[0] : hs->heap[hs->heap_count / 2];
+    rc = iBSP430timerMuxAlarmRemove_ni(hs, mp);
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+    checkHeap(hs);
+  }
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, hs->heap_count);
+}
+
+#else /* configBSP430_TIMER_MUX_ALARM_HEAP */
+
 void
 testAddRemove (void)
 {
@@ -137,13 +209,148 @@ testAddRemove (void)
   BSP430_UNITTEST_ASSERT_FALSE(BSP430_TIMER_ALARM_FLAG_SET & hs->dedicated.flags);
 }
 
+#endif /* configBSP430_TIMER_MUX_ALARM_HEAP */
+
+void
+testBatch (void)
+{
+  sBSP430timerMuxSharedAlarm sd;
+  hBSP430timerMuxSharedAlarm hs;
+  sBSP430timerMuxAlarm alarms[4];
+  int i;
+  int rc;
+
+  memset(&sd, 0x96, sizeof(sd));
+  hs = hBSP430timerMuxAlarmStartup(&sd, BSP430_TIMER_CCACLK_PERIPH_HANDLE, 1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(&sd, hs);
+  hs->dedicated.timer->hpl->ctl &= ~(MC0 | MC1);
+  vBSP430timerResetCounter_ni(hs->dedicated.timer);
+  for (i = 0; i < sizeof(alarms)/sizeof(*alarms); ++i) {
+    alarms[i].setting_tck = 100 * (i+1);
+  }
+
+  /* Nothing is programmed until the commit */
+  vBSP430timerMuxAlarmBegin_ni(hs);
+  rc = iBSP430timerMuxAlarmAdd_ni(hs, alarms+2);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+  rc = iBSP430timerMuxAlarmAdd_ni(hs, alarms+1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+  rc = iBSP430timerMuxAlarmAdd_ni(hs, alarms+3);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+  BSP430_UNITTEST_ASSERT_FALSE(BSP430_TIMER_ALARM_FLAG_SET & hs->dedicated.flags);
+  rc = iBSP430timerMuxAlarmCommit_ni(hs);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+  BSP430_UNITTEST_ASSERT_TRUE(BSP430_TIMER_ALARM_FLAG_SET & hs->dedicated.flags);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(alarms[1].setting_tck, hs->dedicated.setting_tck);
+
+  /* Replacing the earliest alarm leaves the old setting in place
+   * until the commit */
+  vBSP430timerMuxAlarmBegin_ni(hs);
+  rc = iBSP430timerMuxAlarmRemove_ni(hs, alarms+1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+  rc = iBSP430timerMuxAlarmAdd_ni(hs, alarms+0);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(alarms[1].setting_tck, hs->dedicated.setting_tck);
+  rc = iBSP430timerMuxAlarmCommit_ni(hs);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+  BSP430_UNITTEST_ASSERT_TRUE(BSP430_TIMER_ALARM_FLAG_SET & hs->dedicated.flags);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(alarms[0].setting_tck, hs->dedicated.setting_tck);
+
+  /* Removing everything cancels the dedicated alarm */
+  vBSP430timerMuxAlarmBegin_ni(hs);
+  (void)iBSP430timerMuxAlarmRemove_ni(hs, alarms+0);
+  (void)iBSP430timerMuxAlarmRemove_ni(hs, alarms+2);
+  (void)iBSP430timerMuxAlarmRemove_ni(hs, alarms+3);
+  BSP430_UNITTEST_ASSERT_TRUE(BSP430_TIMER_ALARM_FLAG_SET & hs->dedicated.flags);
+  rc = iBSP430timerMuxAlarmCommit_ni(hs);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+  BSP430_UNITTEST_ASSERT_FALSE(BSP430_TIMER_ALARM_FLAG_SET & hs->dedicated.flags);
+}
+
+static int periodic_calls;
+
+static int
+periodic_cb_ni (hBSP430timerMuxSharedAlarm shared,
+                hBSP430timerMuxPeriodic periodic)
+{
+  ++periodic_calls;
+  return 0;
+}
+
+/* Service a periodic alarm that is 2.5 periods late under the given
+ * policy, by invoking the dedicated alarm callback directly with the
+ * counter stopped. */
+static void
+checkPeriodic (unsigned char policy,
+               int expected_calls,
+               unsigned long expected_periods)
+{
+  sBSP430timerMuxSharedAlarm sd;
+  hBSP430timerMuxSharedAlarm hs;
+  sBSP430timerMuxPeriodic periodic;
+  sBSP430timerMuxAlarm other;
+  int rc;
+
+  hs = hBSP430timerMuxAlarmStartup(&sd, BSP430_TIMER_CCACLK_PERIPH_HANDLE, 1);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTp(&sd, hs);
+  hs->dedicated.timer->hpl->ctl &= ~(MC0 | MC1);
+  vBSP430timerResetCounter_ni(hs->dedicated.timer);
+
+  memset(&periodic, 0, sizeof(periodic));
+  periodic.interval_tck = 100;
+  periodic.callback_ni = periodic_cb_ni;
+  periodic.policy = policy;
+  rc = iBSP430timerMuxPeriodicAdd_ni(hs, &periodic, 100);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+  other.setting_tck = 1000;
+  other.callback_ni = NULL;
+  rc = iBSP430timerMuxAlarmAdd_ni(hs, &other);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+
+  periodic_calls = 0;
+  hs->dedicated.timer->hpl->r = 350;
+  (void)iBSP430timerAlarmCancel_ni(&hs->dedicated);
+  (void)hs->dedicated.callback_ni(&hs->dedicated);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(expected_calls, periodic_calls);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(2UL, periodic.overruns_ni);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(expected_periods, periodic.periods_ni);
+
+  /* The next setting keeps the original phase, and the alarm is
+   * still pending ahead of the other one. */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(400UL, periodic.alarm.setting_tck);
+  BSP430_UNITTEST_ASSERT_TRUE(BSP430_TIMER_ALARM_FLAG_SET & hs->dedicated.flags);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(400UL, hs->dedicated.setting_tck);
+
+  rc = iBSP430timerMuxPeriodicRemove_ni(hs, &periodic);
+  BSP430_UNITTEST_ASSERT_TRUE(0 <= rc);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu(1000UL, hs->dedicated.setting_tck);
+  rc = iBSP430timerMuxAlarmRemove_ni(hs, &other);
+  BSP430_UNITTEST_ASSERT_TRUE(0 <= rc);
+  rc = iBSP430timerMuxAlarmShutdown(hs);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, rc);
+}
+
+void
+testPeriodic (void)
+{
+  checkPeriodic(eBSP430timerMuxPeriodicPolicy_BURST, 3, 1);
+  checkPeriodic(eBSP430timerMuxPeriodicPolicy_SKIP, 1, 1);
+  checkPeriodic(eBSP430timerMuxPeriodicPolicy_COALESCE, 1, 3);
+}
+
 void main ()
 {
   vBSP430platformInitialize_ni();
   vBSP430unittestInitialize();
 
   testOnOff();
+#if (configBSP430_TIMER_MUX_ALARM_HEAP - 0)
+  testHeap();
+#else /* configBSP430_TIMER_MUX_ALARM_HEAP */
   testAddRemove();
+#endif /* configBSP430_TIMER_MUX_ALARM_HEAP */
+  testBatch();
+  testPeriodic();
 
   vBSP430unittestFinalize();
 }
@@ -0,0 +1,108 @@
+/** This file is in the public domain.
+ *
+ * Validate the single-producer single-consumer ring in
+ * bsp430/utility/ring.h, including behavior when the free-running
+ * counters wrap.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/ring.h>
+#include <bsp430/utility/unittest.h>
+
+#define CAPACITY 8
+
+static uint8_t storage[CAPACITY];
+static sBSP430ring ring = BSP430_RING_INITIALIZER(CAPACITY);
+
+static void
+testCapacity (void)
+{
+  BSP430_UNITTEST_ASSERT_TRUE(BSP430_RING_VALID_CAPACITY(1));
+  BSP430_UNITTEST_ASSERT_TRUE(BSP430_RING_VALID_CAPACITY(CAPACITY));
+  BSP430_UNITTEST_ASSERT_TRUE(BSP430_RING_VALID_CAPACITY(32768U));
+  BSP430_UNITTEST_ASSERT_FALSE(BSP430_RING_VALID_CAPACITY(0));
+  BSP430_UNITTEST_ASSERT_FALSE(BSP430_RING_VALID_CAPACITY(80));
+  BSP430_UNITTEST_ASSERT_FALSE(BSP430_RING_VALID_CAPACITY(65536UL));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(CAPACITY, uiBSP430ringCapacity(&ring));
+}
+
+static void
+testFillDrain (void)
+{
+  int i;
+
+  vBSP430ringReset(&ring);
+  BSP430_UNITTEST_ASSERT_TRUE(iBSP430ringEmpty(&ring));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-1, iBSP430ringGetOctet(&ring, storage));
+  for (i = 0; i < CAPACITY; ++i) {
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0x40 + i, iBSP430ringPutOctet(&ring, storage, 0x40 + i));
+  }
+  /* Every slot is usable */
+  BSP430_UNITTEST_ASSERT_TRUE(iBSP430ringFull(&ring));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(CAPACITY, uiBSP430ringCount(&ring));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, uiBSP430ringSpace(&ring));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-1, iBSP430ringPutOctet(&ring, storage, 0));
+  for (i = 0; i < CAPACITY; ++i) {
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0x40 + i, iBSP430ringGetOctet(&ring, storage));
+  }
+  BSP430_UNITTEST_ASSERT_TRUE(iBSP430ringEmpty(&ring));
+}
+
+static void
+testCounterWrap (void)
+{
+  int i;
+
+  /* Place the counters just short of the 16-bit wrap, in the middle
+   * of the storage. */
+  ring.head = ring.tail = 0xFFFD;
+  BSP430_UNITTEST_ASSERT_TRUE(iBSP430ringEmpty(&ring));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(5, uiBSP430ringHeadSlot(&ring));
+  for (i = 0; i < CAPACITY; ++i) {
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(i, iBSP430ringPutOctet(&ring, storage, i));
+  }
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0x0005, ring.head);
+  BSP430_UNITTEST_ASSERT_TRUE(iBSP430ringFull(&ring));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(3, uiBSP430ringContiguousCount(&ring));
+  for (i = 0; i < CAPACITY; ++i) {
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTu(CAPACITY - i, uiBSP430ringCount(&ring));
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTd(i, iBSP430ringGetOctet(&ring, storage));
+  }
+  BSP430_UNITTEST_ASSERT_TRUE(iBSP430ringEmpty(&ring));
+}
+
+static void
+testBulk (void)
+{
+  static const uint8_t src[] = "0123456789";
+  uint8_t dst[sizeof(src)];
+
+  ring.head = ring.tail = 6;
+  /* Write wraps the storage and is truncated to the space available */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(5, uiBSP430ringWriteOctets(&ring, storage, src, 5));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(3, uiBSP430ringWriteOctets(&ring, storage, src + 5, 5));
+  BSP430_UNITTEST_ASSERT_TRUE(iBSP430ringFull(&ring));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(2, uiBSP430ringContiguousCount(&ring));
+
+  memset(dst, 0, sizeof(dst));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(3, uiBSP430ringReadOctets(&ring, storage, dst, 3));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(5, uiBSP430ringReadOctets(&ring, storage, dst + 3, sizeof(dst)));
+  BSP430_UNITTEST_ASSERT_TRUE(iBSP430ringEmpty(&ring));
+  BSP430_UNITTEST_ASSERT_EQUAL_ASCIIZ("01234567", (const char *)dst);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, uiBSP430ringReadOctets(&ring, storage, dst, sizeof(dst)));
+}
+
+void main ()
+{
+  vBSP430platformInitialize_ni();
+  vBSP430unittestInitialize();
+
+  testCapacity();
+  testFillDrain();
+  testCounterWrap();
+  testBulk();
+
+  vBSP430unittestFinalize();
+}
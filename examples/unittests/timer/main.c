@@ -136,6 +136,38 @@ testWrapCorrection (void)
 {
 }
 
+/* The lock-free reads must agree with the interrupts-disabled reads,
+ * including when an overflow is pending. */
+void
+testLockFree (void)
+{
+  unsigned int ofl_ni;
+  unsigned int ofl;
+  unsigned long ul;
+
+  resetTimer();
+  BSP430_CORE_DISABLE_INTERRUPT();
+  do {
+    uthal->overflow_count = 0x2345FFFFUL;
+    uthal->hpl->r = 0x1234;
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(0xFFFF1234UL, ulBSP430timerCounter(uthal, &ofl));
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0x2345, ofl);
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTllx(0x2345FFFF1234ULL, ullBSP430timerCounter(uthal));
+    uthal->hpl->ctl |= TAIFG;
+    ul = ulBSP430timerCounter_ni(uthal, &ofl_ni);
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(0x00001234UL, ul);
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTx(0x2346, ofl_ni);
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(ul, ulBSP430timerCounter(uthal, &ofl));
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTx(ofl_ni, ofl);
+    BSP430_UNITTEST_ASSERT_EQUAL_FMTllx(ullBSP430timerCounter_ni(uthal), ullBSP430timerCounter(uthal));
+  } while (0);
+  BSP430_CORE_ENABLE_INTERRUPT();
+  /* The pending overflow has now been handled */
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTllx(0x234600001234ULL, ullBSP430uptime());
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(0x00001234UL, ulBSP430uptime());
+  resetTimer();
+}
+
 void main ()
 {
   vBSP430platformInitialize_ni();
@@ -154,6 +186,7 @@ void main ()
 
   testInitialConditions();
   testOverflowTimer();
+  testLockFree();
   testCorrection(0x4000, 0xC000);
   testCorrection(0xC000, 0x4000);
   testCorrection(0x0000, 0xFFFF);
@@ -0,0 +1,136 @@
+/** This file is in the public domain.
+ *
+ * Compare the cost of logging a message with cprintf() against the
+ * deferred formatting provided by bsp430/utility/binlog.h.
+ *
+ * For each of a few representative messages the application reports
+ * the number of octets placed on the wire and the number of SMCLK
+ * cycles spent in the call that produced them.  The console transmit
+ * buffer is flushed before each call so neither variant waits for the
+ * UART.
+ *
+ * View the output through <tt>maintainer/binlog-decode</tt> with this
+ * application's ELF file to see the binary log messages rendered as
+ * text; a plain terminal shows them as noise.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/clock.h>
+#include <bsp430/periph/timer.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/utility/binlog.h>
+
+#if ! (BSP430_CONSOLE_TX_BUFFER_SIZE - 0)
+#error Application requires interrupt-driven console transmission
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+
+typedef struct sResult {
+  unsigned long octets;
+  unsigned int cycles;
+} sResult;
+
+static hBSP430halSERIAL console;
+static volatile sBSP430hplTIMER * hrt;
+static unsigned int hrt_overhead;
+static unsigned long tx0;
+static unsigned int t0;
+
+static void
+start_trial (void)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+
+  (void)iBSP430consoleFlush();
+  BSP430_CORE_DISABLE_INTERRUPT();
+  tx0 = console->num_tx;
+  t0 = uiBSP430timerSyncCounterRead_ni(hrt);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+}
+
+static void
+end_trial (sResult * rp)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rp->cycles = uiBSP430timerSyncCounterRead_ni(hrt) - t0 - hrt_overhead;
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  (void)iBSP430consoleFlush();
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rp->octets = console->num_tx - tx0;
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+}
+
+static void
+report (const char * tag,
+        const sResult * cp,
+        const sResult * bp)
+{
+  cprintf("%-8s cprintf %3lu octets %5u cycles; binlog %3lu octets %5u cycles\n",
+          tag, cp->octets, cp->cycles, bp->octets, bp->cycles);
+}
+
+void main ()
+{
+  unsigned int iter = 0;
+
+  vBSP430platformInitialize_ni();
+  (void)iBSP430consoleInitialize();
+  console = hBSP430console();
+
+  cprintf("\n\nbinlog " __DATE__ " " __TIME__ "\n");
+
+  hrt = xBSP430hplLookupTIMER(HRT_PERIPH_HANDLE);
+  if (NULL == hrt) {
+    cprintf("High-resolution timer not available\n");
+    return;
+  }
+  hrt->ctl = TASSEL_2 | MC_2 | TACLR;
+  cprintf("Cycles are SMCLK at %lu Hz\n", ulBSP430clockSMCLK_Hz());
+
+  BSP430_CORE_ENABLE_INTERRUPT();
+  BSP430_CORE_DISABLE_INTERRUPT();
+  t0 = uiBSP430timerSyncCounterRead_ni(hrt);
+  hrt_overhead = uiBSP430timerSyncCounterRead_ni(hrt) - t0;
+  BSP430_CORE_ENABLE_INTERRUPT();
+
+  while (1) {
+    sResult cr;
+    sResult br;
+    unsigned long now = ulBSP430uptime();
+
+    start_trial();
+    cprintf("tick\n");
+    end_trial(&cr);
+    start_trial();
+    BSP430_BINLOG("tick\n");
+    end_trial(&br);
+    report("text", &cr, &br);
+
+    start_trial();
+    cprintf("iter %u at %lu\n", iter, now);
+    end_trial(&cr);
+    start_trial();
+    BSP430_BINLOG("iter %u at %lu\n", iter, now);
+    end_trial(&br);
+    report("ints", &cr, &br);
+
+    start_trial();
+    cprintf("sample %d: temp %d.%02u C, pressure %lu Pa, flags %04x, state %s\n",
+            iter, -12, 7, 101325UL, 0x1234 ^ iter, "idle");
+    end_trial(&cr);
+    start_trial();
+    BSP430_BINLOG("sample %d: temp %d.%02u C, pressure %lu Pa, flags %04x, state %s\n",
+                  iter, -12, 7, 101325UL, 0x1234 ^ iter, "idle");
+    end_trial(&br);
+    report("mixed", &cr, &br);
+
+    ++iter;
+    BSP430_CORE_DISABLE_INTERRUPT();
+    BSP430_UPTIME_DELAY_MS_NI(2000, LPM0_bits, 0);
+    BSP430_CORE_ENABLE_INTERRUPT();
+  }
+}
@@ -0,0 +1,137 @@
+/** This file is in the public domain.
+ *
+ * Demonstrate bsp430/utility/chanmux.h by sharing the console UART
+ * between interactive text and two framed channels:
+ *
+ * @li Channel 1 carries a continuous stream of binary telemetry
+ * records, each holding the uptime clock and a sequence number;
+ * @li Channel 2 accepts commands from the host and answers each with
+ * a frame that reports the multiplexer statistics.
+ *
+ * Console text is echoed back a line at a time and a status line is
+ * printed every few seconds.  Run <tt>maintainer/chanmux-demux</tt>
+ * on the serial device with channels 1 and 2 to see the streams
+ * separated; a plain terminal shows the frames as noise.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/utility/chanmux.h>
+#include <stdio.h>
+#include <string.h>
+
+#if ! (BSP430_CONSOLE_RX_BUFFER_SIZE - 0)
+#error Application requires interrupt-driven console reception
+#endif /* BSP430_CONSOLE_RX_BUFFER_SIZE */
+
+#ifndef STATUS_INTERVAL_MS
+#define STATUS_INTERVAL_MS 5000
+#endif /* STATUS_INTERVAL_MS */
+
+#ifndef SAMPLE_INTERVAL_MS
+#define SAMPLE_INTERVAL_MS 10
+#endif /* SAMPLE_INTERVAL_MS */
+
+#define TELEMETRY_CHANNEL 1
+#define COMMAND_CHANNEL 2
+
+typedef struct sTelemetry {
+  unsigned long timestamp_utt;
+  unsigned int sequence;
+} sTelemetry;
+
+static uint8_t telemetry_buffer[128];
+static uint8_t command_buffer[32];
+static unsigned int commands;
+
+static void
+command_rx (sBSP430chanmuxChannel * chan,
+            const uint8_t * data,
+            size_t len)
+{
+  sBSP430chanmuxStatistics stats;
+  char reply[BSP430_CHANMUX_MAX_PAYLOAD];
+  int n;
+
+  ++commands;
+  vBSP430chanmuxStatistics(&stats, 0);
+  n = snprintf(reply, sizeof(reply), "cmd %u len %u: crc %u framing %u unknown %u\n",
+               commands, (unsigned int)len, stats.rx_crc_errors,
+               stats.rx_framing_errors, stats.rx_unknown_channel);
+  if (n >= (int)sizeof(reply)) {
+    n = sizeof(reply) - 1;
+  }
+  (void)iBSP430chanmuxWrite(chan, (const uint8_t *)reply, n);
+}
+
+static sBSP430chanmuxChannel telemetry = {
+  .id = TELEMETRY_CHANNEL,
+  .tx_ring = BSP430_RING_INITIALIZER(sizeof(telemetry_buffer)),
+  .tx_buffer = telemetry_buffer,
+};
+
+static sBSP430chanmuxChannel command = {
+  .id = COMMAND_CHANNEL,
+  .tx_ring = BSP430_RING_INITIALIZER(sizeof(command_buffer)),
+  .tx_buffer = command_buffer,
+  .rx_callback = command_rx,
+};
+
+void main ()
+{
+  char line[64];
+  unsigned int line_len = 0;
+  sTelemetry sample;
+  unsigned long next_status_utt;
+  unsigned long frames = 0;
+
+  vBSP430platformInitialize_ni();
+  (void)iBSP430consoleInitialize();
+
+  cprintf("\n\nchanmux " __DATE__ " " __TIME__ "\n");
+  cprintf("Telemetry on channel %u, commands on channel %u, %u-octet payloads\n",
+          TELEMETRY_CHANNEL, COMMAND_CHANNEL, BSP430_CHANMUX_MAX_PAYLOAD);
+  (void)iBSP430chanmuxRegister(&telemetry);
+  (void)iBSP430chanmuxRegister(&command);
+
+  memset(&sample, 0, sizeof(sample));
+  next_status_utt = ulBSP430uptime() + BSP430_UPTIME_MS_TO_UTT(STATUS_INTERVAL_MS);
+  while (1) {
+    int c;
+
+    while (0 <= ((c = cgetchar()))) {
+      c = iBSP430chanmuxRxFilter(c);
+      if (0 > c) {
+        continue;
+      }
+      if (('\r' == c) || ('\n' == c) || (line_len == (sizeof(line) - 1))) {
+        if (0 < line_len) {
+          line[line_len] = 0;
+          cprintf("echo: %s\n", line);
+          line_len = 0;
+        }
+        continue;
+      }
+      line[line_len++] = c;
+    }
+
+    sample.timestamp_utt = ulBSP430uptime();
+    ++sample.sequence;
+    (void)iBSP430chanmuxWrite(&telemetry, (const uint8_t *)&sample, sizeof(sample));
+    frames += iBSP430chanmuxFlush();
+
+    if (0 <= (long)(sample.timestamp_utt - next_status_utt)) {
+      cprintf("%s: %lu frames, telemetry dropped %lu, %u commands\n",
+              xBSP430uptimeAsText_ni(sample.timestamp_utt),
+              frames, telemetry.tx_dropped, commands);
+      next_status_utt += BSP430_UPTIME_MS_TO_UTT(STATUS_INTERVAL_MS);
+    }
+
+    BSP430_CORE_DISABLE_INTERRUPT();
+    BSP430_UPTIME_DELAY_MS_NI(SAMPLE_INTERVAL_MS, LPM0_bits, 0);
+    BSP430_CORE_ENABLE_INTERRUPT();
+  }
+}
@@ -8,16 +8,31 @@
 /* Support console output */
 #define configBSP430_CONSOLE 1
 
+#if (APP_LINE_MODE - 0)
+/* Assemble input lines in the console receive handler, so the
+ * application wakes once per command.  The rx buffer must hold a full
+ * command; echo goes through the tx buffer. */
+#define configBSP430_CONSOLE_RX_LINE_MODE 1
+#define BSP430_CONSOLE_RX_BUFFER_SIZE 128
+#define BSP430_CONSOLE_TX_BUFFER_SIZE 64
+#else /* APP_LINE_MODE */
 /* Enable an 8-character rx buffer for the console */
 #define BSP430_CONSOLE_RX_BUFFER_SIZE 8
+#endif /* APP_LINE_MODE */
 
 /* Enable an 80-character command buffer */
 #define BSP430_CLI_CONSOLE_BUFFER_SIZE 80
 
+/* Record commands for recall with arrow keys and C-r search */
+#define BSP430_CLI_CONSOLE_HISTORY_SIZE 256
+
 /* Enable command completion, and completion helper */
 #define configBSP430_CLI_COMMAND_COMPLETION 1
 #define configBSP430_CLI_COMMAND_COMPLETION_HELPER 1
 
+/* Maintain event interval statistics, shown by the events command */
+#define configBSP430_EVENT_TAG_STATS 1
+
 /* Monitor uptime and provide generic ACLK-driven timer */
 #define configBSP430_UPTIME 1
 
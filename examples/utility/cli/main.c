@@ -9,6 +9,7 @@
 #include <bsp430/utility/console.h>
 #include <bsp430/utility/cli.h>
 #include <bsp430/utility/led.h>
+#include <bsp430/utility/event.h>
 #include <bsp430/periph/pmm.h>
 #include <string.h>
 #include <ctype.h>
@@ -102,6 +103,53 @@ static const sBSP430cliCommand dcmd_uptime = {
 #undef LAST_COMMAND
 #define LAST_COMMAND &dcmd_uptime
 
+static int
+cmd_console (const char * argstr)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  sBSP430consoleTxStatistics tx;
+  sBSP430consoleRxStatistics rx;
+  size_t argstr_len = strlen(argstr);
+  size_t len;
+  const char * tp = xBSP430cliNextToken(&argstr, &argstr_len, &len);
+  int reset = (5 == len) && (0 == strncmp("reset", tp, len));
+  int have_tx;
+  int have_rx;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  have_tx = (0 == iBSP430consoleTxStatistics_ni(&tx, reset));
+  have_rx = (0 == iBSP430consoleRxStatistics_ni(&rx, reset));
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  if (have_tx) {
+    cprintf("TX: %lu queued, %lu transmitted, %lu interrupts, %lu dropped, high water %u\n",
+            tx.queued, tx.transmitted, tx.interrupts, tx.dropped, tx.high_water);
+    cprintf("TX: %u blocked %lu ms, %u waits %lu ms\n",
+            tx.blocked, BSP430_UPTIME_UTT_TO_MS(tx.blocked_utt),
+            tx.waits, BSP430_UPTIME_UTT_TO_MS(tx.wait_utt));
+    cprintf("TX: %u flushes %lu ms, longest %lu ms\n",
+            tx.flushes, BSP430_UPTIME_UTT_TO_MS(tx.flush_utt),
+            BSP430_UPTIME_UTT_TO_MS(tx.flush_max_utt));
+  } else {
+    cprintf("TX: not buffered\n");
+  }
+  if (have_rx) {
+    cprintf("RX: %lu received, %lu overruns, high water %u\n",
+            rx.received, rx.overruns, rx.high_water);
+  } else {
+    cprintf("RX: not buffered\n");
+  }
+  return 0;
+}
+static const sBSP430cliCommand dcmd_console = {
+  .key = "console",
+  .help = "[reset] # Show (and optionally reset) console statistics",
+  .next = LAST_COMMAND,
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_console
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_console
+
 static int
 cmd_expand_ (sBSP430cliCommandLink * chain,
              void * param,
@@ -231,6 +279,30 @@ static const sBSP430cliCommand dcmd_quote = {
 #undef LAST_COMMAND
 #define LAST_COMMAND &dcmd_quote
 
+/* A setup sequence held in flash and replayed without passing through
+ * the console buffer. */
+static const char setup_script[] =
+  "# Restore the initial values\n"
+  "set ival -5; set uival 0x20\n"
+  "set lval 100000; set ulval 0xDEADBEEF\n"
+  "show\n"
+  "uptime\n";
+
+static int
+cmd_setup (const char * argstr)
+{
+  return iBSP430cliConsoleExecuteScript(commandSet, NULL, setup_script, sizeof(setup_script) - 1, 0);
+}
+static const sBSP430cliCommand dcmd_setup = {
+  .key = "setup",
+  .help = "# Execute a stored script of commands",
+  .next = LAST_COMMAND,
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_setup
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_setup
+
 static int
 cmd_dummy (const char * argstr)
 {
@@ -398,6 +470,88 @@ static const sBSP430cliCommand dcmd_responsive = {
 #undef LAST_COMMAND
 #define LAST_COMMAND &dcmd_responsive
 
+#if (configBSP430_EVENT_TAG_STATS - 0)
+/* An event recorded as each command is executed, so the statistics
+ * show the intervals between commands without waking the MCU.  The
+ * records themselves are never consumed. */
+static unsigned char command_tag;
+
+static int
+cmd_events (const char * argstr)
+{
+  unsigned long resp_Hz = ulBSP430uptimeConversionFrequency_Hz();
+  size_t argstr_len = strlen(argstr);
+  size_t len;
+  const char * tp = xBSP430cliNextToken(&argstr, &argstr_len, &len);
+  int reset = (5 == len) && (0 == strncmp("reset", tp, len));
+  unsigned char tag;
+
+  for (tag = 1; NULL != hBSP430eventTagLookup(tag); ++tag) {
+    sBSP430eventTagStats st;
+    unsigned long mean_utt;
+    unsigned int b;
+
+    (void)iBSP430eventTagGetStats(tag, &st, reset);
+    cprintf("%u %s: %lu events, %lu intervals\n", tag, hBSP430eventTagLookup(tag)->id,
+            st.events, st.intervals);
+    if (0 == st.intervals) {
+      continue;
+    }
+    mean_utt = st.interval_sum_utt / st.intervals;
+    cprintf("\tmin %lu mean %lu max %lu tick (%lu %lu %lu us)\n",
+            st.interval_min_utt, mean_utt, st.interval_max_utt,
+            BSP430_CORE_TICKS_TO_US(st.interval_min_utt, resp_Hz),
+            BSP430_CORE_TICKS_TO_US(mean_utt, resp_Hz),
+            BSP430_CORE_TICKS_TO_US(st.interval_max_utt, resp_Hz));
+    for (b = 0; b < sizeof(st.histogram)/sizeof(*st.histogram); ++b) {
+      if (st.histogram[b]) {
+        cprintf("\t>= %lu tick: %u\n", (b ? (1UL << b) : 0UL), st.histogram[b]);
+      }
+    }
+  }
+  return 0;
+}
+static const sBSP430cliCommand dcmd_events = {
+  .key = "events",
+  .help = "[reset] # Display event interval statistics",
+  .next = LAST_COMMAND,
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_events
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_events
+#endif /* configBSP430_EVENT_TAG_STATS */
+
+#if 0 < BSP430_CLI_CONSOLE_HISTORY_SIZE
+static int
+cmd_history (const char * argstr)
+{
+  const char * text;
+  size_t len;
+  unsigned int n = 0;
+
+  if (0 == strcmp(argstr, "clear")) {
+    vBSP430cliConsoleHistoryClear();
+    return 0;
+  }
+  while (NULL != (text = xBSP430cliConsoleHistoryEntry(n, &len))) {
+    cprintf("%3u ", n++);
+    cputchars(text, len);
+    cputchar('\n');
+  }
+  return 0;
+}
+static const sBSP430cliCommand dcmd_history = {
+  .key = "history",
+  .help = "[clear] # Display or discard recorded commands",
+  .next = LAST_COMMAND,
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_history
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_history
+#endif /* BSP430_CLI_CONSOLE_HISTORY_SIZE */
+
 static int
 cmd_help (sBSP430cliCommandLink * chain,
           void * param,
@@ -456,6 +610,10 @@ void main ()
     }
   }
 
+#if (configBSP430_EVENT_TAG_STATS - 0)
+  command_tag = ucBSP430eventTagAllocate("Command");
+#endif /* configBSP430_EVENT_TAG_STATS */
+
   vBSP430ledSet(0, 1);
   cprintf("\nLED lit when not awaiting input\n");
 
@@ -470,6 +628,10 @@ void main ()
 
   BSP430_CORE_ENABLE_INTERRUPT();
   while (1) {
+#if 0 < BSP430_CLI_CONSOLE_HISTORY_SIZE
+    /* Let the library recognize the arrow keys that recall commands */
+    flags = iBSP430cliConsoleBufferConsumeEscape(flags);
+#endif /* BSP430_CLI_CONSOLE_HISTORY_SIZE */
     if (flags & eBSP430cliConsole_ANY_ESCAPE) {
       int c;
       while (0 <= ((c = cgetchar()))) {
@@ -495,6 +657,9 @@ void main ()
     if (flags & eBSP430cliConsole_READY) {
       int rv;
 
+#if (configBSP430_EVENT_TAG_STATS - 0)
+      vBSP430eventRecordEvent(command_tag, 0, NULL);
+#endif /* configBSP430_EVENT_TAG_STATS */
       rv = iBSP430cliExecuteCommand(commandSet, 0, command);
       if (0 != rv) {
         cprintf("Command execution returned %d\n", rv);
@@ -0,0 +1,242 @@
+/** This file is in the public domain.
+ *
+ * Measure the throughput of the command line engine in
+ * bsp430/utility/cli.h, as a baseline for evaluating changes to its
+ * parsing and dispatch.
+ *
+ * The application defines a small command set with nested
+ * subcommands, integer store handlers, and a handler that extracts
+ * quoted tokens.  Each of several command lines is executed
+ * repeatedly with iBSP430cliExecuteCommand(), and completion of
+ * several partial commands is performed with
+ * iBSP430cliCommandCompletion().  For each the application reports
+ * the average SMCLK cycles per operation and the corresponding
+ * number of operations per second.  No handler produces output, so
+ * only the engine is measured.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/clock.h>
+#include <bsp430/periph/timer.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/utility/cli.h>
+#include <string.h>
+
+#define REPETITIONS 100
+
+static volatile sBSP430hplTIMER * hrt;
+static unsigned int hrt_overhead;
+
+static struct {
+  int ival;
+  unsigned int uival;
+  long lval;
+  unsigned long ulval;
+} data;
+
+static int
+cmd_noop (const char * argstr)
+{
+  return 0;
+}
+
+static int
+cmd_tokens (const char * argstr)
+{
+  size_t arglen = strlen(argstr);
+  size_t len;
+  int ntokens = 0;
+
+  while (0 < arglen) {
+    (void)xBSP430cliNextQToken(&argstr, &arglen, &len);
+    ntokens += (0 < len);
+  }
+  return ntokens;
+}
+
+#define LAST_COMMAND NULL
+
+static const sBSP430cliCommand dcmd_set_ival = {
+  .key = "ival",
+  .handler = iBSP430cliHandlerStoreI,
+  .param.ptr = &data.ival
+};
+static const sBSP430cliCommand dcmd_set_uival = {
+  .key = "uival",
+  .next = &dcmd_set_ival,
+  .handler = iBSP430cliHandlerStoreUI,
+  .param.ptr = &data.uival
+};
+static const sBSP430cliCommand dcmd_set_lval = {
+  .key = "lval",
+  .next = &dcmd_set_uival,
+  .handler = iBSP430cliHandlerStoreL,
+  .param.ptr = &data.lval
+};
+static const sBSP430cliCommand dcmd_set_ulval = {
+  .key = "ulval",
+  .next = &dcmd_set_lval,
+  .handler = iBSP430cliHandlerStoreUL,
+  .param.ptr = &data.ulval
+};
+static const sBSP430cliCommand dcmd_set = {
+  .key = "set",
+  .child = &dcmd_set_ulval,
+  .next = LAST_COMMAND,
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_set
+
+static const sBSP430cliCommand dcmd_show_data = {
+  .key = "data",
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_noop
+};
+static const sBSP430cliCommand dcmd_show_clocks = {
+  .key = "clocks",
+  .next = &dcmd_show_data,
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_noop
+};
+static const sBSP430cliCommand dcmd_show_config = {
+  .key = "config",
+  .next = &dcmd_show_clocks,
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_noop
+};
+static const sBSP430cliCommand dcmd_show = {
+  .key = "show",
+  .child = &dcmd_show_config,
+  .next = LAST_COMMAND,
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_show
+
+static const sBSP430cliCommand dcmd_tokens = {
+  .key = "tokens",
+  .next = LAST_COMMAND,
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_tokens
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_tokens
+
+static const sBSP430cliCommand dcmd_help = {
+  .key = "help",
+  .next = LAST_COMMAND,
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_help
+
+static const char * const commands[] = {
+  "help",
+  "show data",
+  "sh cl",
+  "set ival -1234",
+  "set ulval 0x12345678",
+  "set lval 1.5M",
+  "tokens one 'two three' \"four\"",
+};
+
+static const char * const completions[] = {
+  "",
+  "s",
+  "show c",
+  "set u",
+  "set ulval",
+};
+
+static unsigned int
+cycles_since (unsigned int t0)
+{
+  return uiBSP430timerSyncCounterRead_ni(hrt) - t0 - hrt_overhead;
+}
+
+static void
+display (unsigned long cycles)
+{
+  unsigned long per_op = (cycles + REPETITIONS / 2) / REPETITIONS;
+
+  cprintf(": %5lu cycles, %7lu per second\n", per_op,
+          per_op ? (ulBSP430clockSMCLK_Hz() / per_op) : 0);
+}
+
+void main ()
+{
+  unsigned int i;
+
+  vBSP430platformInitialize_ni();
+  (void)iBSP430consoleInitialize();
+
+  cprintf("\n\ncli_bench " __DATE__ " " __TIME__ "\n");
+
+  hrt = xBSP430hplLookupTIMER(HRT_PERIPH_HANDLE);
+  if (NULL == hrt) {
+    cprintf("High-resolution timer not available\n");
+    return;
+  }
+  hrt->ctl = TASSEL_2 | MC_2 | TACLR;
+  cprintf("Cycles are SMCLK at %lu Hz, averaged over %u repetitions\n",
+          ulBSP430clockSMCLK_Hz(), REPETITIONS);
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  i = uiBSP430timerSyncCounterRead_ni(hrt);
+  hrt_overhead = uiBSP430timerSyncCounterRead_ni(hrt) - i;
+  BSP430_CORE_ENABLE_INTERRUPT();
+
+  while (1) {
+    for (i = 0; i < sizeof(commands) / sizeof(*commands); ++i) {
+      unsigned long cycles = 0;
+      unsigned int n;
+      int rv = 0;
+
+      for (n = 0; n < REPETITIONS; ++n) {
+        unsigned int t0;
+
+        BSP430_CORE_DISABLE_INTERRUPT();
+        t0 = uiBSP430timerSyncCounterRead_ni(hrt);
+        rv = iBSP430cliExecuteCommand(LAST_COMMAND, NULL, commands[i]);
+        cycles += cycles_since(t0);
+        BSP430_CORE_ENABLE_INTERRUPT();
+      }
+      cprintf("%-32s", commands[i]);
+      if (0 > rv) {
+        cprintf(": error %d\n", rv);
+        continue;
+      }
+      display(cycles);
+    }
+    for (i = 0; i < sizeof(completions) / sizeof(*completions); ++i) {
+      const char * cands[4];
+      sBSP430cliCompletionData ccd;
+      unsigned long cycles = 0;
+      unsigned int n;
+
+      memset(&ccd, 0, sizeof(ccd));
+      ccd.command_set = LAST_COMMAND;
+      ccd.returned_candidates = cands;
+      ccd.max_returned_candidates = sizeof(cands) / sizeof(*cands);
+      for (n = 0; n < REPETITIONS; ++n) {
+        unsigned int t0;
+
+        ccd.command = completions[i];
+        BSP430_CORE_DISABLE_INTERRUPT();
+        t0 = uiBSP430timerSyncCounterRead_ni(hrt);
+        (void)iBSP430cliCommandCompletion(&ccd);
+        cycles += cycles_since(t0);
+        BSP430_CORE_ENABLE_INTERRUPT();
+      }
+      cprintf("complete %-12s %u candidates", completions[i], (unsigned int)ccd.ncandidates);
+      display(cycles);
+    }
+    cputchar('\n');
+    BSP430_CORE_DISABLE_INTERRUPT();
+    BSP430_UPTIME_DELAY_MS_NI(5000, LPM0_bits, 0);
+    BSP430_CORE_ENABLE_INTERRUPT();
+  }
+}
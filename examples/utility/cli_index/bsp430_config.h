@@ -0,0 +1,23 @@
+/* Use a crystal if one is installed.  Much more accurate timing
+ * results. */
+#define BSP430_PLATFORM_BOOT_CONFIGURE_LFXT1 1
+
+/* Application does output: support spin-for-jumper */
+#define configBSP430_PLATFORM_SPIN_FOR_JUMPER 1
+
+/* Support console output */
+#define configBSP430_CONSOLE 1
+
+/* Monitor uptime and provide generic ACLK-driven timer */
+#define configBSP430_UPTIME 1
+#define configBSP430_UPTIME_DELAY 1
+
+/* Support sorted command indexes */
+#define configBSP430_CLI_COMMAND_INDEX 1
+
+/* Use a secondary timer for high-resolution timing */
+#define configBSP430_TIMER_CCACLK 1
+#define HRT_PERIPH_HANDLE BSP430_TIMER_CCACLK_PERIPH_HANDLE
+
+/* Get platform defaults */
+#include <bsp430/platform/bsp430_config.h>
@@ -0,0 +1,90 @@
+/* Generated by maintainer/cli-index from main.c; do not edit. */
+static const sBSP430cliCommand * const cliIndex_dcmd_reg_adc12ctl0_[] = {
+  &dcmd_reg_adc12ctl0,
+  &dcmd_reg_adc12ctl1,
+  &dcmd_reg_adc12ctl2,
+  &dcmd_reg_adc12ie,
+  &dcmd_reg_adc12ifg,
+  &dcmd_reg_comp_bctl0,
+  &dcmd_reg_comp_bctl1,
+  &dcmd_reg_crcdi,
+  &dcmd_reg_crcinires,
+  &dcmd_reg_dma0ctl,
+  &dcmd_reg_dma0da,
+  &dcmd_reg_dma0sa,
+  &dcmd_reg_dmactl0,
+  &dcmd_reg_pmmctl0,
+  &dcmd_reg_pmmctl1,
+  &dcmd_reg_rtcctl0,
+  &dcmd_reg_rtcctl1,
+  &dcmd_reg_sfrie1,
+  &dcmd_reg_sfrifg1,
+  &dcmd_reg_svsmhctl,
+  &dcmd_reg_svsmlctl,
+  &dcmd_reg_sysctl,
+  &dcmd_reg_ta0ctl,
+  &dcmd_reg_ta0r,
+  &dcmd_reg_ta1ctl,
+  &dcmd_reg_ta1r,
+  &dcmd_reg_tb0ctl,
+  &dcmd_reg_tb0r,
+  &dcmd_reg_ucsctl0,
+  &dcmd_reg_ucsctl1,
+  &dcmd_reg_ucsctl4,
+  &dcmd_reg_wdtctl,
+};
+static const sBSP430cliCommand * const cliIndex_dcmd_adc_[] = {
+  &dcmd_adc,
+  &dcmd_alarm,
+  &dcmd_baud,
+  &dcmd_beep,
+  &dcmd_ble,
+  &dcmd_boot,
+  &dcmd_calib,
+  &dcmd_cap,
+  &dcmd_clk,
+  &dcmd_comp,
+  &dcmd_crc,
+  &dcmd_dac,
+  &dcmd_debug,
+  &dcmd_dma,
+  &dcmd_eeprom,
+  &dcmd_erase,
+  &dcmd_event,
+  &dcmd_flash,
+  &dcmd_fll,
+  &dcmd_gpio,
+  &dcmd_help,
+  &dcmd_i2c,
+  &dcmd_id,
+  &dcmd_info,
+  &dcmd_irq,
+  &dcmd_lcd,
+  &dcmd_led,
+  &dcmd_log,
+  &dcmd_lpm,
+  &dcmd_mem,
+  &dcmd_mpu,
+  &dcmd_nvmem,
+  &dcmd_pmm,
+  &dcmd_port,
+  &dcmd_power,
+  &dcmd_pwm,
+  &dcmd_reboot,
+  &dcmd_reg,
+  &dcmd_reset,
+  &dcmd_rtc,
+  &dcmd_sample,
+  &dcmd_sense,
+  &dcmd_sleep,
+  &dcmd_spi,
+  &dcmd_stats,
+  &dcmd_status,
+  &dcmd_temp,
+  &dcmd_timer,
+};
+static const sBSP430cliCommandIndex cliCommandIndexes_[] = {
+  { .head = &dcmd_reg_adc12ctl0, .sorted = cliIndex_dcmd_reg_adc12ctl0_, .count = sizeof(cliIndex_dcmd_reg_adc12ctl0_) / sizeof(*cliIndex_dcmd_reg_adc12ctl0_) },
+  { .head = &dcmd_adc, .sorted = cliIndex_dcmd_adc_, .count = sizeof(cliIndex_dcmd_adc_) / sizeof(*cliIndex_dcmd_adc_) },
+};
+#define CLI_COMMAND_INDEX_COUNT 2
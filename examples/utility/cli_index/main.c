@@ -0,0 +1,547 @@
+/** This file is in the public domain.
+ *
+ * Compare the cost of identifying commands by walking the chain of
+ * sibling commands with that of a binary search in the sorted
+ * indexes generated by @c maintainer/cli-index.
+ *
+ * The application defines a command set with 48 top-level commands,
+ * one of which has 32 subcommands, roughly the size of a full-featured
+ * diagnostic shell.  For each of several inputs it reports the SMCLK
+ * cycles consumed by iBSP430cliMatchCommand() with and without the
+ * indexes registered, and verifies that both methods identify the
+ * same command and number of candidates.
+ *
+ * The indexes in @c cli_index.h are regenerated with <tt>make
+ * cli_index.h</tt> after the commands are changed.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/clock.h>
+#include <bsp430/periph/timer.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/utility/cli.h>
+#include <string.h>
+
+static volatile sBSP430hplTIMER * hrt;
+static unsigned int hrt_overhead;
+
+static int
+cmd_noop (sBSP430cliCommandLink * chain,
+          void * param,
+          const char * argstr,
+          size_t argstr_len)
+{
+  return 0;
+}
+
+/* The register names are completion candidates beneath @c reg.  The
+ * chain is built in reverse so the linked list walk visits them in
+ * the order they are declared here. */
+#define LAST_SUBCOMMAND NULL
+static const sBSP430cliCommand dcmd_reg_wdtctl = {
+  .key = "wdtctl", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_wdtctl
+static const sBSP430cliCommand dcmd_reg_ucsctl4 = {
+  .key = "ucsctl4", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_ucsctl4
+static const sBSP430cliCommand dcmd_reg_ucsctl1 = {
+  .key = "ucsctl1", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_ucsctl1
+static const sBSP430cliCommand dcmd_reg_ucsctl0 = {
+  .key = "ucsctl0", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_ucsctl0
+static const sBSP430cliCommand dcmd_reg_tb0r = {
+  .key = "tb0r", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_tb0r
+static const sBSP430cliCommand dcmd_reg_tb0ctl = {
+  .key = "tb0ctl", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_tb0ctl
+static const sBSP430cliCommand dcmd_reg_ta1r = {
+  .key = "ta1r", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_ta1r
+static const sBSP430cliCommand dcmd_reg_ta1ctl = {
+  .key = "ta1ctl", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_ta1ctl
+static const sBSP430cliCommand dcmd_reg_ta0r = {
+  .key = "ta0r", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_ta0r
+static const sBSP430cliCommand dcmd_reg_ta0ctl = {
+  .key = "ta0ctl", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_ta0ctl
+static const sBSP430cliCommand dcmd_reg_sysctl = {
+  .key = "sysctl", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_sysctl
+static const sBSP430cliCommand dcmd_reg_svsmlctl = {
+  .key = "svsmlctl", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_svsmlctl
+static const sBSP430cliCommand dcmd_reg_svsmhctl = {
+  .key = "svsmhctl", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_svsmhctl
+static const sBSP430cliCommand dcmd_reg_sfrifg1 = {
+  .key = "sfrifg1", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_sfrifg1
+static const sBSP430cliCommand dcmd_reg_sfrie1 = {
+  .key = "sfrie1", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_sfrie1
+static const sBSP430cliCommand dcmd_reg_rtcctl1 = {
+  .key = "rtcctl1", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_rtcctl1
+static const sBSP430cliCommand dcmd_reg_rtcctl0 = {
+  .key = "rtcctl0", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_rtcctl0
+static const sBSP430cliCommand dcmd_reg_pmmctl1 = {
+  .key = "pmmctl1", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_pmmctl1
+static const sBSP430cliCommand dcmd_reg_pmmctl0 = {
+  .key = "pmmctl0", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_pmmctl0
+static const sBSP430cliCommand dcmd_reg_dmactl0 = {
+  .key = "dmactl0", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_dmactl0
+static const sBSP430cliCommand dcmd_reg_dma0da = {
+  .key = "dma0da", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_dma0da
+static const sBSP430cliCommand dcmd_reg_dma0sa = {
+  .key = "dma0sa", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_dma0sa
+static const sBSP430cliCommand dcmd_reg_dma0ctl = {
+  .key = "dma0ctl", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_dma0ctl
+static const sBSP430cliCommand dcmd_reg_crcinires = {
+  .key = "crcinires", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_crcinires
+static const sBSP430cliCommand dcmd_reg_crcdi = {
+  .key = "crcdi", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_crcdi
+static const sBSP430cliCommand dcmd_reg_comp_bctl1 = {
+  .key = "comp_bctl1", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_comp_bctl1
+static const sBSP430cliCommand dcmd_reg_comp_bctl0 = {
+  .key = "comp_bctl0", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_comp_bctl0
+static const sBSP430cliCommand dcmd_reg_adc12ie = {
+  .key = "adc12ie", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_adc12ie
+static const sBSP430cliCommand dcmd_reg_adc12ifg = {
+  .key = "adc12ifg", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_adc12ifg
+static const sBSP430cliCommand dcmd_reg_adc12ctl2 = {
+  .key = "adc12ctl2", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_adc12ctl2
+static const sBSP430cliCommand dcmd_reg_adc12ctl1 = {
+  .key = "adc12ctl1", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_adc12ctl1
+static const sBSP430cliCommand dcmd_reg_adc12ctl0 = {
+  .key = "adc12ctl0", .next = LAST_SUBCOMMAND, .handler = cmd_noop
+};
+#undef LAST_SUBCOMMAND
+#define LAST_SUBCOMMAND &dcmd_reg_adc12ctl0
+
+#define LAST_COMMAND NULL
+static const sBSP430cliCommand dcmd_timer = {
+  .key = "timer", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_timer
+static const sBSP430cliCommand dcmd_temp = {
+  .key = "temp", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_temp
+static const sBSP430cliCommand dcmd_status = {
+  .key = "status", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_status
+static const sBSP430cliCommand dcmd_stats = {
+  .key = "stats", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_stats
+static const sBSP430cliCommand dcmd_spi = {
+  .key = "spi", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_spi
+static const sBSP430cliCommand dcmd_sleep = {
+  .key = "sleep", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_sleep
+static const sBSP430cliCommand dcmd_sense = {
+  .key = "sense", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_sense
+static const sBSP430cliCommand dcmd_sample = {
+  .key = "sample", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_sample
+static const sBSP430cliCommand dcmd_rtc = {
+  .key = "rtc", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_rtc
+static const sBSP430cliCommand dcmd_reset = {
+  .key = "reset", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_reset
+static const sBSP430cliCommand dcmd_reg = {
+  .key = "reg", .child = LAST_SUBCOMMAND, .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_reg
+static const sBSP430cliCommand dcmd_reboot = {
+  .key = "reboot", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_reboot
+static const sBSP430cliCommand dcmd_pwm = {
+  .key = "pwm", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_pwm
+static const sBSP430cliCommand dcmd_power = {
+  .key = "power", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_power
+static const sBSP430cliCommand dcmd_port = {
+  .key = "port", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_port
+static const sBSP430cliCommand dcmd_pmm = {
+  .key = "pmm", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_pmm
+static const sBSP430cliCommand dcmd_nvmem = {
+  .key = "nvmem", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_nvmem
+static const sBSP430cliCommand dcmd_mpu = {
+  .key = "mpu", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_mpu
+static const sBSP430cliCommand dcmd_mem = {
+  .key = "mem", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_mem
+static const sBSP430cliCommand dcmd_lpm = {
+  .key = "lpm", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_lpm
+static const sBSP430cliCommand dcmd_log = {
+  .key = "log", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_log
+static const sBSP430cliCommand dcmd_led = {
+  .key = "led", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_led
+static const sBSP430cliCommand dcmd_lcd = {
+  .key = "lcd", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_lcd
+static const sBSP430cliCommand dcmd_irq = {
+  .key = "irq", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_irq
+static const sBSP430cliCommand dcmd_info = {
+  .key = "info", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_info
+static const sBSP430cliCommand dcmd_id = {
+  .key = "id", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_id
+static const sBSP430cliCommand dcmd_i2c = {
+  .key = "i2c", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_i2c
+static const sBSP430cliCommand dcmd_help = {
+  .key = "help", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_help
+static const sBSP430cliCommand dcmd_gpio = {
+  .key = "gpio", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_gpio
+static const sBSP430cliCommand dcmd_fll = {
+  .key = "fll", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_fll
+static const sBSP430cliCommand dcmd_flash = {
+  .key = "flash", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_flash
+static const sBSP430cliCommand dcmd_event = {
+  .key = "event", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_event
+static const sBSP430cliCommand dcmd_erase = {
+  .key = "erase", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_erase
+static const sBSP430cliCommand dcmd_eeprom = {
+  .key = "eeprom", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_eeprom
+static const sBSP430cliCommand dcmd_dma = {
+  .key = "dma", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_dma
+static const sBSP430cliCommand dcmd_debug = {
+  .key = "debug", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_debug
+static const sBSP430cliCommand dcmd_dac = {
+  .key = "dac", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_dac
+static const sBSP430cliCommand dcmd_crc = {
+  .key = "crc", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_crc
+static const sBSP430cliCommand dcmd_comp = {
+  .key = "comp", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_comp
+static const sBSP430cliCommand dcmd_clk = {
+  .key = "clk", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_clk
+static const sBSP430cliCommand dcmd_cap = {
+  .key = "cap", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_cap
+static const sBSP430cliCommand dcmd_calib = {
+  .key = "calib", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_calib
+static const sBSP430cliCommand dcmd_boot = {
+  .key = "boot", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_boot
+static const sBSP430cliCommand dcmd_ble = {
+  .key = "ble", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_ble
+static const sBSP430cliCommand dcmd_beep = {
+  .key = "beep", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_beep
+static const sBSP430cliCommand dcmd_baud = {
+  .key = "baud", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_baud
+static const sBSP430cliCommand dcmd_alarm = {
+  .key = "alarm", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_alarm
+static const sBSP430cliCommand dcmd_adc = {
+  .key = "adc", .next = LAST_COMMAND, .handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_adc
+
+#include "cli_index.h"
+
+static const char * const inputs[] = {
+  "adc",                        /* first in chain */
+  "timer",                      /* last in chain */
+  "s",                          /* ambiguous prefix */
+  "nvm",                        /* unique prefix */
+  "zz",                         /* no match */
+  "",                           /* all candidates */
+  "reg wdtctl",                 /* last subcommand */
+};
+
+static unsigned int
+cycles_since (unsigned int t0)
+{
+  return uiBSP430timerSyncCounterRead_ni(hrt) - t0 - hrt_overhead;
+}
+
+/* Identify the command for input through all levels, returning the
+ * number of candidates at the last level examined. */
+static int
+match_input (const char * input,
+             const sBSP430cliCommand ** matchp)
+{
+  const sBSP430cliCommand * cmds = LAST_COMMAND;
+  size_t len = strlen(input);
+  int rv;
+
+  while (1) {
+    rv = iBSP430cliMatchCommand(cmds, input, len, matchp, 0, &input, &len);
+    if ((1 != rv) || (NULL == (*matchp)->child) || (0 == len)) {
+      break;
+    }
+    cmds = (*matchp)->child;
+  }
+  return rv;
+}
+
+static unsigned int
+time_input (const char * input,
+            int * nmatchesp,
+            const sBSP430cliCommand ** matchp)
+{
+  unsigned int t0;
+  unsigned int cycles;
+
+  *matchp = NULL;
+  BSP430_CORE_DISABLE_INTERRUPT();
+  t0 = uiBSP430timerSyncCounterRead_ni(hrt);
+  *nmatchesp = match_input(input, matchp);
+  cycles = cycles_since(t0);
+  BSP430_CORE_ENABLE_INTERRUPT();
+  return cycles;
+}
+
+void main ()
+{
+  unsigned int i;
+
+  vBSP430platformInitialize_ni();
+  (void)iBSP430consoleInitialize();
+
+  cprintf("\n\ncli_index " __DATE__ " " __TIME__ "\n");
+  cprintf("%u command indexes\n", CLI_COMMAND_INDEX_COUNT);
+
+  hrt = xBSP430hplLookupTIMER(HRT_PERIPH_HANDLE);
+  if (NULL == hrt) {
+    cprintf("High-resolution timer not available\n");
+    return;
+  }
+  hrt->ctl = TASSEL_2 | MC_2 | TACLR;
+  cprintf("Cycles are SMCLK at %lu Hz\n", ulBSP430clockSMCLK_Hz());
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  i = uiBSP430timerSyncCounterRead_ni(hrt);
+  hrt_overhead = uiBSP430timerSyncCounterRead_ni(hrt) - i;
+  BSP430_CORE_ENABLE_INTERRUPT();
+
+  while (1) {
+    for (i = 0; i < sizeof(inputs) / sizeof(*inputs); ++i) {
+      const sBSP430cliCommand * wmatch;
+      const sBSP430cliCommand * imatch;
+      int wn;
+      int in;
+      unsigned int wc;
+      unsigned int ic;
+
+      vBSP430cliSetCommandIndexes(NULL, 0);
+      wc = time_input(inputs[i], &wn, &wmatch);
+      vBSP430cliSetCommandIndexes(cliCommandIndexes_, CLI_COMMAND_INDEX_COUNT);
+      ic = time_input(inputs[i], &in, &imatch);
+      cprintf("%-12s: %3d %-8s walk %5u index %5u%s\n",
+              inputs[i], wn, wmatch ? wmatch->key : "-", wc, ic,
+              ((wn != in) || (wmatch != imatch)) ? " MISMATCH" : "");
+    }
+    cputchar('\n');
+    BSP430_CORE_DISABLE_INTERRUPT();
+    BSP430_UPTIME_DELAY_MS_NI(5000, LPM0_bits, 0);
+    BSP430_CORE_ENABLE_INTERRUPT();
+  }
+}
@@ -0,0 +1,192 @@
+/** This file is in the public domain.
+ *
+ * Measure the cost of converting command arguments to integers with
+ * the parsers in bsp430/utility/cli.h, compared with the library
+ * strtol() and strtoul() that the CLI used previously.
+ *
+ * For each of several inputs the application reports the SMCLK
+ * cycles consumed by each method and the value or error produced.
+ * Note that strtoul() accepts "-1" and that neither library function
+ * recognizes the @c k suffix the CLI parsers support.
+ *
+ * Build with <tt>PARSER=1</tt> to link only iBSP430cliParseL() and
+ * iBSP430cliParseUL(), or <tt>PARSER=2</tt> to link only strtol()
+ * and strtoul(), then compare the text sizes reported by @c
+ * msp430-size.  With no @c PARSER both are linked and timed.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/clock.h>
+#include <bsp430/periph/timer.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/utility/cli.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef APP_PARSER
+#define APP_PARSER 0
+#endif /* APP_PARSER */
+
+static volatile sBSP430hplTIMER * hrt;
+static unsigned int hrt_overhead;
+
+static const char * const inputs[] = {
+  "7",
+  "-1",
+  "1234",
+  "65535",
+  "65536",
+  "0x7FFF",
+  "0177777",
+  "2147483647",
+  "-2147483648",
+  "4294967295",
+  "1.5k",
+  "12a",
+};
+
+static volatile long sink_l;
+static volatile unsigned long sink_ul;
+
+static unsigned int
+cycles_since (unsigned int t0)
+{
+  return uiBSP430timerSyncCounterRead_ni(hrt) - t0 - hrt_overhead;
+}
+
+#if (1 != APP_PARSER)
+/* Convert as the store handlers did before the CLI provided its own
+ * parsers: the text is copied to a NUL-terminated buffer, and a
+ * conversion that does not consume the whole argument is invalid. */
+static unsigned int
+time_strto (const char * input,
+            int is_signed,
+            int * rvp)
+{
+  char buffer[15];
+  char * ep;
+  size_t len = strlen(input);
+  unsigned int t0;
+  unsigned int cycles;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  t0 = uiBSP430timerSyncCounterRead_ni(hrt);
+  *rvp = -eBSP430_CLI_ERR_Invalid;
+  if (len < sizeof(buffer)) {
+    memcpy(buffer, input, len);
+    buffer[len] = 0;
+    if (is_signed) {
+      sink_l = strtol(buffer, &ep, 0);
+    } else {
+      sink_ul = strtoul(buffer, &ep, 0);
+    }
+    if (ep == (buffer + len)) {
+      *rvp = 0;
+    }
+  }
+  cycles = cycles_since(t0);
+  BSP430_CORE_ENABLE_INTERRUPT();
+  return cycles;
+}
+#endif /* APP_PARSER */
+
+#if (2 != APP_PARSER)
+static unsigned int
+time_parse (const char * input,
+            int is_signed,
+            int * rvp)
+{
+  long l;
+  unsigned long ul;
+  size_t len = strlen(input);
+  unsigned int t0;
+  unsigned int cycles;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  t0 = uiBSP430timerSyncCounterRead_ni(hrt);
+  if (is_signed) {
+    *rvp = iBSP430cliParseL(input, len, &l);
+  } else {
+    *rvp = iBSP430cliParseUL(input, len, &ul);
+  }
+  cycles = cycles_since(t0);
+  BSP430_CORE_ENABLE_INTERRUPT();
+  if (0 == *rvp) {
+    if (is_signed) {
+      sink_l = l;
+    } else {
+      sink_ul = ul;
+    }
+  }
+  return cycles;
+}
+#endif /* APP_PARSER */
+
+void main ()
+{
+  unsigned int i;
+
+  vBSP430platformInitialize_ni();
+  (void)iBSP430consoleInitialize();
+
+  cprintf("\n\ncli_parse " __DATE__ " " __TIME__ "\n");
+
+  hrt = xBSP430hplLookupTIMER(HRT_PERIPH_HANDLE);
+  if (NULL == hrt) {
+    cprintf("High-resolution timer not available\n");
+    return;
+  }
+  hrt->ctl = TASSEL_2 | MC_2 | TACLR;
+  cprintf("Cycles are SMCLK at %lu Hz\n", ulBSP430clockSMCLK_Hz());
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  i = uiBSP430timerSyncCounterRead_ni(hrt);
+  hrt_overhead = uiBSP430timerSyncCounterRead_ni(hrt) - i;
+  BSP430_CORE_ENABLE_INTERRUPT();
+
+  while (1) {
+    int is_signed;
+
+    for (is_signed = 1; 0 <= is_signed; --is_signed) {
+      cprintf("%s conversion:\n", is_signed ? "Signed" : "Unsigned");
+      for (i = 0; i < sizeof(inputs) / sizeof(*inputs); ++i) {
+        int rv;
+        unsigned int c;
+
+        cprintf("%-12s:", inputs[i]);
+#if (1 != APP_PARSER)
+        c = time_strto(inputs[i], is_signed, &rv);
+        if (0 == rv) {
+          if (is_signed) {
+            cprintf(" strtol %5u %11ld", c, sink_l);
+          } else {
+            cprintf(" strtoul %5u %10lu", c, sink_ul);
+          }
+        } else {
+          cprintf(" strto%s %5u %*s", is_signed ? "l" : "ul", c, is_signed ? 11 : 10, "err");
+        }
+#endif /* APP_PARSER */
+#if (2 != APP_PARSER)
+        c = time_parse(inputs[i], is_signed, &rv);
+        if (0 == rv) {
+          if (is_signed) {
+            cprintf(" parse %5u %11ld", c, sink_l);
+          } else {
+            cprintf(" parse %5u %10lu", c, sink_ul);
+          }
+        } else {
+          cprintf(" parse %5u err %d", c, rv);
+        }
+#endif /* APP_PARSER */
+        cputchar('\n');
+      }
+    }
+    cputchar('\n');
+    BSP430_CORE_DISABLE_INTERRUPT();
+    BSP430_UPTIME_DELAY_MS_NI(5000, LPM0_bits, 0);
+    BSP430_CORE_ENABLE_INTERRUPT();
+  }
+}
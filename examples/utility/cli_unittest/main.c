@@ -11,7 +11,9 @@
 #include <bsp430/utility/unittest.h>
 #include <bsp430/utility/console.h>
 #include <bsp430/utility/cli.h>
+#include <bsp430/utility/xtoa.h>
 #include <string.h>
+#include <ctype.h>
 
 void
 testNextToken (void)
@@ -302,6 +304,235 @@ testHelperStringsExtract (void)
   BSP430_UNITTEST_ASSERT_EQUAL_FMTu(8, len);
 }
 
+#define PARSE(fn_,str_,destp_) fn_(str_, strlen(str_), destp_)
+
+void
+testParse (void)
+{
+  int i;
+  unsigned int ui;
+  long l;
+  unsigned long ul;
+
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, PARSE(iBSP430cliParseI, "-32768", &i));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-32768, i);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Range, PARSE(iBSP430cliParseI, "-32769", &i));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, PARSE(iBSP430cliParseI, "0x7fff", &i));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(32767, i);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Range, PARSE(iBSP430cliParseI, "32768", &i));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, PARSE(iBSP430cliParseUI, "65535", &ui));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(65535U, ui);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Range, PARSE(iBSP430cliParseUI, "65536", &ui));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Range, PARSE(iBSP430cliParseUI, "-1", &ui));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, PARSE(iBSP430cliParseUI, "-0", &ui));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, ui);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, PARSE(iBSP430cliParseUI, "0177777", &ui));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(65535U, ui);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, PARSE(iBSP430cliParseUI, "0b1010", &ui));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(10, ui);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, PARSE(iBSP430cliParseUI, "1.5k", &ui));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(1500, ui);
+
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, PARSE(iBSP430cliParseL, "-2147483648", &l));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(-2147483647L - 1, l);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Range, PARSE(iBSP430cliParseL, "2147483648", &l));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, PARSE(iBSP430cliParseL, "-2M", &l));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(-2000000L, l);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, PARSE(iBSP430cliParseUL, "0xFFFFFFFF", &ul));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlx(0xFFFFFFFFUL, ul);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Range, PARSE(iBSP430cliParseUL, "0x100000000", &ul));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Range, PARSE(iBSP430cliParseUL, "4294967296", &ul));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Range, PARSE(iBSP430cliParseUL, "5M", &ul));
+
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Invalid, PARSE(iBSP430cliParseL, "", &l));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Invalid, PARSE(iBSP430cliParseL, "-", &l));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Invalid, PARSE(iBSP430cliParseL, "0x", &l));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Invalid, PARSE(iBSP430cliParseL, "08", &l));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Invalid, PARSE(iBSP430cliParseL, "12a", &l));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Invalid, PARSE(iBSP430cliParseL, "0.5", &l));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Invalid, PARSE(iBSP430cliParseL, "1e3", &l));
+
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430cliParseFixed("-2.5", 4, 3, &l));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(-2500L, l);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430cliParseFixed("1.500", 5, 1, &l));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(15L, l);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(-eBSP430_CLI_ERR_Invalid, iBSP430cliParseFixed("1.25", 4, 1, &l));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTd(0, iBSP430cliParseFixed("0.5k", 4, 2, &l));
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTld(50000L, l);
+}
+
+/* Randomized round trips: values are formatted in each radix and must
+ * parse back exactly, and arbitrary strings drawn from the characters
+ * the parser treats specially must either be rejected or produce a
+ * value that survives the same round trip. */
+void
+testParseFuzz (void)
+{
+  static const char alphabet[] = "0123456789abfxX.-+kM";
+  unsigned long state = 1;
+  unsigned int n;
+  unsigned int failures = 0;
+
+  for (n = 0; n < 2000; ++n) {
+    char text[BSP430_XTOA_LONG_BUFFER_SIZE + 2];
+    unsigned long v;
+    unsigned long pv;
+    long sv;
+    long sv2;
+    unsigned int len;
+    int rv;
+
+    state = state * 1103515245UL + 12345;
+    v = state >> (state & 0x1F);
+    text[0] = '0';
+    text[1] = 'x';
+    (void)xBSP430xtoaULong(v, text + 2, 16);
+    rv = PARSE(iBSP430cliParseUL, text, &pv);
+    failures += (0 != rv) || (pv != v);
+    (void)xBSP430xtoaULong(v, text + 1, 8);
+    rv = PARSE(iBSP430cliParseUL, text, &pv);
+    failures += (0 != rv) || (pv != v);
+    (void)xBSP430xtoaLong((long)v, text, 10);
+    rv = PARSE(iBSP430cliParseL, text, &sv);
+    failures += (0 != rv) || (sv != (long)v);
+
+    len = 1 + (state >> 29);
+    text[len] = 0;
+    while (len--) {
+      state = state * 1103515245UL + 12345;
+      text[len] = alphabet[(state >> 16) % (sizeof(alphabet) - 1)];
+    }
+    if (0 == PARSE(iBSP430cliParseL, text, &sv)) {
+      (void)xBSP430xtoaLong(sv, text, 10);
+      rv = PARSE(iBSP430cliParseL, text, &sv2);
+      failures += (0 != rv) || (sv2 != sv);
+    }
+  }
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, failures);
+}
+
+/* Advance the generator at statep and return 15 bits of the result.
+ * The state is kept to 32 bits so the sequence does not depend on the
+ * width of unsigned long. */
+static unsigned int
+fuzz_next (unsigned long * statep)
+{
+  *statep = 0xFFFFFFFFUL & (*statep * 1103515245UL + 12345);
+  return 0x7FFF & (unsigned int)(*statep >> 16);
+}
+
+/* Store len characters drawn from alphabet into text, advancing the
+ * generator at statep, and terminate the result. */
+static void
+fuzz_text (unsigned long * statep,
+           const char * alphabet,
+           size_t alphabet_len,
+           char * text,
+           size_t len)
+{
+  text[len] = 0;
+  while (len--) {
+    text[len] = alphabet[fuzz_next(statep) % alphabet_len];
+  }
+}
+
+/* Tokenize random mixtures of words, whitespace, and quotes.  Each
+ * call must return a token within the input, leave the remaining
+ * length consistent with the updated position, and make progress;
+ * unquoted tokens must not contain whitespace. */
+void
+testTokenFuzz (void)
+{
+  static const char alphabet[] = "ab '\"\t";
+  unsigned long state = 1;
+  unsigned int n;
+  unsigned int failures = 0;
+  unsigned int nonempty = 0;
+
+  for (n = 0; n < 1000; ++n) {
+    char text[16];
+    size_t text_len = fuzz_next(&state) % sizeof(text);
+    const char * end = text + text_len;
+    int quoted;
+
+    nonempty += (0 < text_len);
+    fuzz_text(&state, alphabet, sizeof(alphabet) - 1, text, text_len);
+    for (quoted = 0; quoted < 2; ++quoted) {
+      const char * cp = text;
+      size_t remaining = text_len;
+      unsigned int ntokens = 0;
+
+      while (0 < remaining) {
+        const char * last_cp = cp;
+        const char * tp;
+        size_t len;
+        size_t i;
+
+        if (quoted) {
+          tp = xBSP430cliNextQToken(&cp, &remaining, &len);
+        } else {
+          tp = xBSP430cliNextToken(&cp, &remaining, &len);
+          for (i = 0; i < len; ++i) {
+            failures += !!isspace((unsigned char)tp[i]);
+          }
+        }
+        failures += (tp < text) || ((tp + len) > end)
+          || (cp <= last_cp) || (cp > end)
+          || (remaining != (size_t)(end - cp));
+        if (sizeof(text) < ++ntokens) {
+          ++failures;
+          break;
+        }
+      }
+    }
+  }
+  BSP430_UNITTEST_ASSERT_TRUE(900 < nonempty);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, failures);
+}
+
+/* Complete and execute random commands built from fragments of the
+ * command keys.  Completion must return only the candidates it
+ * counted and an append text within the candidate, and execution must
+ * either reach a handler or report a defined error. */
+void
+testCommandFuzz (void)
+{
+  static const char alphabet[] = "comptesayhr  ";
+  const char * cands[5];
+  sBSP430cliCompletionData ccd;
+  unsigned long state = 1;
+  unsigned int n;
+  unsigned int failures = 0;
+  unsigned int nonempty = 0;
+
+  ccd.command_set = LAST_COMMAND;
+  ccd.returned_candidates = cands;
+  ccd.max_returned_candidates = sizeof(cands)/sizeof(*cands);
+  for (n = 0; n < 1000; ++n) {
+    char text[12];
+    size_t text_len = fuzz_next(&state) % sizeof(text);
+    size_t i;
+    int rv;
+
+    nonempty += (0 < text_len);
+    fuzz_text(&state, alphabet, sizeof(alphabet) - 1, text, text_len);
+    memset(cands, 0, sizeof(cands));
+    ccd.command = text;
+    (void)iBSP430cliCommandCompletion(&ccd);
+    for (i = 0; i < ccd.max_returned_candidates; ++i) {
+      failures += (i < ccd.ncandidates) != (NULL != cands[i]);
+    }
+    if (NULL != ccd.append) {
+      failures += (0 == ccd.ncandidates) || (ccd.append_len > strlen(ccd.append));
+    }
+
+    rv = iBSP430cliExecuteCommand(LAST_COMMAND, NULL, text);
+    failures += (0 < rv) || (-eBSP430_CLIERRORTYPES >= rv);
+  }
+  BSP430_UNITTEST_ASSERT_TRUE(900 < nonempty);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, failures);
+}
+
 void main (void)
 {
   vBSP430platformInitialize_ni();
@@ -312,6 +543,10 @@ void main (void)
   testConsoleBufferExtend();
   testCommandCompletion();
   testHelperStringsExtract();
+  testParse();
+  testParseFuzz();
+  testTokenFuzz();
+  testCommandFuzz();
 
   vBSP430unittestFinalize();
 }
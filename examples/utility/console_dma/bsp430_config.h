@@ -0,0 +1,38 @@
+/* Use a crystal if one is installed.  Much more accurate timing
+ * results. */
+#define BSP430_PLATFORM_BOOT_CONFIGURE_LFXT1 1
+
+/* Application does output: support spin-for-jumper */
+#define configBSP430_PLATFORM_SPIN_FOR_JUMPER 1
+
+/* Support console output with interrupt-driven transmission.  The
+ * test text carries its own carriage returns so the number of octets
+ * queued is exactly the number of octets passed in. */
+#define configBSP430_CONSOLE 1
+#define configBSP430_CONSOLE_USE_ONLCR 0
+#ifndef BSP430_CONSOLE_TX_BUFFER_SIZE
+#define BSP430_CONSOLE_TX_BUFFER_SIZE 128
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+#ifndef BSP430_CONSOLE_BAUD_RATE
+#define BSP430_CONSOLE_BAUD_RATE 115200
+#endif /* BSP430_CONSOLE_BAUD_RATE */
+
+/* Monitor uptime for elapsed time measurement */
+#define configBSP430_UPTIME 1
+#define configBSP430_UPTIME_DELAY 1
+
+/* Drain the console through DMA unless told otherwise by the build */
+#ifndef USE_TX_DMA
+#define USE_TX_DMA 1
+#endif /* USE_TX_DMA */
+#define configBSP430_HAL_DMA 1
+#define configBSP430_CONSOLE_TX_DMA (USE_TX_DMA - 0)
+
+#if (BSP430_PLATFORM_TRXEB - 0)
+#define BSP430_CONSOLE_TX_DMA_TSEL 21
+#elif (BSP430_PLATFORM_EXP430FG4618 - 0)
+#define BSP430_CONSOLE_TX_DMA_TSEL 4
+#endif
+
+/* Get platform defaults */
+#include <bsp430/platform/bsp430_config.h>
@@ -0,0 +1,179 @@
+/** This file is in the public domain.
+ *
+ * Measure the cost of interrupt-driven console output, comparing the
+ * per-character UART transmit interrupt with the DMA drain enabled
+ * by #configBSP430_CONSOLE_TX_DMA.  Build with <tt>TX_DMA=0</tt> to
+ * obtain the figures for the per-character interrupt.
+ *
+ * The cost is expressed per kilobyte transmitted as the number of
+ * console interrupts taken, and as the CPU time consumed by the
+ * console (queuing plus interrupt handling).  The latter is obtained
+ * by counting iterations of a busy loop that runs while output
+ * drains, and comparing the rate with that of the same loop when no
+ * output is in progress.
+ *
+ * The per-character mode necessarily takes one interrupt per octet.
+ * The DMA mode takes one per buffer span, of which there are at most
+ * two for each 64-octet block queued.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/clock.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/periph/dma.h>
+
+#if ! (BSP430_CONSOLE_TX_BUFFER_SIZE - 0)
+#error Application requires interrupt-driven console transmission
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+
+#ifndef TRIAL_BYTES
+#define TRIAL_BYTES 4096
+#endif /* TRIAL_BYTES */
+
+#ifndef BASELINE_MS
+#define BASELINE_MS 1000
+#endif /* BASELINE_MS */
+
+/* 64 octets per block, including the line terminator. */
+const char text[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxy\r\n";
+
+static volatile unsigned int interrupts;
+
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+static int
+count_isr_ni (const struct sBSP430halISRIndexedChainNode * cb,
+              void * context,
+              int idx)
+{
+  ++interrupts;
+  return 0;
+}
+
+static sBSP430halISRIndexedChainNode count_cb = {
+  .callback_ni = count_isr_ni
+};
+#else /* configBSP430_CONSOLE_TX_DMA */
+static int
+count_isr_ni (const struct sBSP430halISRVoidChainNode * cb,
+              void * context)
+{
+  ++interrupts;
+  return 0;
+}
+
+static sBSP430halISRVoidChainNode count_cb = {
+  .callback_ni = count_isr_ni
+};
+#endif /* configBSP430_CONSOLE_TX_DMA */
+
+/* Number of octets handed to the UART since tx0 was recorded */
+static unsigned long
+transmitted (hBSP430halSERIAL console,
+             unsigned long tx0)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  unsigned long rv;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rv = console->num_tx - tx0;
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return rv;
+}
+
+void main ()
+{
+  hBSP430halSERIAL console;
+  unsigned long baseline_spins;
+  unsigned long baseline_utt;
+  unsigned long spins;
+  unsigned long queued;
+  unsigned long tx0;
+  unsigned long t0;
+  unsigned long t1;
+  unsigned long elapsed_utt;
+  unsigned long busy_utt;
+  unsigned int nint;
+
+  vBSP430platformInitialize_ni();
+  (void)iBSP430consoleInitialize();
+  console = hBSP430console();
+
+  cprintf("\n\nconsole_dma " __DATE__ " " __TIME__ "\n");
+  cprintf("Console %s at %lu baud, %u-octet buffer, drained by %s\n",
+          xBSP430serialName(BSP430_CONSOLE_SERIAL_PERIPH_HANDLE),
+          (unsigned long)BSP430_CONSOLE_BAUD_RATE,
+          BSP430_CONSOLE_TX_BUFFER_SIZE,
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+          "DMA"
+#else /* configBSP430_CONSOLE_TX_DMA */
+          "UART interrupt"
+#endif /* configBSP430_CONSOLE_TX_DMA */
+         );
+  cprintf("Uptime clock %lu Hz, trial %u octets\n",
+          ulBSP430uptimeConversionFrequency_Hz(), TRIAL_BYTES);
+  (void)iBSP430consoleFlush();
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+  BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRIndexedChainNode,
+                                  BSP430_HAL_DMA->ch_cbchain_ni[BSP430_CONSOLE_TX_DMA_CHANNEL],
+                                  count_cb, next_ni);
+#else /* configBSP430_CONSOLE_TX_DMA */
+  BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRVoidChainNode,
+                                  console->tx_cbchain_ni,
+                                  count_cb, next_ni);
+#endif /* configBSP430_CONSOLE_TX_DMA */
+  BSP430_CORE_ENABLE_INTERRUPT();
+
+  /* Rate at which the busy loop runs when the console is idle */
+  baseline_utt = BSP430_UPTIME_MS_TO_UTT(BASELINE_MS);
+  baseline_spins = 0;
+  t0 = ulBSP430uptime();
+  do {
+    ++baseline_spins;
+    (void)transmitted(console, 0);
+    t1 = ulBSP430uptime();
+  } while ((t1 - t0) < baseline_utt);
+  baseline_utt = t1 - t0;
+
+  while (1) {
+    BSP430_CORE_DISABLE_INTERRUPT();
+    interrupts = 0;
+    BSP430_CORE_ENABLE_INTERRUPT();
+    tx0 = transmitted(console, 0);
+    spins = 0;
+    queued = 0;
+    t0 = ulBSP430uptime();
+    while (queued < TRIAL_BYTES) {
+      if ((queued - transmitted(console, tx0)) > (BSP430_CONSOLE_TX_BUFFER_SIZE - sizeof(text))) {
+        ++spins;
+        (void)ulBSP430uptime();
+        continue;
+      }
+      queued += cputchars(text, sizeof(text) - 1);
+    }
+    while (transmitted(console, tx0) < queued) {
+      ++spins;
+      (void)ulBSP430uptime();
+    }
+    t1 = ulBSP430uptime();
+    BSP430_CORE_DISABLE_INTERRUPT();
+    nint = interrupts;
+    BSP430_CORE_ENABLE_INTERRUPT();
+
+    elapsed_utt = t1 - t0;
+    busy_utt = elapsed_utt - (unsigned long)(((unsigned long long)spins * baseline_utt) / baseline_spins);
+    cprintf("%lu octets in %lu ms: %u interrupts, %lu us busy; per KiB %lu interrupts, %lu us busy\n",
+            queued, BSP430_UPTIME_UTT_TO_MS(elapsed_utt),
+            nint, BSP430_UPTIME_UTT_TO_US(busy_utt),
+            (1024UL * nint) / queued,
+            (1024UL * BSP430_UPTIME_UTT_TO_US(busy_utt)) / queued);
+    (void)iBSP430consoleFlush();
+    BSP430_CORE_DISABLE_INTERRUPT();
+    BSP430_UPTIME_DELAY_MS_NI(2000, LPM0_bits, 0);
+    BSP430_CORE_ENABLE_INTERRUPT();
+  }
+}
@@ -7,7 +7,10 @@
 
 /* Support console output with transmission buffer */
 #define configBSP430_CONSOLE 1
-#define BSP430_CONSOLE_TX_BUFFER_SIZE 80
+#define BSP430_CONSOLE_TX_BUFFER_SIZE 64
+
+/* Maintain event interval statistics, shown in the periodic report */
+#define configBSP430_EVENT_TAG_STATS 1
 
 /* Monitor uptime and provide generic ACLK-driven timer */
 #define configBSP430_UPTIME 1
@@ -10,6 +10,11 @@
  * @li tagged timestamped output at 700 ms from Flags 0x01
  * @li event/interrupt/duty cycle statistics at 10s from Flags 0x01
  *
+ * With full statistics the 10s report also shows, for each tag, the
+ * interval statistics maintained under #configBSP430_EVENT_TAG_STATS.
+ * The spread of the MuxAlarm intervals about 700 ms is the jitter in
+ * alarm delivery.
+ *
  * The stable state active duty cycle is about 0.6%, most of which is
  * formatting the statistics output.  BSP430_CONSOLE_TX_BUFFER_SIZE
  * enables interrupt-driven output so emitting the formatted output
@@ -118,6 +123,40 @@ process_mux_flag ()
   vBSP430ledSet(BSP430_LED_GREEN, -1);
 }
 
+#if (configBSP430_EVENT_TAG_STATS - 0)
+/* Display and reset the interval statistics for each tag */
+static void
+display_tag_stats (void)
+{
+  unsigned long resp_Hz = ulBSP430uptimeConversionFrequency_Hz();
+  unsigned char tag;
+
+  for (tag = 1; NULL != hBSP430eventTagLookup(tag); ++tag) {
+    sBSP430eventTagStats st;
+    unsigned long mean_utt;
+    unsigned int b;
+
+    (void)iBSP430eventTagGetStats(tag, &st, 1);
+    cprintf("\t%s: %lu events, %lu intervals\n", hBSP430eventTagLookup(tag)->id,
+            st.events, st.intervals);
+    if (0 == st.intervals) {
+      continue;
+    }
+    mean_utt = st.interval_sum_utt / st.intervals;
+    cprintf("\t\tmin %lu mean %lu max %lu tck (%lu %lu %lu us)\n",
+            st.interval_min_utt, mean_utt, st.interval_max_utt,
+            BSP430_CORE_TICKS_TO_US(st.interval_min_utt, resp_Hz),
+            BSP430_CORE_TICKS_TO_US(mean_utt, resp_Hz),
+            BSP430_CORE_TICKS_TO_US(st.interval_max_utt, resp_Hz));
+    for (b = 0; b < sizeof(st.histogram)/sizeof(*st.histogram); ++b) {
+      if (st.histogram[b]) {
+        cprintf("\t\t>= %lu tck: %u\n", (b ? (1UL << b) : 0UL), st.histogram[b]);
+      }
+    }
+  }
+}
+#endif /* configBSP430_EVENT_TAG_STATS */
+
 static void
 process_statistics (const struct sBSP430eventTagRecord * ep,
                     struct sExampleMuxAlarm * ap)
@@ -150,6 +189,9 @@ process_statistics (const struct sBSP430eventTagRecord * ep,
   cprintf("\tasleep %lu tck = %lu ms ; awake %lu tck = %lu ms\n",
           st.sleep_utt, BSP430_UPTIME_UTT_TO_MS(st.sleep_utt),
           st.awake_utt, BSP430_UPTIME_UTT_TO_MS(st.awake_utt));
+#if (configBSP430_EVENT_TAG_STATS - 0)
+  display_tag_stats();
+#endif /* configBSP430_EVENT_TAG_STATS */
 #else /* USE_FULL_STATS */
   (void)i;
   (void)as_text;
@@ -240,14 +282,16 @@ void main ()
   mux_alarms[3].process_fn = process_statistics;
   mux_alarms[3].tag = stats_tag;
 
-  /* Enable the multiplexed alarms */
+  /* Enable the multiplexed alarms, programming the timer once */
   BSP430_CORE_DISABLE_INTERRUPT();
   do {
     int i = 0;
+    vBSP430timerMuxAlarmBegin_ni(map);
     for (i = 0; (0 == rc) && (i < sizeof(mux_alarms)/sizeof(*mux_alarms)); ++i) {
       mux_alarms[i].alarm.setting_tck = ulBSP430uptime_ni();
       arc[i] = iBSP430timerMuxAlarmAdd_ni(map, &mux_alarms[i].alarm);
     }
+    rc = iBSP430timerMuxAlarmCommit_ni(map);
   } while (0);
   BSP430_CORE_ENABLE_INTERRUPT();
 
@@ -255,7 +299,9 @@ void main ()
   {
     int i;
     cprintf("Alarm installation got:");
-    rc = 0;
+    if (0 > rc) {
+      cprintf(" commit %d;", rc);
+    }
     for (i = 0; i < sizeof(arc)/sizeof(*arc); ++i) {
       cprintf(" %d", arc[i]);
       if (0 > arc[i]) {
@@ -0,0 +1,132 @@
+/** This file is in the public domain.
+ *
+ * Export tagged event records to the host in compact binary form.
+ *
+ * Three periodic events are recorded at different intervals by
+ * multiplexed alarms on the uptime timer.  The main loop sleeps in
+ * uiBSP430eventFlagsWait() until records are available, then drains the
+ * event buffer, encodes the records with iBSP430eventTraceEncode(),
+ * and transmits each encoded buffer as a frame on channel
+ * #TRACE_CHANNEL.  Every ten seconds a line of console text reports
+ * the number of records exported and the octets they occupied.
+ *
+ * Capture a trace with:
+ *
+ *   maintainer/eventtrace-chrome -c 1 /dev/ttyACM0 > trace.json
+ *
+ * interrupting it when enough has been collected, and load the
+ * result into ui.perfetto.dev.  Each tag appears as a separate
+ * track.
+ *
+ * The same buffers could instead be appended to an M25P flash
+ * device; the raw contents read back are a valid input to
+ * <tt>eventtrace-chrome</tt> without the @c -c option.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/periph/timer.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/event.h>
+#include <bsp430/utility/eventtrace.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/utility/chanmux.h>
+
+/* Need a CCIDX on the uptime clock that isn't used for something
+ * else. */
+#ifndef UPTIME_MUXALARM_CCIDX
+#define UPTIME_MUXALARM_CCIDX 3
+#endif /* UPTIME_MUXALARM_CCIDX */
+
+#define TRACE_CHANNEL 1
+
+static sBSP430timerMuxSharedAlarm mux_alarm_base;
+static sBSP430eventPeriodicConfig periodic[3];
+static const unsigned int periodic_ms[] = { 100, 250, 1000 };
+static const char * const periodic_id[] = { "Fast", "Medium", "Slow" };
+
+static sBSP430eventTraceEncoder encoder;
+static unsigned long records_exported;
+static unsigned long octets_exported;
+
+static void
+export_records (void)
+{
+  sBSP430eventTagRecord evt[8];
+  int nevt;
+
+  while (0 < (nevt = iBSP430eventTagGetRecords(evt, sizeof(evt)/sizeof(*evt)))) {
+    int nenc = 0;
+
+    while (nenc < nevt) {
+      uint8_t buf[BSP430_CHANMUX_MAX_PAYLOAD];
+      size_t len = sizeof(buf);
+      int rc = iBSP430eventTraceEncode(&encoder, evt + nenc, nevt - nenc, buf, &len);
+
+      if (0 > rc) {
+        cprintf("ERR: encode failed\n");
+        return;
+      }
+      if (0 < len) {
+        (void)iBSP430chanmuxSendFrame(TRACE_CHANNEL, buf, len);
+        octets_exported += len;
+      }
+      nenc += rc;
+    }
+    records_exported += nevt;
+  }
+}
+
+void main ()
+{
+  hBSP430timerMuxSharedAlarm map;
+  unsigned long report_utt;
+  int i;
+  int rc = 0;
+
+  vBSP430platformInitialize_ni();
+  (void)iBSP430consoleInitialize();
+  BSP430_CORE_ENABLE_INTERRUPT();
+
+  cprintf("\n\neventtrace " __DATE__ " " __TIME__ "\n");
+  map = hBSP430timerMuxAlarmStartup(&mux_alarm_base,
+                                    xBSP430periphFromHPL(hBSP430uptimeTimer()->hpl),
+                                    UPTIME_MUXALARM_CCIDX);
+  if (! map) {
+    cprintf("ERR initializing mux shared alarm\n");
+    goto err_out;
+  }
+  vBSP430eventTraceReset(&encoder);
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  for (i = 0; (0 <= rc) && (i < sizeof(periodic)/sizeof(*periodic)); ++i) {
+    periodic[i].tag = ucBSP430eventTagAllocate(periodic_id[i]);
+    periodic[i].interval_tck = BSP430_UPTIME_MS_TO_UTT(periodic_ms[i]);
+    rc = iBSP430eventPeriodicAdd_ni(map, periodic + i, ulBSP430uptime_ni());
+  }
+  BSP430_CORE_ENABLE_INTERRUPT();
+  if (0 > rc) {
+    cprintf("ERR: periodic add got %d\n", rc);
+    goto err_out;
+  }
+  cprintf("Trace on channel %u\n", TRACE_CHANNEL);
+
+  report_utt = ulBSP430uptime() + BSP430_UPTIME_MS_TO_UTT(10000);
+  while (1) {
+    /* Sleep until there are records to export or a report is due */
+    unsigned int events = uiBSP430eventFlagsWait(uiBSP430eventFlag_EventRecord,
+                                                 report_utt, LPM3_bits);
+
+    if (uiBSP430eventFlag_EventRecord & events) {
+      export_records();
+    }
+    if (0 <= (long)(ulBSP430uptime() - report_utt)) {
+      report_utt += BSP430_UPTIME_MS_TO_UTT(10000);
+      cprintf("%lu records in %lu octets\n", records_exported, octets_exported);
+    }
+  }
+err_out:
+  (void)iBSP430consoleFlush();
+  return;
+}
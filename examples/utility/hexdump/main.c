@@ -0,0 +1,164 @@
+/** This file is in the public domain.
+ *
+ * Measure the rate at which memory can be dumped to the console,
+ * comparing:
+ *
+ * @li the original implementation of vBSP430consoleDisplayMemory(),
+ * which emitted each element with cprintf() or cputchar();
+ * @li the current implementation, which formats each row into a
+ * buffer and transmits it as a single block;
+ * @li the compact binary form produced by iBSP430chanmuxSendMemory().
+ *
+ * Each trial dumps the same region and reports the elapsed time,
+ * rows (16 octets) per second, and octets placed on the wire.  Until
+ * the UART becomes the bottleneck the rate reflects the formatting
+ * cost; beyond that the octets per row determine it.  View the output
+ * through <tt>maintainer/chanmux-memory 1</tt> to see the binary dump
+ * rendered as text.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/utility/chanmux.h>
+#include <ctype.h>
+
+#ifndef DUMP_OCTETS
+#define DUMP_OCTETS 1024
+#endif /* DUMP_OCTETS */
+
+#define DUMP_CHANNEL 1
+
+static hBSP430halSERIAL console;
+
+/* The implementation of vBSP430consoleDisplayMemory() prior to
+ * row-at-a-time formatting. */
+static void
+legacy_display_memory (const uint8_t * dp,
+                       size_t len,
+                       unsigned long base)
+{
+  const uint8_t * const edp = dp + len;
+  const uint8_t * adp = dp;
+
+  while (dp < edp) {
+    if (0 == (base & 0x0F)) {
+      if (adp < dp) {
+        cputtext("  ");
+        while (adp < dp) {
+          cputchar(isprint(*adp) ? *adp : '.');
+          ++adp;
+        }
+      }
+      adp = dp;
+      cprintf("\n%08lx ", base);
+    } else if (0 == (base & 0x07)) {
+      cputchar(' ');
+    }
+    cprintf(" %02x", *dp++);
+    ++base;
+  }
+  if (adp < dp) {
+    while (base & 0x0F) {
+      if (0 == (base & 0x07)) {
+        cputchar(' ');
+      }
+      cprintf("   ");
+      ++base;
+    }
+    cputtext("  ");
+    while (adp < dp) {
+      cputchar(isprint(*adp) ? *adp : '.');
+      ++adp;
+    }
+  }
+  cputchar('\n');
+}
+
+static void
+display_memory (const uint8_t * dp,
+                size_t len,
+                unsigned long base)
+{
+  vBSP430consoleDisplayMemory(dp, len, base);
+}
+
+static void
+send_memory (const uint8_t * dp,
+             size_t len,
+             unsigned long base)
+{
+  (void)iBSP430chanmuxSendMemory(DUMP_CHANNEL, dp, len, base);
+}
+
+typedef struct sResult {
+  unsigned long elapsed_utt;
+  unsigned long octets;
+} sResult;
+
+static void
+run_trial (void (* dump) (const uint8_t * dp, size_t len, unsigned long base),
+           sResult * rp)
+{
+  /* Dump application code: readable, and not all printable */
+  const uint8_t * dp = (const uint8_t *)(uintptr_t)legacy_display_memory;
+  unsigned long t0;
+  unsigned long tx0;
+
+  (void)iBSP430consoleFlush();
+  BSP430_CORE_DISABLE_INTERRUPT();
+  tx0 = console->num_tx;
+  BSP430_CORE_ENABLE_INTERRUPT();
+  t0 = ulBSP430uptime();
+  dump(dp, DUMP_OCTETS, (unsigned long)(uintptr_t)dp);
+  (void)iBSP430consoleFlush();
+  rp->elapsed_utt = ulBSP430uptime() - t0;
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rp->octets = console->num_tx - tx0;
+  BSP430_CORE_ENABLE_INTERRUPT();
+}
+
+static void
+report (const char * tag,
+        const sResult * rp)
+{
+  unsigned long ms = BSP430_UPTIME_UTT_TO_MS(rp->elapsed_utt);
+
+  if (0 == ms) {
+    ms = 1;
+  }
+  cprintf("%-8s %5lu ms, %4lu rows/s, %5lu octets\n", tag, ms,
+          (1000UL * (DUMP_OCTETS / 16)) / ms, rp->octets);
+}
+
+void main ()
+{
+  vBSP430platformInitialize_ni();
+  (void)iBSP430consoleInitialize();
+  console = hBSP430console();
+  BSP430_CORE_ENABLE_INTERRUPT();
+
+  cprintf("\n\nhexdump " __DATE__ " " __TIME__ "\n");
+  cprintf("Console %lu baud, dumping %u octets\n",
+          (unsigned long)BSP430_CONSOLE_BAUD_RATE, DUMP_OCTETS);
+
+  while (1) {
+    sResult legacy;
+    sResult current;
+    sResult binary;
+
+    run_trial(legacy_display_memory, &legacy);
+    run_trial(display_memory, &current);
+    run_trial(send_memory, &binary);
+    cprintf("\n");
+    report("legacy", &legacy);
+    report("rows", &current);
+    report("binary", &binary);
+
+    BSP430_CORE_DISABLE_INTERRUPT();
+    BSP430_UPTIME_DELAY_MS_NI(5000, LPM0_bits, 0);
+    BSP430_CORE_ENABLE_INTERRUPT();
+  }
+}
@@ -0,0 +1,126 @@
+/** This file is in the public domain.
+ *
+ * Let the idle manager choose the low power mode.
+ *
+ * A periodic multiplexed alarm on the uptime timer toggles an LED
+ * every 250 ms, and the main loop reports how long the system spent
+ * in each mode every five seconds.  The alarm is watched by the idle
+ * manager, and the console registers a constraint that keeps the
+ * UART clock running until its output has drained, so the reports
+ * themselves are transmitted in LPM0 while the rest of each interval
+ * is spent in LPM3.
+ *
+ * Every other interval the application places an LPM0 hold, as it
+ * would while using an SMCLK-driven peripheral, and the residency
+ * moves to LPM0 for that interval.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/periph/timer.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/led.h>
+#include <bsp430/utility/console.h>
+
+/* Need a CCIDX on the uptime clock that isn't used for something
+ * else. */
+#ifndef UPTIME_MUXALARM_CCIDX
+#define UPTIME_MUXALARM_CCIDX 3
+#endif /* UPTIME_MUXALARM_CCIDX */
+
+#define REPORT_INTERVAL_MS 5000
+
+static sBSP430timerMuxSharedAlarm mux_alarm_base;
+static sBSP430timerMuxPeriodic blink;
+static volatile unsigned long blinks;
+
+static int
+blink_cb_ni (hBSP430timerMuxSharedAlarm shared,
+             hBSP430timerMuxPeriodic periodic)
+{
+  vBSP430ledSet(0, -1);
+  ++blinks;
+  return 0;
+}
+
+static void
+report (int held)
+{
+  sBSP430uptimeIdleResidency res;
+  unsigned long total_utt;
+  int level;
+
+  vBSP430uptimeIdleResidency(&res, 1);
+  /* Intervals are short enough to fit in 32 bits */
+  total_utt = res.awake_utt;
+  for (level = 0; level < BSP430_UPTIME_IDLE_LEVELS; ++level) {
+    total_utt += res.sleep_utt[level];
+  }
+  cprintf("%s: %lu blinks; %s total %lu ms; awake %lu ms",
+          xBSP430uptimeAsText_ni(ulBSP430uptime_ni()), blinks,
+          held ? "LPM0 hold" : "no hold",
+          BSP430_UPTIME_UTT_TO_MS(total_utt),
+          BSP430_UPTIME_UTT_TO_MS((unsigned long)res.awake_utt));
+  for (level = 0; level < BSP430_UPTIME_IDLE_LEVELS; ++level) {
+    if (0 != res.sleeps[level]) {
+      cprintf("; LPM%u %lu ms in %lu", level,
+              BSP430_UPTIME_UTT_TO_MS((unsigned long)res.sleep_utt[level]), res.sleeps[level]);
+    }
+  }
+  cputchar('\n');
+}
+
+void main ()
+{
+  hBSP430timerMuxSharedAlarm map;
+  unsigned long wake_utt;
+  int held = 0;
+  int rc = 0;
+
+  vBSP430platformInitialize_ni();
+  (void)iBSP430consoleInitialize();
+  cprintf("\nidle " __DATE__ " " __TIME__ "\n");
+  cprintf("Deepest idle level LPM%u; shallow below %u ticks\n",
+          BSP430_UPTIME_IDLE_DEEPEST_LEVEL, BSP430_UPTIME_IDLE_SHALLOW_UTT);
+
+  map = hBSP430timerMuxAlarmStartup(&mux_alarm_base, BSP430_UPTIME_TIMER_PERIPH_HANDLE, UPTIME_MUXALARM_CCIDX);
+  if (NULL == map) {
+    cprintf("ERR initializing mux shared alarm\n");
+    return;
+  }
+  blink.interval_tck = BSP430_UPTIME_MS_TO_UTT(250);
+  blink.callback_ni = blink_cb_ni;
+  blink.policy = eBSP430timerMuxPeriodicPolicy_SKIP;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  do {
+    rc = iBSP430uptimeIdleWatchAlarm_ni(&map->dedicated);
+    if (0 == rc) {
+      rc = iBSP430timerMuxPeriodicAdd_ni(map, &blink, ulBSP430uptime_ni() + blink.interval_tck);
+    }
+  } while (0);
+  BSP430_CORE_ENABLE_INTERRUPT();
+  if (0 != rc) {
+    cprintf("ERR %d starting blink\n", rc);
+    return;
+  }
+
+  wake_utt = ulBSP430uptime();
+  while (1) {
+    wake_utt += BSP430_UPTIME_MS_TO_UTT(REPORT_INTERVAL_MS);
+    BSP430_CORE_DISABLE_INTERRUPT();
+    if (held) {
+      vBSP430uptimeIdleRelease_ni(0);
+    }
+    held = ! held;
+    if (held) {
+      vBSP430uptimeIdleHold_ni(0);
+    }
+    while (0 < lBSP430uptimeIdleUntil(wake_utt)) {
+      /* Woken early when the console drained: choose again */
+    }
+    BSP430_CORE_ENABLE_INTERRUPT();
+    report(held);
+  }
+}
@@ -0,0 +1,167 @@
+/** This file is in the public domain.
+ *
+ * Measure the throughput of the ring in bsp430/utility/ring.h,
+ * against the unsigned char index with modulo arithmetic that the
+ * console buffers used previously.
+ *
+ * Each trial passes #TRIAL_OCTETS octets through a ring in batches of
+ * #BATCH_OCTETS, and reports the SMCLK cycles per octet for the
+ * producer and consumer combined.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/clock.h>
+#include <bsp430/periph/timer.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/utility/ring.h>
+
+#ifndef TRIAL_OCTETS
+#define TRIAL_OCTETS 1024
+#endif /* TRIAL_OCTETS */
+
+#ifndef BATCH_OCTETS
+#define BATCH_OCTETS 48
+#endif /* BATCH_OCTETS */
+
+/* A legacy-sized buffer for the modulo ring; the ring.h buffer must
+ * be a power of two. */
+#define LEGACY_SIZE 80
+#define RING_SIZE 64
+
+static volatile sBSP430hplTIMER * hrt;
+static uint8_t batch[BATCH_OCTETS];
+static uint8_t sink[BATCH_OCTETS];
+
+static struct {
+  uint8_t buffer[LEGACY_SIZE];
+  volatile unsigned char head;
+  volatile unsigned char tail;
+} legacy;
+
+static uint8_t storage[RING_SIZE];
+static sBSP430ring ring = BSP430_RING_INITIALIZER(RING_SIZE);
+
+static int
+legacy_put (uint8_t c)
+{
+  unsigned char head = legacy.head;
+  unsigned char next_head = (head + 1) % LEGACY_SIZE;
+
+  if (next_head == legacy.tail) {
+    return -1;
+  }
+  legacy.buffer[head] = c;
+  legacy.head = next_head;
+  return c;
+}
+
+static int
+legacy_get (void)
+{
+  unsigned char tail = legacy.tail;
+  int rv;
+
+  if (legacy.head == tail) {
+    return -1;
+  }
+  rv = legacy.buffer[tail];
+  legacy.tail = (tail + 1) % LEGACY_SIZE;
+  return rv;
+}
+
+static unsigned long
+trial_legacy (void)
+{
+  unsigned long cycles = 0;
+  unsigned int n;
+
+  for (n = 0; n < TRIAL_OCTETS; n += BATCH_OCTETS) {
+    unsigned int t0 = uiBSP430timerSyncCounterRead_ni(hrt);
+    unsigned int i;
+
+    for (i = 0; i < BATCH_OCTETS; ++i) {
+      (void)legacy_put(batch[i]);
+    }
+    for (i = 0; i < BATCH_OCTETS; ++i) {
+      sink[i] = legacy_get();
+    }
+    cycles += (unsigned int)(uiBSP430timerSyncCounterRead_ni(hrt) - t0);
+  }
+  return cycles;
+}
+
+static unsigned long
+trial_octet (void)
+{
+  unsigned long cycles = 0;
+  unsigned int n;
+
+  for (n = 0; n < TRIAL_OCTETS; n += BATCH_OCTETS) {
+    unsigned int t0 = uiBSP430timerSyncCounterRead_ni(hrt);
+    unsigned int i;
+
+    for (i = 0; i < BATCH_OCTETS; ++i) {
+      (void)iBSP430ringPutOctet(&ring, storage, batch[i]);
+    }
+    for (i = 0; i < BATCH_OCTETS; ++i) {
+      sink[i] = iBSP430ringGetOctet(&ring, storage);
+    }
+    cycles += (unsigned int)(uiBSP430timerSyncCounterRead_ni(hrt) - t0);
+  }
+  return cycles;
+}
+
+static unsigned long
+trial_bulk (void)
+{
+  unsigned long cycles = 0;
+  unsigned int n;
+
+  for (n = 0; n < TRIAL_OCTETS; n += BATCH_OCTETS) {
+    unsigned int t0 = uiBSP430timerSyncCounterRead_ni(hrt);
+
+    (void)uiBSP430ringWriteOctets(&ring, storage, batch, sizeof(batch));
+    (void)uiBSP430ringReadOctets(&ring, storage, sink, sizeof(sink));
+    cycles += (unsigned int)(uiBSP430timerSyncCounterRead_ni(hrt) - t0);
+  }
+  return cycles;
+}
+
+static void
+report (const char * tag,
+        unsigned long cycles)
+{
+  unsigned int octets = (TRIAL_OCTETS / BATCH_OCTETS) * BATCH_OCTETS;
+
+  cprintf("%-8s %6lu cycles, %lu.%02lu cycles per octet\n", tag, cycles,
+          cycles / octets, (100 * (cycles % octets)) / octets);
+}
+
+void main ()
+{
+  unsigned int i;
+
+  vBSP430platformInitialize_ni();
+  (void)iBSP430consoleInitialize();
+
+  cprintf("\n\nring " __DATE__ " " __TIME__ "\n");
+  hrt = xBSP430hplLookupTIMER(HRT_PERIPH_HANDLE);
+  if (NULL == hrt) {
+    cprintf("High-resolution timer not available\n");
+    return;
+  }
+  hrt->ctl = TASSEL_2 | MC_2 | TACLR;
+  cprintf("Cycles are SMCLK at %lu Hz; %u octets in batches of %u\n",
+          ulBSP430clockSMCLK_Hz(), TRIAL_OCTETS, BATCH_OCTETS);
+  for (i = 0; i < sizeof(batch); ++i) {
+    batch[i] = i;
+  }
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  report("modulo", trial_legacy());
+  report("octet", trial_octet());
+  report("bulk", trial_bulk());
+  BSP430_CORE_ENABLE_INTERRUPT();
+}
@@ -0,0 +1,166 @@
+/** This file is in the public domain.
+ *
+ * Demonstrate bsp430/utility/rpc.h by serving one set of commands
+ * both as a text command line and as binary requests on a
+ * bsp430/utility/chanmux.h channel.
+ *
+ * Lines typed on the console are executed with
+ * iBSP430cliExecuteCommand().  Frames on channel 1 are executed by
+ * the binary server.  For example, with the console in raw mode:
+ *
+ * @code
+ * maintainer/rpc-bench /dev/ttyACM0 1 -
+ * maintainer/rpc-bench -n 1000 /dev/ttyACM0 1 "set ival" -42
+ * @endcode
+ *
+ * lists the command numbers, then measures the round-trip latency of
+ * storing a value that the text command @c show will display.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/utility/cli.h>
+#include <bsp430/utility/chanmux.h>
+#include <bsp430/utility/rpc.h>
+#include <string.h>
+
+#if ! (BSP430_CONSOLE_RX_BUFFER_SIZE - 0)
+#error Application requires interrupt-driven console reception
+#endif /* BSP430_CONSOLE_RX_BUFFER_SIZE */
+
+#define RPC_CHANNEL 1
+
+struct data_t {
+  int ival;
+  unsigned int uival;
+  long lval;
+  unsigned long ulval;
+} data;
+
+const sBSP430cliCommand * commandSet;
+#define LAST_COMMAND NULL
+
+static const sBSP430cliCommand dcmd_set_ival = {
+  .key = "ival",
+  .help = "[signed 16-bit integer]",
+  .handler = iBSP430cliHandlerStoreI,
+  .param.ptr = &data.ival
+};
+static const sBSP430cliCommand dcmd_set_uival = {
+  .key = "uival",
+  .help = "[unsigned 16-bit integer]",
+  .next = &dcmd_set_ival,
+  .handler = iBSP430cliHandlerStoreUI,
+  .param.ptr = &data.uival
+};
+static const sBSP430cliCommand dcmd_set_lval = {
+  .key = "lval",
+  .help = "[signed 32-bit integer]",
+  .next = &dcmd_set_uival,
+  .handler = iBSP430cliHandlerStoreL,
+  .param.ptr = &data.lval
+};
+static const sBSP430cliCommand dcmd_set_ulval = {
+  .key = "ulval",
+  .help = "[unsigned 32-bit integer]",
+  .next = &dcmd_set_lval,
+  .handler = iBSP430cliHandlerStoreUL,
+  .param.ptr = &data.ulval
+};
+static const sBSP430cliCommand dcmd_set = {
+  .key = "set",
+  .child = &dcmd_set_ulval,
+  .next = LAST_COMMAND,
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_set
+
+static int
+cmd_show (const char * argstr)
+{
+  cprintf("ival %d uival %u lval %ld ulval %lu\n",
+          data.ival, data.uival, data.lval, data.ulval);
+  return 0;
+}
+static const sBSP430cliCommand dcmd_show = {
+  .key = "show",
+  .help = "# Display the value of variables",
+  .next = LAST_COMMAND,
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_show
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_show
+
+static int
+cmd_echo (sBSP430cliCommandLink * chain,
+          void * param,
+          const char * argstr,
+          size_t argstr_len)
+{
+  cputtext("echo:");
+  cputchars(argstr, argstr_len);
+  cputchar('\n');
+  return argstr_len;
+}
+static const sBSP430cliCommand dcmd_echo = {
+  .key = "echo",
+  .help = "[text] # Display the text",
+  .next = LAST_COMMAND,
+  .handler = cmd_echo
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_echo
+
+static uint8_t rpc_buffer[16];
+static sBSP430rpcServer rpc = {
+  .channel = {
+    .id = RPC_CHANNEL,
+    .tx_ring = BSP430_RING_INITIALIZER(sizeof(rpc_buffer)),
+    .tx_buffer = rpc_buffer,
+  },
+};
+
+void main ()
+{
+  char line[64];
+  unsigned int line_len = 0;
+
+  vBSP430platformInitialize_ni();
+  (void)iBSP430consoleInitialize();
+  vBSP430cliSetDiagnosticFunction(iBSP430cliConsoleDiagnostic);
+
+  commandSet = LAST_COMMAND;
+  rpc.cmds = commandSet;
+  (void)iBSP430rpcRegister(&rpc);
+
+  cprintf("\n\nrpc " __DATE__ " " __TIME__ "\n");
+  cprintf("Binary requests on channel %u\n", RPC_CHANNEL);
+  vBSP430cliConsoleDisplayHelp(commandSet);
+
+  while (1) {
+    int c;
+
+    while (0 <= ((c = cgetchar()))) {
+      c = iBSP430chanmuxRxFilter(c);
+      if (0 > c) {
+        continue;
+      }
+      if (('\r' == c) || ('\n' == c) || (line_len == (sizeof(line) - 1))) {
+        if (0 < line_len) {
+          line[line_len] = 0;
+          (void)iBSP430cliExecuteCommand(commandSet, NULL, line);
+          line_len = 0;
+        }
+        continue;
+      }
+      line[line_len++] = c;
+    }
+    BSP430_CORE_DISABLE_INTERRUPT();
+    BSP430_CORE_LPM_ENTER_NI(LPM0_bits);
+    BSP430_CORE_ENABLE_INTERRUPT();
+  }
+}
@@ -0,0 +1,208 @@
+/** This file is in the public domain.
+ *
+ * Measure the cost of converting integers to text with the
+ * division-free routines in bsp430/utility/xtoa.h, compared with the
+ * conventional conversion that divides by the radix once per digit.
+ *
+ * For each of several 16- and 32-bit values the application reports
+ * the SMCLK cycles consumed by each method in radix 10 and radix 16,
+ * verifying that the text agrees.  It then compares the library
+ * snprintf() with iBSP430xtoaVuprintf() on a typical log message.
+ *
+ * Build with <tt>RECIPROCAL=0</tt> or <tt>RECIPROCAL=1</tt> to select
+ * the decimal method explicitly; by default the reciprocal method is
+ * used only where the MPY32 peripheral is present.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/clock.h>
+#include <bsp430/periph/timer.h>
+#include <bsp430/utility/uptime.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/utility/xtoa.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+static volatile sBSP430hplTIMER * hrt;
+static unsigned int hrt_overhead;
+
+/* The conventional conversion, as used by the console before the
+ * xtoa module was introduced. */
+#define DIVIDE_T(INT_T)                         \
+static char *                                   \
+divide_##INT_T (unsigned INT_T uval,            \
+                char * str,                     \
+                unsigned int radix)             \
+{                                               \
+  char * sp = str;                              \
+  char * sp2 = str;                             \
+                                                \
+  do {                                          \
+    unsigned int rem = uval % radix;            \
+    uval /= radix;                              \
+    if (10 > rem) {                             \
+      *sp++ = '0' + rem;                        \
+    } else {                                    \
+      *sp++ = 'A' + rem - 10;                   \
+    }                                           \
+  } while (0 < uval);                           \
+  *sp-- = 0;                                    \
+  while (sp2 < sp) {                            \
+    char tmp = *sp2;                            \
+    *sp2++ = *sp;                               \
+    *sp-- = tmp;                                \
+  }                                             \
+  return str;                                   \
+}
+
+DIVIDE_T(int)
+DIVIDE_T(long)
+
+static unsigned int
+cycles_since (unsigned int t0)
+{
+  return uiBSP430timerSyncCounterRead_ni(hrt) - t0 - hrt_overhead;
+}
+
+static void
+compare_uint (unsigned int v,
+              unsigned int radix)
+{
+  char b1[BSP430_XTOA_LONG_BUFFER_SIZE];
+  char b2[BSP430_XTOA_LONG_BUFFER_SIZE];
+  unsigned int t0;
+  unsigned int dc;
+  unsigned int xc;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  t0 = uiBSP430timerSyncCounterRead_ni(hrt);
+  (void)divide_int(v, b1, radix);
+  dc = cycles_since(t0);
+  t0 = uiBSP430timerSyncCounterRead_ni(hrt);
+  (void)xBSP430xtoaUInt(v, b2, radix);
+  xc = cycles_since(t0);
+  BSP430_CORE_ENABLE_INTERRUPT();
+  cprintf("16-bit %2u %10s: divide %5u xtoa %5u%s\n", radix, b1, dc, xc,
+          strcmp(b1, b2) ? " MISMATCH" : "");
+}
+
+static void
+compare_ulong (unsigned long v,
+               unsigned int radix)
+{
+  char b1[BSP430_XTOA_LONG_BUFFER_SIZE];
+  char b2[BSP430_XTOA_LONG_BUFFER_SIZE];
+  unsigned int t0;
+  unsigned int dc;
+  unsigned int xc;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  t0 = uiBSP430timerSyncCounterRead_ni(hrt);
+  (void)divide_long(v, b1, radix);
+  dc = cycles_since(t0);
+  t0 = uiBSP430timerSyncCounterRead_ni(hrt);
+  (void)xBSP430xtoaULong(v, b2, radix);
+  xc = cycles_since(t0);
+  BSP430_CORE_ENABLE_INTERRUPT();
+  cprintf("32-bit %2u %10s: divide %5u xtoa %5u%s\n", radix, b1, dc, xc,
+          strcmp(b1, b2) ? " MISMATCH" : "");
+}
+
+static char sink_buffer[80];
+static unsigned int sink_len;
+
+static int
+sink (int c)
+{
+  if (sink_len < (sizeof(sink_buffer) - 1)) {
+    sink_buffer[sink_len++] = c;
+  }
+  return c;
+}
+
+static int
+sink_printf (const char * fmt, ...)
+{
+  va_list ap;
+  int rv;
+
+  va_start(ap, fmt);
+  sink_len = 0;
+  rv = iBSP430xtoaVuprintf(sink, fmt, ap);
+  sink_buffer[sink_len] = 0;
+  va_end(ap);
+  return rv;
+}
+
+static const unsigned int values16[] = { 7, 42, 1234, 65535 };
+static const unsigned long values32[] = { 7, 65536UL, 1234567UL, 4294967295UL };
+
+void main ()
+{
+  char buffer[sizeof(sink_buffer)];
+  unsigned int i;
+  unsigned int iter = 0;
+
+  vBSP430platformInitialize_ni();
+  (void)iBSP430consoleInitialize();
+
+  cprintf("\n\nxtoa " __DATE__ " " __TIME__ "\n");
+  cprintf("Decimal conversion by %s; MPY32 %s\n",
+          (configBSP430_XTOA_USE_RECIPROCAL - 0) ? "reciprocal" : "subtraction",
+#if defined(__MSP430_HAS_MPY32__)
+          "present"
+#else /* __MSP430_HAS_MPY32__ */
+          "absent"
+#endif /* __MSP430_HAS_MPY32__ */
+         );
+
+  hrt = xBSP430hplLookupTIMER(HRT_PERIPH_HANDLE);
+  if (NULL == hrt) {
+    cprintf("High-resolution timer not available\n");
+    return;
+  }
+  hrt->ctl = TASSEL_2 | MC_2 | TACLR;
+  cprintf("Cycles are SMCLK at %lu Hz\n", ulBSP430clockSMCLK_Hz());
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  i = uiBSP430timerSyncCounterRead_ni(hrt);
+  hrt_overhead = uiBSP430timerSyncCounterRead_ni(hrt) - i;
+  BSP430_CORE_ENABLE_INTERRUPT();
+
+  while (1) {
+    unsigned long now = ulBSP430uptime();
+    unsigned int t0;
+    unsigned int lc;
+    unsigned int xc;
+
+    for (i = 0; i < sizeof(values16) / sizeof(*values16); ++i) {
+      compare_uint(values16[i], 10);
+      compare_uint(values16[i], 16);
+    }
+    for (i = 0; i < sizeof(values32) / sizeof(*values32); ++i) {
+      compare_ulong(values32[i], 10);
+      compare_ulong(values32[i], 16);
+    }
+
+    BSP430_CORE_DISABLE_INTERRUPT();
+    t0 = uiBSP430timerSyncCounterRead_ni(hrt);
+    (void)snprintf(buffer, sizeof(buffer), "iter %u at %lu: %d %04x %-6s|",
+                   iter, now, -1234, iter, "ok");
+    lc = cycles_since(t0);
+    t0 = uiBSP430timerSyncCounterRead_ni(hrt);
+    (void)sink_printf("iter %u at %lu: %d %04x %-6s|",
+                      iter, now, -1234, iter, "ok");
+    xc = cycles_since(t0);
+    BSP430_CORE_ENABLE_INTERRUPT();
+    cprintf("%s\nsnprintf %u cycles, iBSP430xtoaVuprintf %u cycles%s\n",
+            buffer, lc, xc, strcmp(buffer, sink_buffer) ? " MISMATCH" : "");
+
+    ++iter;
+    BSP430_CORE_DISABLE_INTERRUPT();
+    BSP430_UPTIME_DELAY_MS_NI(5000, LPM0_bits, 0);
+    BSP430_CORE_ENABLE_INTERRUPT();
+  }
+}
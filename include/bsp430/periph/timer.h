@@ -1268,24 +1268,59 @@ unsigned long ulBSP430timerCounter_ni (hBSP430halTIMER timer,
 
 /** Read timer counter regardless of interrupt enable state.
  *
- * This wraps #ulBSP430timerCounter_ni with code that saves the
- * interrupt state, reads the timer, then restores the entry interrupt
- * state prior to returning the timer counts.
- *
- * @warning See warnings at ulBSP430timerCounter_ni().
+ * This produces the same result as ulBSP430timerCounter_ni() without
+ * disabling interrupts.  The overflow interrupt handler is the only
+ * code that updates sBSP430halTIMER::overflow_count while the timer
+ * runs, and every update changes the low word of that counter.  The
+ * low word is therefore read before and after the counter and
+ * overflow values are sampled, and the sample is repeated if it
+ * changed: a sequence lock where the interrupt handler is the writer.
+ * A retry is needed only when an overflow interrupt is taken during
+ * the few instructions of the sample.
+ *
+ * @warning See warnings at ulBSP430timerCounter_ni().  The result is
+ * not reliable if the counter is reset or set from an interrupt
+ * handler while this is being executed.
  */
+unsigned long ulBSP430timerCounter (hBSP430halTIMER timer,
+                                    unsigned int * overflowp);
+
+/** Read the full-precision timer counter assuming interrupts are
+ * disabled.
+ *
+ * This combines the 32-bit result of ulBSP430timerCounter_ni() with
+ * the high word of the overflow counter.
+ *
+ * @param timer The timer for which the count is desired.
+ *
+ * @return the counter as a 64-bit value of which the low 48 bits are
+ * valid. */
 static BSP430_CORE_INLINE
-unsigned long
-ulBSP430timerCounter (hBSP430halTIMER timer,
-                      unsigned int * overflowp)
+unsigned long long
+ullBSP430timerCounter_ni (hBSP430halTIMER timer)
 {
-  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
-  unsigned long rv;
+  unsigned int overflow;
+  unsigned long ul = ulBSP430timerCounter_ni(timer, &overflow);
+  return (((unsigned long long)overflow) << (8 * sizeof(ul))) | ul;
+}
 
-  BSP430_CORE_DISABLE_INTERRUPT();
-  rv = ulBSP430timerCounter_ni(timer, overflowp);
-  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
-  return rv;
+/** Read the full-precision timer counter regardless of interrupt
+ * enable state.
+ *
+ * As with ullBSP430timerCounter_ni() but using
+ * ulBSP430timerCounter(), so interrupts are not disabled.
+ *
+ * @param timer The timer for which the count is desired.
+ *
+ * @return the counter as a 64-bit value of which the low 48 bits are
+ * valid. */
+static BSP430_CORE_INLINE
+unsigned long long
+ullBSP430timerCounter (hBSP430halTIMER timer)
+{
+  unsigned int overflow;
+  unsigned long ul = ulBSP430timerCounter(timer, &overflow);
+  return (((unsigned long long)overflow) << (8 * sizeof(ul))) | ul;
 }
 
 /** Return the full-precision counter at the point the timer produced @p ctr
@@ -1308,17 +1343,12 @@ unsigned long long
 ullBSP430timerCorrected (hBSP430halTIMER timer,
                          unsigned int ctr)
 {
-  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
   unsigned int overflow;
   unsigned int ui;
   unsigned long ul;
   unsigned long long ull;
 
-  BSP430_CORE_DISABLE_INTERRUPT();
-  do {
-    ul = ulBSP430timerCounter_ni(timer, &overflow);
-  } while (0);
-  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  ul = ulBSP430timerCounter(timer, &overflow);
   ull = overflow;
   ull <<= 8 * sizeof(ul);
   ull += ul;
@@ -1735,6 +1765,43 @@ int iBSP430timerAlarmCancel (hBSP430timerAlarm alarm)
   return rv;
 }
 
+/** Define to a true value to keep multiplexed alarms in a binary
+ * min-heap instead of a sorted list.
+ *
+ * With the default list, adding an alarm walks the list to find its
+ * position and reprograms the dedicated alarm, both with interrupts
+ * disabled, so the cost of iBSP430timerMuxAlarmAdd_ni() grows
+ * linearly with the number of pending alarms.  With the heap, adding,
+ * removing, and firing an alarm each cost a number of steps
+ * logarithmic in the number of pending alarms, and the dedicated
+ * alarm is reprogrammed only when the earliest alarm changes.  The
+ * cost is storage for #BSP430_TIMER_MUX_ALARM_HEAP_CAPACITY pointers
+ * in each #sBSP430timerMuxSharedAlarm, and that alarms with identical
+ * settings may fire in any order rather than the order in which they
+ * were added.
+ *
+ * Alarm settings are ordered by their signed difference, so all
+ * alarms pending on a shared alarm must be due within 2^31 ticks of
+ * each other.
+ *
+ * @cppflag
+ * @defaulted
+ * @ingroup grp_timer_alarm */
+#ifndef configBSP430_TIMER_MUX_ALARM_HEAP
+#define configBSP430_TIMER_MUX_ALARM_HEAP 0
+#endif /* configBSP430_TIMER_MUX_ALARM_HEAP */
+
+/** The maximum number of alarms that may be pending on a shared
+ * alarm when #configBSP430_TIMER_MUX_ALARM_HEAP is enabled.
+ *
+ * @cppflag
+ * @defaulted
+ * @dependency #configBSP430_TIMER_MUX_ALARM_HEAP
+ * @ingroup grp_timer_alarm */
+#ifndef BSP430_TIMER_MUX_ALARM_HEAP_CAPACITY
+#define BSP430_TIMER_MUX_ALARM_HEAP_CAPACITY 16
+#endif /* BSP430_TIMER_MUX_ALARM_HEAP_CAPACITY */
+
 /* Forward declaration */
 struct sBSP430timerMuxAlarm;
 
@@ -1769,9 +1836,32 @@ typedef struct sBSP430timerMuxSharedAlarm {
    * code.  */
   sBSP430timerAlarm dedicated;
 
+#if defined(BSP430_DOXYGEN) || ! (configBSP430_TIMER_MUX_ALARM_HEAP - 0)
   /** The active multiplexed alarms, sorted by time with earliest
-   * wakeup first. */
+   * wakeup first.
+   *
+   * @dependency ! #configBSP430_TIMER_MUX_ALARM_HEAP */
   struct sBSP430timerMuxAlarm * alarms;
+#endif /* configBSP430_TIMER_MUX_ALARM_HEAP */
+
+#if defined(BSP430_DOXYGEN) || (configBSP430_TIMER_MUX_ALARM_HEAP - 0)
+  /** The active multiplexed alarms, as a binary min-heap ordered by
+   * time: the earliest wakeup is at index zero, and the children of
+   * the alarm at index @c i are at indexes @c 2i+1 and @c 2i+2.
+   *
+   * @dependency #configBSP430_TIMER_MUX_ALARM_HEAP */
+  struct sBSP430timerMuxAlarm * heap[BSP430_TIMER_MUX_ALARM_HEAP_CAPACITY];
+
+  /** The number of alarms in #heap.
+   *
+   * @dependency #configBSP430_TIMER_MUX_ALARM_HEAP */
+  unsigned int heap_count;
+#endif /* configBSP430_TIMER_MUX_ALARM_HEAP */
+
+  /** Nonzero between vBSP430timerMuxAlarmBegin_ni() and
+   * iBSP430timerMuxAlarmCommit_ni(), during which adding and
+   * removing alarms does not reprogram #dedicated. */
+  unsigned char batch_ni;
 } sBSP430timerMuxSharedAlarm;
 
 /** Handle for the underlying shared alarm for multiplixed alarms.
@@ -1801,6 +1891,14 @@ typedef struct sBSP430timerMuxAlarm {
    * User code is only permitted to use this field when the structure
    * is not owned by a shared multiplex alarm. */
   struct sBSP430timerMuxAlarm * next;
+
+#if defined(BSP430_DOXYGEN) || (configBSP430_TIMER_MUX_ALARM_HEAP - 0)
+  /** The position of the alarm in sBSP430timerMuxSharedAlarm::heap,
+   * maintained by the infrastructure while the alarm is pending.
+   *
+   * @dependency #configBSP430_TIMER_MUX_ALARM_HEAP */
+  unsigned int heap_idx;
+#endif /* configBSP430_TIMER_MUX_ALARM_HEAP */
 } sBSP430timerMuxAlarm;
 
 /** Handle for an individual multiplixed alarm.
@@ -1834,7 +1932,9 @@ hBSP430timerMuxSharedAlarm hBSP430timerMuxAlarmStartup (sBSP430timerMuxSharedAla
  *
  * The underlying shared alarm is cancelled and disabled.  User code
  * may inspect and manipulate the remaining alarms to process any
- * unexpired timers.
+ * unexpired timers, found in sBSP430timerMuxSharedAlarm::alarms or
+ * sBSP430timerMuxSharedAlarm::heap depending on
+ * #configBSP430_TIMER_MUX_ALARM_HEAP.
  *
  * @param shared a pointer to the structure used for multiplexed alarms
  *
@@ -1882,7 +1982,11 @@ unsigned long ulBSP430timerMuxSharedAlarmCounter (sBSP430timerMuxSharedAlarm * s
  * @return Normally the return value from
  * iBSP430timerAlarmSetForced_ni() when setting for the first
  * multiplexed alarm.  If a negative value appears, the multiplexed
- * alarm structure is in an undefined state.
+ * alarm structure is in an undefined state.  When
+ * #configBSP430_TIMER_MUX_ALARM_HEAP is enabled, zero is returned if
+ * @p alarm is not the first to fire, since the dedicated alarm is not
+ * changed, and -1 is returned without adding @p alarm if
+ * #BSP430_TIMER_MUX_ALARM_HEAP_CAPACITY alarms are already pending.
  *
  * @ingroup grp_timer_alarm */
 int iBSP430timerMuxAlarmAdd_ni (hBSP430timerMuxSharedAlarm shared,
@@ -1901,7 +2005,9 @@ int iBSP430timerMuxAlarmAdd_ni (hBSP430timerMuxSharedAlarm shared,
  *
  * @return Normally the return value from
  * iBSP430timerAlarmSetForced_ni() when setting for the next scheduled
- * multiplexed alarm.  Zero is returned if no alarms remain.  If a
+ * multiplexed alarm.  Zero is returned if no alarms remain, or when
+ * #configBSP430_TIMER_MUX_ALARM_HEAP is enabled and @p alarm was not
+ * the first to fire.  If a
  * negative value appears, the multiplexed alarm structure is in an
  * undefined state.
  *
@@ -1909,6 +2015,170 @@ int iBSP430timerMuxAlarmAdd_ni (hBSP430timerMuxSharedAlarm shared,
 int iBSP430timerMuxAlarmRemove_ni (hBSP430timerMuxSharedAlarm shared,
                                    hBSP430timerMuxAlarm alarm);
 
+/** Begin a batch of changes to multiplexed alarms.
+ *
+ * Until iBSP430timerMuxAlarmCommit_ni() is invoked,
+ * iBSP430timerMuxAlarmAdd_ni() and iBSP430timerMuxAlarmRemove_ni()
+ * update the set of alarms managed by @p shared but leave the
+ * dedicated alarm as it was, and return zero unless an error is
+ * detected.  This allows many alarms to be rescheduled, for example
+ * after a wakeup, with a single reprogramming of the underlying
+ * capture/compare register.
+ *
+ * Interrupts must remain disabled from this call through the
+ * corresponding commit, since the dedicated alarm may refer to an
+ * alarm that has been removed in the interim.
+ *
+ * @param shared the shared alarm that manages multiplexed alarms.
+ *
+ * @ingroup grp_timer_alarm */
+static BSP430_CORE_INLINE
+void vBSP430timerMuxAlarmBegin_ni (hBSP430timerMuxSharedAlarm shared)
+{
+  shared->batch_ni = 1;
+}
+
+/** Complete a batch of changes to multiplexed alarms.
+ *
+ * The dedicated alarm is set for the earliest alarm now managed by @p
+ * shared, or cancelled if none remain.  It is left untouched if it is
+ * already set for the earliest alarm.  As with
+ * iBSP430timerMuxAlarmAdd_ni() the setting is forced, so alarms that
+ * became due during the batch fire as soon as interrupts are enabled.
+ *
+ * @param shared the shared alarm that manages multiplexed alarms.
+ *
+ * @return Normally the return value from
+ * iBSP430timerAlarmSetForced_ni() when setting for the earliest
+ * multiplexed alarm, or zero if no alarms remain or the setting was
+ * unchanged.  A negative value indicates the dedicated alarm could
+ * not be updated.
+ *
+ * @ingroup grp_timer_alarm */
+int iBSP430timerMuxAlarmCommit_ni (hBSP430timerMuxSharedAlarm shared);
+
+/** Policies for recovering when a periodic multiplexed alarm is
+ * serviced one or more full periods late.
+ *
+ * In all cases the alarm remains aligned to the phase established by
+ * its original setting: the next setting is always a whole number of
+ * intervals after the first, so lateness never accumulates as drift.
+ *
+ * @ingroup grp_timer_alarm */
+typedef enum eBSP430timerMuxPeriodicPolicy {
+  /** Invoke the callback once for every period, including those that
+   * were missed, back to back until the alarm has caught up.  This is
+   * the behavior of a callback that re-adds its own alarm one
+   * interval later. */
+  eBSP430timerMuxPeriodicPolicy_BURST,
+
+  /** Invoke the callback once, and discard the missed periods.  The
+   * next invocation is at the first period boundary that has not yet
+   * passed. */
+  eBSP430timerMuxPeriodicPolicy_SKIP,
+
+  /** As with #eBSP430timerMuxPeriodicPolicy_SKIP, but
+   * sBSP430timerMuxPeriodic::periods_ni records the number of periods
+   * the single invocation stands for, so that the callback can
+   * account for all of them. */
+  eBSP430timerMuxPeriodicPolicy_COALESCE,
+} eBSP430timerMuxPeriodicPolicy;
+
+/* Forward declaration */
+struct sBSP430timerMuxPeriodic;
+
+/** Callback used for periodic multiplexed alarms.
+ *
+ * Unlike iBSP430timerMuxAlarmCallback_ni, when this is invoked @p
+ * periodic remains associated with @p shared, and its setting has
+ * already been advanced to the next period.  The callback may invoke
+ * iBSP430timerMuxPeriodicRemove_ni() to stop the alarm.
+ *
+ * @return as with iBSP430timerMuxAlarmCallback_ni.
+ *
+ * @ingroup grp_timer_alarm */
+typedef int (* iBSP430timerMuxPeriodicCallback_ni) (struct sBSP430timerMuxSharedAlarm * shared,
+                                                    struct sBSP430timerMuxPeriodic * periodic);
+
+/** Structure holding the state of a periodic multiplexed alarm.
+ *
+ * The multiplexed alarm infrastructure re-arms a periodic alarm in
+ * place when it fires, without removing it from the set of pending
+ * alarms and adding it back.  With #configBSP430_TIMER_MUX_ALARM_HEAP
+ * this is a single sift down from the root of the heap.
+ *
+ * @ingroup grp_timer_alarm */
+typedef struct sBSP430timerMuxPeriodic {
+  /** The underlying multiplexed alarm.  Its fields are managed by
+   * iBSP430timerMuxPeriodicAdd_ni() and the infrastructure. */
+  sBSP430timerMuxAlarm alarm;
+
+  /** The interval between invocations, in ticks of the shared alarm
+   * timer.  A zero interval produces a single invocation.  Changes
+   * made from the callback take effect at the next period. */
+  unsigned long interval_tck;
+
+  /** The function to invoke at each period. */
+  iBSP430timerMuxPeriodicCallback_ni callback_ni;
+
+  /** The number of period boundaries that had passed without an
+   * invocation when the alarm was serviced.  This is cumulative from
+   * iBSP430timerMuxPeriodicAdd_ni(), and is counted identically under
+   * every policy. */
+  unsigned long overruns_ni;
+
+  /** The number of periods represented by the current invocation of
+   * #callback_ni.  This is always 1 except under
+   * #eBSP430timerMuxPeriodicPolicy_COALESCE. */
+  unsigned long periods_ni;
+
+  /** The eBSP430timerMuxPeriodicPolicy value used when the alarm is
+   * serviced late. */
+  unsigned char policy;
+} sBSP430timerMuxPeriodic;
+
+/** Handle for a periodic multiplexed alarm.
+ * @ingroup grp_timer_alarm */
+typedef sBSP430timerMuxPeriodic * hBSP430timerMuxPeriodic;
+
+/** Register a periodic multiplexed alarm.
+ *
+ * The caller must have set sBSP430timerMuxPeriodic::interval_tck,
+ * sBSP430timerMuxPeriodic::callback_ni, and
+ * sBSP430timerMuxPeriodic::policy.  The overrun count is cleared.
+ *
+ * @param shared the shared alarm that manages multiplexed alarms.
+ *
+ * @param periodic the periodic alarm to register.
+ *
+ * @param setting_tck the time, in absolute ticks of @p shared, of the
+ * first invocation.  Subsequent invocations are at multiples of
+ * sBSP430timerMuxPeriodic::interval_tck after this.
+ *
+ * @return as with iBSP430timerMuxAlarmAdd_ni(), or -1 if @p periodic
+ * has no callback.
+ *
+ * @ingroup grp_timer_alarm */
+int iBSP430timerMuxPeriodicAdd_ni (hBSP430timerMuxSharedAlarm shared,
+                                   hBSP430timerMuxPeriodic periodic,
+                                   unsigned long setting_tck);
+
+/** Stop a periodic multiplexed alarm.
+ *
+ * @param shared the shared alarm that manages multiplexed alarms.
+ *
+ * @param periodic the periodic alarm to remove.
+ *
+ * @return as with iBSP430timerMuxAlarmRemove_ni().
+ *
+ * @ingroup grp_timer_alarm */
+static BSP430_CORE_INLINE
+int iBSP430timerMuxPeriodicRemove_ni (hBSP430timerMuxSharedAlarm shared,
+                                      hBSP430timerMuxPeriodic periodic)
+{
+  return iBSP430timerMuxAlarmRemove_ni(shared, &periodic->alarm);
+}
+
 /** Bit set in sBSP430timerPulseCapture::flags_ni if the
  * sBSP430timerPulseCapture::start_tt timestamp corresponds to the
  * start of a pulse on a timer input. */
@@ -125,6 +125,29 @@ typedef struct sBSP430hplUSCI {
   unsigned char txbuf;              /**< UCtxTXBUF */ /* 0x07 */
 } sBSP430hplUSCI;
 
+/** Registers of a 2xx/4xx USCI peripheral that lie outside
+ * #sBSP430hplUSCI.  Reach it through
+ * #BSP430_SERIAL_HAL_GET_HPLAUX_USCI(). */
+struct sBSP430usciHPLAux {
+  /** Pointer to the interrupt enable register for the peripheral */
+  volatile unsigned char * const iep;
+
+  /** Pointer to the interrupt flag register for the peripheral */
+  volatile unsigned char * const ifgp;
+
+  /** Bit within *iep and *ifgp used to denote an RX interrupt */
+  unsigned char const rx_bit;
+
+  /** Bit within *iep and *ifgp used to denote a TX interrupt */
+  unsigned char const tx_bit;
+
+  /** I2C own address register (USCI_Bx only) */
+  volatile unsigned int * i2coap;
+
+  /** I2C slave address register (USCI_Bx only) */
+  volatile unsigned int * i2csap;
+};
+
 /** @cond DOXYGEN_INTERNAL */
 #define BSP430_PERIPH_USCI_A0_BASEADDRESS_ 0x0060
 #define BSP430_PERIPH_USCI_A1_BASEADDRESS_ 0x00d0
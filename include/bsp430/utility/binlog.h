@@ -0,0 +1,200 @@
+/* Copyright 2014, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Deferred formatting of console log messages.
+ *
+ * Formatting text with cprintf() on an MSP430 is slow, and a
+ * formatted message occupies the console for far longer than the
+ * information in it warrants.  This module allows the formatting to
+ * be deferred to the host that reads the console.
+ *
+ * A message logged with #BSP430_BINLOG places its format string in a
+ * dedicated linker section named @c bsp430_binlog.  At runtime only a
+ * record is emitted, consisting of:
+ * @li the octet #BSP430_BINLOG_RECORD_MARKER;
+ * @li the offset of the format string within the section, as a
+ * base-128 varint;
+ * @li each argument consumed by the format string, encoded as
+ * described below.
+ *
+ * Integer arguments are emitted as base-128 varints (least
+ * significant group first, high bit set on all but the last octet).
+ * Signed conversions (@c d and @c i) are zigzag-encoded first so
+ * small negative values remain short.  @c c is encoded as an
+ * unsigned integer, @c p as an unsigned integer of the pointer
+ * value, and @c s as its length followed by the characters of the
+ * string; a null @c s argument is encoded as an empty string.
+ * A @c * width or precision consumes an @c int argument, encoded as
+ * for @c d.  Length modifiers @c h, @c hh, @c l and @c ll are supported.
+ * Floating point and other conversions are not supported; encoding
+ * of the record stops at the first unsupported conversion and the
+ * host decoder is expected to do the same.
+ *
+ * Each record is assembled on the stack and written into the console
+ * transmit path with a single cputoctets() call made with interrupts
+ * disabled, so records may be freely interleaved with normal console
+ * text, including text written by interrupt handlers.  (The exception
+ * is #eBSP430consoleTxPolicy_BLOCK with a transmit buffer too full to
+ * take the whole record, which enables interrupts while waiting for
+ * space.)  A string that does not fit within
+ * #BSP430_BINLOG_RECORD_LENGTH is truncated; a record that still
+ * does not fit is discarded.  The host utility
+ * <tt>maintainer/binlog-decode</tt> extracts the format strings from
+ * the application ELF file and reconstitutes the text.
+ *
+ * @warning The record marker is a NUL octet, which never appears in
+ * console text but may appear within a record.  A host that attaches
+ * to the stream mid-record will produce garbage until the next
+ * marker.  The marker is also the bsp430/utility/chanmux.h frame
+ * delimiter: when the console carries multiplexed channels define
+ * #BSP430_BINLOG_CHANMUX_ID so each record is sent as a frame on its
+ * own channel, which <tt>maintainer/chanmux-demux</tt> passes to
+ * <tt>maintainer/binlog-decode</tt>.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2014, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#ifndef BSP430_UTILITY_BINLOG_H
+#define BSP430_UTILITY_BINLOG_H
+
+#include <bsp430/core.h>
+#include <bsp430/utility/console.h>
+#include <stdarg.h>
+
+#if defined(BSP430_UTILITY_CHANMUX_H) && ! (BSP430_BINLOG_CHANMUX_ID - 0)
+#error Binary log records conflict with chanmux frames: define BSP430_BINLOG_CHANMUX_ID
+#endif /* BSP430_UTILITY_CHANMUX_H */
+
+/** Define to a true value to have #BSP430_BINLOG format its message
+ * on the MCU with cprintf() rather than emitting a binary record.
+ *
+ * This is useful when no host decoder is available; the format
+ * strings remain in the @c bsp430_binlog section.
+ *
+ * @cppflag
+ * @defaulted
+ */
+#ifndef configBSP430_BINLOG_AS_TEXT
+#define configBSP430_BINLOG_AS_TEXT 0
+#endif /* configBSP430_BINLOG_AS_TEXT */
+
+/** The maximum number of octets in one binary log record.
+ *
+ * The record is assembled on the stack in a buffer somewhat larger
+ * than this.
+ *
+ * @cppflag
+ * @defaulted
+ */
+#ifndef BSP430_BINLOG_RECORD_LENGTH
+#define BSP430_BINLOG_RECORD_LENGTH 48
+#endif /* BSP430_BINLOG_RECORD_LENGTH */
+
+/** The bsp430/utility/chanmux.h channel on which binary log records
+ * are sent.
+ *
+ * If zero, records are written directly into the console stream.
+ * Otherwise each record, including its marker, is the payload of one
+ * frame on this channel, and #BSP430_BINLOG_RECORD_LENGTH may not
+ * exceed #BSP430_CHANMUX_MAX_PAYLOAD.  This must be defined in
+ * <bsp430_config.h> rather than in a single translation unit, since
+ * the two headers refuse to be used together without it.
+ *
+ * @cppflag
+ * @defaulted
+ */
+#ifndef BSP430_BINLOG_CHANMUX_ID
+#define BSP430_BINLOG_CHANMUX_ID 0
+#endif /* BSP430_BINLOG_CHANMUX_ID */
+
+/** The octet that introduces a binary log record in the console
+ * stream. */
+#define BSP430_BINLOG_RECORD_MARKER 0x00
+
+/** The name of the linker section holding binary log format strings.
+ * The host decoder locates the strings by this name. */
+#define BSP430_BINLOG_SECTION_NAME "bsp430_binlog"
+
+/** Attributes that place an object in the binary log format string
+ * section.
+ *
+ * The section name is a valid C identifier, so the GNU linker
+ * provides the <tt>__start_bsp430_binlog</tt> symbol that anchors the
+ * string identifiers without any linker script changes. */
+#define BSP430_BINLOG_SECTION __attribute__((__section__(BSP430_BINLOG_SECTION_NAME), __used__))
+
+/** Log a message for formatting by the host.
+ *
+ * @param fmt_ a string literal printf(3) format; see the @link
+ * bsp430/utility/binlog.h module documentation@endlink for the
+ * supported conversions
+ *
+ * @param ... the arguments consumed by @p fmt_
+ *
+ * @consoleoutput
+ */
+#if (configBSP430_BINLOG_AS_TEXT - 0)
+#define BSP430_BINLOG(fmt_, ...) do {                                   \
+    static const char BSP430_BINLOG_SECTION binlog_fmt_[] = fmt_;       \
+    (void)cprintf(binlog_fmt_, ##__VA_ARGS__);                          \
+  } while (0)
+#else /* configBSP430_BINLOG_AS_TEXT */
+#define BSP430_BINLOG(fmt_, ...) do {                                   \
+    static const char BSP430_BINLOG_SECTION binlog_fmt_[] = fmt_;       \
+    (void)iBSP430binlog(binlog_fmt_, ##__VA_ARGS__);                    \
+  } while (0)
+#endif /* configBSP430_BINLOG_AS_TEXT */
+
+/** Emit a binary log record.
+ *
+ * Normally invoked through #BSP430_BINLOG.
+ *
+ * @param fmt a format string located in the @c bsp430_binlog section
+ *
+ * @param ... the arguments consumed by @p fmt
+ *
+ * @return the number of octets emitted for the record, zero if the
+ * console is not available, or -1 if the record was discarded because
+ * it exceeded #BSP430_BINLOG_RECORD_LENGTH
+ *
+ * @consoleoutput */
+int iBSP430binlog (const char * fmt, ...)
+__attribute__((__format__(printf, 1, 2)));
+
+/** Like iBSP430binlog() but with a <tt>va_list</tt> argument.
+ *
+ * @consoleoutput */
+int iBSP430binlogv (const char * fmt, va_list ap);
+
+#endif /* BSP430_UTILITY_BINLOG_H */
@@ -0,0 +1,362 @@
+/* Copyright 2014, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Framed logical channels multiplexed over the console UART.
+ *
+ * Many applications share the console UART between the interactive
+ * user, binary telemetry, and commands from a host program.  Writing
+ * all of these with cputchar() interleaves them with nothing to tell
+ * them apart.  This module carries binary data on numbered logical
+ * channels in frames that the host can separate from console text
+ * without ambiguity.
+ *
+ * Each frame on the wire consists of:
+ * @li the delimiter octet #BSP430_CHANMUX_DELIMITER;
+ * @li the <a href="http://en.wikipedia.org/wiki/Consistent_Overhead_Byte_Stuffing">COBS</a>
+ * encoding of the channel identifier, the payload, and a CRC-16 of
+ * the identifier and payload;
+ * @li the delimiter octet.
+ *
+ * The CRC uses the CCITT polynomial 0x1021 with initial value 0xFFFF
+ * and no bit reversal, and is transmitted least significant octet
+ * first.  COBS encoding ensures the delimiter does not appear within
+ * the frame.  Console text never contains a NUL octet, so anything
+ * outside a frame is console text and is carried by the host as
+ * channel zero.  Channel identifiers 1 through 255 are available to
+ * the application.
+ *
+ * Data for each channel is queued in a per-channel ring by
+ * iBSP430chanmuxWrite(), which is safe to call from a single
+ * producer in interrupt context.  Queued data is framed and handed to
+ * the console by iBSP430chanmuxFlush(), which must be invoked from a
+ * single context.  Each frame is built on the stack and written to
+ * the console with interrupts disabled, so frames are never split by
+ * console text, including text written by interrupt handlers.
+ * Channels are served round-robin, one frame of at most
+ * #BSP430_CHANMUX_MAX_PAYLOAD octets each pass, so a channel streaming
+ * at full link rate does not starve the others.
+ *
+ * Frames sent by the host are recognized in the console input stream
+ * by passing each received character through iBSP430chanmuxRxFilter().
+ * Valid frames are delivered to the receive callback of the channel;
+ * frames that fail the CRC check or address an unregistered channel
+ * are counted and discarded.
+ *
+ * The host utility <tt>maintainer/chanmux-demux</tt> separates the
+ * stream and exposes console text and each channel as a
+ * pseudo-terminal or TCP socket.
+ *
+ * Records emitted by bsp430/utility/binlog.h begin with a NUL octet
+ * and cannot be distinguished from frames, so on a console that
+ * carries multiplexed channels they must be sent in frames of their
+ * own by defining #BSP430_BINLOG_CHANMUX_ID.  A translation unit that
+ * includes both headers without doing so will not compile.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2014, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#ifndef BSP430_UTILITY_CHANMUX_H
+#define BSP430_UTILITY_CHANMUX_H
+
+#include <bsp430/core.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/utility/ring.h>
+
+#if defined(BSP430_UTILITY_BINLOG_H) && ! (BSP430_BINLOG_CHANMUX_ID - 0)
+#error Binary log records conflict with chanmux frames: define BSP430_BINLOG_CHANMUX_ID
+#endif /* BSP430_UTILITY_BINLOG_H */
+
+/** The maximum number of payload octets carried in one frame.
+ *
+ * This determines the size of the static buffer used to decode frames
+ * and of the stack buffer used to encode them.  It must not exceed
+ * 250, which ensures the COBS encoding of a frame adds exactly one
+ * octet.
+ *
+ * @cppflag
+ * @defaulted
+ */
+#ifndef BSP430_CHANMUX_MAX_PAYLOAD
+#define BSP430_CHANMUX_MAX_PAYLOAD 64
+#endif /* BSP430_CHANMUX_MAX_PAYLOAD */
+
+/** The octet that delimits frames. */
+#define BSP430_CHANMUX_DELIMITER 0x00
+
+/** The number of octets a frame adds to its payload: two delimiters,
+ * the COBS overhead, the channel identifier, and the CRC. */
+#define BSP430_CHANMUX_FRAME_OVERHEAD 6
+
+/** The offset of the payload within a buffer passed to
+ * uiBSP430chanmuxEncodeFrame(). */
+#define BSP430_CHANMUX_PAYLOAD_OFFSET 3
+
+/* Forward declaration */
+struct sBSP430chanmuxChannel;
+
+/** Callback invoked for each valid frame received on a channel.
+ *
+ * The callback is invoked from iBSP430chanmuxRxFilter(), and so in
+ * whatever context the application reads the console.
+ *
+ * @param chan the channel to which the frame was addressed
+ *
+ * @param data the payload of the frame.  This is valid only for the
+ * duration of the call.
+ *
+ * @param len the number of octets in @p data */
+typedef void (* vBSP430chanmuxRxCallback) (struct sBSP430chanmuxChannel * chan,
+                                           const uint8_t * data,
+                                           size_t len);
+
+/** State for a logical channel.
+ *
+ * The application initializes @a id, @a tx_buffer, @a tx_ring (using
+ * #BSP430_RING_INITIALIZER with the size of @a tx_buffer), and
+ * optionally @a rx_callback, then registers the channel with
+ * iBSP430chanmuxRegister().  The remaining fields belong to the
+ * module. */
+typedef struct sBSP430chanmuxChannel {
+  /** Link to the next registered channel */
+  struct sBSP430chanmuxChannel * next;
+
+  /** The channel identifier, in the range 1 through 255 */
+  uint8_t id;
+
+  /** Ring state for data queued for transmission */
+  sBSP430ring tx_ring;
+
+  /** Storage for data queued for transmission.  The length must
+   * satisfy #BSP430_RING_VALID_CAPACITY. */
+  uint8_t * tx_buffer;
+
+  /** Function to receive frames addressed to this channel, or a null
+   * pointer to discard them */
+  vBSP430chanmuxRxCallback rx_callback;
+
+  /** The number of octets discarded because @a tx_buffer was full */
+  unsigned long tx_dropped;
+
+  /** The number of frames transmitted for this channel */
+  unsigned long tx_frames;
+
+  /** The number of frames received for this channel */
+  unsigned long rx_frames;
+} sBSP430chanmuxChannel;
+
+/** Aggregate statistics for the multiplexer. */
+typedef struct sBSP430chanmuxStatistics {
+  /** Received frames discarded because the CRC did not match */
+  unsigned int rx_crc_errors;
+  /** Received frames discarded because they were malformed or too
+   * long for the receive buffer */
+  unsigned int rx_framing_errors;
+  /** Received frames discarded because they addressed no registered
+   * channel */
+  unsigned int rx_unknown_channel;
+} sBSP430chanmuxStatistics;
+
+/** Add a channel to the multiplexer.
+ *
+ * @param chan the channel to be registered
+ *
+ * @return 0 if the channel was registered, or -1 if its identifier is
+ * zero, its ring capacity is invalid, or its identifier is already in
+ * use */
+int iBSP430chanmuxRegister (sBSP430chanmuxChannel * chan);
+
+/** Remove a channel from the multiplexer.
+ *
+ * Data queued for the channel is discarded.
+ *
+ * @param chan the channel to be removed
+ *
+ * @return 0 if the channel was removed, or -1 if it was not
+ * registered */
+int iBSP430chanmuxUnregister (sBSP430chanmuxChannel * chan);
+
+/** Queue data for transmission on a channel.
+ *
+ * Data that does not fit in the channel transmit ring is discarded
+ * and counted in sBSP430chanmuxChannel::tx_dropped.  Message
+ * boundaries are not preserved: queued data may be split across
+ * frames.
+ *
+ * This may be invoked from interrupt context provided it is the only
+ * producer for @p chan.
+ *
+ * @param chan the channel on which the data is to be sent
+ *
+ * @param data the data to be sent
+ *
+ * @param len the number of octets in @p data
+ *
+ * @return the number of octets queued */
+int iBSP430chanmuxWrite (sBSP430chanmuxChannel * chan,
+                         const uint8_t * data,
+                         size_t len);
+
+/** Frame and transmit queued channel data.
+ *
+ * Each pass over the registered channels emits at most one frame per
+ * channel; passes repeat until all channels are empty.  Frames are
+ * written with cputoctets(), so the console transmit policy
+ * determines whether this waits for the UART.
+ *
+ * @return the number of frames transmitted
+ *
+ * @consoleoutput */
+int iBSP430chanmuxFlush (void);
+
+/** Transmit a frame on a channel immediately.
+ *
+ * The frame bypasses the channel transmit ring, preserving the
+ * message boundary.
+ *
+ * @param id the channel identifier
+ *
+ * @param data the frame payload
+ *
+ * @param len the number of octets in @p data, no larger than
+ * #BSP430_CHANMUX_MAX_PAYLOAD
+ *
+ * @return the number of octets written to the console, or -1 if @p
+ * len is too large
+ *
+ * @consoleoutput */
+int iBSP430chanmuxSendFrame (uint8_t id,
+                             const uint8_t * data,
+                             size_t len);
+
+/** Encode a frame in place.
+ *
+ * This is the framing used by the transmit functions, for callers
+ * that must write the frame themselves: for example to send it along
+ * with other output while interrupts are disabled.  It uses no shared
+ * state.
+ *
+ * @param frame a buffer of at least @p len +
+ * #BSP430_CHANMUX_FRAME_OVERHEAD octets, with the payload stored
+ * beginning at offset #BSP430_CHANMUX_PAYLOAD_OFFSET.  On return it
+ * holds the complete frame including both delimiters.
+ *
+ * @param id the channel identifier
+ *
+ * @param len the number of payload octets, no larger than
+ * #BSP430_CHANMUX_MAX_PAYLOAD
+ *
+ * @return the number of octets in the encoded frame */
+size_t uiBSP430chanmuxEncodeFrame (uint8_t * frame,
+                                   uint8_t id,
+                                   size_t len);
+
+/** Transmit a block of memory in compact binary form.
+ *
+ * This is the binary counterpart of vBSP430consoleDisplayMemory(),
+ * for use when the console is read by a host tool.  The block is sent
+ * on channel @p id as a sequence of frames, each holding the address
+ * of its first octet as four octets in little-endian order followed
+ * by up to #BSP430_CHANMUX_MAX_PAYLOAD-4 octets of data.  The host
+ * utility <tt>maintainer/chanmux-memory</tt> renders the frames as
+ * text or writes them to a file.
+ *
+ * @param id the channel identifier
+ *
+ * @param dp pointer to the start of the memory region
+ *
+ * @param len the number of octets to send
+ *
+ * @param base the address reported for the octet at @p dp
+ *
+ * @return the number of frames transmitted
+ *
+ * @consoleoutput */
+int iBSP430chanmuxSendMemory (uint8_t id,
+                              const uint8_t * dp,
+                              size_t len,
+                              unsigned long base);
+
+/** Separate received frames from console input.
+ *
+ * Pass each character returned by cgetchar() through this function.
+ * Characters that belong to a frame are consumed; when a frame is
+ * complete and valid it is delivered to the addressed channel.
+ *
+ * @param c a character received from the console
+ *
+ * @return @p c if it is console input, or -1 if it was consumed as
+ * part of a frame */
+int iBSP430chanmuxRxFilter (int c);
+
+/** Decode a received frame in place.
+ *
+ * @param frame the COBS-encoded frame excluding its delimiters.  On
+ * success this is overwritten with the channel identifier followed by
+ * the payload.
+ *
+ * @param len the number of octets in @p frame
+ *
+ * @return the number of payload octets, -1 if the frame is malformed,
+ * or -2 if the CRC does not match */
+int iBSP430chanmuxDecodeFrame (uint8_t * frame,
+                               size_t len);
+
+/** Update a CRC-16/CCITT value with one octet.
+ *
+ * @param crc the CRC of the preceding octets, or 0xFFFF initially
+ *
+ * @param octet the octet to be included
+ *
+ * @return the updated CRC */
+static BSP430_CORE_INLINE
+uint16_t
+uiBSP430chanmuxCRCUpdate (uint16_t crc,
+                          uint8_t octet)
+{
+  uint16_t x = (crc >> 8) ^ octet;
+
+  x ^= x >> 4;
+  return (crc << 8) ^ (x << 12) ^ (x << 5) ^ x;
+}
+
+/** Obtain the multiplexer statistics.
+ *
+ * @param sp where the statistics should be stored
+ *
+ * @param reset if nonzero the statistics are cleared after being
+ * read */
+void vBSP430chanmuxStatistics (sBSP430chanmuxStatistics * sp,
+                               int reset);
+
+#endif /* BSP430_UTILITY_CHANMUX_H */
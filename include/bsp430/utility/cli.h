@@ -171,6 +171,30 @@
 #define configBSP430_CLI_COMMAND_COMPLETION_HELPER 0
 #endif /* configBSP430_CLI_COMMAND_COMPLETION_HELPER */
 
+/** Define to a true value to support sorted command indexes.
+ *
+ * iBSP430cliMatchCommand() normally identifies candidate commands by
+ * walking the sBSP430cliCommand::next chain and comparing the input
+ * token against every key.  For applications with many commands at a
+ * single level this linear walk dominates command dispatch and
+ * completion.
+ *
+ * Setting this to a true value enables
+ * vBSP430cliSetCommandIndexes(), through which the application may
+ * register #sBSP430cliCommandIndex structures generated at build
+ * time by the @c maintainer/cli-index script.  When the chain passed
+ * to iBSP430cliMatchCommand() has a registered index the candidates
+ * are located by binary search on the sorted keys; chains without an
+ * index continue to be walked.
+ *
+ * @cppflag
+ * @defaulted
+ * @ingroup grp_utility_cli_hci
+ */
+#ifndef configBSP430_CLI_COMMAND_INDEX
+#define configBSP430_CLI_COMMAND_INDEX 0
+#endif /* configBSP430_CLI_COMMAND_INDEX */
+
 /** Get the next token in the command string.
  *
  * @param commandp pointer to a pointer into an immutable buffer
@@ -555,6 +579,49 @@ int iBSP430cliMatchCommand (const sBSP430cliCommand * cmds,
                             const char ** argstrp,
                             size_t * argstr_lenp);
 
+#if (configBSP430_CLI_COMMAND_INDEX - 0)
+/** A sorted view of a chain of sibling commands.
+ *
+ * Instances are normally generated by the @c maintainer/cli-index
+ * script from the application source that defines the commands, and
+ * registered with vBSP430cliSetCommandIndexes().  The entries in @a
+ * sorted must be exactly the commands reachable from @a head through
+ * sBSP430cliCommand::next, ordered so that successive keys increase
+ * as compared by @c strcmp().
+ *
+ * When an index is used, iBSP430cliMatchCommand() invokes its match
+ * callback on the candidate commands in key order rather than chain
+ * order.
+ *
+ * @dependency #configBSP430_CLI_COMMAND_INDEX
+ * @ingroup grp_utility_cli_hci */
+typedef struct sBSP430cliCommandIndex {
+  /** The first command in the chain described by this index.  This
+   * is the value that will be passed as @p cmds to
+   * iBSP430cliMatchCommand(). */
+  const sBSP430cliCommand * const head;
+
+  /** The commands of the chain, sorted by key */
+  const sBSP430cliCommand * const * const sorted;
+
+  /** The number of entries in @a sorted */
+  unsigned int const count;
+} sBSP430cliCommandIndex;
+
+/** Register indexes for command chains.
+ *
+ * @param indexes an array of index structures, typically the @c
+ * cliCommandIndexes_ table emitted by @c maintainer/cli-index.  A
+ * null pointer removes any previously registered indexes.
+ *
+ * @param count the number of entries in @p indexes
+ *
+ * @dependency #configBSP430_CLI_COMMAND_INDEX
+ * @ingroup grp_utility_cli_hci */
+void vBSP430cliSetCommandIndexes (const sBSP430cliCommandIndex * indexes,
+                                  unsigned int count);
+#endif /* configBSP430_CLI_COMMAND_INDEX */
+
 /** Entrypoint to command execution.
  *
  * @param cmds the first in a sequence of sibling commands that may
@@ -608,14 +675,210 @@ iBSP430cliParseCommand (const sBSP430cliCommand * cmds,
                         iBSP430cliHandlerFunction chain_handler,
                         iBSP430cliHandlerFunction handler);
 
+/** Flag for iBSP430cliExecuteScript() requesting that execution
+ * continue with the next command when a command returns a negative
+ * value.  By default the script is abandoned at the first error.
+ *
+ * @ingroup grp_utility_cli_cli */
+#define BSP430_CLI_SCRIPT_CONTINUE 0x01
+
+/** The longest command that iBSP430cliExecuteScript() will execute.
+ *
+ * Each command of a script is copied to a buffer of this many
+ * characters plus a terminating NUL on the stack.
+ *
+ * @defaulted
+ * @ingroup grp_utility_cli_cli */
+#if defined(BSP430_DOXYGEN) || ! defined(BSP430_CLI_SCRIPT_COMMAND_LENGTH)
+#define BSP430_CLI_SCRIPT_COMMAND_LENGTH 80
+#endif /* BSP430_CLI_SCRIPT_COMMAND_LENGTH */
+
+/** Structure used to observe the commands of a script executed by
+ * iBSP430cliExecuteScript().  It may be embedded in a larger
+ * structure that carries additional state, as with
+ * #sBSP430cliMatchCallback.
+ *
+ * @ingroup grp_utility_cli_cli */
+typedef struct sBSP430cliScriptCallback {
+  /** Optional function invoked immediately before each command is
+   * executed.
+   *
+   * @param self the structure provided to iBSP430cliExecuteScript()
+   *
+   * @param command the command text, not terminated by a NUL
+   *
+   * @param command_len the number of characters in @p command */
+  void (* start) (struct sBSP430cliScriptCallback * self,
+                  const char * command,
+                  size_t command_len);
+
+  /** Optional function invoked immediately after each command is
+   * executed.
+   *
+   * @param self as with @a start
+   *
+   * @param command as with @a start
+   *
+   * @param command_len as with @a start
+   *
+   * @param rv the value returned by command execution */
+  void (* complete) (struct sBSP430cliScriptCallback * self,
+                     const char * command,
+                     size_t command_len,
+                     int rv);
+} sBSP430cliScriptCallback;
+
+/** Execute a sequence of commands held in memory.
+ *
+ * This supports replaying configuration sequences stored in flash or
+ * FRAM, or received as a single buffer, without passing each
+ * character through iBSP430cliConsoleBufferProcessInput().  The
+ * script is not modified.  Each command is copied to a buffer on the
+ * stack and executed as with iBSP430cliExecuteCommand(), so handlers
+ * see the same text whether a command comes from a script or is
+ * entered at the console.  A command longer than
+ * #BSP430_CLI_SCRIPT_COMMAND_LENGTH is not executed and fails with
+ * <c>-#eBSP430_CLI_ERR_Invalid</c>.
+ *
+ * Commands are separated by semicolons or newlines.  A semicolon
+ * within a quoted token does not end a command.  As with
+ * xBSP430cliNextQToken() a quote begins a quoted token only at the
+ * start of a token, and only if the matching quote on the same line
+ * is followed by space or the end of the command; otherwise it is an
+ * ordinary character.  Empty commands are ignored, as is the text
+ * from a @c # that begins a command through the end of its line.
+ * The script ends after @p script_len characters or at a NUL
+ * character, whichever comes first.
+ *
+ * @param cmds as with iBSP430cliExecuteCommand()
+ *
+ * @param param as with iBSP430cliExecuteCommand()
+ *
+ * @param script the text of the commands to be executed
+ *
+ * @param script_len the maximum number of characters in @p script
+ *
+ * @param flags a bit-wise combination of flags such as
+ * #BSP430_CLI_SCRIPT_CONTINUE
+ *
+ * @param callback optional structure through which the caller is
+ * notified of each command.
+ *
+ * @return the number of commands executed if none returned a negative
+ * value, otherwise the negative value returned by the first command
+ * that failed.
+ *
+ * @ingroup grp_utility_cli_cli */
+int iBSP430cliExecuteScript (const sBSP430cliCommand * cmds,
+                             void * param,
+                             const char * script,
+                             size_t script_len,
+                             unsigned int flags,
+                             sBSP430cliScriptCallback * callback);
+
+/** Convert text to an unsigned 32-bit integer.
+ *
+ * This is the parser shared by the iBSP430cliStoreExtracted family
+ * and the iBSP430cliHandlerStore handlers.  It avoids @c strtoul(),
+ * which is large and on 16-bit cores slow, and detects values that
+ * do not fit in the destination.  The accepted syntax is:
+ *
+ * @li An optional sign.  A minus sign is accepted only where the
+ * destination is signed or the value is zero.
+ * @li A prefix selecting the radix: @c 0x or @c 0X for hexadecimal,
+ * @c 0b or @c 0B for binary, a leading @c 0 for octal, otherwise
+ * decimal.
+ * @li One or more digits.  A decimal value may include a decimal
+ * point, provided any digits that follow it are consumed by the
+ * scaling described below or are zero.
+ * @li An optional SI suffix: @c k multiplies the value by 1000 and @c
+ * M by 1000000.
+ *
+ * For example @c 1.5k is 1500, @c 0x10k is 16000, and @c 2.5 is
+ * rejected as an integer but accepted by iBSP430cliParseFixed() with
+ * one or more fractional digits.
+ *
+ * No multiplication or division is performed at runtime, so no
+ * support routines are linked on cores without a hardware
+ * multiplier.
+ *
+ * @param text the text to be converted.  It need not be
+ * NUL-terminated; every one of the @p len characters must be part of
+ * the number.
+ *
+ * @param len the number of characters in @p text
+ *
+ * @param destp where the converted value is stored on success
+ *
+ * @return 0 on success, <c>-#eBSP430_CLI_ERR_Invalid</c> if @p text
+ * is not a number, or <c>-#eBSP430_CLI_ERR_Range</c> if the number
+ * does not fit in the destination.
+ *
+ * @ingroup grp_utility_cli_hci */
+int iBSP430cliParseUL (const char * text,
+                       size_t len,
+                       unsigned long * destp);
+
+/** Convert text to a signed 32-bit integer.
+ *
+ * As with iBSP430cliParseUL() but for signed values.
+ *
+ * @ingroup grp_utility_cli_hci */
+int iBSP430cliParseL (const char * text,
+                      size_t len,
+                      long * destp);
+
+/** Convert text to an unsigned 16-bit integer.
+ *
+ * As with iBSP430cliParseUL() but for @c unsigned @c int values.
+ *
+ * @ingroup grp_utility_cli_hci */
+int iBSP430cliParseUI (const char * text,
+                       size_t len,
+                       unsigned int * destp);
+
+/** Convert text to a signed 16-bit integer.
+ *
+ * As with iBSP430cliParseUL() but for @c int values.
+ *
+ * @ingroup grp_utility_cli_hci */
+int iBSP430cliParseI (const char * text,
+                      size_t len,
+                      int * destp);
+
+/** Convert text to a fixed-point value.
+ *
+ * As with iBSP430cliParseL(), except that the result is scaled by
+ * 10<sup>@p frac_digits</sup>.  For example with @p frac_digits 3
+ * the text @c 1.25 produces 1250 and @c -2m is invalid, while @c
+ * 0.5k produces 500000.  Digits beyond the available precision are
+ * accepted only if they are zero, so a value is never silently
+ * truncated.
+ *
+ * @param text as with iBSP430cliParseUL()
+ *
+ * @param len as with iBSP430cliParseUL()
+ *
+ * @param frac_digits the number of decimal digits following the
+ * implied decimal point of the result
+ *
+ * @param destp where the scaled value is stored on success
+ *
+ * @return as with iBSP430cliParseUL()
+ *
+ * @ingroup grp_utility_cli_hci */
+int iBSP430cliParseFixed (const char * text,
+                          size_t len,
+                          unsigned int frac_digits,
+                          long * destp);
+
 /** Utility to extract and store a signed 16-bit integer expressed in
  * text.
  *
  * @param argstrp pointer to a pointer to the text representation of a
- * signed 16-bit integer, normally decimal but optionally in
- * hexadecimal (with leading @c 0x) or octal (with leading @c 0).  On
- * success @p *argstrp is updated to point past the consumed integer
- * token.
+ * signed 16-bit integer in the syntax accepted by
+ * iBSP430cliParseUL().  On success @p *argstrp is updated to
+ * point past the consumed integer token.
  *
  * @param argstr_lenp pointer to the length of the @p *argstrp text.
  * On success the @p *argstr_lenp is updated to hold
@@ -636,11 +899,10 @@ int iBSP430cliStoreExtractedI (const char ** argstrp,
 /** Utility to extract and store an unsigned 16-bit integer expressed in
  * text.
  *
- * @param argstrp pointer to a pointer to the text representation of a
- * signed 16-bit integer, normally decimal but optionally in
- * hexadecimal (with leading @c 0x) or octal (with leading @c 0).  On
- * success @p *argstrp is updated to point past the consumed integer
- * token.
+ * @param argstrp pointer to a pointer to the text representation of an
+ * unsigned 16-bit integer in the syntax accepted by
+ * iBSP430cliParseUL().  On success @p *argstrp is updated to
+ * point past the consumed integer token.
  *
  * @param argstr_lenp pointer to the length of the @p *argstrp text.
  * On success the @p *argstr_lenp is updated to hold
@@ -662,10 +924,9 @@ int iBSP430cliStoreExtractedUI (const char ** argstrp,
  * text.
  *
  * @param argstrp pointer to a pointer to the text representation of a
- * signed 32-bit integer, normally decimal but optionally in
- * hexadecimal (with leading @c 0x) or octal (with leading @c 0).  On
- * success @p *argstrp is updated to point past the consumed integer
- * token.
+ * signed 32-bit integer in the syntax accepted by
+ * iBSP430cliParseUL().  On success @p *argstrp is updated to
+ * point past the consumed integer token.
  *
  * @param argstr_lenp pointer to the length of the @p *argstrp text.
  * On success the @p *argstr_lenp is updated to hold
@@ -687,10 +948,9 @@ int iBSP430cliStoreExtractedL (const char ** argstrp,
  * in text.
  *
  * @param argstrp pointer to a pointer to the text representation of an
- * unsigned 32-bit integer, normally decimal but optionally in
- * hexadecimal (with leading @c 0x) or octal (with leading @c 0).  On
- * success @p *argstrp is updated to point past the consumed integer
- * token.
+ * unsigned 32-bit integer in the syntax accepted by
+ * iBSP430cliParseUL().  On success @p *argstrp is updated to
+ * point past the consumed integer token.
  *
  * @param argstr_lenp pointer to the length of the @p *argstrp text.
  * On success the @p *argstr_lenp is updated to hold
@@ -736,9 +996,8 @@ int iBSP430cliHandlerSimple (sBSP430cliCommandLink * chain,
  *
  * @param param unused
  *
- * @param argstr text representation of a signed 16-bit integer,
- * normally decimal but optionally in hexadecimal (with leading @c 0x)
- * or octal (with leading @c 0).
+ * @param argstr text representation of a signed 16-bit integer
+ * in the syntax accepted by iBSP430cliParseUL().
  *
  * @param argstr_len length of the @p argstr text
  *
@@ -758,9 +1017,8 @@ int iBSP430cliHandlerStoreI (struct sBSP430cliCommandLink * chain,
  *
  * @param param unused
  *
- * @param argstr text representation of an unsigned 16-bit integer,
- * normally decimal but optionally in hexadecimal (with leading @c 0x)
- * or octal (with leading @c 0).
+ * @param argstr text representation of an unsigned 16-bit integer
+ * in the syntax accepted by iBSP430cliParseUL().
  *
  * @param argstr_len length of the @p argstr text
  *
@@ -780,9 +1038,8 @@ int iBSP430cliHandlerStoreUI (struct sBSP430cliCommandLink * chain,
  *
  * @param param unused
  *
- * @param argstr text representation of a signed 32-bit integer,
- * normally decimal but optionally in hexadecimal (with leading @c 0x)
- * or octal (with leading @c 0).
+ * @param argstr text representation of a signed 32-bit integer
+ * in the syntax accepted by iBSP430cliParseUL().
  *
  * @param argstr_len length of the @p argstr text
  *
@@ -802,9 +1059,8 @@ int iBSP430cliHandlerStoreL (struct sBSP430cliCommandLink * chain,
  *
  * @param param unused
  *
- * @param argstr text representation of an unsigned 32-bit integer,
- * normally decimal but optionally in hexadecimal (with leading @c 0x)
- * or octal (with leading @c 0).
+ * @param argstr text representation of an unsigned 32-bit integer
+ * in the syntax accepted by iBSP430cliParseUL().
  *
  * @param argstr_len length of the @p argstr text
  *
@@ -844,6 +1100,10 @@ enum eBSP430cliErrorType {
    * processing command. */
   eBSP430_CLI_ERR_Invalid,
 
+  /** Returned when a numeric token in the command string is valid
+   * but does not fit in the destination. */
+  eBSP430_CLI_ERR_Range,
+
   /** A sentinal value strictly greater than any valid enumeration
    * tag */
   eBSP430_CLIERRORTYPES,
@@ -947,6 +1207,39 @@ void vBSP430cliConsoleDisplayChain (struct sBSP430cliCommandLink * chain,
 void vBSP430cliConsoleDisplayHelp (const sBSP430cliCommand * cmd);
 #endif /* configBSP430_CONSOLE */
 
+/** Execute a script with progress displayed on the console.
+ *
+ * This invokes iBSP430cliExecuteScript() with a callback that
+ * displays each command before it is executed, and afterwards the
+ * value it returned.  When #configBSP430_UPTIME is enabled the time
+ * taken by the command is also displayed, scaled by
+ * uiBSP430uptimeScaleForDisplay().
+ *
+ * @consoleoutput
+ *
+ * @param cmds as with iBSP430cliExecuteScript()
+ *
+ * @param param as with iBSP430cliExecuteScript()
+ *
+ * @param script as with iBSP430cliExecuteScript()
+ *
+ * @param script_len as with iBSP430cliExecuteScript()
+ *
+ * @param flags as with iBSP430cliExecuteScript()
+ *
+ * @return as with iBSP430cliExecuteScript()
+ *
+ * @dependency #BSP430_CONSOLE
+ *
+ * @ingroup grp_utility_cli_cli */
+#if defined(BSP430_DOXYGEN) || (BSP430_CONSOLE - 0)
+int iBSP430cliConsoleExecuteScript (const sBSP430cliCommand * cmds,
+                                    void * param,
+                                    const char * script,
+                                    size_t script_len,
+                                    unsigned int flags);
+#endif /* configBSP430_CONSOLE */
+
 /** Reverse a command chain.
  *
  * The chain constructed during command parsing leads from the deepest
@@ -978,6 +1271,49 @@ sBSP430cliCommandLink * xBSP430cliReverseChain (sBSP430cliCommandLink * chain);
 #define BSP430_CLI_CONSOLE_BUFFER_SIZE 0
 #endif /* BSP430_CLI_CONSOLE_BUFFER_SIZE */
 
+/** Specify the size of an arena holding previously entered commands.
+ *
+ * A non-zero setting for this parameter allocates an arena of this
+ * many octets in which iBSP430cliConsoleBufferProcessInput() records
+ * each completed command.  Each entry occupies one octet for its
+ * length plus its text, so the memory used does not depend on the
+ * number of commands.  When a new command does not fit the oldest
+ * entries are discarded, and a command that repeats an earlier entry
+ * replaces it rather than being stored twice.  Commands longer than
+ * 255 characters are not recorded.
+ *
+ * Recorded commands are recalled with the up and down arrow keys,
+ * which are recognized by iBSP430cliConsoleBufferConsumeEscape(), or
+ * by incremental search as described at
+ * iBSP430cliConsoleBufferProcessInput().
+ *
+ * @see #BSP430_CLI_CONSOLE_HISTORY_SECTION
+ *
+ * @defaulted
+ * @dependency #BSP430_CLI_CONSOLE_BUFFER_SIZE
+ * @ingroup grp_utility_cli_cli
+ */
+#if defined(BSP430_DOXYGEN) || ! defined(BSP430_CLI_CONSOLE_HISTORY_SIZE)
+#define BSP430_CLI_CONSOLE_HISTORY_SIZE 0
+#endif /* BSP430_CLI_CONSOLE_HISTORY_SIZE */
+
+/** Attributes applied to the command history arena.
+ *
+ * By default the arena is placed in the @c .noinit section, so
+ * history survives a reset that does not remove power.  On FRAM
+ * devices a section that is located in FRAM and not initialized at
+ * startup preserves history across power cycles.  The arena carries
+ * a signature and its entries are validated on first use, so
+ * uninitialized or corrupted content is discarded.
+ *
+ * @defaulted
+ * @dependency #BSP430_CLI_CONSOLE_HISTORY_SIZE
+ * @ingroup grp_utility_cli_cli
+ */
+#if defined(BSP430_DOXYGEN) || ! defined(BSP430_CLI_CONSOLE_HISTORY_SECTION)
+#define BSP430_CLI_CONSOLE_HISTORY_SECTION __attribute__((__section__(".noinit")))
+#endif /* BSP430_CLI_CONSOLE_HISTORY_SECTION */
+
 /** Enumeration of bit values returned from
  * iBSP430cliConsoleBufferProcessInput().
  *
@@ -1188,12 +1524,25 @@ int iBSP430cliConsoleBufferExtend (const char * text, size_t len);
  * Enter (CR)     | Return #eBSP430cliConsole_READY
  * C-u (NAK)      | Kill command (resets buffer)
  * C-w (ETB)      | Kill previous word (erases back to space)
+ * C-r (DC2)      | Incremental history search (<b>if enabled</b>)
  * Escape (ESC)   | Return #eBSP430cliConsole_PROCESS_ESCAPE
  * Tab (HT)       | Auto-complete based on legal commands (<b>if enabled</b>)
  *
  * Note that auto-completion is enabled by
  * #configBSP430_CLI_COMMAND_COMPLETION.
  *
+ * When #BSP430_CLI_CONSOLE_HISTORY_SIZE is nonzero each command is
+ * recorded when carriage return is pressed, and C-r begins an
+ * incremental search of the history.  While searching, printable
+ * characters and backspace edit the search text and the most recent
+ * command containing it is displayed; C-r again moves to the next
+ * older match.  C-g abandons the search leaving the buffer as it
+ * was.  Any other key places the displayed command in the buffer and
+ * is then processed normally, so carriage return executes it.  Search
+ * and recall erase the current line and return
+ * #eBSP430cliConsole_REPAINT so the application redraws the prompt
+ * and buffer.
+ *
  * When carriage return is pressed, a complete command is recognized,
  * and the function returns even if there is additional data to be
  * consumed.
@@ -1210,6 +1559,34 @@ int iBSP430cliConsoleBufferExtend (const char * text, size_t len);
 int iBSP430cliConsoleBufferProcessInput (void);
 #endif /* BSP430_CLI_CONSOLE_BUFFER_SIZE */
 
+/** Get a command from the console history.
+ *
+ * @param n the position of the command, with zero being the most
+ * recently entered command
+ *
+ * @param lenp where the length of the command is stored.  The
+ * command text is not NUL-terminated.
+ *
+ * @return a pointer to the text of the command, or a null pointer if
+ * the history holds @p n or fewer commands
+ *
+ * @dependency #BSP430_CLI_CONSOLE_HISTORY_SIZE
+ * @ingroup grp_utility_cli_cli
+ */
+#if defined(BSP430_DOXYGEN) || ((0 < BSP430_CLI_CONSOLE_BUFFER_SIZE) && (0 < BSP430_CLI_CONSOLE_HISTORY_SIZE))
+const char * xBSP430cliConsoleHistoryEntry (unsigned int n,
+                                            size_t * lenp);
+#endif /* BSP430_CLI_CONSOLE_HISTORY_SIZE */
+
+/** Discard all commands in the console history.
+ *
+ * @dependency #BSP430_CLI_CONSOLE_HISTORY_SIZE
+ * @ingroup grp_utility_cli_cli
+ */
+#if defined(BSP430_DOXYGEN) || ((0 < BSP430_CLI_CONSOLE_BUFFER_SIZE) && (0 < BSP430_CLI_CONSOLE_HISTORY_SIZE))
+void vBSP430cliConsoleHistoryClear (void);
+#endif /* BSP430_CLI_CONSOLE_HISTORY_SIZE */
+
 /** Consume any pending escape sequences recorded in @p flags.
  *
  * This utility function allows applications that perform console
@@ -1222,7 +1599,11 @@ int iBSP430cliConsoleBufferProcessInput (void);
  * change or delay.  Otherwise this function will block until the
  * remainder of the escape sequence has been entered and consumed.
  *
- * The escape sequence is not returned to the caller.
+ * The escape sequence is not returned to the caller, except that when
+ * #BSP430_CLI_CONSOLE_HISTORY_SIZE is nonzero the up and down arrow
+ * sequences replace the console buffer with the previous or next
+ * recorded command and add #eBSP430cliConsole_REPAINT to the result.
+ * Moving down past the most recent command empties the buffer.
  *
  * @param flags A value returned by
  * iBSP430cliConsoleBufferProcessInput_ni()
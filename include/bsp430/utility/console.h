@@ -62,16 +62,22 @@
  *
  * Core routines natively supported are cputchar(), cputs(), and
  * cgetchar().  Extensions include cputchars(), cputtext(), and
- * cpeekchar().
+ * cpeekchar().  iBSP430consoleWriteDescriptors() transmits blocks of
+ * data by reference, without copying them into the transmit buffer.
  *
  * With library support through #BSP430_CONSOLE_USE_EMBTEXTF or <a
  * href="https://sourceforge.net/projects/mspgcc/files/msp430-libc/">msp430-libc</a>
  * in the MSPGCC toolchain full support for formatted output via
  * cprintf() and vcprintf() is possible.
  *
+ * Without library support #configBSP430_CONSOLE_XTOA_PRINTF provides
+ * a compact implementation of the common integer and string
+ * conversions; it may also be selected in preference to the library.
+ *
  * In addition optimized routines are provided to convert integers in
  * standard bases with minimal space overhead (cputi(), cputu(),
- * cputl(), cputul()).  The integer routines are more cumbersome but
+ * cputl(), cputul()).  These use the division-free conversions in
+ * bsp430/utility/xtoa.h.  The integer routines are more cumbersome but
  * necessary when the platform cannot accommodate the stack overhead
  * of cprintf() (on the order of 100 bytes if 64-bit integer support
  * is included).
@@ -79,7 +85,9 @@
  * Compile-time options #BSP430_CONSOLE_RX_BUFFER_SIZE and
  * #BSP430_CONSOLE_TX_BUFFER_SIZE enable interrupt-driven input and
  * output, allowing the application to make progress while output is
- * produced and input buffered using interrupts.
+ * produced and input buffered using interrupts.  Where a DMA
+ * peripheral is available #configBSP430_CONSOLE_TX_DMA reduces the
+ * cost of output to one interrupt per block of buffered text.
  *
  * @homepage http://github.com/pabigot/bsp430
  * @copyright Copyright 2012-2014, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
@@ -155,8 +163,8 @@
 #endif /* BSP430_CONSOLE_BAUD_RATE */
 
 /** Define this to the size of a buffer to be used for interrupt-driven
- * console input.  The value must not exceed 254, and buffer
- * management is most efficient if the value is a power of 2.
+ * console input.  The value must be a power of 2 no larger than
+ * #BSP430_RING_MAX_CAPACITY; see bsp430/utility/ring.h.
  *
  * If this has a value of zero, character input is not interrupt
  * driven.  cgetchar() will return the most recently received
@@ -167,9 +175,82 @@
 #define BSP430_CONSOLE_RX_BUFFER_SIZE 0
 #endif /* BSP430_CONSOLE_RX_BUFFER_SIZE */
 
+/** Define to a true value to assemble console input into lines within
+ * the receive interrupt handler.
+ *
+ * Normally each received character is made available to cgetchar()
+ * immediately, and the application is woken from low power mode once
+ * per character.  In line mode the interrupt handler holds characters
+ * back until a line is complete, so an application (such as the @ref
+ * grp_utility_cli "command line interface") is woken once per line:
+ *
+ * @li Carriage return or line feed (with a line feed immediately
+ * following a carriage return ignored) ends the line.  A carriage
+ * return is stored in its place.
+ * @li Backspace or delete removes the last character of the line being
+ * assembled.  If there is no such character the backspace is passed
+ * through, so the application can edit what it has already received.
+ * @li C-u (NAK) removes the line being assembled and is passed
+ * through.  C-w (ETB) removes the last word of the line being
+ * assembled; it is passed through instead if there is no such text.
+ * @li An escape sequence (ESC followed by one character, or ESC-[
+ * followed by parameters through a final character in the range 64
+ * to 126) is passed through unedited.
+ * @li Any other control character is passed through, and ends the
+ * assembly if it is in #BSP430_CONSOLE_RX_LINE_WAKE_MASK.  For ESC
+ * this happens when the sequence is complete.
+ *
+ * Wakeup and the callback registered with
+ * vBSP430consoleSetRxCallback_ni() occur only when assembly ends.
+ * If the buffer fills, characters that do not end assembly are
+ * discarded.  #BSP430_CONSOLE_RX_BUFFER_SIZE should therefore be at
+ * least as long as the longest expected line.
+ *
+ * Characters added to or removed from the line are echoed to the
+ * console if #configBSP430_CONSOLE_RX_LINE_ECHO is true.
+ *
+ * @cppflag
+ * @defaulted
+ * @dependency #BSP430_CONSOLE_RX_BUFFER_SIZE */
+#ifndef configBSP430_CONSOLE_RX_LINE_MODE
+#define configBSP430_CONSOLE_RX_LINE_MODE 0
+#endif /* configBSP430_CONSOLE_RX_LINE_MODE */
+
+/** A bit mask of control characters that end line assembly under
+ * #configBSP430_CONSOLE_RX_LINE_MODE.  Bit @em n corresponds to the
+ * character with value @em n.
+ *
+ * The default includes ETX (C-c), HT (Tab, for command completion),
+ * FF (C-l, for repaint), and ESC.
+ *
+ * @defaulted
+ * @dependency #configBSP430_CONSOLE_RX_LINE_MODE */
+#ifndef BSP430_CONSOLE_RX_LINE_WAKE_MASK
+#define BSP430_CONSOLE_RX_LINE_WAKE_MASK ((1UL << 0x03) | (1UL << 0x09) | (1UL << 0x0C) | (1UL << 0x1B))
+#endif /* BSP430_CONSOLE_RX_LINE_WAKE_MASK */
+
+/** Define to a true value to have the receive interrupt handler echo
+ * line edits under #configBSP430_CONSOLE_RX_LINE_MODE.
+ *
+ * Printable characters added to the line are echoed, and are not if
+ * they are discarded because the buffer is full.  Each character
+ * removed by backspace, C-u, or C-w is erased by
+ * backspace-space-backspace, and the end of a line is echoed as
+ * carriage return and line feed.  Echo through the
+ * transmission buffer is dropped if the buffer is full; without a
+ * transmission buffer the handler waits for the UART.
+ *
+ * @cppflag
+ * @defaulted
+ * @dependency #configBSP430_CONSOLE_RX_LINE_MODE */
+#ifndef configBSP430_CONSOLE_RX_LINE_ECHO
+#define configBSP430_CONSOLE_RX_LINE_ECHO 1
+#endif /* configBSP430_CONSOLE_RX_LINE_ECHO */
+
 /** Define this to the size of a buffer to be used for interrupt-driven
- * console output.  The value must not exceed 254, and buffer
- * management is most efficient if the value is a power of 2.
+ * console output.  The value must be a power of 2 no larger than
+ * #BSP430_RING_MAX_CAPACITY; see bsp430/utility/ring.h.  All octets
+ * of the buffer may hold pending output.
  *
  * If this has a value of zero, character output is not interrupt
  * driven.  cputchar() will block until the UART is ready to accept
@@ -184,6 +265,50 @@
 #define BSP430_CONSOLE_TX_BUFFER_SIZE 0
 #endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
 
+/** Define to a true value to drain the console transmit buffer using
+ * a DMA channel instead of the serial transmit interrupt.
+ *
+ * Normally interrupt-driven console output takes one UART transmit
+ * interrupt per character.  When this option is enabled, each
+ * contiguous span of queued data in the transmit buffer is handed to
+ * DMA channel #BSP430_CONSOLE_TX_DMA_CHANNEL, which copies it to the
+ * UART transmit register as the UART becomes ready.  Only one
+ * interrupt occurs per span, when the DMA transfer completes.  A
+ * span ends at the most recently queued character or at the end of
+ * the buffer storage, whichever comes first.
+ *
+ * The application must provide #BSP430_CONSOLE_TX_DMA_TSEL, and must
+ * not otherwise use the selected DMA channel.  The serial transmit
+ * callback chain is left empty in this mode.
+ *
+ * @cppflag
+ * @defaulted
+ * @dependency #BSP430_CONSOLE_TX_BUFFER_SIZE, #configBSP430_HAL_DMA */
+#ifndef configBSP430_CONSOLE_TX_DMA
+#define configBSP430_CONSOLE_TX_DMA 0
+#endif /* configBSP430_CONSOLE_TX_DMA */
+
+/** The DMA channel used when #configBSP430_CONSOLE_TX_DMA is true.
+ *
+ * @defaulted
+ * @dependency #configBSP430_CONSOLE_TX_DMA */
+#ifndef BSP430_CONSOLE_TX_DMA_CHANNEL
+#define BSP430_CONSOLE_TX_DMA_CHANNEL 0
+#endif /* BSP430_CONSOLE_TX_DMA_CHANNEL */
+
+/** The DMA trigger select value corresponding to the transmit
+ * interrupt flag of the console UART, e.g. 21 for UCA1TXIFG on the
+ * MSP430F5438A or 4 for UCA0TXIFG on the MSP430FG4618.  The value is
+ * MCU-specific and is documented in the device data sheet.
+ *
+ * There is no default; this must be defined in the application
+ * configuration when #configBSP430_CONSOLE_TX_DMA is true.
+ *
+ * @dependency #configBSP430_CONSOLE_TX_DMA */
+#if defined(BSP430_DOXYGEN)
+#define BSP430_CONSOLE_TX_DMA_TSEL application-specific
+#endif /* BSP430_DOXYGEN */
+
 /** Define to indicate build infrastructure support for embtextf
  *
  * This flag should be defined to a true value by the build
@@ -201,6 +326,20 @@
 #define BSP430_CONSOLE_USE_EMBTEXTF 0
 #endif /* BSP430_CONSOLE_USE_EMBTEXTF */
 
+/** Define to a true value to implement cprintf() and vcprintf() with
+ * iBSP430xtoaVuprintf() rather than a library formatter.
+ *
+ * The formatter supports the integer, character, and string
+ * conversions, converting integers without division.  It does not
+ * support floating point or 64-bit values.  It is available
+ * regardless of toolchain library.
+ *
+ * @cppflag
+ * @defaulted */
+#ifndef configBSP430_CONSOLE_XTOA_PRINTF
+#define configBSP430_CONSOLE_XTOA_PRINTF 0
+#endif /* configBSP430_CONSOLE_XTOA_PRINTF */
+
 /** Return a character that was input to the console.
  *
  * @return the next character that was input to the console, or -1 if
@@ -264,8 +403,59 @@ int cpeekchar (void);
  */
 void vBSP430consoleSetRxCallback_ni (iBSP430consoleRxCallback_ni cb);
 
+/** Obtain direct access to received console data.
+ *
+ * This allows received data to be processed in blocks rather than by
+ * individual calls to cgetchar().  The data remains in the receive
+ * buffer until released with vBSP430consoleRxConsume_ni().
+ *
+ * @param datap where a pointer to the oldest unread character is
+ * stored
+ *
+ * @return the number of unread characters that are contiguous at @p
+ * *datap.  Additional characters may be available after those are
+ * consumed.
+ *
+ * @dependency #BSP430_CONSOLE_RX_BUFFER_SIZE */
+int iBSP430consoleRxContiguous_ni (const uint8_t ** datap);
+
+/** Release characters obtained through iBSP430consoleRxContiguous_ni().
+ *
+ * @param len the number of characters to release, which must not
+ * exceed the value returned by iBSP430consoleRxContiguous_ni() within
+ * the same interrupt-disabled region.
+ *
+ * @dependency #BSP430_CONSOLE_RX_BUFFER_SIZE */
+void vBSP430consoleRxConsume_ni (int len);
+
 #endif /* BSP430_CONSOLE_RX_BUFFER_SIZE */
 
+/** Statistics on use of the console receive buffer. */
+typedef struct sBSP430consoleRxStatistics {
+  /** Number of octets received from the UART. */
+  unsigned long received;
+
+  /** Number of octets lost because the buffer was full.  Without
+   * #configBSP430_CONSOLE_RX_LINE_MODE the oldest octet is discarded;
+   * with it the newest. */
+  unsigned long overruns;
+
+  /** The largest number of octets held in the buffer. */
+  unsigned int high_water;
+} sBSP430consoleRxStatistics;
+
+/** Retrieve statistics on use of the console receive buffer.
+ *
+ * @param sp where the statistics should be stored
+ *
+ * @param reset nonzero if the statistics should be cleared after
+ * being retrieved
+ *
+ * @return 0 if the statistics were retrieved, or -1 if the
+ * application was not configured with interrupt-driven reception. */
+int iBSP430consoleRxStatistics_ni (sBSP430consoleRxStatistics * sp,
+                                   int reset);
+
 /** If defined to a true value, the individual character display
  * function used internally to the console module will be made public
  * with the name @c putchar so that it will be used by @c printf(3)
@@ -356,6 +546,129 @@ int cputtext (const char * s);
  * @consoleoutput */
 int cputchars (const char * cp, size_t len);
 
+/** Like cputchars() but for binary data.
+ *
+ * The octets are queued exactly as provided:
+ * #configBSP430_CONSOLE_USE_ONLCR is not applied.
+ *
+ * @param dp first of a series of octets to be emitted to the console
+ *
+ * @param len number of octets to emit
+ *
+ * @return the number of octets written
+ *
+ * @consoleoutput */
+int cputoctets (const uint8_t * dp, size_t len);
+
+/* Forward declaration */
+struct sBSP430consoleTxDescriptor;
+
+/** Callback invoked when the data referenced by a transmit descriptor
+ * has been handed to the UART.
+ *
+ * The callback is invoked from an interrupt context, and is the
+ * point at which the descriptor and the memory it references may be
+ * reused.
+ *
+ * @param dp the descriptor that has been completed
+ *
+ * @return As with iBSP430halISRCallbackVoid_ni(). */
+typedef int (* iBSP430consoleTxDescriptorCallback_ni) (struct sBSP430consoleTxDescriptor * dp);
+
+/** A reference to a block of data to be transmitted on the console
+ * without being copied into the transmit buffer.
+ *
+ * The application provides #data, #len, and optionally #callback_ni.
+ * The remaining fields are reserved to the console infrastructure.
+ *
+ * @see iBSP430consoleWriteDescriptors() */
+typedef struct sBSP430consoleTxDescriptor {
+  /** The first octet to be transmitted.  The data may be in RAM or
+   * in flash, and must remain unchanged until the descriptor has
+   * completed. */
+  const uint8_t * data;
+
+  /** The number of octets to be transmitted */
+  size_t len;
+
+  /** An optional callback invoked when the descriptor completes.  If
+   * this is null the infrastructure behaves as though the callback
+   * returned #BSP430_HAL_ISR_CALLBACK_EXIT_LPM. */
+  iBSP430consoleTxDescriptorCallback_ni callback_ni;
+
+  /** @cond DOXYGEN_EXCLUDE */
+  /* Link within the console queue of pending descriptors */
+  struct sBSP430consoleTxDescriptor * next_;
+
+  /* Transmit buffer ring position at which the descriptor data is to
+   * be interleaved with other console output */
+  uint16_t mark_;
+
+  /* Nonzero while the descriptor is queued */
+  volatile unsigned char busy_;
+  /** @endcond */
+} sBSP430consoleTxDescriptor;
+
+/** Queue a sequence of data blocks for transmission on the console
+ * without copying.
+ *
+ * The blocks referenced by @p dps are transmitted in order, after any
+ * console output that was queued prior to the call and before any
+ * output queued after the call.  When interrupt-driven transmission
+ * is active the data is read directly by the transmit interrupt (or
+ * by DMA, if #configBSP430_CONSOLE_TX_DMA is enabled), so this is
+ * the cheapest way to emit large constant text such as banners.
+ *
+ * The data is emitted as-is: #configBSP430_CONSOLE_USE_ONLCR is not
+ * applied.
+ *
+ * If interrupt-driven transmission is not active the data is written
+ * directly to the UART and each completion callback is invoked before
+ * this function returns.
+ *
+ * @param dps pointer to an array of descriptors.  Each descriptor
+ * must not be queued already, and must not be modified until its
+ * completion callback is invoked or iBSP430consoleTxDescriptorWait_ni()
+ * returns.
+ *
+ * @param count the number of descriptors in @p dps
+ *
+ * @return the total number of octets queued for transmission, or -1
+ * if the console is not available.
+ *
+ * @consoleoutput */
+int iBSP430consoleWriteDescriptors (sBSP430consoleTxDescriptor * dps,
+                                    unsigned int count);
+
+/** Determine whether a transmit descriptor is still in use by the
+ * console.
+ *
+ * @param dp a descriptor previously passed to
+ * iBSP430consoleWriteDescriptors()
+ *
+ * @return nonzero if the data referenced by @p dp has not yet been
+ * completely transmitted. */
+static BSP430_CORE_INLINE
+int iBSP430consoleTxDescriptorBusy (const sBSP430consoleTxDescriptor * dp)
+{
+  return dp->busy_;
+}
+
+/** Block until a transmit descriptor has completed.
+ *
+ * This suspends the caller in LPM0 until the console has finished
+ * with @p dp.  The wakeup relies on the descriptor completion
+ * returning #BSP430_HAL_ISR_CALLBACK_EXIT_LPM, which is the default
+ * when @p dp has no callback.
+ *
+ * @param dp a descriptor previously passed to
+ * iBSP430consoleWriteDescriptors()
+ *
+ * @return Zero if the descriptor had completed on entry; a positive
+ * value if it was necessary to suspend (enabling interrupts) to wait
+ * for completion. */
+int iBSP430consoleTxDescriptorWait_ni (const sBSP430consoleTxDescriptor * dp);
+
 #if (defined(BSP430_DOXYGEN)                            \
      || (BSP430_CONSOLE_USE_EMBTEXTF - 0)               \
      || (BSP430_CORE_TOOLCHAIN_LIBC_MSP430_LIBC - 0)    \
@@ -376,7 +689,7 @@ int cputchars (const char * cp, size_t len);
  * if it is disabled; a negative error code if an error is
  * encountered
  *
- * @dependency #BSP430_CONSOLE, #BSP430_CONSOLE_USE_EMBTEXTF, libc
+ * @dependency #BSP430_CONSOLE, #configBSP430_CONSOLE_XTOA_PRINTF or #BSP430_CONSOLE_USE_EMBTEXTF or libc
  *
  * @consoleoutput */
 int cprintf (const char * format, ...)
@@ -391,67 +704,67 @@ __attribute__((__format__(printf, 1, 2)))
  * @param ap A stdarg reference to variable arguments to a calling function.
  * @return as with cprintf().
  *
- * @dependency #BSP430_CONSOLE, #BSP430_CONSOLE_USE_EMBTEXTF
+ * @dependency #BSP430_CONSOLE, #configBSP430_CONSOLE_XTOA_PRINTF or #BSP430_CONSOLE_USE_EMBTEXTF or libc
  *
  * @consoleoutput */
 int vcprintf (const char * format, va_list ap);
 
-/** Format an int using itoa and emit it to the console.
+/** Format an integer using xBSP430xtoaInt() and emit it to the console.
  *
  * @param n the integer value to be formatted
  * @param radix the radix to use when formatting
  *
- * @warning The implementation assumes that @p radix is at least 10.
+ * @warning The implementation assumes that @p radix is at least 8.
  * Passing a smaller radix will likely result in stack corruption.
  *
  * @return the number of characters emitted
  *
- * @dependency #BSP430_CONSOLE, #BSP430_CONSOLE_USE_EMBTEXTF */
+ * @dependency #BSP430_CONSOLE */
 int cputi (int n, int radix);
 
-/** Format an int using utoa and emit it to the console.
+/** Format an integer using xBSP430xtoaUInt() and emit it to the console.
  *
  * @consoleoutput
  *
  * @param n the integer value to be formatted
  * @param radix the radix to use when formatting
  *
- * @warning The implementation assumes that the radix is at least 10.
+ * @warning The implementation assumes that the radix is at least 8.
  * Passing a smaller radix will likely result in stack corruption.
  *
  * @return the number of characters emitted
  *
- * @dependency #BSP430_CONSOLE, #BSP430_CONSOLE_USE_EMBTEXTF
+ * @dependency #BSP430_CONSOLE
  *
  * @consoleoutput */
 int cputu (unsigned int n, int radix);
 
-/** Format an int using ltoa and emit it to the console.
+/** Format an integer using xBSP430xtoaLong() and emit it to the console.
  *
  * @param n the integer value to be formatted
  * @param radix the radix to use when formatting
  *
- * @warning The implementation assumes that the radix is at least 10.
+ * @warning The implementation assumes that the radix is at least 8.
  * Passing a smaller radix will likely result in stack corruption.
  *
  * @return the number of characters emitted
  *
- * @dependency #BSP430_CONSOLE, #BSP430_CONSOLE_USE_EMBTEXTF
+ * @dependency #BSP430_CONSOLE
  *
  * @consoleoutput */
 int cputl (long n, int radix);
 
-/** Format an int using itoa and emit it to the console.
+/** Format an integer using xBSP430xtoaULong() and emit it to the console.
  *
  * @param n the integer value to be formatted
  * @param radix the radix to use when formatting
  *
- * @warning The implementation assumes that the radix is at least 10.
+ * @warning The implementation assumes that the radix is at least 8.
  * Passing a smaller radix will likely result in stack corruption.
  *
  * @return the number of characters emitted
  *
- * @dependency #BSP430_CONSOLE, #BSP430_CONSOLE_USE_EMBTEXTF
+ * @dependency #BSP430_CONSOLE
  *
  * @consoleoutput */
 int cputul (unsigned long n, int radix);
@@ -501,6 +814,30 @@ int iBSP430consoleDeconfigure (void);
  * initialized. */
 hBSP430halSERIAL hBSP430console (void);
 
+/** Policies for console output when the transmission buffer is full.
+ *
+ * These values are passed to iBSP430consoleTransmitUseInterrupts_ni()
+ * to select interrupt-driven transmission. */
+typedef enum eBSP430consoleTxPolicy {
+  /** Sleep until the interrupt handler has made room for the octet.
+   * This is the default, and is also selected by passing @c 1 to
+   * iBSP430consoleTransmitUseInterrupts_ni(). */
+  eBSP430consoleTxPolicy_BLOCK = 1,
+
+  /** Discard the octet being written.  Output routines never wait
+   * for the UART, at the cost of losing the most recent output. */
+  eBSP430consoleTxPolicy_DROP_NEWEST = 2,
+
+  /** Discard the oldest octet in the buffer to make room for the one
+   * being written.  Output routines never wait for the UART, and the
+   * most recent output is retained.
+   *
+   * @note Octets that have already been handed to a DMA channel (see
+   * #configBSP430_CONSOLE_TX_DMA) cannot be discarded.  If the whole
+   * buffer is in flight the new octet is dropped instead. */
+  eBSP430consoleTxPolicy_OVERWRITE_OLDEST = 3,
+} eBSP430consoleTxPolicy;
+
 /** Control whether console output uses interrupt-driven transmission.
  *
  * When #BSP430_CONSOLE_TX_BUFFER_SIZE is configured to a positive
@@ -512,21 +849,100 @@ hBSP430halSERIAL hBSP430console (void);
  * to disable the interrupt-based transmission, thus allowing use of
  * direct, busy-waiting console output.
  *
+ * It can also be used to select a policy that never waits for space
+ * in the buffer, so that time-critical code may produce output
+ * without missing deadlines.  Use
+ * iBSP430consoleTxStatistics_ni() to determine how much output has
+ * been lost under such a policy, or how long output was delayed under
+ * #eBSP430consoleTxPolicy_BLOCK.
+ *
  * @note You probably want to invoke vBSP430consoleFlush() prior to
  * disabling interrupt-driven transmission.  If you don't, whatever
  * was unflushed in the buffer will be displayed once the transmission
  * is re-enabled.
  *
- * @param enablep nonzero if interrupt-drive transmission is to be
- * used; zero to disable the transmit interrupt on the console UART
- * and use direct UART writes instead.
+ * @note The policy applies only to output through the transmission
+ * buffer.  iBSP430consoleFlush(), iBSP430consoleWaitForTxSpace_ni(),
+ * and iBSP430consoleWriteDescriptors() wait as they always have.
+ *
+ * @param enablep zero to disable the transmit interrupt on the
+ * console UART and use direct UART writes instead; otherwise an
+ * #eBSP430consoleTxPolicy value selecting interrupt-driven
+ * transmission with that policy.
  *
  * @return 0 if the configuration was accepted.  -1 if @p enable is
  * nonzero but the application was not configured with
- * interrupt-driven transmission enabled.
+ * interrupt-driven transmission enabled, if @p enablep is not a
+ * recognized policy, or if the #configBSP430_CONSOLE_TX_DMA channel
+ * cannot be used with the console UART.  On error the transmit path
+ * and policy are unchanged.
  */
 int iBSP430consoleTransmitUseInterrupts_ni (int enablep);
 
+/** Statistics on use of the console transmission buffer. */
+typedef struct sBSP430consoleTxStatistics {
+  /** Number of octets discarded under
+   * #eBSP430consoleTxPolicy_DROP_NEWEST or
+   * #eBSP430consoleTxPolicy_OVERWRITE_OLDEST. */
+  unsigned long dropped;
+
+  /** Total time spent waiting for space in the buffer under
+   * #eBSP430consoleTxPolicy_BLOCK, in uptime ticks.  This remains
+   * zero unless #configBSP430_UPTIME is enabled. */
+  unsigned long blocked_utt;
+
+  /** Number of times output waited for space in the buffer. */
+  unsigned int blocked;
+
+  /** The largest number of octets held in the buffer.  A value equal
+   * to #BSP430_CONSOLE_TX_BUFFER_SIZE indicates the buffer filled. */
+  unsigned int high_water;
+
+  /** Number of octets accepted for transmission, whether copied into
+   * the buffer or referenced by a descriptor. */
+  unsigned long queued;
+
+  /** Number of octets handed to the UART. */
+  unsigned long transmitted;
+
+  /** Number of transmit interrupts handled.  With
+   * #configBSP430_CONSOLE_TX_DMA this counts DMA transfer
+   * completions. */
+  unsigned long interrupts;
+
+  /** Total time spent suspended in iBSP430consoleWaitForTxSpace_ni(),
+   * in uptime ticks.  This remains zero unless #configBSP430_UPTIME is
+   * enabled. */
+  unsigned long wait_utt;
+
+  /** Total time spent in iBSP430consoleFlush(), in uptime ticks.
+   * This remains zero unless #configBSP430_UPTIME is enabled. */
+  unsigned long flush_utt;
+
+  /** The longest time spent in a single call to
+   * iBSP430consoleFlush(), in uptime ticks. */
+  unsigned long flush_max_utt;
+
+  /** Number of times iBSP430consoleWaitForTxSpace_ni() suspended. */
+  unsigned int waits;
+
+  /** Number of calls to iBSP430consoleFlush(). */
+  unsigned int flushes;
+} sBSP430consoleTxStatistics;
+
+/** Retrieve statistics on use of the console transmission buffer.
+ *
+ * @param sp where the statistics should be stored
+ *
+ * @param reset nonzero if the statistics should be cleared after
+ * being retrieved
+ *
+ * @return 0 if the statistics were retrieved, or -1 if the
+ * application was not configured with interrupt-driven transmission.
+ */
+int iBSP430consoleTxStatistics_ni (sBSP430consoleTxStatistics * sp,
+                                   int reset);
+
 /** Potentially block until space is available in console transmit buffer.
  *
  * This function causes the caller to block until the interrupt-driven
@@ -553,7 +969,7 @@ int iBSP430consoleTransmitUseInterrupts_ni (int enablep);
  * function had to suspend (enabling interrupts) in order to obtain
  * that space;
  * @li -1 if @p want_available is larger than
- * #BSP430_CONSOLE_TX_BUFFER_SIZE-1, which is the maximum number of
+ * #BSP430_CONSOLE_TX_BUFFER_SIZE, which is the maximum number of
  * bytes that can be made available.
  *
  * @consoleoutput */
@@ -586,6 +1002,14 @@ int iBSP430consoleFlush (void);
  * followed by up to 16 octet values, followed by the values as
  * printable characters.
  *
+ * Each line is formatted into a buffer on the stack and passed to
+ * iBSP430consoleWriteDescriptors().  Complete rows are formatted by
+ * filling in a fixed template.  Two such buffers (about 160
+ * octets) are used so formatting overlaps transmission.
+ *
+ * @see iBSP430chanmuxSendMemory() for a compact binary alternative
+ * suitable for host tools.
+ *
  * @param dp pointer to start of memory region
  * @param len number of octets to display
  * @param base base displayed address for first octet
@@ -599,7 +1023,8 @@ void vBSP430consoleDisplayMemory (const uint8_t * dp,
  * This function displays a sequence of octets on the console.  It
  * differs from vBSP430consoleDisplayMemory() in that there is no
  * address information, no printable character display, and no attempt
- * to split the output into individual lines.
+ * to split the output into individual lines.  The text is formatted
+ * and written in blocks of up to 16 octets.
  *
  * @param dp pointer to start of memory region
  * @param len number of octetst to display
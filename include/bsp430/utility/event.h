@@ -73,6 +73,7 @@
 #define BSP430_UTILITY_EVENT_H
 
 #include <bsp430/periph/timer.h>
+#include <bsp430/utility/uptime.h>
 
 /** A utility union that allows event records to hold one value of any
  * scalar type not exceeding 32 bits.  The union field that is valid
@@ -96,6 +97,67 @@ typedef union uBSP430eventAnyType {
   void (* fp)();
 } uBSP430eventAnyType;
 
+/** Define to a true value to maintain per-tag statistics on the
+ * interval between events, updated by xBSP430eventRecordEvent_ni().
+ * See iBSP430eventTagGetStats().
+ *
+ * The cost is a few dozen instructions per recorded event, and the
+ * size of #sBSP430eventTagStats for each supported tag.
+ *
+ * @cppflag
+ * @defaulted
+ */
+#ifndef configBSP430_EVENT_TAG_STATS
+#define configBSP430_EVENT_TAG_STATS 0
+#endif /* configBSP430_EVENT_TAG_STATS */
+
+/** The number of buckets in the interval histogram of
+ * #sBSP430eventTagStats.  Bucket @c i counts intervals of at least
+ * 2^i and less than 2^(i+1) uptime ticks, except that bucket 0 also
+ * counts zero-length intervals and the last bucket counts all longer
+ * intervals.  The default covers intervals up to two seconds at a
+ * 32 KiHz uptime clock.
+ *
+ * @cppflag
+ * @defaulted
+ * @dependency #configBSP430_EVENT_TAG_STATS
+ */
+#ifndef BSP430_EVENT_TAG_STATS_BUCKETS
+#define BSP430_EVENT_TAG_STATS_BUCKETS 16
+#endif /* BSP430_EVENT_TAG_STATS_BUCKETS */
+
+/** Statistics on the intervals between consecutive events with the
+ * same tag.  Intervals are measured in uptime ticks between the
+ * sBSP430eventTagRecord::timestamp_utt values of the events.
+ *
+ * @dependency #configBSP430_EVENT_TAG_STATS */
+typedef struct sBSP430eventTagStats {
+  /** The timestamp of the most recent event with the tag.  Valid
+   * only if #has_last is nonzero. */
+  unsigned long last_utt;
+  /** The number of events recorded since the statistics were
+   * reset */
+  unsigned long events;
+  /** The number of intervals measured.  This is one less than
+   * #events for the first collection after the tag is allocated, and
+   * equal to it after a reset, since the interval from the last event
+   * before the reset is counted. */
+  unsigned long intervals;
+  /** The shortest interval measured */
+  unsigned long interval_min_utt;
+  /** The longest interval measured */
+  unsigned long interval_max_utt;
+  /** The sum of all intervals measured, from which the mean is
+   * calculated */
+  unsigned long long interval_sum_utt;
+  /** Count of intervals by power of two; see
+   * #BSP430_EVENT_TAG_STATS_BUCKETS.  Counts saturate rather than
+   * wrap. */
+  unsigned int histogram[BSP430_EVENT_TAG_STATS_BUCKETS];
+  /** Nonzero once an event with the tag has been recorded */
+  unsigned char has_last;
+} sBSP430eventTagStats;
+
 /** Information about a particular allocated event tag.
  *
  * @see xBSP430eventTagLookup(). */
@@ -104,19 +166,28 @@ typedef struct sBSP430eventTagConfig {
   const char * id;
   /** A sequence number used to distinguish events with the corresponding tag. */
   volatile unsigned int seqno;
+#if defined(BSP430_DOXYGEN) || (configBSP430_EVENT_TAG_STATS - 0)
+  /** Interval statistics, updated by xBSP430eventRecordEvent_ni().
+   * Read with iBSP430eventTagGetStats().
+   *
+   * @dependency #configBSP430_EVENT_TAG_STATS */
+  sBSP430eventTagStats stats_;
+#endif /* configBSP430_EVENT_TAG_STATS */
 } sBSP430eventTagConfig;
 
 #if defined(BSP430_DOXYGEN) || ! defined(BSP430_EVENT_TAG_NUM_SUPPORTED)
 /** The number of event tags that the application will support.  The
  * value must be at least 2, and cannot exceed 255.  The per-tag
- * memory required is the size of #sBSP430eventTagConfig. */
+ * memory required is the size of #sBSP430eventTagConfig, which
+ * includes #sBSP430eventTagStats when #configBSP430_EVENT_TAG_STATS
+ * is enabled. */
 #define BSP430_EVENT_TAG_NUM_SUPPORTED 8
 #endif /* BSP430_EVENT_TAG_NUM_SUPPORTED */
 
 #if defined(BSP430_DOXYGEN) || ! defined(BSP430_EVENT_RECORD_NUM_SUPPORTED)
 /** The capacity of the tagged event record buffer.  The value must be
- * at least 2 and cannot exceed 255.  Using a power-of-2 may produce
- * slightly faster code.  The per-record memory required is the size
+ * a power of 2 no larger than #BSP430_RING_MAX_CAPACITY; see
+ * bsp430/utility/ring.h.  The per-record memory required is the size
  * of #sBSP430eventTagRecord. */
 #define BSP430_EVENT_RECORD_NUM_SUPPORTED 16
 #endif /* BSP430_EVENT_RECORD_NUM_SUPPORTED */
@@ -177,27 +248,36 @@ typedef void (* vBSP430eventPeriodicProcess) (const sBSP430eventTagRecord * ep,
  * @note None of the fields in this structure may be mutated while the
  * periodic event is registered. */
 typedef struct sBSP430eventPeriodicConfig {
-  /** A standard alarm structure.  No fields in this need be
+  /** A periodic multiplexed alarm.  No fields in this need be
    * initialized: that will be done when iBSP430eventPeriodicAdd_ni()
-   * is invoked to register the periodic event. */
-  sBSP430timerMuxAlarm alarm_;
+   * is invoked to register the periodic event.  The overrun count in
+   * sBSP430timerMuxPeriodic::overruns_ni may be inspected by the
+   * event consumer. */
+  sBSP430timerMuxPeriodic periodic_;
 
   /** The interval at which the periodic alarm should repeat.  The
    * periodic event infrastructure will automatically reschedule the
-   * event to be posted again this many ticks after the last posting.
-   * A zero interval results in a single event with no re-schedule.
+   * event to be posted again this many ticks after the last
+   * scheduled posting, so late service does not accumulate drift.  A
+   * zero interval results in a single event with no re-schedule.
    *
    * Note that the interval is not coupled to the
    * processing of the event; an unresponsive handler may result in
    * multiple events being queued. */
   unsigned long interval_tck;
 
+  /** The eBSP430timerMuxPeriodicPolicy to apply when the alarm is
+   * serviced one or more periods late.  The default
+   * #eBSP430timerMuxPeriodicPolicy_BURST records an event for every
+   * period. */
+  unsigned char policy;
+
   /** The tag parameter passed to xBSP430eventRecordEvent_ni() in the
-   * callback for #alarm_. */
+   * callback for #periodic_. */
   unsigned char tag;
 
   /** The flags parameter passed to xBSP430eventRecordEvent_ni() in
-   * the callback for #alarm_. */
+   * the callback for #periodic_. */
   unsigned char flags;
 } sBSP430eventPeriodicConfig;
 
@@ -374,6 +454,42 @@ void vBSP430eventFlagsSet (unsigned int flags)
   BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
 }
 
+/** Sleep until an event flag of interest is set or a deadline is
+ * reached.
+ *
+ * The test of the flags and the entry to low power mode are made
+ * with interrupts disabled, and interrupts are enabled only by the
+ * instruction that enters low power mode, so a flag set by an
+ * interrupt after the test cannot be missed: the wakeup from that
+ * interrupt is what ends the sleep.  The function repeats the test
+ * after each wakeup, so wakeups that set no flag in @p mask do not
+ * return to the caller before @p deadline_utt.
+ *
+ * The sleep uses lBSP430uptimeSleepUntil().  Producers that set the
+ * flags must exit low power mode when they do so, for example by
+ * returning #BSP430_HAL_ISR_CALLBACK_EXIT_LPM as the periodic event
+ * callback does.
+ *
+ * @param mask the flags of interest.  Flags outside the mask are
+ * left pending.
+ *
+ * @param deadline_utt the uptime at which the function returns if no
+ * flag in @p mask has been set
+ *
+ * @param lpm_bits the bits for the deepest low power mode the
+ * application permits; see lBSP430uptimeSleepUntil()
+ *
+ * @return the flags in @p mask that were set, which are cleared from
+ * the pending flags.  Zero indicates the deadline was reached (or the
+ * uptime delay alarm is disabled).
+ *
+ * @dependency #configBSP430_UPTIME_DELAY */
+#if defined(BSP430_DOXYGEN) || (configBSP430_UPTIME_DELAY - 0)
+unsigned int uiBSP430eventFlagsWait (unsigned int mask,
+                                     unsigned long deadline_utt,
+                                     unsigned int lpm_bits);
+#endif /* configBSP430_UPTIME_DELAY */
+
 /** Record an event along with its metadata.
  *
  * @param tag the tag identifying the type of event
@@ -405,10 +521,55 @@ void vBSP430eventRecordEvent (unsigned char tag,
   BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
 }
 
+#if defined(BSP430_DOXYGEN) || (configBSP430_EVENT_TAG_STATS - 0)
+/** Obtain the interval statistics for a tag.
+ *
+ * The statistics are copied with interrupts disabled so they are
+ * consistent with each other.  The mean interval is
+ * sBSP430eventTagStats::interval_sum_utt divided by
+ * sBSP430eventTagStats::intervals.
+ *
+ * @param tag a tag as returned by ucBSP430eventTagAllocate()
+ *
+ * @param sp where the statistics should be stored.  May be null if
+ * only a reset is desired.
+ *
+ * @param reset if nonzero the statistics for @p tag are cleared after
+ * being copied, retaining only the time of the last event so that the
+ * interval to the next one is measured
+ *
+ * @return 0 on success, or -1 if @p tag is not an allocated tag
+ *
+ * @dependency #configBSP430_EVENT_TAG_STATS */
+int iBSP430eventTagGetStats (unsigned char tag,
+                             sBSP430eventTagStats * sp,
+                             int reset);
+#endif /* configBSP430_EVENT_TAG_STATS */
+
 /** Transfer tagged events from the infrastructure to the application.
  *
  * This function should be invoked whenever
- * #uiBSP430eventFlag_EventRecord is set.
+ * #uiBSP430eventFlag_EventRecord is set.  It must be invoked from only
+ * one context, normally the main loop.
+ *
+ * Records are copied with interrupts enabled, so producers in
+ * interrupt handlers are never delayed by the copy.  When the buffer
+ * overflows producers overwrite the oldest records; a record that is
+ * replaced while it is being copied is discarded along with the
+ * others that were lost, and the count of lost records is returned as
+ * a #ucBSP430eventTag_LostEventRecord record before any records that
+ * follow it.  The only interval during which this function disables
+ * interrupts is the few instructions that set
+ * #uiBSP430eventFlag_EventRecord when records remain, independent of
+ * @p len.  The interrupt-disabled time attributable to the event
+ * buffer is therefore bounded by the cost of one invocation of
+ * xBSP430eventRecordEvent_ni(): a single record store and an uptime
+ * read.
+ *
+ * @note Loss accounting uses 16-bit counters.  If more than 65535
+ * records less the buffer capacity are produced between invocations
+ * the reported loss count is too small, though the returned records
+ * remain valid.
  *
  * @param evts space into which tagged event records may be copied
  *
@@ -0,0 +1,173 @@
+/* Copyright 2014, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** @file
+ *
+ * @brief Compact binary export of tagged event records
+ *
+ * Records obtained from iBSP430eventTagGetRecords() are useful for
+ * understanding the timing behavior of an application, but
+ * formatting each as text on the device costs far more than
+ * recording it did.  This module encodes the records into a compact
+ * octet stream that a host decodes at leisure.  The stream may be
+ * transmitted as frames with iBSP430chanmuxSendFrame(), or written
+ * sequentially to external storage such as an M25P flash device and
+ * read back later: the encoding of each buffer follows directly from
+ * the one before it, so the concatenation of the buffers in the
+ * order they were produced is the stream.
+ *
+ * The stream is a sequence of records.  Integers are base-128
+ * varints (least significant group first, high bit set on all but
+ * the last octet).  A record that begins with
+ * #BSP430_EVENTTRACE_CONTROL is a control record, identified by the
+ * octet following it:
+ *
+ * @li #BSP430_EVENTTRACE_CONTROL_SYNC carries the uptime conversion
+ * frequency in Hz and the absolute 32-bit uptime of the following
+ * event record.  It is emitted before the first event record
+ * following vBSP430eventTraceReset().
+ *
+ * @li #BSP430_EVENTTRACE_CONTROL_TAG carries a tag value, the length
+ * of its identifier, and the characters of the identifier as passed
+ * to ucBSP430eventTagAllocate().  Each allocated tag is described
+ * once, before the first event record that follows its allocation.
+ *
+ * Any other leading octet is the tag of an event record, which
+ * continues with the event flags octet, then varints holding the
+ * uptime ticks elapsed since the previous event record, the tag
+ * sequence number, and the @c ul member of the event value.  An
+ * event record is at most #BSP430_EVENTTRACE_RECORD_MAX_LENGTH
+ * octets; most are five or six.
+ *
+ * Timestamp deltas are computed modulo 2^32, so the host can extend
+ * the uptime clock beyond its wrap provided consecutive event records
+ * are separated by less than a full uptime period.
+ *
+ * The host utility <tt>maintainer/eventtrace-chrome</tt> converts a
+ * stream to the Chrome trace event JSON format, which can be viewed
+ * in Perfetto or chrome://tracing.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2014, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#ifndef BSP430_UTILITY_EVENTTRACE_H
+#define BSP430_UTILITY_EVENTTRACE_H
+
+#include <bsp430/core.h>
+#include <bsp430/utility/event.h>
+
+/** Leading octet of a control record.  Event tags are allocated
+ * from zero and never reach this value. */
+#define BSP430_EVENTTRACE_CONTROL 0xFF
+
+/** Control record establishing the time base of the stream */
+#define BSP430_EVENTTRACE_CONTROL_SYNC 0x01
+
+/** Control record associating a tag with its identifier */
+#define BSP430_EVENTTRACE_CONTROL_TAG 0x02
+
+/** The maximum length of an encoded event record */
+#define BSP430_EVENTTRACE_RECORD_MAX_LENGTH 15
+
+/** The maximum length of a #BSP430_EVENTTRACE_CONTROL_SYNC record */
+#define BSP430_EVENTTRACE_SYNC_MAX_LENGTH 12
+
+/** The maximum number of identifier characters in a
+ * #BSP430_EVENTTRACE_CONTROL_TAG record.  Longer identifiers are
+ * truncated.
+ *
+ * @cppflag
+ * @defaulted
+ */
+#ifndef BSP430_EVENTTRACE_TAG_ID_MAX
+#define BSP430_EVENTTRACE_TAG_ID_MAX 16
+#endif /* BSP430_EVENTTRACE_TAG_ID_MAX */
+
+/** The smallest buffer guaranteed to hold any single record, and
+ * hence to allow iBSP430eventTraceEncode() to make progress. */
+#define BSP430_EVENTTRACE_MIN_BUFFER (4 + BSP430_EVENTTRACE_TAG_ID_MAX)
+
+/** State carried between buffers of an encoded stream */
+typedef struct sBSP430eventTraceEncoder {
+  /** Uptime of the most recent event record */
+  unsigned long last_utt;
+  /** Nonzero once the #BSP430_EVENTTRACE_CONTROL_SYNC record has
+   * been emitted */
+  unsigned char synchronized;
+  /** The number of tags described so far */
+  unsigned char tags_described;
+} sBSP430eventTraceEncoder;
+
+/** Begin a new stream.
+ *
+ * The next encoded buffer will start with a
+ * #BSP430_EVENTTRACE_CONTROL_SYNC record and describe all allocated
+ * tags, so the host can decode from that point without having seen
+ * anything earlier.
+ *
+ * @param enc the encoder state */
+void vBSP430eventTraceReset (sBSP430eventTraceEncoder * enc);
+
+/** Encode event records into a buffer.
+ *
+ * Control records are emitted as required, followed by as many
+ * complete event records as fit.  A typical use drains the event
+ * buffer and loops until all records have been consumed, passing
+ * each non-empty buffer to the transport.
+ *
+ * A #ucBSP430eventTag_LostEventRecord record carries no timestamp,
+ * and is encoded with the timestamp of the event record that
+ * preceded it, or at the start of a stream the one that follows it.
+ *
+ * @param enc the encoder state
+ *
+ * @param evts the records to encode
+ *
+ * @param nevts the number of records at @p evts
+ *
+ * @param buf where the encoded octets are stored
+ *
+ * @param lenp on entry the space available at @p buf; on return the
+ * number of octets stored there
+ *
+ * @return the number of event records consumed from @p evts, or -1
+ * if the buffer is too small to hold the next record (see
+ * #BSP430_EVENTTRACE_MIN_BUFFER).  Zero is returned with a non-zero
+ * length when the buffer was filled by control records. */
+int iBSP430eventTraceEncode (sBSP430eventTraceEncoder * enc,
+                             const sBSP430eventTagRecord * evts,
+                             int nevts,
+                             uint8_t * buf,
+                             size_t * lenp);
+
+#endif /* BSP430_UTILITY_EVENTTRACE_H */
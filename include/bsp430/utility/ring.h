@@ -0,0 +1,350 @@
+/* Copyright 2014, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Single-producer single-consumer ring buffer indexes.
+ *
+ * A ring is a power-of-two number of slots in storage owned by the
+ * user, together with an #sBSP430ring that records how many elements
+ * have ever been added (the head) and removed (the tail).  These are
+ * free-running 16-bit counters; the slot for a counter is obtained by
+ * masking it with the capacity minus one.  Because the counters are
+ * never reduced modulo the capacity, a full ring is distinguished
+ * from an empty one without sacrificing a slot, and capacities up to
+ * 32768 elements are supported.
+ *
+ * The head is written only by the producer and the tail only by the
+ * consumer.  Both are 16-bit values that the MSP430 reads and writes
+ * atomically, so when the producer and consumer are respectively an
+ * interrupt handler and the main loop (or the reverse), neither side
+ * needs to disable interrupts to use the ring.  The producer must
+ * store the element before publishing it with
+ * vBSP430ringProduce(), and the consumer must read the element
+ * before releasing it with vBSP430ringConsume().  Both functions
+ * issue BSP430_RING_BARRIER() before updating the index so the
+ * compiler cannot move element accesses past the update.
+ *
+ * The ring does not itself hold the element storage, so one
+ * implementation serves rings of octets, of structures, and of
+ * anything else.  Octet rings get bulk copy helpers
+ * uiBSP430ringWriteOctets() and uiBSP430ringReadOctets().
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2014, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#ifndef BSP430_UTILITY_RING_H
+#define BSP430_UTILITY_RING_H
+
+#include <bsp430/core.h>
+#include <string.h>
+
+/** A compiler memory barrier.
+ *
+ * The MSP430 does not reorder memory accesses, but the compiler may
+ * move ordinary accesses to element storage across the volatile
+ * store of a ring index.  This prevents that. */
+#define BSP430_RING_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+/** The largest capacity supported by a ring. */
+#define BSP430_RING_MAX_CAPACITY 32768U
+
+/** Evaluate to a true value if @p n_ is a valid ring capacity.
+ *
+ * This is a constant expression when @p n_ is, and is intended for
+ * use in preprocessor validation of configured sizes. */
+#define BSP430_RING_VALID_CAPACITY(n_)                          \
+  ((0 < (n_)) && ((n_) <= BSP430_RING_MAX_CAPACITY)             \
+   && (0 == ((n_) & ((n_) - 1))))
+
+/** State of a single-producer single-consumer ring. */
+typedef struct sBSP430ring {
+  /** Total number of elements produced, modulo 2^16.  Written only
+   * by the producer. */
+  volatile uint16_t head;
+
+  /** Total number of elements consumed, modulo 2^16.  Written only
+   * by the consumer. */
+  volatile uint16_t tail;
+
+  /** The capacity of the ring, minus one. */
+  uint16_t mask;
+} sBSP430ring;
+
+/** A static initializer for an #sBSP430ring with the given capacity,
+ * which must satisfy #BSP430_RING_VALID_CAPACITY. */
+#define BSP430_RING_INITIALIZER(capacity_) { .head = 0, .tail = 0, .mask = (capacity_) - 1 }
+
+/** Initialize @p rp as an empty ring of capacity @p capacity, which
+ * must satisfy #BSP430_RING_VALID_CAPACITY.
+ *
+ * This must not be invoked while the producer or consumer is active. */
+static BSP430_CORE_INLINE
+void
+vBSP430ringInitialize (sBSP430ring * rp,
+                       uint16_t capacity)
+{
+  rp->head = rp->tail = 0;
+  rp->mask = capacity - 1;
+}
+
+/** Discard all elements in the ring.
+ *
+ * This must not be invoked while the producer or consumer is active. */
+static BSP430_CORE_INLINE
+void
+vBSP430ringReset (sBSP430ring * rp)
+{
+  rp->head = rp->tail = 0;
+}
+
+/** The number of elements the ring can hold. */
+static BSP430_CORE_INLINE
+uint16_t
+uiBSP430ringCapacity (const sBSP430ring * rp)
+{
+  return rp->mask + 1;
+}
+
+/** The number of elements in the ring.
+ *
+ * This is exact when invoked by either party, although the value may
+ * be stale (too small for the consumer, too large for the producer)
+ * by the time it is used. */
+static BSP430_CORE_INLINE
+uint16_t
+uiBSP430ringCount (const sBSP430ring * rp)
+{
+  return rp->head - rp->tail;
+}
+
+/** The number of elements that may be added to the ring. */
+static BSP430_CORE_INLINE
+uint16_t
+uiBSP430ringSpace (const sBSP430ring * rp)
+{
+  return rp->mask + 1 - (uint16_t)(rp->head - rp->tail);
+}
+
+/** True if the ring holds no elements. */
+static BSP430_CORE_INLINE
+int
+iBSP430ringEmpty (const sBSP430ring * rp)
+{
+  return rp->head == rp->tail;
+}
+
+/** True if no element may be added to the ring. */
+static BSP430_CORE_INLINE
+int
+iBSP430ringFull (const sBSP430ring * rp)
+{
+  return (uint16_t)(rp->head - rp->tail) > rp->mask;
+}
+
+/** The slot into which the producer should store the next element. */
+static BSP430_CORE_INLINE
+uint16_t
+uiBSP430ringHeadSlot (const sBSP430ring * rp)
+{
+  return rp->head & rp->mask;
+}
+
+/** The slot holding the oldest element, which is valid only if the
+ * ring is not empty. */
+static BSP430_CORE_INLINE
+uint16_t
+uiBSP430ringTailSlot (const sBSP430ring * rp)
+{
+  return rp->tail & rp->mask;
+}
+
+/** The number of elements beginning at uiBSP430ringTailSlot() that
+ * occupy consecutive slots.  A consumer that hands the elements to
+ * something like a DMA channel can transfer at most this many at
+ * once. */
+static BSP430_CORE_INLINE
+uint16_t
+uiBSP430ringContiguousCount (const sBSP430ring * rp)
+{
+  uint16_t count = rp->head - rp->tail;
+  uint16_t to_end = rp->mask + 1 - (rp->tail & rp->mask);
+
+  return (count < to_end) ? count : to_end;
+}
+
+/** Publish @p n elements that the producer has stored beginning at
+ * uiBSP430ringHeadSlot().  Invoked only by the producer, and @p n
+ * must not exceed uiBSP430ringSpace(). */
+static BSP430_CORE_INLINE
+void
+vBSP430ringProduce (sBSP430ring * rp,
+                    uint16_t n)
+{
+  BSP430_RING_BARRIER();
+  rp->head += n;
+}
+
+/** Release @p n elements beginning at uiBSP430ringTailSlot().
+ * Invoked only by the consumer, and @p n must not exceed
+ * uiBSP430ringCount(). */
+static BSP430_CORE_INLINE
+void
+vBSP430ringConsume (sBSP430ring * rp,
+                    uint16_t n)
+{
+  BSP430_RING_BARRIER();
+  rp->tail += n;
+}
+
+/** Store an octet into a ring of octets.
+ *
+ * @param rp the ring state
+ *
+ * @param storage the ring storage
+ *
+ * @param c the value to be stored
+ *
+ * @return @p c, or -1 if the ring was full */
+static BSP430_CORE_INLINE
+int
+iBSP430ringPutOctet (sBSP430ring * rp,
+                     uint8_t * storage,
+                     uint8_t c)
+{
+  if (iBSP430ringFull(rp)) {
+    return -1;
+  }
+  BSP430_RING_BARRIER();
+  storage[uiBSP430ringHeadSlot(rp)] = c;
+  vBSP430ringProduce(rp, 1);
+  return c;
+}
+
+/** Remove an octet from a ring of octets.
+ *
+ * @param rp the ring state
+ *
+ * @param storage the ring storage
+ *
+ * @return the oldest octet in the ring, or -1 if the ring was empty */
+static BSP430_CORE_INLINE
+int
+iBSP430ringGetOctet (sBSP430ring * rp,
+                     const uint8_t * storage)
+{
+  int rv;
+
+  if (iBSP430ringEmpty(rp)) {
+    return -1;
+  }
+  BSP430_RING_BARRIER();
+  rv = storage[uiBSP430ringTailSlot(rp)];
+  vBSP430ringConsume(rp, 1);
+  return rv;
+}
+
+/** Store as many as possible of a sequence of octets into a ring of
+ * octets.
+ *
+ * @param rp the ring state
+ *
+ * @param storage the ring storage
+ *
+ * @param src the octets to be stored
+ *
+ * @param len the number of octets in @p src
+ *
+ * @return the number of octets stored */
+static BSP430_CORE_INLINE
+uint16_t
+uiBSP430ringWriteOctets (sBSP430ring * rp,
+                         uint8_t * storage,
+                         const uint8_t * src,
+                         uint16_t len)
+{
+  uint16_t slot = uiBSP430ringHeadSlot(rp);
+  uint16_t space = uiBSP430ringSpace(rp);
+  uint16_t n;
+
+  if (len > space) {
+    len = space;
+  }
+  n = rp->mask + 1 - slot;
+  if (n > len) {
+    n = len;
+  }
+  BSP430_RING_BARRIER();
+  memcpy(storage + slot, src, n);
+  memcpy(storage, src + n, len - n);
+  vBSP430ringProduce(rp, len);
+  return len;
+}
+
+/** Remove as many as possible of a sequence of octets from a ring of
+ * octets.
+ *
+ * @param rp the ring state
+ *
+ * @param storage the ring storage
+ *
+ * @param dst where the octets should be stored
+ *
+ * @param len the maximum number of octets to remove
+ *
+ * @return the number of octets removed */
+static BSP430_CORE_INLINE
+uint16_t
+uiBSP430ringReadOctets (sBSP430ring * rp,
+                        const uint8_t * storage,
+                        uint8_t * dst,
+                        uint16_t len)
+{
+  uint16_t slot = uiBSP430ringTailSlot(rp);
+  uint16_t count = uiBSP430ringCount(rp);
+  uint16_t n;
+
+  if (len > count) {
+    len = count;
+  }
+  n = rp->mask + 1 - slot;
+  if (n > len) {
+    n = len;
+  }
+  BSP430_RING_BARRIER();
+  memcpy(dst, storage + slot, n);
+  memcpy(dst + n, storage, len - n);
+  vBSP430ringConsume(rp, len);
+  return len;
+}
+
+#endif /* BSP430_UTILITY_RING_H */
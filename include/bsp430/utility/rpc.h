@@ -0,0 +1,203 @@
+/* Copyright 2014, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** @file
+ *
+ * @brief Binary request/response access to command line handlers.
+ *
+ * Host programs that drive a device through the text command line
+ * must format each request as text, and the device must tokenize it
+ * with xBSP430cliNextQToken() and convert numbers with the
+ * iBSP430cliStoreExtracted family.  The host then parses whatever
+ * the handler wrote with cprintf().  This module provides a compact
+ * binary alternative that reaches the same #sBSP430cliCommand
+ * structures used by the text interface.
+ *
+ * Commands are identified by number: the position of the command in
+ * a depth-first walk of the command hierarchy, counting from zero at
+ * the first top-level command.  A host discovers the numbers by name
+ * with #BSP430_RPC_OP_LIST, so they need not be shared at build time.
+ *
+ * Requests and responses begin with a four-octet header: a sequence
+ * number chosen by the host and echoed in the response, an operation
+ * code, and a 16-bit command number in little-endian order.  The
+ * response operation code is the request code with
+ * #BSP430_RPC_OP_RESPONSE set.  The header is followed by fields,
+ * each comprising a type octet, a length octet, and the value.
+ * Integer values are little-endian.
+ *
+ * For #BSP430_RPC_OP_CALL the request carries at most one argument
+ * field, and the response carries a #BSP430_RPC_TLV_STATUS field
+ * with the value returned by the command:
+ * @li Commands implemented by iBSP430cliHandlerStoreI(),
+ * iBSP430cliHandlerStoreUI(), iBSP430cliHandlerStoreL(), or
+ * iBSP430cliHandlerStoreUL() accept a #BSP430_RPC_TLV_INT or
+ * #BSP430_RPC_TLV_UINT argument that is range-checked and stored
+ * directly, without conversion to or from text.  The response
+ * includes the value of the variable, so a request with no argument
+ * reads it.
+ * @li Other commands accept an optional #BSP430_RPC_TLV_TEXT
+ * argument that is passed to sBSP430cliCommand::handler as the
+ * argument string.  Text output from the handler appears on the
+ * console as usual.
+ *
+ * Requests are carried as frames on a bsp430/utility/chanmux.h
+ * channel.  The host client is the @c bsp430.rpc Python module in
+ * <tt>maintainer/lib/python</tt>, and <tt>maintainer/rpc-bench</tt>
+ * measures round-trip latency.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2014, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#ifndef BSP430_UTILITY_RPC_H
+#define BSP430_UTILITY_RPC_H
+
+#include <bsp430/core.h>
+#include <bsp430/utility/cli.h>
+#include <bsp430/utility/chanmux.h>
+
+/** The number of octets in a request or response header */
+#define BSP430_RPC_HEADER_LENGTH 4
+
+/** The maximum length of a #BSP430_RPC_TLV_TEXT argument.
+ *
+ * Text arguments are copied to a static buffer of this many octets
+ * plus a terminating NUL, so handlers that rely on NUL termination
+ * may be invoked.
+ *
+ * The default is the longest text that fits in a request frame
+ * after the header and the field type and length.  A smaller value
+ * may be used to save RAM; a larger one is rejected since no request
+ * could carry it.
+ *
+ * @cppflag
+ * @defaulted
+ */
+#ifndef BSP430_RPC_TEXT_LENGTH
+#define BSP430_RPC_TEXT_LENGTH (BSP430_CHANMUX_MAX_PAYLOAD - BSP430_RPC_HEADER_LENGTH - 2)
+#endif /* BSP430_RPC_TEXT_LENGTH */
+
+#if (BSP430_CHANMUX_MAX_PAYLOAD - BSP430_RPC_HEADER_LENGTH - 2) < (BSP430_RPC_TEXT_LENGTH)
+#error BSP430_RPC_TEXT_LENGTH exceeds the space in a request frame
+#endif /* BSP430_RPC_TEXT_LENGTH */
+
+/** Operation code requesting the names of commands.  The response
+ * holds a #BSP430_RPC_TLV_NAME field for each command, beginning
+ * with the command number in the request, for as many commands as
+ * fit.  A response with no fields indicates there are no further
+ * commands. */
+#define BSP430_RPC_OP_LIST 0x01
+
+/** Operation code requesting execution of a command */
+#define BSP430_RPC_OP_CALL 0x02
+
+/** Flag set in the operation code of a response */
+#define BSP430_RPC_OP_RESPONSE 0x80
+
+/** Field holding a signed integer of 1, 2, or 4 octets */
+#define BSP430_RPC_TLV_INT 0x01
+
+/** Field holding an unsigned integer of 1, 2, or 4 octets */
+#define BSP430_RPC_TLV_UINT 0x02
+
+/** Field holding text, not NUL-terminated */
+#define BSP430_RPC_TLV_TEXT 0x03
+
+/** Field holding the 16-bit signed value returned by a command */
+#define BSP430_RPC_TLV_STATUS 0x04
+
+/** Field holding the full name of a command, with the keys of the
+ * command and its parents separated by single spaces */
+#define BSP430_RPC_TLV_NAME 0x05
+
+/** Process one request.
+ *
+ * This is the transport-independent core of the module, used by the
+ * channel receive callback installed by iBSP430rpcRegister().
+ *
+ * @param cmds the first top-level command, as would be passed to
+ * iBSP430cliExecuteCommand()
+ *
+ * @param param the parameter passed to command handlers
+ *
+ * @param request the request, beginning with its header
+ *
+ * @param request_len the number of octets in @p request
+ *
+ * @param response where the response is to be stored
+ *
+ * @param response_size the number of octets available at @p
+ * response, at least #BSP430_RPC_HEADER_LENGTH + 10
+ *
+ * @return the number of octets in the response, or -1 if the request
+ * was too short to hold a header or @p response_size is too small */
+int iBSP430rpcProcessRequest (const sBSP430cliCommand * cmds,
+                              void * param,
+                              const uint8_t * request,
+                              size_t request_len,
+                              uint8_t * response,
+                              size_t response_size);
+
+/** State for a command server on a multiplexed channel.
+ *
+ * The application initializes @a channel as for any
+ * #sBSP430chanmuxChannel except for its receive callback, along with
+ * @a cmds and @a param, then invokes iBSP430rpcRegister().  The
+ * channel transmit ring remains available to the application for
+ * unsolicited data; responses are sent as individual frames. */
+typedef struct sBSP430rpcServer {
+  /** The channel carrying requests and responses.  This must be the
+   * first field. */
+  sBSP430chanmuxChannel channel;
+
+  /** The first top-level command */
+  const sBSP430cliCommand * cmds;
+
+  /** The parameter passed to command handlers */
+  void * param;
+
+  /** The number of requests processed */
+  unsigned long requests;
+} sBSP430rpcServer;
+
+/** Install a command server on its multiplexed channel.
+ *
+ * Requests are processed from iBSP430chanmuxRxFilter(), so handlers
+ * execute in the context in which the application reads the console.
+ *
+ * @param server the server to be registered
+ *
+ * @return as with iBSP430chanmuxRegister() */
+int iBSP430rpcRegister (sBSP430rpcServer * server);
+
+#endif /* BSP430_UTILITY_RPC_H */
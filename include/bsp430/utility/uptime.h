@@ -169,6 +169,22 @@
 #define configBSP430_UPTIME_DELAY 0
 #endif /* configBSP430_UPTIME_DELAY */
 
+/** Define to a true value to enable the idle manager.
+ *
+ * The idle manager selects the deepest low power mode that is safe
+ * given the pending deadlines of watched timer alarms and the
+ * constraints registered by active peripherals, and records the time
+ * spent in each mode.  The core API for this capability is
+ * lBSP430uptimeIdleUntil().  When enabled, lBSP430uptimeSleepUntil()
+ * also limits the requested mode to the deepest safe mode.
+ *
+ * @cppflag
+ * @defaulted
+ * @dependency #configBSP430_UPTIME_DELAY */
+#ifndef configBSP430_UPTIME_IDLE
+#define configBSP430_UPTIME_IDLE 0
+#endif /* configBSP430_UPTIME_IDLE */
+
 /** Define to the preprocessor-compatible identifier for a timer that
  * should be used to maintain a continuous system clock sourced from
  * ACLK.  The define must appear in the @ref bsp430_config subsystem
@@ -363,7 +379,9 @@ ulBSP430uptime_ni (void)
   return ulBSP430timerCounter_ni(hBSP430uptimeTimer(), 0);
 }
 
-/** Return the system uptime in clock ticks. */
+/** Return the system uptime in clock ticks.
+ *
+ * This does not disable interrupts; see ulBSP430timerCounter(). */
 static BSP430_CORE_INLINE
 unsigned long
 ulBSP430uptime (void)
@@ -380,16 +398,18 @@ static BSP430_CORE_INLINE
 unsigned long long
 ullBSP430uptime (void)
 {
-  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
-  unsigned int overflow;
-  unsigned long ul;
-
-  BSP430_CORE_DISABLE_INTERRUPT();
-  do {
-    ul = ulBSP430timerCounter_ni(hBSP430uptimeTimer(), &overflow);
-  } while (0);
-  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
-  return (((unsigned long long)overflow) << (8 * sizeof(ul))) | ul;
+  return ullBSP430timerCounter(hBSP430uptimeTimer());
+}
+
+/** Return the system uptime in clock ticks at its full precision
+ * assuming interrupts are disabled.
+ *
+ * @see ullBSP430uptime() */
+static BSP430_CORE_INLINE
+unsigned long long
+ullBSP430uptime_ni (void)
+{
+  return ullBSP430timerCounter_ni(hBSP430uptimeTimer());
 }
 
 /** Adjust a captured 16-bit counter to a full resolution timestamp.
@@ -822,6 +842,205 @@ int iBSP430uptimeDelaySetEnabled_ni (int enablep);
   } while (0)
 #endif /* configBSP430_UPTIME_DELAY */
 
+#if defined(BSP430_DOXYGEN) || ((configBSP430_UPTIME_IDLE - 0) && (configBSP430_UPTIME_DELAY - 0))
+
+/** The number of low power modes distinguished by the idle manager.
+ * Modes are identified by level, where level @c n corresponds to
+ * <tt>LPMn_bits</tt>.
+ *
+ * @dependency #configBSP430_UPTIME_IDLE */
+#define BSP430_UPTIME_IDLE_LEVELS 5
+
+/** The deepest low power mode level the idle manager will select.
+ *
+ * The uptime timer is normally clocked from ACLK, which continues
+ * through LPM3, so the default is 3.
+ *
+ * @defaulted
+ * @dependency #configBSP430_UPTIME_IDLE */
+#ifndef BSP430_UPTIME_IDLE_DEEPEST_LEVEL
+#define BSP430_UPTIME_IDLE_DEEPEST_LEVEL 3
+#endif /* BSP430_UPTIME_IDLE_DEEPEST_LEVEL */
+
+/** The shortest sleep, in uptime ticks, for which the idle manager
+ * will select a mode deeper than LPM0.  Wakeup from deeper modes
+ * requires the DCO to restart, which is not worthwhile for very short
+ * sleeps.
+ *
+ * @defaulted
+ * @dependency #configBSP430_UPTIME_IDLE */
+#ifndef BSP430_UPTIME_IDLE_SHALLOW_UTT
+#define BSP430_UPTIME_IDLE_SHALLOW_UTT 4
+#endif /* BSP430_UPTIME_IDLE_SHALLOW_UTT */
+
+/** The maximum number of timer alarms that may be watched by the idle
+ * manager.
+ *
+ * @defaulted
+ * @dependency #configBSP430_UPTIME_IDLE */
+#ifndef BSP430_UPTIME_IDLE_ALARM_MAX
+#define BSP430_UPTIME_IDLE_ALARM_MAX 4
+#endif /* BSP430_UPTIME_IDLE_ALARM_MAX */
+
+/* Forward declaration */
+struct sBSP430uptimeIdleConstraint;
+
+/** A function reporting the deepest low power mode level a
+ * peripheral can tolerate right now.
+ *
+ * This is invoked with interrupts disabled immediately before the
+ * idle manager selects a mode.  It must not enable interrupts, but
+ * may wait briefly for the peripheral to become idle.
+ *
+ * @param cp the constraint node through which the function was
+ * invoked.
+ *
+ * @return the deepest acceptable level, between 0 and
+ * #BSP430_UPTIME_IDLE_LEVELS-1. */
+typedef int (* iBSP430uptimeIdleConstraint_ni) (const struct sBSP430uptimeIdleConstraint * cp);
+
+/** A node in the chain of constraints consulted by the idle manager.
+ *
+ * @see iBSP430uptimeIdleConstraintRegister_ni()
+ * @dependency #configBSP430_UPTIME_IDLE */
+typedef struct sBSP430uptimeIdleConstraint {
+  /** The next constraint in the chain.  Managed by the idle
+   * manager. */
+  struct sBSP430uptimeIdleConstraint * next_ni;
+
+  /** The function that evaluates the constraint. */
+  iBSP430uptimeIdleConstraint_ni level_ni;
+} sBSP430uptimeIdleConstraint;
+
+/** A structure recording the time spent awake and in each low power
+ * mode entered through the idle manager.
+ *
+ * This is the per-mode counterpart of sBSP430uptimeActivityTotals.
+ *
+ * @see vBSP430uptimeIdleResidency()
+ * @dependency #configBSP430_UPTIME_IDLE */
+typedef struct sBSP430uptimeIdleResidency {
+  /** Cumulative number of uptime ticks spent in active mode. */
+  unsigned long long awake_utt;
+  /** Cumulative number of uptime ticks spent in each low-power mode,
+   * indexed by level. */
+  unsigned long long sleep_utt[BSP430_UPTIME_IDLE_LEVELS];
+  /** Number of times each low-power mode has been entered. */
+  unsigned long sleeps[BSP430_UPTIME_IDLE_LEVELS];
+  /** The uptime clock when the system last came out of low-power
+   * mode. */
+  unsigned long last_wake_utt;
+} sBSP430uptimeIdleResidency;
+
+/** Return the status register bits for a low power mode level.
+ *
+ * @param level a level between 0 and #BSP430_UPTIME_IDLE_LEVELS-1.
+ *
+ * @dependency #configBSP430_UPTIME_IDLE */
+unsigned int uiBSP430uptimeIdleLevelBits (int level);
+
+/** Add a peripheral constraint to the idle manager.
+ *
+ * @param cp the constraint to add.  It must not already be
+ * registered.
+ *
+ * @return 0
+ *
+ * @dependency #configBSP430_UPTIME_IDLE */
+int iBSP430uptimeIdleConstraintRegister_ni (sBSP430uptimeIdleConstraint * cp);
+
+/** Remove a peripheral constraint from the idle manager.
+ *
+ * @param cp the constraint to remove.
+ *
+ * @return 0 if @p cp was removed, -1 if it was not registered.
+ *
+ * @dependency #configBSP430_UPTIME_IDLE */
+int iBSP430uptimeIdleConstraintUnregister_ni (sBSP430uptimeIdleConstraint * cp);
+
+/** Prevent the idle manager from selecting a mode deeper than @p
+ * level until a matching vBSP430uptimeIdleRelease_ni().
+ *
+ * This is intended for code that keeps a clock in use for a bounded
+ * interval, such as an SMCLK-driven conversion.  Holds nest.
+ *
+ * @param level the deepest level acceptable to the holder.
+ *
+ * @dependency #configBSP430_UPTIME_IDLE */
+void vBSP430uptimeIdleHold_ni (int level);
+
+/** Release a hold placed by vBSP430uptimeIdleHold_ni() with the same
+ * @p level.
+ *
+ * @dependency #configBSP430_UPTIME_IDLE */
+void vBSP430uptimeIdleRelease_ni (int level);
+
+/** Ask the idle manager to account for a timer alarm.
+ *
+ * While the alarm is set, its timer must keep running: if the timer
+ * is clocked from anything other than ACLK the idle manager will not
+ * go deeper than LPM0.  If the alarm is on the uptime timer its
+ * setting is a deadline, and a deadline sooner than
+ * #BSP430_UPTIME_IDLE_SHALLOW_UTT also limits the mode to LPM0.  For
+ * @ref grp_timer_alarm_muxed pass the @link
+ * sBSP430timerMuxSharedAlarm::dedicated dedicated@endlink alarm.
+ *
+ * @param alarm the alarm to watch.
+ *
+ * @return 0 on success, -1 if #BSP430_UPTIME_IDLE_ALARM_MAX alarms
+ * are already watched.
+ *
+ * @dependency #configBSP430_UPTIME_IDLE */
+int iBSP430uptimeIdleWatchAlarm_ni (hBSP430timerAlarm alarm);
+
+/** Stop accounting for an alarm registered with
+ * iBSP430uptimeIdleWatchAlarm_ni().
+ *
+ * @return 0 on success, -1 if @p alarm was not watched.
+ *
+ * @dependency #configBSP430_UPTIME_IDLE */
+int iBSP430uptimeIdleUnwatchAlarm_ni (hBSP430timerAlarm alarm);
+
+/** Determine the deepest safe low power mode level for a sleep that
+ * should end no later than @p wake_utt.
+ *
+ * The result is the shallowest of #BSP430_UPTIME_IDLE_DEEPEST_LEVEL,
+ * any outstanding holds, the registered constraints, and the limits
+ * imposed by watched alarms and @p wake_utt.
+ *
+ * @param wake_utt the uptime at which the caller will wake.
+ *
+ * @dependency #configBSP430_UPTIME_IDLE */
+int iBSP430uptimeIdleLevel_ni (unsigned long wake_utt);
+
+/** Sleep until @p wake_utt in the deepest safe low power mode.
+ *
+ * This is lBSP430uptimeSleepUntil() with the mode chosen by
+ * iBSP430uptimeIdleLevel_ni().
+ *
+ * @blocking
+ *
+ * @return as with lBSP430uptimeSleepUntil().
+ *
+ * @dependency #configBSP430_UPTIME_IDLE */
+long lBSP430uptimeIdleUntil (unsigned long wake_utt);
+
+/** Obtain the time spent in each low power mode.
+ *
+ * Sleeps through lBSP430uptimeSleepUntil(), including those made by
+ * lBSP430uptimeIdleUntil() and the delay macros, are recorded.
+ *
+ * @param sp where to store a copy of the residency record.
+ *
+ * @param reset if nonzero the residency record is cleared after it
+ * is copied.
+ *
+ * @dependency #configBSP430_UPTIME_IDLE */
+void vBSP430uptimeIdleResidency (sBSP430uptimeIdleResidency * sp,
+                                 int reset);
+
+#endif /* configBSP430_UPTIME_IDLE */
+
 #if defined(BSP430_DOXYGEN) || (configBSP430_UPTIME_EPOCH - 0)
 
 #include <sys/time.h>
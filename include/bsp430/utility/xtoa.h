@@ -0,0 +1,147 @@
+/* Copyright 2014, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @file
+ *
+ * @brief Integer to text conversion without division.
+ *
+ * The MSP430 has no divide instruction.  The conventional conversion
+ * of an integer to text performs one software division and one
+ * remainder operation per output digit, each costing hundreds of
+ * cycles for a 32-bit value.  The routines in this module avoid
+ * division for the radixes that matter:
+ *
+ * @li Radixes 2, 8, and 16 extract digits by shift and mask.
+ * @li Radix 10 uses a reciprocal multiplication when a hardware
+ * multiplier is present (see #configBSP430_XTOA_USE_RECIPROCAL).
+ * Values are split into four-digit groups by multiplying by the
+ * reciprocal of 10000, and each group is emitted as two entries from
+ * a table of digit pairs.  Otherwise each digit is obtained by
+ * comparing against and subtracting 8, 4, 2, and 1 times the
+ * corresponding power of ten.
+ *
+ * Other radixes fall back to division.
+ *
+ * These routines are used by cputi(), cputu(), cputl(), and
+ * cputul().  iBSP430xtoaVuprintf() is a compact formatter built on
+ * them, which supplies vcprintf() when
+ * #configBSP430_CONSOLE_XTOA_PRINTF is enabled.
+ *
+ * @homepage http://github.com/pabigot/bsp430
+ * @copyright Copyright 2014, Peter A. Bigot.  Licensed under <a href="http://www.opensource.org/licenses/BSD-3-Clause">BSD-3-Clause</a>
+ */
+
+#ifndef BSP430_UTILITY_XTOA_H
+#define BSP430_UTILITY_XTOA_H
+
+#include <bsp430/core.h>
+#include <stdarg.h>
+
+/** Define to a true value to convert decimal values by multiplying
+ * by a reciprocal rather than by repeated subtraction.
+ *
+ * The reciprocal of 10000 requires a 32x32 to 64-bit multiplication,
+ * which is fast only with the MPY32 peripheral.  On MCUs without it
+ * the subtraction method is faster.
+ *
+ * @cppflag
+ * @defaulted
+ */
+#ifndef configBSP430_XTOA_USE_RECIPROCAL
+#if defined(__MSP430_HAS_MPY32__)
+#define configBSP430_XTOA_USE_RECIPROCAL 1
+#else /* __MSP430_HAS_MPY32__ */
+#define configBSP430_XTOA_USE_RECIPROCAL 0
+#endif /* __MSP430_HAS_MPY32__ */
+#endif /* configBSP430_XTOA_USE_RECIPROCAL */
+
+/** The size of a buffer sufficient to hold any @c long value in
+ * radix 8 or higher, including the terminating NUL.  A radix 2
+ * conversion requires one octet per bit plus one. */
+#define BSP430_XTOA_LONG_BUFFER_SIZE sizeof("-2147483648")
+
+/** Convert an unsigned long value to text.
+ *
+ * @param value the value to be converted
+ *
+ * @param str where the NUL-terminated text should be stored
+ *
+ * @param radix the radix for the conversion, from 2 through 36.
+ * Digits above 9 are represented by upper-case letters.
+ *
+ * @return @p str */
+char * xBSP430xtoaULong (unsigned long value,
+                         char * str,
+                         int radix);
+
+/** Convert a long value to text.
+ *
+ * As with xBSP430xtoaULong(), except that when @p radix is 10 a
+ * negative value is preceded by a minus sign.  In other radixes the
+ * value is converted as an unsigned long. */
+char * xBSP430xtoaLong (long value,
+                        char * str,
+                        int radix);
+
+/** Convert an unsigned int value to text.
+ *
+ * As with xBSP430xtoaULong(), but using only 16-bit arithmetic. */
+char * xBSP430xtoaUInt (unsigned int value,
+                        char * str,
+                        int radix);
+
+/** Convert an int value to text.
+ *
+ * As with xBSP430xtoaLong(), but using only 16-bit arithmetic. */
+char * xBSP430xtoaInt (int value,
+                       char * str,
+                       int radix);
+
+/** Format text like vprintf(3), passing each character to a function.
+ *
+ * The supported conversions are @c d, @c i, @c u, @c o, @c x, @c X,
+ * @c c, @c s, @c p, and @c %, with flags <tt>-+ #0</tt>, field width
+ * and precision (including @c *), and length modifiers @c hh, @c h,
+ * and @c l.  Floating point and 64-bit conversions are not supported;
+ * such a conversion is emitted verbatim and formatting stops.
+ *
+ * @param emitc the function that outputs a character
+ *
+ * @param fmt the format string
+ *
+ * @param ap the arguments consumed by @p fmt
+ *
+ * @return the number of characters output */
+int iBSP430xtoaVuprintf (int (* emitc) (int c),
+                         const char * fmt,
+                         va_list ap);
+
+#endif /* BSP430_UTILITY_XTOA_H */
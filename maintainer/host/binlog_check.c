@@ -0,0 +1,221 @@
+/* This file is in the public domain.
+ *
+ * Check the records emitted by bsp430/utility/binlog.h.
+ *
+ * Each message is logged with console output captured in memory, and
+ * the record is compared with the expected encoding.  The cases cover
+ * each conversion, a null string, truncation of a long string, and a
+ * record that is discarded because it does not fit in
+ * #BSP430_BINLOG_RECORD_LENGTH.
+ *
+ * Built with a nonzero #BSP430_BINLOG_CHANMUX_ID the captured output
+ * must instead be a single chanmux frame on that channel, which is
+ * decoded and its payload compared with the expected record.
+ *
+ * Exits with a nonzero status if any check fails.
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/binlog.h>
+#if (BSP430_BINLOG_CHANMUX_ID - 0)
+#include <bsp430/utility/chanmux.h>
+#endif /* BSP430_BINLOG_CHANMUX_ID */
+#include "host.h"
+#include <stdlib.h>
+#include <string.h>
+
+extern const char __start_bsp430_binlog[];
+
+static char * capture;
+static size_t capture_len;
+static FILE * capture_fp;
+static unsigned int failures;
+
+#if (BSP430_BINLOG_CHANMUX_ID - 0)
+/* Replace the captured frame with its payload.  Returns zero if the
+ * capture is a single well-formed frame on the binary log channel. */
+static int
+unframe (void)
+{
+  uint8_t * const bp = (uint8_t *)capture;
+  uint8_t * dp = bp;
+  size_t i = 1;
+  uint16_t crc = 0xFFFF;
+
+  if ((3 + 1 + 2 + 1 > capture_len)
+      || (BSP430_CHANMUX_DELIMITER != bp[0])
+      || (BSP430_CHANMUX_DELIMITER != bp[capture_len - 1])) {
+    return -1;
+  }
+  while (i < capture_len - 1) {
+    size_t code = bp[i++];
+
+    if ((0 == code) || (capture_len - 1 < i - 1 + code)) {
+      return -1;
+    }
+    while (--code) {
+      if (0 == bp[i]) {
+        return -1;
+      }
+      *dp++ = bp[i++];
+    }
+    if (i < capture_len - 1) {
+      *dp++ = 0;
+    }
+  }
+  capture_len = dp - bp - 3;
+  for (i = 0; i < 1 + capture_len; ++i) {
+    crc = uiBSP430chanmuxCRCUpdate(crc, bp[i]);
+  }
+  if ((crc != (bp[i] | (bp[i + 1] << 8)))
+      || (BSP430_BINLOG_CHANMUX_ID != bp[0])) {
+    return -1;
+  }
+  memmove(bp, bp + 1, capture_len);
+  return 0;
+}
+#endif /* BSP430_BINLOG_CHANMUX_ID */
+
+static void
+begin (void)
+{
+  capture_fp = open_memstream(&capture, &capture_len);
+  vBSP430hostSetConsole(capture_fp);
+}
+
+/* Compare the captured output with a record for fmt followed by the
+ * encoded arguments in body. */
+static void
+end (int line,
+     int rv,
+     const char * fmt,
+     const uint8_t * body,
+     size_t body_len)
+{
+  uint8_t expect[BSP430_BINLOG_RECORD_LENGTH + 16];
+  size_t len = 0;
+  unsigned long ofs = fmt - __start_bsp430_binlog;
+
+  fclose(capture_fp);
+  vBSP430hostSetConsole(stdout);
+#if (BSP430_BINLOG_CHANMUX_ID - 0)
+  {
+    size_t frame_len = capture_len;
+
+    if (0 != unframe()) {
+      printf("binlog_check.c:%d: malformed frame\n", line);
+      ++failures;
+    }
+    if (rv == (int)frame_len) {
+      rv = capture_len;
+    }
+  }
+#endif /* BSP430_BINLOG_CHANMUX_ID */
+  expect[len++] = BSP430_BINLOG_RECORD_MARKER;
+  while (0x80 <= ofs) {
+    expect[len++] = 0x80 | (uint8_t)ofs;
+    ofs >>= 7;
+  }
+  expect[len++] = (uint8_t)ofs;
+  memcpy(expect + len, body, body_len);
+  len += body_len;
+  if ((rv != (int)len) || (capture_len != len) || memcmp(capture, expect, len)) {
+    size_t i;
+
+    printf("binlog_check.c:%d: rv %d, captured", line, rv);
+    for (i = 0; i < capture_len; ++i) {
+      printf(" %02x", (uint8_t)capture[i]);
+    }
+    printf("; expected");
+    for (i = 0; i < len; ++i) {
+      printf(" %02x", expect[i]);
+    }
+    putchar('\n');
+    ++failures;
+  }
+  free(capture);
+}
+
+#define CHECK_RECORD(body_, fmt_, ...) do {                             \
+    static const char BSP430_BINLOG_SECTION binlog_fmt_[] = fmt_;       \
+    static const uint8_t body[] = body_;                                \
+    int rv;                                                             \
+    begin();                                                            \
+    rv = iBSP430binlog(binlog_fmt_, ##__VA_ARGS__);                     \
+    end(__LINE__, rv, binlog_fmt_, body, sizeof(body));                 \
+  } while (0)
+
+#define CHECK_DISCARD(fmt_, ...) do {                                   \
+    static const char BSP430_BINLOG_SECTION binlog_fmt_[] = fmt_;       \
+    int rv;                                                             \
+    begin();                                                            \
+    rv = iBSP430binlog(binlog_fmt_, ##__VA_ARGS__);                     \
+    fclose(capture_fp);                                                 \
+    vBSP430hostSetConsole(stdout);                                      \
+    if ((-1 != rv) || (0 != capture_len)) {                             \
+      printf("binlog_check.c:%d: rv %d with %u octets, expected discard\n", \
+             __LINE__, rv, (unsigned int)capture_len);                  \
+      ++failures;                                                       \
+    }                                                                   \
+    free(capture);                                                      \
+  } while (0)
+
+#define BYTES(...) { __VA_ARGS__ }
+
+int
+main (void)
+{
+  char longtext[2 * BSP430_BINLOG_RECORD_LENGTH];
+
+#if (0x80 <= BSP430_BINLOG_RECORD_LENGTH)
+#error Checks assume string lengths encode in one octet
+#endif
+  uint8_t body[BSP430_BINLOG_RECORD_LENGTH];
+  unsigned long ofs;
+  size_t hdr_len;
+  size_t n;
+
+  CHECK_RECORD(BYTES('a'), "one argument %c\n", 'a');
+  CHECK_RECORD(BYTES(5, 0x80, 0x01, 0xff, 0x7f), "%d %u %x\n", -3, 128u, 0x3fff);
+  CHECK_RECORD(BYTES(0x01, 0x05, 'Z', 0x10), "%ld %lu %c %p\n", -1L, 5UL, 'Z', (void *)0x10);
+  CHECK_RECORD(BYTES(0x0c, 0x03), "%*d|\n", 6, -2);
+  CHECK_RECORD(BYTES(2, 'o', 'k', 0), "%s %s.\n", "ok", "");
+  {
+    const char * volatile null_string = NULL;
+
+    CHECK_RECORD(BYTES(0, 0x2a), "%s %d\n", null_string, 21);
+  }
+  CHECK_RECORD(BYTES(0x03, 0x02), "%lld %% %hhu\n", -2LL, 2);
+  CHECK_RECORD(BYTES(0x04), "%u %f\n", 4u, 1.5);
+
+  /* A long string is truncated to fill the record */
+  memset(longtext, 'x', sizeof(longtext) - 1);
+  longtext[sizeof(longtext) - 1] = 0;
+  {
+    static const char BSP430_BINLOG_SECTION fmt[] = "[%s]\n";
+    int rv;
+
+    ofs = fmt - __start_bsp430_binlog;
+    for (hdr_len = 2; 0x80 <= ofs; ofs >>= 7) {
+      ++hdr_len;
+    }
+    /* The length takes one octet in a record this short */
+    n = BSP430_BINLOG_RECORD_LENGTH - hdr_len - 2;
+    body[0] = (uint8_t)n;
+    memset(body + 1, 'x', n);
+    ++n;
+    begin();
+    rv = iBSP430binlog(fmt, longtext);
+    end(__LINE__, rv, fmt, body, n);
+  }
+
+  /* No room remains for the value after a truncated string */
+  CHECK_DISCARD("%s %lu\n", longtext, 300UL);
+
+  if (failures) {
+    printf("binlog: %u failures\n", failures);
+    return 1;
+  }
+  printf("binlog: all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,94 @@
+/* This file is in the public domain.
+ *
+ * Host counterpart of examples/utility/cli_bench: report operations
+ * per second for command execution and completion in the command
+ * line engine of bsp430/utility/cli.h.
+ *
+ * Usage: cli_bench [repetitions]
+ *
+ * The absolute rates say nothing about an MSP430, but the relative
+ * cost of each operation tracks the on-target benchmark and is useful
+ * for evaluating changes to parsing and dispatch without hardware.
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/cli.h>
+#include "host.h"
+#include "cli_commands.h"
+#include <stdlib.h>
+
+static const char * const commands[] = {
+  "help",
+  "show data",
+  "sh cl",
+  "set ival -1234",
+  "set ulval 0x12345678",
+  "set lval 1.5M",
+  "tokens one 'two three' \"four\"",
+};
+
+static const char * const completions[] = {
+  "",
+  "s",
+  "show c",
+  "set u",
+  "set ulval",
+};
+
+static void
+display (const char * label,
+         double elapsed,
+         unsigned long repetitions)
+{
+  printf("%-34s: %8.1f ns, %10.0f per second\n", label,
+         1e9 * elapsed / repetitions, repetitions / elapsed);
+}
+
+int
+main (int argc,
+      char * argv[])
+{
+  unsigned long repetitions = 1000000;
+  unsigned int i;
+
+  if (1 < argc) {
+    repetitions = strtoul(argv[1], NULL, 0);
+  }
+  vBSP430hostSetConsole(NULL);
+  printf("Averaged over %lu repetitions\n", repetitions);
+  for (i = 0; i < sizeof(commands) / sizeof(*commands); ++i) {
+    unsigned long n;
+    int rv = 0;
+    double t0 = dBSP430hostTime();
+
+    for (n = 0; n < repetitions; ++n) {
+      rv = iBSP430cliExecuteCommand(LAST_COMMAND, NULL, commands[i]);
+    }
+    if (0 > rv) {
+      printf("%-34s: error %d\n", commands[i], rv);
+      continue;
+    }
+    display(commands[i], dBSP430hostTime() - t0, repetitions);
+  }
+  for (i = 0; i < sizeof(completions) / sizeof(*completions); ++i) {
+    const char * cands[4];
+    char label[40];
+    sBSP430cliCompletionData ccd;
+    unsigned long n;
+    double t0;
+
+    memset(&ccd, 0, sizeof(ccd));
+    ccd.command_set = LAST_COMMAND;
+    ccd.returned_candidates = cands;
+    ccd.max_returned_candidates = sizeof(cands) / sizeof(*cands);
+    t0 = dBSP430hostTime();
+    for (n = 0; n < repetitions; ++n) {
+      ccd.command = completions[i];
+      (void)iBSP430cliCommandCompletion(&ccd);
+    }
+    snprintf(label, sizeof(label), "complete %-12s %u candidates",
+             completions[i], (unsigned int)ccd.ncandidates);
+    display(label, dBSP430hostTime() - t0, repetitions);
+  }
+  return 0;
+}
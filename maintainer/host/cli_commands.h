@@ -0,0 +1,139 @@
+/* This file is in the public domain.
+ *
+ * Command set shared by the host CLI fuzz driver and benchmark.  It
+ * mirrors the one in examples/utility/cli_bench: nested subcommands,
+ * integer store handlers, a handler that extracts quoted tokens, and
+ * a completion helper.  No handler produces output.
+ */
+
+#ifndef CLI_COMMANDS_H
+#define CLI_COMMANDS_H
+
+#include <bsp430/utility/cli.h>
+#include <string.h>
+
+static struct {
+  int ival;
+  unsigned int uival;
+  long lval;
+  unsigned long ulval;
+} data;
+
+static int
+cmd_noop (const char * argstr)
+{
+  return 0;
+}
+
+static int
+cmd_tokens (const char * argstr)
+{
+  size_t arglen = strlen(argstr);
+  size_t len;
+  int ntokens = 0;
+
+  while (0 < arglen) {
+    (void)xBSP430cliNextQToken(&argstr, &arglen, &len);
+    ntokens += (0 < len);
+  }
+  return ntokens;
+}
+
+#define LAST_COMMAND NULL
+
+static const sBSP430cliCommand dcmd_set_ival = {
+  .key = "ival",
+  .handler = iBSP430cliHandlerStoreI,
+  .param.ptr = &data.ival
+};
+static const sBSP430cliCommand dcmd_set_uival = {
+  .key = "uival",
+  .next = &dcmd_set_ival,
+  .handler = iBSP430cliHandlerStoreUI,
+  .param.ptr = &data.uival
+};
+static const sBSP430cliCommand dcmd_set_lval = {
+  .key = "lval",
+  .next = &dcmd_set_uival,
+  .handler = iBSP430cliHandlerStoreL,
+  .param.ptr = &data.lval
+};
+static const sBSP430cliCommand dcmd_set_ulval = {
+  .key = "ulval",
+  .next = &dcmd_set_lval,
+  .handler = iBSP430cliHandlerStoreUL,
+  .param.ptr = &data.ulval
+};
+static const sBSP430cliCommand dcmd_set = {
+  .key = "set",
+  .child = &dcmd_set_ulval,
+  .next = LAST_COMMAND,
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_set
+
+static const sBSP430cliCommand dcmd_show_data = {
+  .key = "data",
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_noop
+};
+static const sBSP430cliCommand dcmd_show_clocks = {
+  .key = "clocks",
+  .next = &dcmd_show_data,
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_noop
+};
+static const sBSP430cliCommand dcmd_show_config = {
+  .key = "config",
+  .next = &dcmd_show_clocks,
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_noop
+};
+static const sBSP430cliCommand dcmd_show = {
+  .key = "show",
+  .child = &dcmd_show_config,
+  .next = LAST_COMMAND,
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_show
+
+static const char * const numbers[] = {
+  "zero",
+  "one",
+  "two",
+  "three"
+};
+static const sBSP430cliCompletionHelperStrings completion_helper_say = {
+  .completion_helper = { .helper = vBSP430cliCompletionHelperStrings },
+  .strings = numbers,
+  .len = sizeof(numbers) / sizeof(*numbers)
+};
+static const sBSP430cliCommand dcmd_say = {
+  .key = "say",
+  .completion_helper = &completion_helper_say.completion_helper,
+  .next = LAST_COMMAND,
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_say
+
+static const sBSP430cliCommand dcmd_tokens = {
+  .key = "tokens",
+  .next = LAST_COMMAND,
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_tokens
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_tokens
+
+static const sBSP430cliCommand dcmd_help = {
+  .key = "help",
+  .next = LAST_COMMAND,
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_noop
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_help
+
+#endif /* CLI_COMMANDS_H */
@@ -0,0 +1,178 @@
+/* This file is in the public domain.
+ *
+ * Fuzz target for the command line engine in bsp430/utility/cli.h.
+ *
+ * Each input is presented to the tokenizers, command completion,
+ * command execution, script execution, and the numeric parsers.  A
+ * violated invariant aborts, which both libFuzzer and AFL report as a
+ * crash; memory errors are caught by building with AddressSanitizer.
+ *
+ * Built with -fsanitize=fuzzer the file provides only
+ * LLVMFuzzerTestOneInput().  Otherwise it also provides main(),
+ * which runs each file named on the command line, or standard input
+ * if there are none, through the same checks.  That form serves as an
+ * AFL target and for replaying crash inputs.
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/cli.h>
+#include "host.h"
+#include "cli_commands.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_INPUT 256
+
+#define CHECK(expr_) do {                                               \
+    if (! (expr_)) {                                                    \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr_); \
+      abort();                                                          \
+    }                                                                   \
+  } while (0)
+
+/* Every token must lie within the input, the cursor must advance and
+ * stay consistent with the remaining length, and unquoted tokens must
+ * not contain whitespace. */
+static void
+check_tokens (const char * text,
+              size_t text_len,
+              int quoted)
+{
+  const char * const end = text + text_len;
+  const char * cp = text;
+  size_t remaining = text_len;
+
+  while (0 < remaining) {
+    const char * last_cp = cp;
+    const char * tp;
+    size_t len;
+    size_t i;
+
+    if (quoted) {
+      tp = xBSP430cliNextQToken(&cp, &remaining, &len);
+    } else {
+      tp = xBSP430cliNextToken(&cp, &remaining, &len);
+      for (i = 0; i < len; ++i) {
+        CHECK(! isspace((unsigned char)tp[i]));
+      }
+    }
+    CHECK((text <= tp) && ((tp + len) <= end));
+    CHECK((last_cp < cp) && (cp <= end));
+    CHECK(remaining == (size_t)(end - cp));
+  }
+}
+
+/* Completion must return only the candidates it counted, and any
+ * append text must belong to a candidate. */
+static void
+check_completion (const char * text)
+{
+  const char * cands[5];
+  sBSP430cliCompletionData ccd;
+  size_t i;
+
+  memset(&ccd, 0, sizeof(ccd));
+  memset(cands, 0, sizeof(cands));
+  ccd.command = text;
+  ccd.command_set = LAST_COMMAND;
+  ccd.returned_candidates = cands;
+  ccd.max_returned_candidates = sizeof(cands) / sizeof(*cands);
+  (void)iBSP430cliCommandCompletion(&ccd);
+  for (i = 0; i < ccd.max_returned_candidates; ++i) {
+    CHECK((i < ccd.ncandidates) == (NULL != cands[i]));
+  }
+  if (NULL != ccd.append) {
+    CHECK(0 < ccd.ncandidates);
+    CHECK(ccd.append_len <= strlen(ccd.append));
+  }
+}
+
+/* A parser that accepts text must produce a value that survives a
+ * round trip through the C library. */
+static void
+check_parsers (const char * text,
+               size_t len)
+{
+  char buffer[32];
+  unsigned long ul;
+  long l;
+  long l2;
+
+  if (0 == iBSP430cliParseUL(text, len, &ul)) {
+    snprintf(buffer, sizeof(buffer), "%lu", ul);
+    CHECK(0 == iBSP430cliParseUL(buffer, strlen(buffer), &ul));
+    CHECK(ul == strtoul(buffer, NULL, 10));
+  }
+  if (0 == iBSP430cliParseL(text, len, &l)) {
+    snprintf(buffer, sizeof(buffer), "%ld", l);
+    CHECK(0 == iBSP430cliParseL(buffer, strlen(buffer), &l2));
+    CHECK(l == l2);
+  }
+}
+
+int
+LLVMFuzzerTestOneInput (const uint8_t * data,
+                        size_t size)
+{
+  char text[MAX_INPUT + 1];
+  int rv;
+
+  if (MAX_INPUT < size) {
+    size = MAX_INPUT;
+  }
+  vBSP430hostSetConsole(NULL);
+  vBSP430cliSetDiagnosticFunction(iBSP430cliNullDiagnostic);
+
+  /* The script interface takes counted text that may contain NULs */
+  rv = iBSP430cliExecuteScript(LAST_COMMAND, NULL, (const char *)data, size,
+                               BSP430_CLI_SCRIPT_CONTINUE, NULL);
+  CHECK((0 <= rv) || (-eBSP430_CLIERRORTYPES < rv));
+
+  /* The remaining interfaces see the text up to the first NUL */
+  memcpy(text, data, size);
+  text[size] = 0;
+  size = strlen(text);
+  check_tokens(text, size, 0);
+  check_tokens(text, size, 1);
+  check_completion(text);
+  check_parsers(text, size);
+  rv = iBSP430cliExecuteCommand(LAST_COMMAND, NULL, text);
+  CHECK((0 <= rv) || (-eBSP430_CLIERRORTYPES < rv));
+  return 0;
+}
+
+#ifndef BSP430_HOST_LIBFUZZER
+
+static int
+run_stream (FILE * fp)
+{
+  uint8_t data[MAX_INPUT];
+  size_t len = fread(data, 1, sizeof(data), fp);
+
+  return LLVMFuzzerTestOneInput(data, len);
+}
+
+int
+main (int argc,
+      char * argv[])
+{
+  int i;
+
+  if (1 == argc) {
+    return run_stream(stdin);
+  }
+  for (i = 1; i < argc; ++i) {
+    FILE * fp = fopen(argv[i], "rb");
+
+    if (NULL == fp) {
+      perror(argv[i]);
+      return 1;
+    }
+    (void)run_stream(fp);
+    fclose(fp);
+  }
+  return 0;
+}
+
+#endif /* BSP430_HOST_LIBFUZZER */
@@ -0,0 +1,141 @@
+/* This file is in the public domain.
+ *
+ * Check the iBSP430cliParse family from bsp430/utility/cli.h.
+ *
+ * The documented examples are checked for their stated results, and
+ * random decimal, hexadecimal, and octal text is compared with
+ * strtoul() and strtol().  On the host long has the width of the
+ * host, so range limits are checked against its own LONG_MAX and
+ * ULONG_MAX; the 16- and 32-bit limits of the MCU are covered by
+ * examples/utility/cli_unittest.
+ *
+ * Exits with a nonzero status if any check fails.
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/cli.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static unsigned int failures;
+
+#define CHECK(expr_) do {                                               \
+    if (! (expr_)) {                                                    \
+      if (20 > failures++) {                                            \
+        printf("cli_parse_check.c:%d: %s\n", __LINE__, #expr_);         \
+      }                                                                 \
+    }                                                                   \
+  } while (0)
+
+static int
+parse_ul (const char * text,
+          unsigned long * vp)
+{
+  return iBSP430cliParseUL(text, strlen(text), vp);
+}
+
+static int
+parse_l (const char * text,
+         long * vp)
+{
+  return iBSP430cliParseL(text, strlen(text), vp);
+}
+
+static int
+parse_fixed (const char * text,
+             unsigned int frac_digits,
+             long * vp)
+{
+  return iBSP430cliParseFixed(text, strlen(text), frac_digits, vp);
+}
+
+int
+main (void)
+{
+  char text[80];
+  unsigned long ul;
+  long l;
+  int n;
+
+  /* Syntax from the iBSP430cliParseUL() documentation */
+  CHECK((0 == parse_ul("0", &ul)) && (0 == ul));
+  CHECK((0 == parse_ul("-0", &ul)) && (0 == ul));
+  CHECK((0 == parse_ul("+7", &ul)) && (7 == ul));
+  CHECK(-eBSP430_CLI_ERR_Range == parse_ul("-1", &ul));
+  CHECK((0 == parse_l("-1", &l)) && (-1 == l));
+  CHECK((0 == parse_ul("0x1F", &ul)) && (31 == ul));
+  CHECK((0 == parse_ul("0X1f", &ul)) && (31 == ul));
+  CHECK((0 == parse_ul("017", &ul)) && (15 == ul));
+  CHECK((0 == parse_ul("0b101", &ul)) && (5 == ul));
+  CHECK((0 == parse_ul("1.5k", &ul)) && (1500 == ul));
+  CHECK((0 == parse_ul("0x10k", &ul)) && (16000 == ul));
+  CHECK((0 == parse_ul("2M", &ul)) && (2000000 == ul));
+  CHECK((0 == parse_ul("1.000", &ul)) && (1 == ul));
+  CHECK((0 == parse_ul("1.500k", &ul)) && (1500 == ul));
+  CHECK(0 != parse_ul("1.5001k", &ul));
+  CHECK((0 == parse_l("-2.5k", &l)) && (-2500 == l));
+  CHECK(0 != parse_ul("2.5", &ul));
+  CHECK(0 != parse_ul("08", &ul));
+  CHECK(0 != parse_ul("0b", &ul));
+  CHECK(0 != parse_ul("0x", &ul));
+  CHECK(0 != parse_ul("k", &ul));
+  CHECK(0 != parse_ul("-", &ul));
+  CHECK(0 != parse_ul("1e3", &ul));
+  CHECK(0 != parse_ul("12a", &ul));
+  CHECK(0 != parse_ul(".", &ul));
+  CHECK(0 != parse_ul("", &ul));
+
+  /* Examples from the iBSP430cliParseFixed() documentation */
+  CHECK((0 == parse_fixed("1.25", 3, &l)) && (1250 == l));
+  CHECK((0 == parse_fixed("0.5k", 3, &l)) && (500000 == l));
+  CHECK((0 == parse_fixed("-2.5", 1, &l)) && (-25 == l));
+  CHECK((0 == parse_fixed("0.0010", 3, &l)) && (1 == l));
+  CHECK(0 != parse_fixed("0.0001", 3, &l));
+  CHECK(0 != parse_fixed("-2m", 3, &l));
+
+  /* The limits of the destination type */
+  snprintf(text, sizeof(text), "%lu", ULONG_MAX);
+  CHECK((0 == parse_ul(text, &ul)) && (ULONG_MAX == ul));
+  strcat(text, "0");
+  CHECK(-eBSP430_CLI_ERR_Range == parse_ul(text, &ul));
+  snprintf(text, sizeof(text), "0x%lx0", ULONG_MAX);
+  CHECK(-eBSP430_CLI_ERR_Range == parse_ul(text, &ul));
+  snprintf(text, sizeof(text), "%luk", ULONG_MAX / 100);
+  CHECK(-eBSP430_CLI_ERR_Range == parse_ul(text, &ul));
+  snprintf(text, sizeof(text), "%ld", LONG_MAX);
+  CHECK((0 == parse_l(text, &l)) && (LONG_MAX == l));
+  snprintf(text, sizeof(text), "%ld", LONG_MIN);
+  CHECK((0 == parse_l(text, &l)) && (LONG_MIN == l));
+  snprintf(text, sizeof(text), "%lu", (unsigned long)LONG_MAX + 1);
+  CHECK(-eBSP430_CLI_ERR_Range == parse_l(text, &l));
+  snprintf(text, sizeof(text), "-%lu", (unsigned long)LONG_MAX + 2);
+  CHECK(-eBSP430_CLI_ERR_Range == parse_l(text, &l));
+
+  /* Differential against the C library */
+  srand(1);
+  for (n = 0; n < 200000; ++n) {
+    unsigned long v = ((unsigned long)rand() << 33) ^ ((unsigned long)rand() << 10) ^ rand();
+    int form = rand() % 3;
+
+    v >>= rand() % (8 * sizeof(v));
+    if (0 == form) {
+      snprintf(text, sizeof(text), "%lu", v);
+    } else if (1 == form) {
+      snprintf(text, sizeof(text), "0x%lx", v);
+    } else {
+      snprintf(text, sizeof(text), "0%lo", v);
+    }
+    CHECK((0 == parse_ul(text, &ul)) && (strtoul(text, NULL, 0) == ul));
+    snprintf(text, sizeof(text), "%ld", (long)v);
+    CHECK((0 == parse_l(text, &l)) && (strtol(text, NULL, 0) == l));
+  }
+
+  if (failures) {
+    printf("cli_parse: %u failures\n", failures);
+    return 1;
+  }
+  printf("cli_parse: all checks passed\n");
+  return 0;
+}
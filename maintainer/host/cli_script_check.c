@@ -0,0 +1,137 @@
+/* This file is in the public domain.
+ *
+ * Check how iBSP430cliExecuteScript() divides a script into commands.
+ *
+ * The echo command is a simple handler, which sees only its argument
+ * string up to a NUL, so each check also confirms that a command's
+ * handler does not see the rest of the script.  Each argument is
+ * recorded without leading space and followed by a vertical bar.
+ *
+ * Exits with a nonzero status if any check fails.
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/cli.h>
+#include "host.h"
+#include <stdio.h>
+#include <string.h>
+
+static char log_text[256];
+static unsigned int failures;
+
+static int
+cmd_echo (const char * argstr)
+{
+  while (' ' == *argstr) {
+    ++argstr;
+  }
+  strcat(log_text, argstr);
+  strcat(log_text, "|");
+  return 0;
+}
+
+static int
+cmd_fail (const char * argstr)
+{
+  strcat(log_text, "fail|");
+  return -1;
+}
+
+#define LAST_COMMAND NULL
+static const sBSP430cliCommand dcmd_echo = {
+  .key = "echo",
+  .next = LAST_COMMAND,
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_echo
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_echo
+static const sBSP430cliCommand dcmd_fail = {
+  .key = "fail",
+  .next = LAST_COMMAND,
+  .handler = iBSP430cliHandlerSimple,
+  .param.simple_handler = cmd_fail
+};
+#undef LAST_COMMAND
+#define LAST_COMMAND &dcmd_fail
+
+static void
+check_script (int line,
+              const char * script,
+              size_t script_len,
+              unsigned int flags,
+              int expected_rv,
+              const char * expected_log)
+{
+  int rv;
+
+  log_text[0] = 0;
+  rv = iBSP430cliExecuteScript(LAST_COMMAND, NULL, script, script_len, flags, NULL);
+  if ((expected_rv != rv) || (0 != strcmp(expected_log, log_text))) {
+    ++failures;
+    printf("cli_script_check.c:%d: got %d \"%s\", expected %d \"%s\"\n",
+           line, rv, log_text, expected_rv, expected_log);
+  }
+}
+
+#define CHECK_SCRIPT(script_, flags_, rv_, log_) \
+  check_script(__LINE__, script_, strlen(script_), flags_, rv_, log_)
+
+int
+main (void)
+{
+  static const char with_nul[] = "echo a\0echo b";
+  char long_command[BSP430_CLI_SCRIPT_COMMAND_LENGTH + 16];
+
+  vBSP430hostSetConsole(NULL);
+  vBSP430cliSetDiagnosticFunction(iBSP430cliNullDiagnostic);
+
+  /* Separators, empty commands, comments, and surrounding space */
+  CHECK_SCRIPT("echo a; echo b\necho c", 0, 3, "a|b|c|");
+  CHECK_SCRIPT(" ;; \n\t echo a  ;\n\n", 0, 1, "a|");
+  CHECK_SCRIPT("# echo a; echo b\necho c # d", 0, 1, "c # d|");
+
+  /* Each handler sees only its own command */
+  CHECK_SCRIPT("echo one two; echo three", 0, 2, "one two|three|");
+
+  /* Quoted tokens hold separators */
+  CHECK_SCRIPT("echo 'a; b'; echo c", 0, 2, "'a; b'|c|");
+  CHECK_SCRIPT("echo x \"a;b\";echo c", 0, 2, "x \"a;b\"|c|");
+  CHECK_SCRIPT("echo 'a;b';echo c", 0, 2, "'a;b'|c|");
+
+  /* A quote within a word is an ordinary character */
+  CHECK_SCRIPT("echo don't; echo reset", 0, 2, "don't|reset|");
+  CHECK_SCRIPT("echo x'y; echo z'", 0, 2, "x'y|z'|");
+
+  /* A quoted token must end within the line and be followed by space */
+  CHECK_SCRIPT("echo 'abc; echo d", 0, 2, "'abc|d|");
+  CHECK_SCRIPT("echo 'a\necho b'", 0, 2, "'a|b'|");
+  CHECK_SCRIPT("echo 'a'b; echo c", 0, 2, "'a'b|c|");
+
+  /* Errors stop the script unless continuing was requested */
+  CHECK_SCRIPT("echo a; fail; echo b", 0, -1, "a|fail|");
+  CHECK_SCRIPT("echo a; fail; echo b", BSP430_CLI_SCRIPT_CONTINUE, -1, "a|fail|b|");
+  CHECK_SCRIPT("echo a; nosuch; echo b", BSP430_CLI_SCRIPT_CONTINUE,
+               -eBSP430_CLI_ERR_Unrecognized, "a|b|");
+
+  /* The script ends at its length or at a NUL */
+  check_script(__LINE__, "echo abc; echo d", 7, 0, 1, "ab|");
+  check_script(__LINE__, with_nul, sizeof(with_nul) - 1, 0, 1, "a|");
+
+  /* A command that does not fit the copy is rejected */
+  memset(long_command, 'x', sizeof(long_command));
+  memcpy(long_command, "echo ", 5);
+  strcpy(long_command + BSP430_CLI_SCRIPT_COMMAND_LENGTH, "|");
+  check_script(__LINE__, long_command, BSP430_CLI_SCRIPT_COMMAND_LENGTH, 0, 1, long_command + 5);
+  memset(long_command, 'x', sizeof(long_command));
+  memcpy(long_command, "echo ", 5);
+  strcpy(long_command + BSP430_CLI_SCRIPT_COMMAND_LENGTH + 1, "; echo y");
+  CHECK_SCRIPT(long_command, BSP430_CLI_SCRIPT_CONTINUE, -eBSP430_CLI_ERR_Invalid, "y|");
+
+  if (failures) {
+    printf("cli_script: %u failures\n", failures);
+    return 1;
+  }
+  printf("cli_script: all checks passed\n");
+  return 0;
+}
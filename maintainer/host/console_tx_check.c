@@ -0,0 +1,530 @@
+/* This file is in the public domain.
+ *
+ * Check buffered console transmission in src/utility/console.c
+ * against a simulated UART and, when built with
+ * #configBSP430_CONSOLE_TX_DMA, a simulated DMA channel.
+ *
+ * The simulation advances one character time per step.  The UART
+ * moves its transmit buffer to the shift register and raises its
+ * transmit flag; the channel copies an octet to the transmit buffer
+ * on the rising edge of the flag or on a software request, and
+ * interrupts at the end of each span.  Steps are taken between
+ * console calls and whenever the console sleeps, with interrupts
+ * enabled.
+ *
+ * Text and descriptors of random lengths are written with random
+ * pauses, followed by one descriptor longer than a DMA transfer can
+ * be.  The transmitted octets must match what was written, with no
+ * octet written to a full transmit buffer.  Each DMA span must lie
+ * within one descriptor or within the transmit buffer storage, must
+ * continue from where the previous span of the same source ended, and
+ * may wrap only at the end of the storage.  The interrupts taken per
+ * KiB transmitted are reported.
+ *
+ * Exits with a nonzero status if any check fails.
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/console.h>
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+#include <bsp430/periph/dma.h>
+#endif /* configBSP430_CONSOLE_TX_DMA */
+#include "host.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Octets written by the random phase */
+#define RANDOM_OCTETS 200000UL
+
+/* Length of the descriptor that exceeds the DMA size register */
+#define LONG_OCTETS 70000U
+
+/* Steps a sleeping console may take without being woken before the
+ * simulation is deemed stalled */
+#define STALL_STEPS 100000UL
+
+#define NUM_DESCRIPTORS 4
+#define DESCRIPTOR_LENGTH 300
+
+static unsigned int failures;
+
+#define FAIL(...) do {                          \
+    printf(__VA_ARGS__);                        \
+    putchar('\n');                              \
+    ++failures;                                 \
+  } while (0)
+
+static uint8_t expected[RANDOM_OCTETS + LONG_OCTETS + 2 * DESCRIPTOR_LENGTH];
+static unsigned long expected_len;
+static unsigned long received_len;
+static unsigned long interrupts;
+static unsigned long seed = 1;
+
+/* The last descriptor is the long one */
+static sBSP430consoleTxDescriptor descriptors[NUM_DESCRIPTORS + 1];
+static uint8_t descriptor_data[NUM_DESCRIPTORS][DESCRIPTOR_LENGTH];
+static uint8_t long_data[LONG_OCTETS];
+
+static unsigned int
+next_random (unsigned int limit)
+{
+  seed = seed * 1103515245UL + 12345;
+  return (seed >> 16) % limit;
+}
+
+/* Simulated UART.  The transmit flag is set when the transmit buffer
+ * moves to the shift register and cleared when the buffer is
+ * written. */
+static sBSP430hplUSCI5 uart_hpl;
+static sBSP430halSERIAL uart_hal = {
+  .hal_state = { .cflags = BSP430_SERIAL_HAL_HPL_VARIANT_USCI5 },
+  .hpl = { .usci5 = &uart_hpl },
+};
+static int txbuf_full;
+static int shift_busy;
+static uint8_t shift_octet;
+
+static void
+uart_update_busy (void)
+{
+  if (txbuf_full || shift_busy) {
+    uart_hpl.stat |= UCBUSY;
+  } else {
+    uart_hpl.stat &= ~UCBUSY;
+  }
+}
+
+static void
+uart_write (uint8_t c)
+{
+  if (txbuf_full) {
+    FAIL("octet %lu written to a full transmit buffer", received_len);
+  }
+  uart_hpl.txbuf = c;
+  uart_hpl.ifg &= ~UCTXIFG;
+  txbuf_full = 1;
+  uart_update_busy();
+}
+
+static void
+uart_emit (uint8_t c)
+{
+  if ((received_len >= expected_len) || (expected[received_len] != c)) {
+    FAIL("octet %lu: received %02x", received_len, c);
+    exit(1);
+  }
+  ++received_len;
+}
+
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+
+static const sBSP430halISRIndexedChainNode * dma_cbchain[BSP430_DMA_NUM_CHANNELS];
+static sBSP430hplDMA dma_hpl;
+sBSP430halDMA xBSP430hal_DMA_ = {
+  .hpl = &dma_hpl,
+  .ch_cbchain_ni = dma_cbchain,
+};
+
+#define DMA_CH (dma_hpl.ch + BSP430_CONSOLE_TX_DMA_CHANNEL)
+
+/* Source address and size latched when a span starts */
+static const uint8_t * dma_src;
+static unsigned int dma_size;
+static int dma_active;
+
+/* Where the last span from the transmit buffer ended, and the start
+ * of the buffer storage once a wrap has shown where it is */
+static const uint8_t * ring_end;
+static const uint8_t * ring_base;
+static unsigned int ring_wraps;
+static unsigned int full_spans;
+
+/* Check the span that the channel has been enabled to transfer */
+static void
+dma_check_span (void)
+{
+  const uint8_t * sp = dma_src;
+  const uint8_t * ep = sp + dma_size;
+  int i;
+
+  if (DMA_CH->ctl & DMALEVEL) {
+    FAIL("level-sensitive trigger on the UART transmit flag");
+  }
+  if (DMA_CH->da != (uintptr_t)&uart_hpl.txbuf) {
+    FAIL("span destination is not the transmit buffer");
+  }
+  if (0xFFFF == dma_size) {
+    ++full_spans;
+  }
+  for (i = 0; i < NUM_DESCRIPTORS + 1; ++i) {
+    const sBSP430consoleTxDescriptor * dp = descriptors + i;
+
+    if ((dp->data <= sp) && (sp < dp->data + dp->len)) {
+      if (ep > dp->data + dp->len) {
+        FAIL("span of %u passes the end of a descriptor", dma_size);
+      }
+      return;
+    }
+  }
+  if (BSP430_CONSOLE_TX_BUFFER_SIZE < dma_size) {
+    FAIL("buffer span of %u exceeds the storage", dma_size);
+  }
+  if ((NULL != ring_end) && (sp != ring_end)) {
+    if (sp + BSP430_CONSOLE_TX_BUFFER_SIZE != ring_end) {
+      FAIL("buffer span starts %ld octets from the previous end", (long)(sp - ring_end));
+    } else if ((NULL != ring_base) && (sp != ring_base)) {
+      FAIL("buffer wrapped to a different start");
+    }
+    ring_base = sp;
+    ++ring_wraps;
+  }
+  if ((NULL != ring_base) && (ep > ring_base + BSP430_CONSOLE_TX_BUFFER_SIZE)) {
+    FAIL("buffer span passes the end of the storage");
+  }
+  ring_end = ep;
+}
+
+/* Copy one octet to the UART */
+static void
+dma_transfer (void)
+{
+  volatile sBSP430hplDMAchannel * chp = DMA_CH;
+
+  if (! (chp->ctl & DMAEN)) {
+    return;
+  }
+  if (! dma_active) {
+    dma_src = (const uint8_t *)(uintptr_t)chp->sa;
+    dma_size = chp->sz;
+    dma_active = 1;
+    dma_check_span();
+  }
+  uart_write(*dma_src++);
+  if (0 == --chp->sz) {
+    chp->sz = dma_size;
+    chp->ctl = (chp->ctl & ~DMAEN) | DMAIFG;
+    dma_active = 0;
+  }
+}
+
+/* Carry out a software request */
+static void
+dma_request (void)
+{
+  volatile sBSP430hplDMAchannel * chp = DMA_CH;
+
+  if (chp->ctl & DMAREQ) {
+    chp->ctl &= ~DMAREQ;
+    dma_transfer();
+  }
+}
+
+static int
+dma_isr (void)
+{
+  volatile sBSP430hplDMAchannel * chp = DMA_CH;
+  int rv = 0;
+
+  if ((DMAIE | DMAIFG) == (chp->ctl & (DMAIE | DMAIFG))) {
+    chp->ctl &= ~DMAIFG;
+    ++interrupts;
+    rv = iBSP430callbackInvokeISRIndexed_ni(BSP430_CONSOLE_TX_DMA_CHANNEL + dma_cbchain, BSP430_HAL_DMA, BSP430_CONSOLE_TX_DMA_CHANNEL, rv);
+    if (rv & BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT) {
+      chp->ctl &= ~DMAIE;
+    }
+  }
+  return rv;
+}
+
+#define DMA_REQUEST() dma_request()
+#define TXIFG_RISING() dma_transfer()
+#define PERIPHERAL_ISR() dma_isr()
+
+#else /* configBSP430_CONSOLE_TX_DMA */
+
+/* The USCI5 transmit interrupt handler */
+static int
+uart_isr (void)
+{
+  int rv = 0;
+
+  if ((uart_hpl.ie & UCTXIE) && (uart_hpl.ifg & UCTXIFG)) {
+    int did_tx = 0;
+
+    ++interrupts;
+    uart_hpl.ifg &= ~UCTXIFG;
+    rv = iBSP430callbackInvokeISRVoid_ni(&uart_hal.tx_cbchain_ni, &uart_hal, 0);
+    if (rv & BSP430_HAL_ISR_CALLBACK_BREAK_CHAIN) {
+      ++uart_hal.num_tx;
+      did_tx = 1;
+      uart_write(uart_hal.tx_byte);
+    } else {
+      rv |= BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT;
+    }
+    if (rv & BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT) {
+      uart_hpl.ie &= ~UCTXIE;
+      if (! did_tx) {
+        uart_hpl.ifg |= UCTXIFG;
+      }
+    }
+  }
+  return rv;
+}
+
+#define DMA_REQUEST() do { } while (0)
+#define TXIFG_RISING() do { } while (0)
+#define PERIPHERAL_ISR() uart_isr()
+
+#endif /* configBSP430_CONSOLE_TX_DMA */
+
+/* Advance the simulation by one character time, and if interrupts
+ * are enabled run the handler for any pending interrupt.  Returns
+ * the handler flags. */
+static int
+sim_step (void)
+{
+  int rv = 0;
+
+  DMA_REQUEST();
+  if (shift_busy) {
+    uart_emit(shift_octet);
+    shift_busy = 0;
+  }
+  if (txbuf_full) {
+    shift_octet = uart_hpl.txbuf;
+    shift_busy = 1;
+    txbuf_full = 0;
+    uart_hpl.ifg |= UCTXIFG;
+    TXIFG_RISING();
+  }
+  uart_update_busy();
+  if (iBSP430hostInterruptState()) {
+    BSP430_CORE_DISABLE_INTERRUPT();
+    rv = PERIPHERAL_ISR();
+    BSP430_CORE_ENABLE_INTERRUPT();
+  }
+  return rv;
+}
+
+static void
+sim_sleep (unsigned int lpm_bits)
+{
+  unsigned long steps = 0;
+
+  while (! (sim_step() & BSP430_HAL_ISR_CALLBACK_EXIT_LPM)) {
+    if (STALL_STEPS < ++steps) {
+      FAIL("console asleep for %lu steps with %lu of %lu octets received", steps, received_len, expected_len);
+      exit(1);
+    }
+  }
+}
+
+hBSP430halSERIAL
+hBSP430serialLookup (tBSP430periphHandle periph)
+{
+  return (BSP430_CONSOLE_SERIAL_PERIPH_HANDLE == periph) ? &uart_hal : NULL;
+}
+
+hBSP430halSERIAL
+hBSP430serialOpenUART (hBSP430halSERIAL hal,
+                       unsigned char ctl0_byte,
+                       unsigned char ctl1_byte,
+                       unsigned long baud)
+{
+  uart_hpl.ifg = UCTXIFG;
+  return hal;
+}
+
+int
+iBSP430serialClose (hBSP430halSERIAL hal)
+{
+  return 0;
+}
+
+int
+iBSP430serialSetHold_rh (hBSP430halSERIAL hal,
+                         int holdp)
+{
+  return 0;
+}
+
+void
+vBSP430serialWakeupTransmit_rh (hBSP430halSERIAL hal)
+{
+  uart_hpl.ie |= UCTXIE;
+}
+
+void
+vBSP430serialFlush_ni (hBSP430halSERIAL hal)
+{
+  while (uart_hpl.stat & UCBUSY) {
+    (void)sim_step();
+  }
+}
+
+int
+iBSP430uartRxByte_rh (hBSP430halSERIAL hal)
+{
+  return -1;
+}
+
+int
+iBSP430uartTxByte_rh (hBSP430halSERIAL hal,
+                      uint8_t c)
+{
+  if (hal->tx_cbchain_ni) {
+    return -1;
+  }
+  while (! (uart_hpl.ifg & UCTXIFG)) {
+    (void)sim_step();
+  }
+  uart_write(c);
+  ++hal->num_tx;
+  return c;
+}
+
+int
+iBSP430uartTxData_rh (hBSP430halSERIAL hal,
+                      const uint8_t * data,
+                      size_t len)
+{
+  size_t i;
+
+  for (i = 0; i < len; ++i) {
+    if (0 > iBSP430uartTxByte_rh(hal, data[i])) {
+      break;
+    }
+  }
+  return i;
+}
+
+static void
+expect (const uint8_t * dp,
+        size_t len)
+{
+  memcpy(expected + expected_len, dp, len);
+  expected_len += len;
+}
+
+static void
+pause (unsigned int limit)
+{
+  unsigned int n = next_random(limit);
+
+  while (n--) {
+    (void)sim_step();
+  }
+}
+
+static void
+fill (uint8_t * dp,
+      size_t len)
+{
+  while (len--) {
+    *dp++ = next_random(256);
+  }
+}
+
+/* Wait for the console to finish, then compare the totals */
+static void
+check_drained (const char * phase,
+               unsigned long octets)
+{
+  sBSP430consoleTxStatistics stats;
+
+  (void)iBSP430consoleFlush();
+  BSP430_CORE_DISABLE_INTERRUPT();
+  (void)iBSP430consoleTxStatistics_ni(&stats, 1);
+  BSP430_CORE_ENABLE_INTERRUPT();
+  if ((received_len != expected_len) || (stats.transmitted != octets)) {
+    FAIL("%s: %lu of %lu octets received, %lu transmitted", phase, received_len, expected_len, stats.transmitted);
+  }
+  printf("%s: %lu octets, %lu interrupts, %.1f per KiB\n",
+         phase, octets, interrupts, (1024.0 * interrupts) / octets);
+  interrupts = 0;
+}
+
+static void
+write_random (void)
+{
+  uint8_t text[100];
+  unsigned long start_len = expected_len;
+
+  while (expected_len - start_len < RANDOM_OCTETS) {
+    if (0 == next_random(8)) {
+      sBSP430consoleTxDescriptor * dp = descriptors + next_random(NUM_DESCRIPTORS);
+
+      BSP430_CORE_DISABLE_INTERRUPT();
+      (void)iBSP430consoleTxDescriptorWait_ni(dp);
+      BSP430_CORE_ENABLE_INTERRUPT();
+      dp->len = 1 + next_random(DESCRIPTOR_LENGTH);
+      fill((uint8_t *)dp->data, dp->len);
+      dp->callback_ni = NULL;
+      expect(dp->data, dp->len);
+      (void)iBSP430consoleWriteDescriptors(dp, 1);
+    } else {
+      size_t len = 1 + next_random(sizeof(text));
+
+      fill(text, len);
+      expect(text, len);
+      (void)cputoctets(text, len);
+    }
+    pause(2 * BSP430_CONSOLE_TX_BUFFER_SIZE);
+  }
+  check_drained("random writes", expected_len - start_len);
+}
+
+static void
+write_long (void)
+{
+  sBSP430consoleTxDescriptor * dp = descriptors + NUM_DESCRIPTORS;
+  const uint8_t lead[] = "lead";
+  const uint8_t trail[] = "trail";
+  unsigned long start_len = expected_len;
+
+  dp->data = long_data;
+  dp->len = sizeof(long_data);
+  fill(long_data, sizeof(long_data));
+  expect(lead, sizeof(lead) - 1);
+  (void)cputoctets(lead, sizeof(lead) - 1);
+  expect(dp->data, dp->len);
+  (void)iBSP430consoleWriteDescriptors(dp, 1);
+  expect(trail, sizeof(trail) - 1);
+  (void)cputoctets(trail, sizeof(trail) - 1);
+  check_drained("long descriptor", expected_len - start_len);
+}
+
+int
+main (void)
+{
+  int i;
+
+  vBSP430platformInitialize_ni();
+  vBSP430hostSetLPMHook(sim_sleep);
+  for (i = 0; i < NUM_DESCRIPTORS; ++i) {
+    descriptors[i].data = descriptor_data[i];
+  }
+  BSP430_CORE_ENABLE_INTERRUPT();
+  if (0 != iBSP430consoleInitialize()) {
+    printf("console initialization failed\n");
+    return 1;
+  }
+  write_random();
+  write_long();
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+  if (0 == ring_wraps) {
+    FAIL("transmit buffer never wrapped");
+  }
+  if (0 == full_spans) {
+    FAIL("no span was limited by the size register");
+  }
+  printf("%u buffer wraps, %u spans of 65535 octets\n", ring_wraps, full_spans);
+#endif /* configBSP430_CONSOLE_TX_DMA */
+
+  if (failures) {
+    printf("console: %u failures\n", failures);
+    return 1;
+  }
+  printf("console: all checks passed\n");
+  return 0;
+}
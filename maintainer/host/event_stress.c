@@ -0,0 +1,235 @@
+/* This file is in the public domain.
+ *
+ * Host version of examples/unittests/event.
+ *
+ * Producers store in each record a value derived from its sequence
+ * number, so a record overwritten while the consumer was copying it
+ * is detected as inconsistent.  Every produced record must be either
+ * received intact and in order or counted in a LostEventRecord.
+ *
+ * testPreemptedDrain uses a SIGALRM handler in place of the timer
+ * overflow interrupt, with the consumer stalling after each batch so
+ * the buffer is always full.  A signal rarely lands within the copy
+ * of a single record, so on x86_64 Linux testPreemptionPoints also
+ * single-steps iBSP430eventTagGetRecords() and produces a record
+ * after each instruction in turn where interrupts are enabled.
+ */
+
+#define _GNU_SOURCE
+#include <bsp430/platform.h>
+#include <bsp430/utility/event.h>
+#include <bsp430/utility/console.h>
+#include <bsp430/utility/unittest.h>
+#include "host.h"
+#include <signal.h>
+#include <string.h>
+#include <sys/time.h>
+#if defined(__x86_64__) && defined(__linux__)
+#include <ucontext.h>
+#define HAVE_SINGLE_STEP 1
+#endif /* __x86_64__ && __linux__ */
+
+/* Microseconds between producer signals */
+#define PRODUCER_PERIOD_US 20
+
+/* Number of records to produce before checking the totals */
+#define PRODUCER_LIMIT 50000U
+
+/* Records produced while the consumer stalls after each batch.  More
+ * than the batch size, so the buffer is full at every batch. */
+#define STALL_RECORDS 5
+
+#define CHECK_VALUE(seqno_) ((((unsigned long)(seqno_)) << 16) | (0xFFFFU & ~(seqno_)))
+
+typedef struct sConsumer {
+  unsigned long received;
+  unsigned long lost;
+  unsigned int next_seqno;
+  unsigned int torn;
+  unsigned int misordered;
+} sConsumer;
+
+static unsigned char stress_tag;
+static volatile unsigned int produced_v;
+static volatile sig_atomic_t producing_v;
+
+static void
+produce_ni (void)
+{
+  uBSP430eventAnyType u;
+  const volatile sBSP430eventTagRecord * ep;
+
+  u.ul = 0;
+  ep = xBSP430eventRecordEvent_ni(stress_tag, 0, &u);
+  ((volatile sBSP430eventTagRecord *)ep)->u.ul = CHECK_VALUE(ep->seqno);
+  ++produced_v;
+}
+
+/* Retrieve a batch of records and account for them.  Returns the
+ * number of records retrieved. */
+static int
+consume (sConsumer * cp)
+{
+  sBSP430eventTagRecord evts[4];
+  int nevt;
+  int i;
+
+  (void)uiBSP430eventFlagsGet();
+  nevt = iBSP430eventTagGetRecords(evts, sizeof(evts) / sizeof(*evts));
+  for (i = 0; i < nevt; ++i) {
+    const sBSP430eventTagRecord * ep = evts + i;
+
+    if (ucBSP430eventTag_LostEventRecord == ep->tag) {
+      cp->lost += ep->u.sz;
+      cp->next_seqno += ep->u.sz;
+      continue;
+    }
+    cp->misordered += (ep->seqno != cp->next_seqno);
+    cp->torn += (ep->u.ul != CHECK_VALUE(ep->seqno));
+    cp->next_seqno = ep->seqno + 1;
+    ++cp->received;
+  }
+  return nevt;
+}
+
+static void
+check_totals (const sConsumer * cp)
+{
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTlu((unsigned long)produced_v, cp->received + cp->lost);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, cp->torn);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(0, cp->misordered);
+  BSP430_UNITTEST_ASSERT_TRUE(0 < cp->lost);
+}
+
+static void
+set_producer_period (long period_us)
+{
+  struct itimerval it;
+
+  it.it_interval.tv_sec = it.it_value.tv_sec = 0;
+  it.it_interval.tv_usec = it.it_value.tv_usec = period_us;
+  (void)setitimer(ITIMER_REAL, &it, NULL);
+}
+
+static void
+producer_handler (int signum)
+{
+  produce_ni();
+  if (PRODUCER_LIMIT <= produced_v) {
+    set_producer_period(0);
+    producing_v = 0;
+  }
+}
+
+static void
+testPreemptedDrain (void)
+{
+  sConsumer consumer;
+  unsigned int stall_to;
+  int active = 1;
+
+  memset(&consumer, 0, sizeof(consumer));
+  produced_v = 0;
+  producing_v = 1;
+  (void)signal(SIGALRM, producer_handler);
+  set_producer_period(PRODUCER_PERIOD_US);
+
+  while (active) {
+    /* Once the producer has finished, drain what remains. */
+    active = producing_v || !iBSP430eventFlagsEmpty();
+    (void)consume(&consumer);
+    /* Wait until the buffer has overflowed again, so that the next
+     * record copied is the one the producer overwrites next. */
+    stall_to = produced_v + STALL_RECORDS;
+    while (producing_v && ((int)(stall_to - produced_v) > 0)) {
+    }
+  }
+  (void)signal(SIGALRM, SIG_DFL);
+
+  cprintf("signal producer: %lu received, %lu lost\n", consumer.received, consumer.lost);
+  BSP430_UNITTEST_ASSERT_EQUAL_FMTu(PRODUCER_LIMIT, produced_v);
+  check_totals(&consumer);
+}
+
+#if (HAVE_SINGLE_STEP - 0)
+/* x86 EFLAGS trap flag */
+#define EFLAGS_TF 0x100
+
+static volatile unsigned int steps_v;
+static volatile unsigned int inject_at_v;
+static volatile int injected_v;
+
+/* Invoked after each instruction while the trap flag is set.  Once
+ * inject_at_v instructions have executed, produce a record at the
+ * first point where the interrupted code had interrupts enabled, then
+ * stop stepping. */
+static void
+step_handler (int signum,
+              siginfo_t * sip,
+              void * context)
+{
+  ucontext_t * ucp = (ucontext_t *)context;
+
+  if ((inject_at_v <= ++steps_v)
+      && ! sigismember(&ucp->uc_sigmask, SIGALRM)) {
+    produce_ni();
+    injected_v = 1;
+    ucp->uc_mcontext.gregs[REG_EFL] &= ~EFLAGS_TF;
+  }
+}
+
+static void
+testPreemptionPoints (void)
+{
+  sConsumer consumer;
+  struct sigaction sa;
+  unsigned int points = 0;
+  int i;
+
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_sigaction = step_handler;
+  sa.sa_flags = SA_SIGINFO;
+  (void)sigaction(SIGTRAP, &sa, NULL);
+
+  memset(&consumer, 0, sizeof(consumer));
+  consumer.next_seqno = hBSP430eventTagLookup(stress_tag)->seqno;
+  produced_v = 0;
+
+  do {
+    /* Overflow the buffer so the first record copied is the next one
+     * overwritten. */
+    for (i = 0; i <= BSP430_EVENT_RECORD_NUM_SUPPORTED; ++i) {
+      produce_ni();
+    }
+    steps_v = 0;
+    inject_at_v = ++points;
+    injected_v = 0;
+    __asm__ __volatile__("pushf; orl %0, (%%rsp); popf" : : "i" (EFLAGS_TF) : "memory", "cc");
+    (void)consume(&consumer);
+    __asm__ __volatile__("pushf; andl %0, (%%rsp); popf" : : "i" (~EFLAGS_TF) : "memory", "cc");
+  } while (injected_v);
+  while (0 < consume(&consumer)) {
+  }
+  (void)signal(SIGTRAP, SIG_DFL);
+
+  cprintf("%u preemption points: %lu received, %lu lost\n", points, consumer.received, consumer.lost);
+  BSP430_UNITTEST_ASSERT_TRUE(1 < points);
+  check_totals(&consumer);
+}
+#endif /* HAVE_SINGLE_STEP */
+
+int
+main (void)
+{
+  vBSP430platformInitialize_ni();
+  vBSP430unittestInitialize();
+
+  stress_tag = ucBSP430eventTagAllocate("Stress");
+  testPreemptedDrain();
+#if (HAVE_SINGLE_STEP - 0)
+  testPreemptionPoints();
+#endif /* HAVE_SINGLE_STEP */
+
+  vBSP430unittestFinalize();
+  return 0;
+}
@@ -0,0 +1,81 @@
+/* This file is in the public domain.
+ *
+ * Host implementations of the platform, interrupt, low power, and
+ * uptime interfaces used by the hardware-independent utility modules.
+ *
+ * Interrupts are modelled by the process signal mask: disabling
+ * interrupts blocks all signals, so a signal handler can stand in for
+ * an interrupt handler that preempts the main loop.  Entering a low
+ * power mode enables interrupts and calls the hook set by
+ * vBSP430hostSetLPMHook(), if any.
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/uptime.h>
+#include "host.h"
+#include <signal.h>
+#include <time.h>
+
+static void (* lpm_hook) (unsigned int lpm_bits);
+
+int
+iBSP430hostInterruptState (void)
+{
+  sigset_t mask;
+
+  (void)sigprocmask(SIG_BLOCK, NULL, &mask);
+  return ! sigismember(&mask, SIGALRM);
+}
+
+void
+vBSP430hostSetInterruptState (int enabled)
+{
+  sigset_t mask;
+
+  (void)sigfillset(&mask);
+  /* A trap is synchronous and cannot be held off like an interrupt;
+   * the kernel kills a process that blocks it. */
+  (void)sigdelset(&mask, SIGTRAP);
+  (void)sigprocmask(enabled ? SIG_UNBLOCK : SIG_BLOCK, &mask, NULL);
+}
+
+void
+vBSP430hostSetLPMHook (void (* hook) (unsigned int lpm_bits))
+{
+  lpm_hook = hook;
+}
+
+void
+vBSP430hostEnterLPM_ni (unsigned int lpm_bits)
+{
+  vBSP430hostSetInterruptState(1);
+  if (lpm_hook) {
+    lpm_hook(lpm_bits);
+  }
+}
+
+void
+vBSP430platformInitialize_ni (void)
+{
+}
+
+double
+dBSP430hostTime (void)
+{
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+unsigned long
+ulBSP430uptime_ni (void)
+{
+  return (unsigned long)(dBSP430hostTime() * BSP430_UPTIME_HOST_HZ);
+}
+
+unsigned long
+ulBSP430uptime (void)
+{
+  return ulBSP430uptime_ni();
+}
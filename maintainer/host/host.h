@@ -0,0 +1,23 @@
+/* This file is in the public domain.
+ *
+ * Support for running BSP430 utility modules in a host process.
+ */
+
+#ifndef BSP430_HOST_H
+#define BSP430_HOST_H
+
+#include <stdio.h>
+
+/* Direct console output to fp, or discard it if fp is null.  The
+ * default is standard output. */
+void vBSP430hostSetConsole (FILE * fp);
+
+/* Seconds on a monotonic clock, for benchmarks */
+double dBSP430hostTime (void);
+
+/* Function called with interrupts enabled in place of sleeping in a
+ * low power mode, standing in for the interrupts that would wake the
+ * MCU.  With no hook the low power mode is left immediately. */
+void vBSP430hostSetLPMHook (void (* hook) (unsigned int lpm_bits));
+
+#endif /* BSP430_HOST_H */
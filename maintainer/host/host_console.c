@@ -0,0 +1,128 @@
+/* This file is in the public domain.
+ *
+ * Host implementation of the console interface used by the
+ * hardware-independent utility modules.
+ *
+ * Console output goes to standard output unless redirected with
+ * vBSP430hostSetConsole(); console input is not available.  Programs
+ * that link the library console in src/utility/console.c use
+ * host.c without this file.
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/console.h>
+#include "host.h"
+#include <stdlib.h>
+#include <string.h>
+
+static FILE * console_fp;
+static int console_configured;
+
+void
+vBSP430hostSetConsole (FILE * fp)
+{
+  console_configured = 1;
+  console_fp = fp;
+}
+
+static FILE *
+console_ (void)
+{
+  if (! console_configured) {
+    vBSP430hostSetConsole(stdout);
+  }
+  return console_fp;
+}
+
+hBSP430halSERIAL
+hBSP430console (void)
+{
+  return (hBSP430halSERIAL)console_();
+}
+
+int
+iBSP430consoleInitialize (void)
+{
+  return 0;
+}
+
+int
+iBSP430consoleFlush (void)
+{
+  if (console_()) {
+    (void)fflush(console_fp);
+  }
+  return 0;
+}
+
+int
+cgetchar (void)
+{
+  return -1;
+}
+
+int
+cputchar (int c)
+{
+  if (console_()) {
+    (void)fputc(c, console_fp);
+  }
+  return c;
+}
+
+int
+cputs (const char * s)
+{
+  int rv = cputtext(s);
+
+  (void)cputchar('\n');
+  return 1 + rv;
+}
+
+int
+cputtext (const char * s)
+{
+  size_t len = strlen(s);
+
+  return cputchars(s, len);
+}
+
+int
+cputchars (const char * cp,
+           size_t len)
+{
+  if (! console_()) {
+    return 0;
+  }
+  return fwrite(cp, 1, len, console_fp);
+}
+
+int
+cputoctets (const uint8_t * dp,
+            size_t len)
+{
+  return cputchars((const char *)dp, len);
+}
+
+int
+vcprintf (const char * format,
+          va_list ap)
+{
+  if (! console_()) {
+    return 0;
+  }
+  return vfprintf(console_fp, format, ap);
+}
+
+int
+cprintf (const char * format,
+         ...)
+{
+  va_list ap;
+  int rv;
+
+  va_start(ap, format);
+  rv = vcprintf(format, ap);
+  va_end(ap);
+  return rv;
+}
@@ -0,0 +1,35 @@
+/* This file is in the public domain.
+ *
+ * Host stand-in for <bsp430/clock.h>.
+ *
+ * Declares the clock sources and queries referenced by the timer
+ * module.  Nothing on the host configures a clock; programs that link
+ * the timer module use only the functions that do not depend on one.
+ */
+
+#ifndef BSP430_CLOCK_H
+#define BSP430_CLOCK_H
+
+#include <bsp430/core.h>
+
+typedef enum eBSP430clockSource {
+  eBSP430clockSRC_NONE,
+  eBSP430clockSRC_XT1CLK,
+  eBSP430clockSRC_VLOCLK,
+  eBSP430clockSRC_REFOCLK,
+  eBSP430clockSRC_DCOCLK,
+  eBSP430clockSRC_DCOCLKDIV,
+  eBSP430clockSRC_SMCLK_PU_DEFAULT,
+  eBSP430clockSRC_XT2CLK,
+  eBSP430clockSRC_TCLK,
+  eBSP430clockSRC_ITCLK,
+} eBSP430clockSource;
+
+eBSP430clockSource xBSP430clockMCLKSource (void);
+eBSP430clockSource xBSP430clockSMCLKSource (void);
+eBSP430clockSource xBSP430clockACLKSource (void);
+unsigned long ulBSP430clockMCLK_Hz_ni (void);
+unsigned long ulBSP430clockSMCLK_Hz_ni (void);
+unsigned long ulBSP430clockACLK_Hz_ni (void);
+
+#endif /* BSP430_CLOCK_H */
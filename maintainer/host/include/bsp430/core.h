@@ -0,0 +1,42 @@
+/* This file is in the public domain.
+ *
+ * Host stand-in for <bsp430/core.h>.
+ *
+ * Provides the subset of the core interface used by the
+ * hardware-independent utility modules.  Interrupts are modelled by
+ * blocking signals, so a signal handler can stand in for an interrupt
+ * handler.
+ */
+
+#ifndef BSP430_CORE_H
+#define BSP430_CORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define BSP430_CORE_INLINE __inline__
+#define BSP430_CORE_INLINE_FORCED BSP430_CORE_INLINE __attribute__((__always_inline__))
+#define BSP430_CORE_PACKED_STRUCT(nm_) struct __attribute__((__packed__)) nm_
+
+/* Nonzero if signals standing in for interrupts are deliverable */
+#define BSP430_CORE_INTERRUPT_STATE_T int
+int iBSP430hostInterruptState (void);
+void vBSP430hostSetInterruptState (int enabled);
+
+#define BSP430_CORE_SAVED_INTERRUPT_STATE(var_)                 \
+  BSP430_CORE_INTERRUPT_STATE_T var_ = iBSP430hostInterruptState()
+#define BSP430_CORE_RESTORE_INTERRUPT_STATE(state_) vBSP430hostSetInterruptState(state_)
+#define BSP430_CORE_ENABLE_INTERRUPT() vBSP430hostSetInterruptState(1)
+#define BSP430_CORE_DISABLE_INTERRUPT() vBSP430hostSetInterruptState(0)
+#define BSP430_CORE_WATCHDOG_CLEAR() do { } while (0)
+
+/* Entering a low power mode enables interrupts and calls the hook
+ * set by vBSP430hostSetLPMHook(). */
+#define LPM0_bits 0x0010
+void vBSP430hostEnterLPM_ni (unsigned int lpm_bits);
+#define BSP430_CORE_LPM_ENTER_NI(lpm_bits_) vBSP430hostEnterLPM_ni(lpm_bits_)
+
+/* The host stands in for a 5xx family MCU */
+#define BSP430_CORE_FAMILY_IS_5XX 1
+
+#endif /* BSP430_CORE_H */
@@ -0,0 +1,104 @@
+/* This file is in the public domain.
+ *
+ * Host stand-in for <bsp430/periph.h>.
+ *
+ * Provides the HAL state prefix and the interrupt callback chains,
+ * copied from the library header without its register definitions.
+ */
+
+#ifndef BSP430_PERIPH_H
+#define BSP430_PERIPH_H
+
+#include <bsp430/core.h>
+
+/* An int holds a peripheral address on the MCU; the host needs a
+ * pointer-sized type to hold the address of a simulated peripheral. */
+typedef intptr_t tBSP430periphHandle;
+
+#define BSP430_PERIPH_HAL_STATE_CFLAGS_VARIANT_MASK_ 0x0F
+#define BSP430_PERIPH_HAL_STATE_CFLAGS_ISR 0x80
+#define BSP430_PERIPH_HAL_STATE_CFLAGS_ISR2 0x40
+#define BSP430_PERIPH_HAL_STATE_CFLAGS_VARIANT(_p) (BSP430_PERIPH_HAL_STATE_CFLAGS_VARIANT_MASK_ & (_p)->hal_state.cflags)
+
+typedef struct sBSP430hplHALStatePrefix {
+  const unsigned char cflags;
+  volatile unsigned char flags;
+} sBSP430hplHALStatePrefix;
+
+#define BSP430_HAL_ISR_CALLBACK_BREAK_CHAIN 0x0001
+#define BSP430_HAL_ISR_CALLBACK_EXIT_LPM 0x0002
+#define BSP430_HAL_ISR_CALLBACK_YIELD 0x1000
+#define BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT 0x2000
+
+static BSP430_CORE_INLINE
+tBSP430periphHandle
+xBSP430periphFromHPL (volatile void * hpl)
+{
+  return (tBSP430periphHandle)(uintptr_t)hpl;
+}
+
+struct sBSP430halISRVoidChainNode;
+struct sBSP430halISRIndexedChainNode;
+
+typedef int (* iBSP430halISRCallbackVoid_ni) (const struct sBSP430halISRVoidChainNode * cb,
+                                              void * context);
+
+typedef int (* iBSP430halISRCallbackIndexed_ni) (const struct sBSP430halISRIndexedChainNode * cb,
+                                                 void * context,
+                                                 int idx);
+
+typedef struct sBSP430halISRVoidChainNode {
+  const struct sBSP430halISRVoidChainNode * volatile next_ni;
+  iBSP430halISRCallbackVoid_ni callback_ni;
+} sBSP430halISRVoidChainNode;
+
+typedef struct sBSP430halISRIndexedChainNode {
+  const struct sBSP430halISRIndexedChainNode * volatile next_ni;
+  iBSP430halISRCallbackIndexed_ni callback_ni;
+} sBSP430halISRIndexedChainNode;
+
+static BSP430_CORE_INLINE
+int
+iBSP430callbackInvokeISRVoid_ni (const struct sBSP430halISRVoidChainNode * volatile const * cbpp,
+                                 void * context,
+                                 int basis)
+{
+  while (*cbpp && ! (basis & BSP430_HAL_ISR_CALLBACK_BREAK_CHAIN)) {
+    basis |= (*cbpp)->callback_ni(*cbpp, context);
+    cbpp = &(*cbpp)->next_ni;
+  }
+  return basis;
+}
+
+static BSP430_CORE_INLINE
+int
+iBSP430callbackInvokeISRIndexed_ni (const struct sBSP430halISRIndexedChainNode * volatile const * cbpp,
+                                    void * context,
+                                    int idx,
+                                    int basis)
+{
+  while (*cbpp && ! (basis & BSP430_HAL_ISR_CALLBACK_BREAK_CHAIN)) {
+    basis |= (*cbpp)->callback_ni(*cbpp, context, idx);
+    cbpp = &(*cbpp)->next_ni;
+  }
+  return basis;
+}
+
+#define BSP430_HAL_ISR_CALLBACK_LINK_NI(type_,root_,node_,next_) do {   \
+    (node_).next_ = root_;                                              \
+    root_ = &(node_);                                                   \
+  } while (0)
+
+#define BSP430_HAL_ISR_CALLBACK_UNLINK_NI(type_,root_,node_,next_) do { \
+    typedef type_ tNode_;                                               \
+    const tNode_ * volatile * curp_ = &(root_);                         \
+    while ((NULL != *curp_) && (&(node_) != *curp_)) {                  \
+      curp_ = &(((tNode_*)*curp_)->next_);                              \
+    }                                                                   \
+    if (&(node_) == *curp_) {                                           \
+      *curp_ = (node_).next_;                                           \
+      (node_).next_ = NULL;                                             \
+    }                                                                   \
+  } while (0)
+
+#endif /* BSP430_PERIPH_H */
@@ -0,0 +1,53 @@
+/* This file is in the public domain.
+ *
+ * Host stand-in for <bsp430/periph/dma.h>.
+ *
+ * Declares the 5xx DMA register block and HAL.  Programs that link
+ * code using the DMA define xBSP430hal_DMA_ and simulate the channels.
+ */
+
+#ifndef BSP430_PERIPH_DMA_H
+#define BSP430_PERIPH_DMA_H
+
+#include <bsp430/periph.h>
+
+#define BSP430_DMA_NUM_CHANNELS 3
+
+#define DMAREQ 0x0001
+#define DMAIE 0x0004
+#define DMAIFG 0x0008
+#define DMAEN 0x0010
+#define DMALEVEL 0x0020
+#define DMASRCBYTE 0x0040
+#define DMADSTBYTE 0x0080
+#define DMASRCINCR_3 0x0C00
+#define DMADT_0 0x0000
+#define DMARMWDIS 0x0004
+
+typedef struct sBSP430hplDMAchannel {
+  unsigned int ctl;
+  unsigned long sa;
+  unsigned long da;
+  unsigned int sz;
+} sBSP430hplDMAchannel;
+
+typedef struct sBSP430hplDMA {
+  unsigned int ctl0;
+  unsigned int ctl1;
+  unsigned int ctl2;
+  unsigned int ctl3;
+  unsigned int ctl4;
+  unsigned int iv;
+  sBSP430hplDMAchannel ch[BSP430_DMA_NUM_CHANNELS];
+} sBSP430hplDMA;
+
+typedef struct sBSP430halDMA {
+  sBSP430hplHALStatePrefix hal_state;
+  volatile sBSP430hplDMA * const hpl;
+  const struct sBSP430halISRIndexedChainNode * volatile * const ch_cbchain_ni;
+} sBSP430halDMA;
+
+extern sBSP430halDMA xBSP430hal_DMA_;
+#define BSP430_HAL_DMA (&xBSP430hal_DMA_)
+
+#endif /* BSP430_PERIPH_DMA_H */
@@ -0,0 +1,104 @@
+/* This file is in the public domain.
+ *
+ * Host stand-in for <bsp430/periph/timer.h>.
+ *
+ * Declares the periodic multiplexed alarm types referenced by the
+ * event module.  There is no timer on the host, so registering a
+ * periodic alarm always fails.  Programs that link the library timer
+ * in src/periph/timer.c define BSP430_HOST_LIBRARY_TIMER to use its
+ * header instead, with TA0 as a five-CC Timer_A whose registers are
+ * the structure xBSP430hostTA0_ defined by the program.
+ */
+
+#if (BSP430_HOST_LIBRARY_TIMER - 0)
+
+#include <bsp430/periph.h>
+
+#define __MSP430_HAS_MSP430XV2_CPU__
+#define __MSP430_HAS_T0A5__
+struct sBSP430hplTIMER;
+extern struct sBSP430hplTIMER xBSP430hostTA0_;
+#define __MSP430_BASEADDRESS_T0A5__ ((uintptr_t)&xBSP430hostTA0_)
+
+#ifndef configBSP430_HAL_TA0
+#define configBSP430_HAL_TA0 1
+#endif /* configBSP430_HAL_TA0 */
+#define configBSP430_HAL_TA0_ISR 0
+#define configBSP430_HAL_TA0_CC0_ISR 0
+
+#define TASSEL_0 0x0000
+#define TASSEL_1 0x0100
+#define TASSEL_2 0x0200
+#define TASSEL_3 0x0300
+#define ID0 0x0040
+#define ID_3 0x00C0
+#define MC0 0x0010
+#define MC1 0x0020
+#define MC_0 0x0000
+#define MC_2 0x0020
+#define TACLR 0x0004
+#define TAIE 0x0002
+#define TAIFG 0x0001
+#define CM0 0x4000
+#define CM1 0x8000
+#define CM_3 0xC000
+#define CCIS0 0x1000
+#define CCIS1 0x2000
+#define SCS 0x0800
+#define CAP 0x0100
+#define CCIE 0x0010
+#define CCI 0x0008
+#define COV 0x0002
+#define CCIFG 0x0001
+
+#include_next <bsp430/periph/timer.h>
+
+#else /* BSP430_HOST_LIBRARY_TIMER */
+
+#ifndef BSP430_PERIPH_TIMER_H
+#define BSP430_PERIPH_TIMER_H
+
+#include <bsp430/periph.h>
+
+typedef struct sBSP430timerMuxSharedAlarm sBSP430timerMuxSharedAlarm;
+typedef sBSP430timerMuxSharedAlarm * hBSP430timerMuxSharedAlarm;
+
+typedef enum eBSP430timerMuxPeriodicPolicy {
+  eBSP430timerMuxPeriodicPolicy_BURST,
+  eBSP430timerMuxPeriodicPolicy_SKIP,
+  eBSP430timerMuxPeriodicPolicy_COALESCE,
+} eBSP430timerMuxPeriodicPolicy;
+
+struct sBSP430timerMuxPeriodic;
+
+typedef int (* iBSP430timerMuxPeriodicCallback_ni) (struct sBSP430timerMuxSharedAlarm * shared,
+                                                    struct sBSP430timerMuxPeriodic * periodic);
+
+typedef struct sBSP430timerMuxPeriodic {
+  unsigned long interval_tck;
+  iBSP430timerMuxPeriodicCallback_ni callback_ni;
+  unsigned long overruns_ni;
+  unsigned long periods_ni;
+  unsigned char policy;
+} sBSP430timerMuxPeriodic;
+
+typedef sBSP430timerMuxPeriodic * hBSP430timerMuxPeriodic;
+
+static BSP430_CORE_INLINE
+int iBSP430timerMuxPeriodicAdd_ni (hBSP430timerMuxSharedAlarm shared,
+                                   hBSP430timerMuxPeriodic periodic,
+                                   unsigned long setting_tck)
+{
+  return -1;
+}
+
+static BSP430_CORE_INLINE
+int iBSP430timerMuxPeriodicRemove_ni (hBSP430timerMuxSharedAlarm shared,
+                                      hBSP430timerMuxPeriodic periodic)
+{
+  return -1;
+}
+
+#endif /* BSP430_PERIPH_TIMER_H */
+
+#endif /* BSP430_HOST_LIBRARY_TIMER */
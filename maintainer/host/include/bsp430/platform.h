@@ -0,0 +1,18 @@
+/* This file is in the public domain.
+ *
+ * Host stand-in for <bsp430/platform.h>.
+ */
+
+#ifndef BSP430_PLATFORM_H
+#define BSP430_PLATFORM_H
+
+#include <bsp430/core.h>
+
+#ifndef configBSP430_CONSOLE
+#define configBSP430_CONSOLE 1
+#endif /* configBSP430_CONSOLE */
+#define BSP430_CONSOLE (configBSP430_CONSOLE - 0)
+
+void vBSP430platformInitialize_ni (void);
+
+#endif /* BSP430_PLATFORM_H */
@@ -0,0 +1,69 @@
+/* This file is in the public domain.
+ *
+ * Host stand-in for <bsp430/serial.h>.
+ *
+ * Declares a UART HAL with a 5xx USCI register block reduced to the
+ * registers used by the console.  Programs that link the console
+ * implement the serial functions over a simulated peripheral.
+ */
+
+#ifndef BSP430_SERIAL_H
+#define BSP430_SERIAL_H
+
+#include <bsp430/core.h>
+#include <bsp430/periph.h>
+
+#define configBSP430_SERIAL_USE_USCI 0
+#define configBSP430_SERIAL_USE_USCI5 1
+#define configBSP430_SERIAL_USE_EUSCI 0
+
+#define BSP430_SERIAL_HAL_HPL_VARIANT_USCI5 2
+#define BSP430_SERIAL_HAL_HPL_VARIANT_IS_USCI5(hal_) (BSP430_SERIAL_HAL_HPL_VARIANT_USCI5 == BSP430_PERIPH_HAL_STATE_CFLAGS_VARIANT(hal_))
+
+#define UCBUSY 0x01
+#define UCRXIFG 0x01
+#define UCTXIFG 0x02
+#define UCTXIE 0x02
+
+typedef struct sBSP430hplUSCI5 {
+  unsigned char stat;
+  unsigned char rxbuf;
+  unsigned char txbuf;
+  unsigned char ie;
+  unsigned char ifg;
+} sBSP430hplUSCI5;
+
+typedef struct sBSP430halSERIAL {
+  sBSP430hplHALStatePrefix hal_state;
+  union {
+    volatile void * any;
+    volatile struct sBSP430hplUSCI5 * usci5;
+  } const hpl;
+  uint8_t rx_byte;
+  uint8_t tx_byte;
+  const struct sBSP430halISRVoidChainNode * volatile rx_cbchain_ni;
+  const struct sBSP430halISRVoidChainNode * volatile tx_cbchain_ni;
+  unsigned long num_rx;
+  unsigned long num_tx;
+} sBSP430halSERIAL;
+
+typedef struct sBSP430halSERIAL * hBSP430halSERIAL;
+
+hBSP430halSERIAL hBSP430serialLookup (tBSP430periphHandle periph);
+hBSP430halSERIAL hBSP430serialOpenUART (hBSP430halSERIAL hal,
+                                        unsigned char ctl0_byte,
+                                        unsigned char ctl1_byte,
+                                        unsigned long baud);
+int iBSP430serialClose (hBSP430halSERIAL hal);
+int iBSP430serialSetHold_rh (hBSP430halSERIAL hal,
+                             int holdp);
+void vBSP430serialWakeupTransmit_rh (hBSP430halSERIAL hal);
+void vBSP430serialFlush_ni (hBSP430halSERIAL hal);
+int iBSP430uartRxByte_rh (hBSP430halSERIAL hal);
+int iBSP430uartTxByte_rh (hBSP430halSERIAL hal,
+                          uint8_t c);
+int iBSP430uartTxData_rh (hBSP430halSERIAL hal,
+                          const uint8_t * data,
+                          size_t len);
+
+#endif /* BSP430_SERIAL_H */
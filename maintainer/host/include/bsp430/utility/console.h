@@ -0,0 +1,39 @@
+/* This file is in the public domain.
+ *
+ * Host stand-in for <bsp430/utility/console.h>.
+ *
+ * Declares the console functions used by the hardware-independent
+ * utility modules.  host_console.c implements them on the process
+ * standard streams.  Programs that link the library console in
+ * src/utility/console.c define BSP430_HOST_LIBRARY_CONSOLE to use its
+ * header instead.
+ */
+
+#if (BSP430_HOST_LIBRARY_CONSOLE - 0)
+#include_next <bsp430/utility/console.h>
+#else /* BSP430_HOST_LIBRARY_CONSOLE */
+
+#ifndef BSP430_UTILITY_CONSOLE_H
+#define BSP430_UTILITY_CONSOLE_H
+
+#include <bsp430/core.h>
+#include <stdarg.h>
+
+typedef struct sBSP430halSERIAL * hBSP430halSERIAL;
+
+hBSP430halSERIAL hBSP430console (void);
+int iBSP430consoleInitialize (void);
+int iBSP430consoleFlush (void);
+int cgetchar (void);
+int cputs (const char * s);
+int cputchar (int c);
+int cputtext (const char * s);
+int cputchars (const char * cp, size_t len);
+int cputoctets (const uint8_t * dp, size_t len);
+int cprintf (const char * format, ...)
+__attribute__((__format__(printf, 1, 2)));
+int vcprintf (const char * format, va_list ap);
+
+#endif /* BSP430_UTILITY_CONSOLE_H */
+
+#endif /* BSP430_HOST_LIBRARY_CONSOLE */
@@ -0,0 +1,23 @@
+/* This file is in the public domain.
+ *
+ * Host stand-in for <bsp430/utility/uptime.h>.
+ *
+ * host.c provides the uptime from the monotonic clock, in ticks of a
+ * nominal 32 KiHz uptime timer.  The delay alarm is not available.
+ */
+
+#ifndef BSP430_UTILITY_UPTIME_H
+#define BSP430_UTILITY_UPTIME_H
+
+#include <bsp430/core.h>
+
+#define configBSP430_UPTIME_DELAY 0
+
+#define BSP430_UPTIME_HOST_HZ 32768UL
+#define BSP430_UPTIME_MS_TO_UTT(ms_) ((BSP430_UPTIME_HOST_HZ * (ms_)) / 1000)
+#define BSP430_UPTIME_UTT_TO_MS(utt_) ((1000 * (utt_)) / BSP430_UPTIME_HOST_HZ)
+
+unsigned long ulBSP430uptime (void);
+unsigned long ulBSP430uptime_ni (void);
+
+#endif /* BSP430_UTILITY_UPTIME_H */
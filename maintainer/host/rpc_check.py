@@ -0,0 +1,77 @@
+#!/usr/bin/env python
+#
+# This file is in the public domain.
+#
+# Check bsp430/utility/rpc.h against the bsp430.rpc client.
+#
+# Usage: rpc_check.py [./rpc_server]
+#
+# Runs the host rpc_server on one end of a socket pair and drives it
+# with the Python client: command discovery, integer stores and reads,
+# text arguments up to the maximum length, and the rejection of longer
+# text by both the client and the device.  Exits with a nonzero status if any check fails.
+
+import os
+import os.path
+import socket
+import subprocess
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'lib', 'python'))
+import bsp430.rpc
+
+CHANNEL = 3
+
+server = './rpc_server'
+if 1 < len(sys.argv):
+    server = sys.argv[1]
+
+(host_end, dev_end) = socket.socketpair()
+proc = subprocess.Popen([server, str(CHANNEL)], stdin=dev_end.fileno(), stdout=dev_end.fileno())
+dev_end.close()
+client = bsp430.rpc.Client(host_end.fileno(), CHANNEL)
+failures = []
+
+def check (what, got, expected):
+    if got != expected:
+        failures.append(what)
+        print('rpc_check: %s: got %r, expected %r' % (what, got, expected))
+
+try:
+    commands = client.commands()
+    for name in ('set ival', 'set uival', 'set lval', 'set ulval', 'show data', 'tokens', 'help'):
+        check('command %s listed' % (name,), name in commands, True)
+
+    check('store int', client.call('set ival', -300), (0, -300))
+    check('read int', client.call('set ival'), (0, -300))
+    check('store unsigned', client.call('set uival', 0xFFFF), (0, 0xFFFF))
+    check('store long', client.call('set lval', -70000), (0, -70000))
+    check('store unsigned long', client.call('set ulval', 0xDEADBEEF), (0, 0xDEADBEEF))
+    check('reject negative unsigned', client.call('set uival', -1)[0] < 0, True)
+    check('value unchanged after rejection', client.call('set uival'), (0, 0xFFFF))
+
+    # The tokens handler returns the number of tokens in its argument
+    check('text argument', client.call('tokens', 'one "two three" four'), (3, None))
+    longest = ('ab ' * bsp430.rpc.MaxTextLength)[:bsp430.rpc.MaxTextLength]
+    check('longest text', client.call('tokens', longest), (len(longest.split()), None))
+    try:
+        bsp430.rpc.EncodeText(longest + 'x')
+        check('client rejects longer text', False, True)
+    except ValueError:
+        pass
+    # A request that does not fit in a frame is dropped by the device
+    client.timeout = 0.5
+    try:
+        over = bytearray([bsp430.rpc.TLV_TEXT, len(longest) + 1]) + bytearray(longest + 'x', 'latin-1')
+        client.transact(bsp430.rpc.OP_CALL, commands['tokens'], over)
+        check('oversized request dropped', False, True)
+    except bsp430.rpc.RPCError:
+        pass
+finally:
+    proc.kill()
+    proc.wait()
+
+if failures:
+    print('rpc: %u failures' % (len(failures),))
+    sys.exit(1)
+print('rpc: all checks passed')
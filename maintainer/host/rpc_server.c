@@ -0,0 +1,46 @@
+/* This file is in the public domain.
+ *
+ * Host server for bsp430/utility/rpc.h.
+ *
+ * Reads the console stream from standard input and passes each octet
+ * to iBSP430chanmuxRxFilter(); responses and console text are written
+ * to standard output.  The command set is the one used by the CLI
+ * benchmark, served on the channel given as the only argument
+ * (default 3).  rpc_check drives it with the Python client over a
+ * socket pair; it can equally be attached to a pseudo-terminal with
+ * socat for use with maintainer/rpc-bench.
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/rpc.h>
+#include "host.h"
+#include "cli_commands.h"
+#include <stdlib.h>
+#include <unistd.h>
+
+static uint8_t tx_buffer[16];
+static sBSP430rpcServer server = {
+  .channel = {
+    .tx_ring = BSP430_RING_INITIALIZER(sizeof(tx_buffer)),
+    .tx_buffer = tx_buffer,
+  },
+  .cmds = LAST_COMMAND,
+};
+
+int
+main (int argc,
+      char * argv[])
+{
+  uint8_t c;
+
+  setvbuf(stdout, NULL, _IONBF, 0);
+  server.channel.id = (1 < argc) ? atoi(argv[1]) : 3;
+  if (0 != iBSP430rpcRegister(&server)) {
+    fprintf(stderr, "rpc_server: cannot register channel %u\n", server.channel.id);
+    return 1;
+  }
+  while (1 == read(0, &c, 1)) {
+    (void)iBSP430chanmuxRxFilter(c);
+  }
+  return 0;
+}
@@ -0,0 +1,550 @@
+/* This file is in the public domain.
+ *
+ * Check the multiplexed alarms in src/periph/timer.c against a
+ * simulated Timer_A, with the heap or the list implementation
+ * selected by #configBSP430_TIMER_MUX_ALARM_HEAP.
+ *
+ * The simulated counter is advanced in jumps.  Each overflow crossed
+ * invokes the overflow callbacks, and the dedicated alarm raises its
+ * compare interrupt when the counter reaches its setting if the
+ * library enabled the interrupt in that cycle.  Unsigned long is 64
+ * bits on the host, so the counter does not wrap.
+ *
+ * In the random phase one-shot alarms are added, removed and left to
+ * fire while two periodic alarms run throughout, and some callbacks
+ * add their alarm again already due.  After each operation the heap
+ * (each alarm no earlier than its parent, with a correct index) or the
+ * list (in order) must hold exactly the pending alarms, and the
+ * dedicated alarm must be set for the first of them.  No alarm may
+ * fire before its setting or remain pending after it, and periodic
+ * alarms must fire exactly on each interval.
+ *
+ * The benchmark then reports the median time to insert and remove an
+ * alarm, and to take the compare interrupt that fires the first,
+ * while 10, 100 and 1000 are pending.  The median time to read the
+ * clock is subtracted from each.
+ *
+ * Exits with a nonzero status if any check fails.
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/periph/timer.h>
+#include "host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if (configBSP430_TIMER_MUX_ALARM_HEAP - 0)
+#define BACKEND "heap"
+#else /* configBSP430_TIMER_MUX_ALARM_HEAP */
+#define BACKEND "list"
+#endif /* configBSP430_TIMER_MUX_ALARM_HEAP */
+
+/* Capture/compare register used by the dedicated alarm */
+#define CCIDX 1
+
+/* Operations in the random phase */
+#define RANDOM_OPERATIONS 100000UL
+
+/* One-shot alarms in the random phase */
+#define RANDOM_ALARMS 64
+
+/* Longest random alarm delay, spanning several overflows */
+#define RANDOM_DELAY_TCK 200000UL
+
+#define NUM_PERIODIC 2
+
+/* Largest number of pending alarms benchmarked */
+#define BENCH_ALARMS 1000
+
+/* Operations timed at each benchmark size */
+#define BENCH_OPERATIONS 100000UL
+
+#define BENCH_DELAY_TCK 1000000UL
+
+#if (configBSP430_TIMER_MUX_ALARM_HEAP - 0) && (BSP430_TIMER_MUX_ALARM_HEAP_CAPACITY < BENCH_ALARMS)
+#error BSP430_TIMER_MUX_ALARM_HEAP_CAPACITY is too small for the benchmark
+#endif /* capacity */
+
+static unsigned int failures;
+
+#define FAIL(...) do {                          \
+    printf(__VA_ARGS__);                        \
+    putchar('\n');                              \
+    ++failures;                                 \
+  } while (0)
+
+typedef struct sTestAlarm {
+  sBSP430timerMuxAlarm alarm;
+  int pending;
+  int seen;
+} sTestAlarm;
+
+typedef struct sTestPeriodic {
+  sBSP430timerMuxPeriodic periodic;
+  unsigned long next_tck;
+  unsigned long calls;
+  int seen;
+} sTestPeriodic;
+
+sBSP430hplTIMER xBSP430hostTA0_;
+
+static hBSP430halTIMER timer;
+static sBSP430timerMuxSharedAlarm shared_alarm;
+static hBSP430timerMuxSharedAlarm shared;
+static sTestAlarm alarms[BENCH_ALARMS];
+static sTestPeriodic periodics[NUM_PERIODIC];
+static unsigned int num_pending;
+static unsigned long now_tck;
+static unsigned long seed = 1;
+
+/* Totals for the random phase */
+static unsigned long added;
+static unsigned long removed;
+static unsigned long fired;
+
+/* Fired alarms for the benchmark to add again */
+static sTestAlarm * refire[BENCH_ALARMS];
+static unsigned int num_refire;
+static int benchmarking;
+
+static unsigned long
+next_random (unsigned long limit)
+{
+  seed = seed * 1103515245UL + 12345;
+  return (seed >> 16) % limit;
+}
+
+/* Move the counter forward to tck, invoking the overflow callbacks
+ * at each overflow crossed. */
+static void
+set_counter (unsigned long tck)
+{
+  while ((tck >> 16) != timer->overflow_count) {
+    ++timer->overflow_count;
+    xBSP430hostTA0_.r = 0;
+    (void)iBSP430callbackInvokeISRVoid_ni(&timer->overflow_cbchain_ni, timer, 0);
+  }
+  xBSP430hostTA0_.r = 0xFFFF & tck;
+  now_tck = tck;
+}
+
+/* The timer interrupt for the dedicated alarm's compare register */
+static void
+cc_interrupt (void)
+{
+  volatile unsigned int * cctlp = xBSP430hostTA0_.cctl + CCIDX;
+
+  if ((CCIE | CCIFG) != ((CCIE | CCIFG) & *cctlp)) {
+    return;
+  }
+  *cctlp &= ~CCIFG;
+  (void)iBSP430callbackInvokeISRIndexed_ni(timer->cc_cbchain_ni + CCIDX, timer, CCIDX, 0);
+}
+
+/* Advance the counter to end_tck, taking each compare interrupt
+ * raised by the dedicated alarm on the way. */
+static void
+run_until (unsigned long end_tck)
+{
+  while (BSP430_TIMER_ALARM_FLAG_SET & shared->dedicated.flags) {
+    unsigned long due_tck = shared->dedicated.setting_tck;
+
+    if (due_tck < now_tck) {
+      due_tck = now_tck;
+    }
+    if (due_tck > end_tck) {
+      break;
+    }
+    set_counter(due_tck);
+    xBSP430hostTA0_.cctl[CCIDX] |= CCIFG;
+    if (! (CCIE & xBSP430hostTA0_.cctl[CCIDX])) {
+      FAIL("compare interrupt disabled at %lu for alarm due at %lu", now_tck, shared->dedicated.setting_tck);
+      exit(1);
+    }
+    cc_interrupt();
+  }
+  set_counter(end_tck);
+}
+
+static int
+add_alarm (sTestAlarm * tp,
+           unsigned long setting_tck)
+{
+  tp->alarm.setting_tck = setting_tck;
+  tp->pending = 1;
+  ++num_pending;
+  ++added;
+  return iBSP430timerMuxAlarmAdd_ni(shared, &tp->alarm);
+}
+
+static int
+remove_alarm (sTestAlarm * tp)
+{
+  if (tp->pending) {
+    tp->pending = 0;
+    --num_pending;
+    ++removed;
+  }
+  return iBSP430timerMuxAlarmRemove_ni(shared, &tp->alarm);
+}
+
+static int
+alarm_cb_ni (hBSP430timerMuxSharedAlarm sap,
+             hBSP430timerMuxAlarm alarm)
+{
+  sTestAlarm * tp = (sTestAlarm *)alarm;
+
+  if (! tp->pending) {
+    FAIL("alarm %u fired when not pending", (unsigned int)(tp - alarms));
+  }
+  if (now_tck < alarm->setting_tck) {
+    FAIL("alarm due at %lu fired at %lu", alarm->setting_tck, now_tck);
+  }
+  tp->pending = 0;
+  --num_pending;
+  ++fired;
+  if (benchmarking) {
+    refire[num_refire++] = tp;
+  } else if (0 == next_random(4)) {
+    /* Add again, due at once or within the forced-alarm limit */
+    (void)add_alarm(tp, now_tck + next_random(BSP430_TIMER_ALARM_FUTURE_LIMIT));
+  }
+  return 0;
+}
+
+static int
+periodic_cb_ni (hBSP430timerMuxSharedAlarm sap,
+                hBSP430timerMuxPeriodic periodic)
+{
+  sTestPeriodic * pp = (sTestPeriodic *)periodic;
+
+  if ((now_tck != pp->next_tck) || (1 != periodic->periods_ni) || (0 != periodic->overruns_ni)) {
+    FAIL("periodic alarm %u due at %lu fired at %lu, %lu periods, %lu overruns",
+         (unsigned int)(pp - periodics), pp->next_tck, now_tck, periodic->periods_ni, periodic->overruns_ni);
+  }
+  pp->next_tck += periodic->interval_tck;
+  ++pp->calls;
+  return 0;
+}
+
+/* Locate the test structure holding a multiplexed alarm and mark it
+ * seen, failing if it is not pending. */
+static void
+mark_seen (hBSP430timerMuxAlarm alarm)
+{
+  sTestAlarm * tp = (sTestAlarm *)alarm;
+  int i;
+
+  if ((alarms <= tp) && (tp < alarms + BENCH_ALARMS)) {
+    if (! tp->pending) {
+      FAIL("alarm %u queued but not pending", (unsigned int)(tp - alarms));
+    }
+    tp->seen += 1;
+    return;
+  }
+  for (i = 0; i < NUM_PERIODIC; ++i) {
+    if (alarm == &periodics[i].periodic.alarm) {
+      periodics[i].seen += 1;
+      return;
+    }
+  }
+  FAIL("unknown alarm queued");
+}
+
+/* Check that the queue holds each pending alarm exactly once, in
+ * order, and that the dedicated alarm is set for the first. */
+static void
+check_queue (const char * where)
+{
+  hBSP430timerMuxAlarm first;
+  unsigned int count = 0;
+  unsigned int num_periodic = 0;
+  int i;
+
+  for (i = 0; i < BENCH_ALARMS; ++i) {
+    alarms[i].seen = 0;
+  }
+  for (i = 0; i < NUM_PERIODIC; ++i) {
+    num_periodic += (NULL != periodics[i].periodic.alarm.callback_ni);
+    periodics[i].seen = 0;
+  }
+#if (configBSP430_TIMER_MUX_ALARM_HEAP - 0)
+  for (count = 0; count < shared->heap_count; ++count) {
+    hBSP430timerMuxAlarm ap = shared->heap[count];
+
+    if (ap->heap_idx != count) {
+      FAIL("%s: alarm at heap index %u records index %u", where, count, ap->heap_idx);
+    }
+    if ((0 < count) && (0 > (long)(ap->setting_tck - shared->heap[(count - 1) / 2]->setting_tck))) {
+      FAIL("%s: heap index %u due at %lu before its parent due at %lu",
+           where, count, ap->setting_tck, shared->heap[(count - 1) / 2]->setting_tck);
+    }
+    mark_seen(ap);
+  }
+  first = (0 < count) ? shared->heap[0] : NULL;
+#else /* configBSP430_TIMER_MUX_ALARM_HEAP */
+  {
+    hBSP430timerMuxAlarm ap;
+
+    for (ap = shared->alarms; NULL != ap; ap = ap->next) {
+      if ((NULL != ap->next) && (0 > (long)(ap->next->setting_tck - ap->setting_tck))) {
+        FAIL("%s: list entry %u due at %lu before its predecessor due at %lu",
+             where, count + 1, ap->next->setting_tck, ap->setting_tck);
+      }
+      mark_seen(ap);
+      if (++count > BENCH_ALARMS + NUM_PERIODIC) {
+        FAIL("%s: list does not terminate", where);
+        break;
+      }
+    }
+  }
+  first = shared->alarms;
+#endif /* configBSP430_TIMER_MUX_ALARM_HEAP */
+
+  if (count != num_pending + num_periodic) {
+    FAIL("%s: %u queued, %u pending and %u periodic", where, count, num_pending, num_periodic);
+  }
+  for (i = 0; i < BENCH_ALARMS; ++i) {
+    if (alarms[i].pending && (1 != alarms[i].seen)) {
+      FAIL("%s: pending alarm %u queued %d times", where, i, alarms[i].seen);
+    }
+  }
+  for (i = 0; i < NUM_PERIODIC; ++i) {
+    if ((NULL != periodics[i].periodic.alarm.callback_ni) && (1 != periodics[i].seen)) {
+      FAIL("%s: periodic alarm %d queued %d times", where, i, periodics[i].seen);
+    }
+  }
+  if (NULL != first) {
+    if (! (BSP430_TIMER_ALARM_FLAG_SET & shared->dedicated.flags)
+        || (first->setting_tck != shared->dedicated.setting_tck)) {
+      FAIL("%s: dedicated alarm not set for first alarm due at %lu", where, first->setting_tck);
+    }
+  } else if (BSP430_TIMER_ALARM_FLAG_SET & shared->dedicated.flags) {
+    FAIL("%s: dedicated alarm set with no alarm queued", where);
+  }
+  if (failures) {
+    printf(BACKEND ": stopped at %s after %lu added, %lu removed, %lu fired\n", where, added, removed, fired);
+    exit(1);
+  }
+}
+
+static void
+check_not_late (void)
+{
+  int i;
+
+  for (i = 0; i < RANDOM_ALARMS; ++i) {
+    if (alarms[i].pending && (alarms[i].alarm.setting_tck <= now_tck)) {
+      FAIL("alarm %d due at %lu still pending at %lu", i, alarms[i].alarm.setting_tck, now_tck);
+    }
+  }
+}
+
+static void
+random_phase (void)
+{
+  unsigned long op;
+  unsigned long start_tck = now_tck;
+  int i;
+
+  for (i = 0; i < RANDOM_ALARMS; ++i) {
+    alarms[i].alarm.callback_ni = alarm_cb_ni;
+  }
+  for (i = 0; i < NUM_PERIODIC; ++i) {
+    sTestPeriodic * pp = periodics + i;
+
+    pp->periodic.interval_tck = (0 == i) ? 1000 : 77777;
+    pp->periodic.callback_ni = periodic_cb_ni;
+    pp->periodic.policy = eBSP430timerMuxPeriodicPolicy_SKIP;
+    pp->next_tck = now_tck + pp->periodic.interval_tck;
+    (void)iBSP430timerMuxPeriodicAdd_ni(shared, &pp->periodic, pp->next_tck);
+  }
+  check_queue("periodic start");
+
+  for (op = 0; op < RANDOM_OPERATIONS; ++op) {
+    sTestAlarm * tp = alarms + next_random(RANDOM_ALARMS);
+    unsigned int action = next_random(8);
+    int rc = 0;
+
+    if (3 > action) {
+      unsigned long delay_tck = next_random(RANDOM_DELAY_TCK);
+
+      if (0 == next_random(8)) {
+        delay_tck = next_random(BSP430_TIMER_ALARM_FUTURE_LIMIT);
+      }
+      if (0 == action) {
+        /* Add several within a batch */
+        unsigned int n = 1 + next_random(4);
+
+        vBSP430timerMuxAlarmBegin_ni(shared);
+        while (n--) {
+          tp = alarms + next_random(RANDOM_ALARMS);
+          if (! tp->pending) {
+            rc |= add_alarm(tp, now_tck + next_random(RANDOM_DELAY_TCK));
+          }
+        }
+        rc |= iBSP430timerMuxAlarmCommit_ni(shared);
+      } else if (! tp->pending) {
+        rc = add_alarm(tp, now_tck + delay_tck);
+      }
+    } else if (5 > action) {
+      /* Includes removing alarms that are not pending */
+      rc = remove_alarm(tp);
+    } else {
+      run_until(now_tck + next_random(RANDOM_DELAY_TCK / 8));
+      check_not_late();
+    }
+    /* Adding an alarm that is due returns the positive result of a
+     * forced setting. */
+    if (0 > rc) {
+      FAIL("operation %lu: action %u returned %d", op, action, rc);
+    }
+    check_queue("random operation");
+  }
+  run_until(now_tck + RANDOM_DELAY_TCK + 1);
+  check_not_late();
+  check_queue("random drain");
+  if (0 != num_pending) {
+    FAIL("%u alarms pending after drain", num_pending);
+  }
+  if (added != removed + fired) {
+    FAIL("%lu alarms added, %lu removed, %lu fired", added, removed, fired);
+  }
+  for (i = 0; i < NUM_PERIODIC; ++i) {
+    sTestPeriodic * pp = periodics + i;
+    unsigned long expected = (now_tck - start_tck) / pp->periodic.interval_tck;
+
+    if (expected != pp->calls) {
+      FAIL("periodic alarm %d fired %lu times in %lu ticks, expected %lu",
+           i, pp->calls, now_tck - start_tck, expected);
+    }
+    (void)iBSP430timerMuxPeriodicRemove_ni(shared, &pp->periodic);
+    pp->periodic.alarm.callback_ni = NULL;
+  }
+  check_queue("random end");
+  printf(BACKEND ": %lu operations, %lu alarms added, %lu removed, %lu fired, %lu periodic\n",
+         RANDOM_OPERATIONS, added, removed, fired, periodics[0].calls + periodics[1].calls);
+}
+
+/* Durations of each timed operation, and of reading the clock twice
+ * with nothing between */
+static double empty_s[BENCH_OPERATIONS];
+static double insert_s[BENCH_OPERATIONS];
+static double remove_s[BENCH_OPERATIONS];
+static double fire_s[BENCH_OPERATIONS];
+
+static int
+compare_double (const void * a,
+                const void * b)
+{
+  double da = *(const double *)a;
+  double db = *(const double *)b;
+
+  return (da > db) - (da < db);
+}
+
+static double
+median_ns (double * samples)
+{
+  qsort(samples, BENCH_OPERATIONS, sizeof(*samples), compare_double);
+  return 1e9 * samples[BENCH_OPERATIONS / 2];
+}
+
+/* Time one operation, with the clock read around an empty interval
+ * just before it to measure the cost of timing */
+#define TIME_OPERATION(samples_, op_, stmt_) do {       \
+    double t0_ = dBSP430hostTime();                     \
+    double t1_ = dBSP430hostTime();                     \
+    double t2_;                                         \
+    empty_s[op_] = t1_ - t0_;                           \
+    t1_ = dBSP430hostTime();                            \
+    stmt_;                                              \
+    t2_ = dBSP430hostTime();                            \
+    samples_[op_] = t2_ - t1_;                          \
+  } while (0)
+
+static void
+benchmark (unsigned int n)
+{
+  double insert_ns;
+  double remove_ns;
+  double fire_ns;
+  double empty_ns;
+  unsigned long op;
+  unsigned int i;
+
+  benchmarking = 1;
+  for (i = 0; i < n; ++i) {
+    alarms[i].alarm.callback_ni = alarm_cb_ni;
+    (void)add_alarm(alarms + i, now_tck + 1 + next_random(BENCH_DELAY_TCK));
+  }
+  check_queue("benchmark start");
+
+  for (op = 0; op < BENCH_OPERATIONS; ++op) {
+    sTestAlarm * tp = alarms + next_random(n);
+    unsigned long setting_tck = now_tck + 1 + next_random(BENCH_DELAY_TCK);
+
+    TIME_OPERATION(remove_s, op, (void)remove_alarm(tp));
+    TIME_OPERATION(insert_s, op, (void)add_alarm(tp, setting_tck));
+  }
+  check_queue("benchmark insert and remove");
+
+  /* Take the interrupt for the first alarm, then add the alarms it
+   * fired again */
+  for (op = 0; op < BENCH_OPERATIONS; ++op) {
+    if (shared->dedicated.setting_tck > now_tck) {
+      set_counter(shared->dedicated.setting_tck);
+    }
+    xBSP430hostTA0_.cctl[CCIDX] |= CCIFG;
+    num_refire = 0;
+    TIME_OPERATION(fire_s, op, cc_interrupt());
+    if (0 == num_refire) {
+      FAIL("compare interrupt fired no alarm");
+    }
+    for (i = 0; i < num_refire; ++i) {
+      (void)add_alarm(refire[i], now_tck + 1 + next_random(BENCH_DELAY_TCK));
+    }
+  }
+  check_queue("benchmark fire");
+
+  for (i = 0; i < n; ++i) {
+    (void)remove_alarm(alarms + i);
+  }
+  check_queue("benchmark end");
+  benchmarking = 0;
+
+  empty_ns = median_ns(empty_s);
+  insert_ns = median_ns(insert_s) - empty_ns;
+  remove_ns = median_ns(remove_s) - empty_ns;
+  fire_ns = median_ns(fire_s) - empty_ns;
+  printf(BACKEND ": %4u alarms: insert %4.0f ns, remove %4.0f ns, fire %4.0f ns\n",
+         n, insert_ns, remove_ns, fire_ns);
+}
+
+int
+main (void)
+{
+  vBSP430platformInitialize_ni();
+  timer = hBSP430timerLookup(BSP430_PERIPH_TA0);
+  /* Read the counter register directly */
+  timer->hal_state.flags |= BSP430_TIMER_FLAG_MCLKSYNC;
+  shared = hBSP430timerMuxAlarmStartup(&shared_alarm, BSP430_PERIPH_TA0, CCIDX);
+  if (NULL == shared) {
+    printf(BACKEND ": multiplexed alarm startup failed\n");
+    return 1;
+  }
+  set_counter(0x12345);
+
+  random_phase();
+  benchmark(10);
+  benchmark(100);
+  benchmark(1000);
+
+  if (failures) {
+    printf(BACKEND ": %u failures\n", failures);
+    return 1;
+  }
+  printf(BACKEND ": all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,57 @@
+/* This file is in the public domain.
+ *
+ * Host implementation of the bsp430/utility/unittest.h framework, so
+ * the on-target unit tests under examples can run as host programs.
+ *
+ * Failures are reported as on the target; passes are only counted.
+ * vBSP430unittestFinalize() exits with a nonzero status if any test
+ * failed, instead of flashing an LED.
+ */
+
+#include <bsp430/utility/unittest.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static unsigned int num_passed;
+static unsigned int num_failed;
+
+void
+vBSP430unittestInitialize (void)
+{
+  num_passed = num_failed = 0;
+}
+
+void
+vBSP430unittestResult_ (int line,
+                        int passp,
+                        const char * format,
+                        ...)
+{
+  va_list argp;
+
+  if (passp) {
+    ++num_passed;
+    return;
+  }
+  ++num_failed;
+  printf("FAIL [%u]: ", line);
+  va_start(argp, format);
+  vprintf(format, argp);
+  va_end(argp);
+  putchar('\n');
+#if (configBSP430_UNITTEST_FAILFAST - 0)
+  vBSP430unittestFinalize();
+#endif /* configBSP430_UNITTEST_FAILFAST */
+}
+
+void
+vBSP430unittestFinalize (void)
+{
+  if (0 < num_failed) {
+    printf("# FAIL %u pass %u\n", num_failed, num_passed);
+  } else {
+    printf("# PASSED %u\n", num_passed);
+  }
+  exit(0 < num_failed);
+}
@@ -0,0 +1,125 @@
+/* This file is in the public domain.
+ *
+ * Check bsp430/utility/xtoa.h against the C library.
+ *
+ * The integer conversions are compared with sprintf() at boundary
+ * values, over every 16-bit value, and over random 32-bit values.
+ * The compact formatter iBSP430xtoaVuprintf() is compared with
+ * vsnprintf() for each supported conversion, flag, width, and
+ * precision.  Build with configBSP430_XTOA_USE_RECIPROCAL true and
+ * false to cover both decimal methods.
+ *
+ * Exits with a nonzero status if any check fails.
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/xtoa.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static char out[512];
+static int out_len;
+static unsigned int failures;
+
+static int
+emit (int c)
+{
+  out[out_len++] = c;
+  return c;
+}
+
+static void
+fail (const char * what,
+      const char * got,
+      const char * expected)
+{
+  if (20 > failures++) {
+    printf("xtoa_check: %s: got '%s', expected '%s'\n", what, got, expected);
+  }
+}
+
+static void
+check_format (const char * fmt,
+              ...)
+{
+  char expected[512];
+  va_list ap;
+  va_list ap2;
+  int rv_expected;
+  int rv;
+
+  va_start(ap, fmt);
+  va_copy(ap2, ap);
+  rv_expected = vsnprintf(expected, sizeof(expected), fmt, ap);
+  out_len = 0;
+  rv = iBSP430xtoaVuprintf(emit, fmt, ap2);
+  out[out_len] = 0;
+  va_end(ap2);
+  va_end(ap);
+  if ((rv != rv_expected) || strcmp(out, expected)) {
+    fail(fmt, out, expected);
+  }
+}
+
+#define CHECK_CONVERSION(conv_, fmt_, v_) do {                          \
+    char got[40];                                                       \
+    char expected[40];                                                  \
+    conv_;                                                              \
+    sprintf(expected, fmt_, v_);                                        \
+    if (strcmp(got, expected)) {                                        \
+      fail(#conv_, got, expected);                                      \
+    }                                                                   \
+  } while (0)
+
+int
+main (void)
+{
+  static const unsigned long values[] = {
+    0, 1, 9, 10, 99, 100, 999, 1000, 9999, 10000, 10001, 65535, 65536,
+    99999, 100000, 999999999, 1000000000, 1234567890, 2147483647,
+    2147483648UL, 4000000000UL, 4294967295UL
+  };
+  unsigned int i;
+  long k;
+
+  for (i = 0; i < sizeof(values) / sizeof(*values); ++i) {
+    unsigned long v = values[i];
+    long sv = -(long)(int)v;
+
+    CHECK_CONVERSION(xBSP430xtoaULong(v, got, 10), "%lu", v);
+    CHECK_CONVERSION(xBSP430xtoaULong(v, got, 16), "%lX", v);
+    CHECK_CONVERSION(xBSP430xtoaULong(v, got, 8), "%lo", v);
+    CHECK_CONVERSION(xBSP430xtoaLong(sv, got, 10), "%ld", sv);
+    check_format("%lu|%10lu|%-10lu|%010lu|%.12lu|%lx|%#lx|%#lo|%lX|%+ld|% ld|%ld",
+                 v, v, v, v, v, v, v, v, v, (long)v, (long)v, -(long)v);
+    check_format("%u|%5u|%hu|%hhu|%d|%hd|%hhd|%#o|%.0u|%.0d|%x",
+                 (unsigned int)(v & 0xFFFF), (unsigned int)v, (unsigned int)v,
+                 (unsigned int)v, (int)v, (int)v, (int)v, (unsigned int)v,
+                 (unsigned int)v, (int)v, (unsigned int)v);
+  }
+  for (k = 0; k <= 0xFFFF; ++k) {
+    unsigned int uv = k;
+    int iv = (short)k;
+
+    CHECK_CONVERSION(xBSP430xtoaUInt(uv, got, 10), "%u", uv);
+    CHECK_CONVERSION(xBSP430xtoaInt(iv, got, 10), "%d", iv);
+  }
+  srand(1);
+  for (k = 0; k < 2000000; ++k) {
+    unsigned long v = (((unsigned long)rand() << 17) ^ rand()) & 0xFFFFFFFFUL;
+
+    CHECK_CONVERSION(xBSP430xtoaULong(v, got, 10), "%lu", v);
+  }
+  check_format("a%cb%5c%-3c|%s|%.3s|%8s|%-8s|%*d|%-*d|%.*d|%%|%p",
+               'x', 'y', 'z', "hello", "hello", "hi", "hi", 6, 42, 6, 42, 5, 42, (void *)0x1234);
+  check_format("%#x %#X %#o %#o %05d %-05d %+05d % 05d %.3x",
+               0, 255, 0, 8, -42, -42, 42, 42, 7);
+
+  if (failures) {
+    printf("xtoa: %u failures\n", failures);
+    return 1;
+  }
+  printf("xtoa: all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,149 @@
+"""Host-side decoding of records emitted by bsp430/utility/binlog.h.
+
+The format strings are read from the bsp430_binlog section of the
+application ELF file; the console stream is then passed through
+unchanged except that each record is replaced by its formatted text.
+"""
+
+import re
+import struct
+
+SectionName = 'bsp430_binlog'
+RecordMarker = 0
+
+class ELFError (Exception):
+    pass
+
+def ReadSection (path, name=SectionName):
+    """Return the contents of the named section of a 32-bit ELF file."""
+    data = bytearray(open(path, 'rb').read())
+    if data[:4] != bytearray(b'\x7fELF'):
+        raise ELFError('%s: not an ELF file' % (path,))
+    if 1 != data[4]:
+        raise ELFError('%s: not a 32-bit ELF file' % (path,))
+    endian = '<' if 1 == data[5] else '>'
+    (shoff,) = struct.unpack_from(endian + 'I', bytes(data), 0x20)
+    (shentsize, shnum, shstrndx) = struct.unpack_from(endian + 'HHH', bytes(data), 0x2e)
+    sections = []
+    for i in range(shnum):
+        sh = struct.unpack_from(endian + 'IIIIII', bytes(data), shoff + i * shentsize)
+        sections.append(sh)
+    strtab_offset = sections[shstrndx][4]
+    for sh in sections:
+        nm_end = data.index(0, strtab_offset + sh[0])
+        if name == data[strtab_offset + sh[0]:nm_end].decode('ascii'):
+            return bytes(data[sh[4]:sh[4] + sh[5]])
+    raise ELFError('%s: no %s section' % (path, name))
+
+def FormatTable (section):
+    """Map offsets within the section to the format string found there."""
+    table = {}
+    section = bytearray(section)
+    ofs = 0
+    while ofs < len(section):
+        end = section.index(0, ofs)
+        table[ofs] = section[ofs:end].decode('latin-1')
+        ofs = end + 1
+        # Tolerate alignment padding between strings
+        while (ofs < len(section)) and (0 == section[ofs]):
+            ofs += 1
+    return table
+
+Conversion_re = re.compile(r'%(?P<flags>[-+ #0]*)(?P<width>\*|\d+)?(?:\.(?P<precision>\*|\d*))?(?P<length>h+|l+)?(?P<conv>.)', re.DOTALL)
+
+class Decoder (object):
+    """Convert a console stream containing binary log records to text."""
+
+    def __init__ (self, formats):
+        self.formats = formats
+
+    @staticmethod
+    def _varint (next_octet):
+        v = 0
+        shift = 0
+        while True:
+            b = next_octet()
+            v |= (b & 0x7f) << shift
+            shift += 7
+            if not (b & 0x80):
+                return v
+
+    @classmethod
+    def _zigzag (cls, next_octet):
+        v = cls._varint(next_octet)
+        return (v >> 1) ^ -(v & 1)
+
+    def _render (self, fmt, next_octet):
+        text = []
+        pos = 0
+        for mo in Conversion_re.finditer(fmt):
+            text.append(fmt[pos:mo.start()])
+            pos = mo.end()
+            conv = mo.group('conv')
+            if '%' == conv:
+                text.append('%')
+                continue
+            args = []
+            width = mo.group('width') or ''
+            precision = mo.group('precision')
+            if '*' == width:
+                args.append(self._zigzag(next_octet))
+            if '*' == precision:
+                args.append(self._zigzag(next_octet))
+            spec = '%' + mo.group('flags') + width
+            if precision is not None:
+                spec += '.' + precision
+            if conv in 'di':
+                spec += 'd'
+                args.append(self._zigzag(next_octet))
+            elif conv in 'uxXo':
+                spec += ('d' if 'u' == conv else conv)
+                args.append(self._varint(next_octet))
+            elif 'c' == conv:
+                spec += 'c'
+                args.append(self._varint(next_octet))
+            elif 'p' == conv:
+                spec = '0x%x'
+                args = [self._varint(next_octet)]
+            elif 's' == conv:
+                spec += 's'
+                n = self._varint(next_octet)
+                args.append(bytearray([next_octet() for _ in range(n)]).decode('latin-1'))
+            else:
+                text.append('<binlog: unsupported %%%s>' % (conv,))
+                return ''.join(text)
+            text.append(spec % tuple(args))
+        text.append(fmt[pos:])
+        return ''.join(text)
+
+    def decode (self, octets):
+        """Generate text from an iterable of octet values."""
+        it = iter(octets)
+        next_octet = lambda _it=it: next(_it)
+        text = []
+        while True:
+            try:
+                b = next_octet()
+            except StopIteration:
+                break
+            if RecordMarker != b:
+                text.append(chr(b))
+                if 0x0a == b:
+                    yield ''.join(text)
+                    text = []
+                continue
+            if text:
+                yield ''.join(text)
+                text = []
+            try:
+                fid = self._varint(next_octet)
+                fmt = self.formats.get(fid)
+                if fmt is None:
+                    yield '<binlog: unknown format %u>' % (fid,)
+                else:
+                    yield self._render(fmt, next_octet)
+            except StopIteration:
+                yield '<binlog: truncated record>'
+                break
+        if text:
+            yield ''.join(text)
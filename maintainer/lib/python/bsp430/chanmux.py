@@ -0,0 +1,144 @@
+"""Host-side support for frames emitted by bsp430/utility/chanmux.h.
+
+A console stream carries unframed console text interleaved with
+frames that each hold data for one logical channel.  A frame is a
+delimiter octet, the COBS encoding of the channel identifier, payload,
+and CRC-16, and a second delimiter octet.  Console text is reported as
+channel zero.
+"""
+
+Delimiter = 0
+MaxPayload = 64
+
+def CRC16 (data, crc=0xFFFF):
+    """CRC-16 with the CCITT polynomial, no bit reversal."""
+    for b in bytearray(data):
+        x = ((crc >> 8) ^ b) & 0xFF
+        x ^= x >> 4
+        crc = ((crc << 8) ^ (x << 12) ^ (x << 5) ^ x) & 0xFFFF
+    return crc
+
+def COBSEncode (data):
+    data = bytearray(data)
+    out = bytearray([0])
+    code_pos = 0
+    code = 1
+    for b in data:
+        if 0 == b:
+            out[code_pos] = code
+            code_pos = len(out)
+            out.append(0)
+            code = 1
+            continue
+        out.append(b)
+        code += 1
+        if 0xFF == code:
+            out[code_pos] = code
+            code_pos = len(out)
+            out.append(0)
+            code = 1
+    out[code_pos] = code
+    return bytes(out)
+
+class FrameError (Exception):
+    pass
+
+def COBSDecode (data):
+    data = bytearray(data)
+    out = bytearray()
+    ip = 0
+    while ip < len(data):
+        code = data[ip]
+        ip += 1
+        if 0 == code:
+            raise FrameError('delimiter within frame')
+        if (ip + code - 1) > len(data):
+            raise FrameError('truncated frame')
+        out.extend(data[ip:ip + code - 1])
+        ip += code - 1
+        if (0xFF != code) and (ip < len(data)):
+            out.append(0)
+    return bytes(out)
+
+def EncodeFrame (channel, payload):
+    """Return the octets that carry payload on the given channel."""
+    if not (1 <= channel <= 255):
+        raise ValueError('channel %d out of range' % (channel,))
+    raw = bytearray([channel]) + bytearray(payload)
+    crc = CRC16(raw)
+    raw.extend([crc & 0xFF, crc >> 8])
+    return bytes(bytearray([Delimiter]) + bytearray(COBSEncode(raw)) + bytearray([Delimiter]))
+
+def DecodeFrame (frame):
+    """Decode a frame without its delimiters; return (channel, payload)."""
+    raw = bytearray(COBSDecode(frame))
+    if 3 > len(raw):
+        raise FrameError('short frame')
+    if CRC16(raw[:-2]) != (raw[-2] | (raw[-1] << 8)):
+        raise FrameError('CRC mismatch')
+    return (raw[0], bytes(raw[1:-2]))
+
+class Demux (object):
+    """Separate a console stream into per-channel data."""
+
+    def __init__ (self):
+        self.frame = None
+        self.crc_errors = 0
+        self.framing_errors = 0
+
+    def feed (self, octets):
+        """Generate (channel, data) pairs from a block of octets.
+
+        Channel zero carries console text.  Frames that fail
+        validation are counted and discarded."""
+        text = bytearray()
+        for b in bytearray(octets):
+            if self.frame is None:
+                if Delimiter == b:
+                    if text:
+                        yield (0, bytes(text))
+                        text = bytearray()
+                    self.frame = bytearray()
+                else:
+                    text.append(b)
+                continue
+            if Delimiter != b:
+                self.frame.append(b)
+                continue
+            if not self.frame:
+                continue
+            frame = self.frame
+            self.frame = None
+            try:
+                yield DecodeFrame(frame)
+            except FrameError as e:
+                if 'CRC mismatch' == str(e):
+                    self.crc_errors += 1
+                else:
+                    self.framing_errors += 1
+        if text:
+            yield (0, bytes(text))
+
+def DecodeMemory (payload):
+    """Decode a frame sent by iBSP430chanmuxSendMemory; return
+    (address, data)."""
+    payload = bytearray(payload)
+    if 4 > len(payload):
+        raise FrameError('short memory frame')
+    address = payload[0] | (payload[1] << 8) | (payload[2] << 16) | (payload[3] << 24)
+    return (address, bytes(payload[4:]))
+
+def FormatMemory (address, data):
+    """Render data as rows like vBSP430consoleDisplayMemory."""
+    data = bytearray(data)
+    lines = []
+    while data:
+        ofs = address & 0x0F
+        n = min(16 - ofs, len(data))
+        row = data[:n]
+        hexes = ['  '] * ofs + ['%02x' % (_b,) for _b in row] + ['  '] * (16 - ofs - n)
+        text = ' ' * ofs + ''.join([chr(_b) if (0x20 <= _b < 0x7f) else '.' for _b in row])
+        lines.append('%08x  %s  %s  %s' % (address & ~0x0F, ' '.join(hexes[:8]), ' '.join(hexes[8:]), text))
+        address += n
+        data = data[n:]
+    return lines
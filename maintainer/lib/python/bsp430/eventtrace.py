@@ -0,0 +1,106 @@
+"""Host-side decoding of streams produced by bsp430/utility/eventtrace.h.
+
+A stream is a sequence of records.  Control records begin with 0xFF
+and establish the time base or name a tag; all other records are
+events holding a tag, flags, the uptime ticks since the previous
+event, the tag sequence number, and a 32-bit value.  Integers are
+base-128 varints.
+"""
+
+Control = 0xFF
+ControlSync = 0x01
+ControlTag = 0x02
+
+class TraceError (Exception):
+    pass
+
+class Event (object):
+    """A decoded event record.  time_utt is the uptime extended
+    beyond 32 bits; time_s is the same in seconds."""
+    def __init__ (self, tag, name, flags, time_utt, time_s, seqno, value):
+        self.tag = tag
+        self.name = name
+        self.flags = flags
+        self.time_utt = time_utt
+        self.time_s = time_s
+        self.seqno = seqno
+        self.value = value
+
+class Decoder (object):
+    """Incrementally decode a stream.
+
+    Octets may be supplied in arbitrary pieces; records that span
+    pieces are completed by later calls to feed()."""
+
+    def __init__ (self):
+        self.buffer = bytearray()
+        self.frequency_Hz = None
+        self.time_utt = None
+        self.tags = {}
+
+    @staticmethod
+    def _varint (data, ip):
+        v = 0
+        shift = 0
+        while True:
+            if ip >= len(data):
+                return (None, ip)
+            b = data[ip]
+            ip += 1
+            v |= (b & 0x7f) << shift
+            shift += 7
+            if not (b & 0x80):
+                return (v, ip)
+
+    def _record (self, data, ip):
+        """Decode the record at ip, returning the event (or None for
+        a control record) and the offset following the record.
+        Raises IndexError if the record is incomplete."""
+        lead = data[ip]
+        if Control == lead:
+            kind = data[ip + 1]
+            if ControlSync == kind:
+                (hz, ip) = self._varint(data, ip + 2)
+                (ts, ip) = self._varint(data, ip)
+                if ts is None:
+                    raise IndexError
+                self.frequency_Hz = hz
+                self.time_utt = ts
+                return (None, ip)
+            if ControlTag == kind:
+                tag = data[ip + 2]
+                idlen = data[ip + 3]
+                end = ip + 4 + idlen
+                if end > len(data):
+                    raise IndexError
+                self.tags[tag] = data[ip + 4:end].decode('latin-1')
+                return (None, end)
+            raise TraceError('unrecognized control record %u' % (kind,))
+        flags = data[ip + 1]
+        (delta, ip) = self._varint(data, ip + 2)
+        (seqno, ip) = self._varint(data, ip)
+        (value, ip) = self._varint(data, ip)
+        if value is None:
+            raise IndexError
+        if self.time_utt is None:
+            raise TraceError('event record precedes synchronization')
+        self.time_utt += delta
+        return (Event(lead, self.tags.get(lead, 'tag%u' % (lead,)), flags,
+                      self.time_utt, float(self.time_utt) / self.frequency_Hz,
+                      seqno, value), ip)
+
+    def feed (self, data):
+        """Add octets to the stream and return the list of events
+        completed by them."""
+        self.buffer.extend(bytearray(data))
+        events = []
+        ip = 0
+        while ip < len(self.buffer):
+            try:
+                (evt, ip) = self._record(self.buffer, ip)
+            except IndexError:
+                break
+            if evt is not None:
+                events.append(evt)
+        del self.buffer[:ip]
+        return events
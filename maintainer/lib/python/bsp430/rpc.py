@@ -0,0 +1,167 @@
+"""Host-side client for bsp430/utility/rpc.h.
+
+Requests and responses are carried in frames on a
+bsp430/utility/chanmux.h channel.  Each begins with a header of a
+sequence number, an operation code, and a 16-bit little-endian command
+number, followed by type-length-value fields.  Commands are numbered
+by a depth-first walk of the device command hierarchy; the client
+learns the numbers by name with a LIST request.
+"""
+
+import numbers
+import os
+import select
+import struct
+
+import bsp430.chanmux
+
+OP_LIST = 0x01
+OP_CALL = 0x02
+OP_RESPONSE = 0x80
+
+TLV_INT = 0x01
+TLV_UINT = 0x02
+TLV_TEXT = 0x03
+TLV_STATUS = 0x04
+TLV_NAME = 0x05
+
+HeaderLength = 4
+
+# The longest text argument: whatever remains of a frame after the
+# header and the field type and length octets.  This matches the
+# default BSP430_RPC_TEXT_LENGTH.
+MaxTextLength = bsp430.chanmux.MaxPayload - HeaderLength - 2
+
+class RPCError (Exception):
+    pass
+
+def EncodeInteger (value):
+    """Return a field holding value in the smallest of 1, 2, or 4
+    octets; signed only if value is negative."""
+    if 0 > value:
+        for (fmt, lo) in (('<b', -0x80), ('<h', -0x8000), ('<i', -0x80000000)):
+            if lo <= value:
+                data = struct.pack(fmt, value)
+                return bytearray([TLV_INT, len(data)]) + bytearray(data)
+    else:
+        for (fmt, hi) in (('<B', 0xFF), ('<H', 0xFFFF), ('<I', 0xFFFFFFFF)):
+            if value <= hi:
+                data = struct.pack(fmt, value)
+                return bytearray([TLV_UINT, len(data)]) + bytearray(data)
+    raise ValueError('%d does not fit in 32 bits' % (value,))
+
+def EncodeText (text):
+    if not isinstance(text, bytes):
+        text = text.encode('latin-1')
+    if MaxTextLength < len(text):
+        raise ValueError('text longer than %u octets' % (MaxTextLength,))
+    return bytearray([TLV_TEXT, len(text)]) + bytearray(text)
+
+def EncodeRequest (seq, op, cmd_id, fields=b''):
+    return bytes(bytearray(struct.pack('<BBH', seq & 0xFF, op, cmd_id)) + bytearray(fields))
+
+def DecodeFields (data):
+    """Generate (type, value) pairs from the fields of a response.
+    Integer fields are converted to Python integers."""
+    data = bytearray(data)
+    ip = 0
+    while ip < len(data):
+        if (ip + 2) > len(data):
+            raise RPCError('truncated field header')
+        (ftype, flen) = data[ip:ip + 2]
+        value = bytes(data[ip + 2:ip + 2 + flen])
+        if len(value) != flen:
+            raise RPCError('truncated field')
+        ip += 2 + flen
+        if ftype in (TLV_INT, TLV_UINT, TLV_STATUS):
+            v = 0
+            for b in reversed(bytearray(value)):
+                v = (v << 8) | b
+            if (TLV_UINT != ftype) and flen and (0x80 & bytearray(value)[-1]):
+                v -= 1 << (8 * flen)
+            value = v
+        elif TLV_NAME == ftype:
+            value = value.decode('latin-1')
+        yield (ftype, value)
+
+def DecodeResponse (payload):
+    """Return (seq, op, cmd_id, fields) for a response payload."""
+    if HeaderLength > len(payload):
+        raise RPCError('short response')
+    (seq, op, cmd_id) = struct.unpack('<BBH', payload[:4])
+    return (seq, op, cmd_id, list(DecodeFields(payload[4:])))
+
+class Client (object):
+    """Issue requests to a device over a raw console file descriptor.
+
+    Console text received while waiting for a response is passed to
+    text_handler, which by default discards it."""
+
+    def __init__ (self, fd, channel, text_handler=None, timeout=2.0):
+        self.fd = fd
+        self.channel = channel
+        self.text_handler = text_handler
+        self.timeout = timeout
+        self.seq = 0
+        self.demux = bsp430.chanmux.Demux()
+        self.pending = []
+        self.ids = None
+
+    def transact (self, op, cmd_id, fields=b''):
+        """Send a request and return the fields of its response."""
+        self.seq = (self.seq + 1) & 0xFF
+        request = EncodeRequest(self.seq, op, cmd_id, fields)
+        os.write(self.fd, bsp430.chanmux.EncodeFrame(self.channel, request))
+        while True:
+            while self.pending:
+                (ch, data) = self.pending.pop(0)
+                if 0 == ch:
+                    if self.text_handler is not None:
+                        self.text_handler(data)
+                    continue
+                if self.channel != ch:
+                    continue
+                (seq, rop, rid, rfields) = DecodeResponse(data)
+                if (self.seq == seq) and ((OP_RESPONSE | op) == rop) and (cmd_id == rid):
+                    return rfields
+            (ready, _, _) = select.select([self.fd], [], [], self.timeout)
+            if not ready:
+                raise RPCError('timeout waiting for response %u' % (self.seq,))
+            self.pending.extend(self.demux.feed(os.read(self.fd, 1024)))
+
+    def commands (self):
+        """Return a map from full command name to command number."""
+        if self.ids is None:
+            ids = {}
+            next_id = 0
+            while True:
+                names = [_v for (_t, _v) in self.transact(OP_LIST, next_id) if TLV_NAME == _t]
+                if not names:
+                    break
+                for n in names:
+                    ids[n] = next_id
+                    next_id += 1
+            self.ids = ids
+        return self.ids
+
+    def call (self, command, arg=None):
+        """Execute a command identified by name or number.
+
+        arg may be an integer, for commands that store a value, or
+        text.  Returns (status, value) where value is the integer
+        returned by a store command or None."""
+        if not isinstance(command, numbers.Integral):
+            command = self.commands()[command]
+        fields = b''
+        if isinstance(arg, numbers.Integral):
+            fields = EncodeInteger(arg)
+        elif arg is not None:
+            fields = EncodeText(arg)
+        status = None
+        value = None
+        for (ftype, fvalue) in self.transact(OP_CALL, command, fields):
+            if TLV_STATUS == ftype:
+                status = fvalue
+            elif ftype in (TLV_INT, TLV_UINT):
+                value = fvalue
+        return (status, value)
@@ -392,6 +392,36 @@ ulBSP430timerCounter_ni (hBSP430halTIMER timer,
   return (overflow_count << 16) + r;
 }
 
+unsigned long
+ulBSP430timerCounter (hBSP430halTIMER timer,
+                      unsigned int * overflowp)
+{
+  /* The low word of the overflow counter is the sequence number; the
+   * MSP430 is little-endian so it is the first word.  All reads of
+   * shared state go through volatile lvalues so they are repeated on
+   * each attempt. */
+  volatile unsigned int * const seqp = (volatile unsigned int *)&timer->overflow_count;
+  volatile unsigned long * const ocp = &timer->overflow_count;
+  unsigned int seq;
+  unsigned int r;
+  unsigned long overflow_count;
+
+  do {
+    seq = *seqp;
+    r = uiBSP430timerBestCounterRead_ni(timer->hpl, timer->hal_state.flags);
+    overflow_count = *ocp;
+    /* As in timerOverflowAdjusted_ni(): an overflow that has not yet
+     * been handled counts only if the counter was read after it. */
+    if ((0 <= (int)r) && (timer->hpl->ctl & TAIFG)) {
+      ++overflow_count;
+    }
+  } while (seq != *seqp);
+  if (overflowp) {
+    *overflowp = overflow_count >> 16;
+  }
+  return (overflow_count << 16) + r;
+}
+
 unsigned long
 ulBSP430timerCaptureCounter_ni (hBSP430halTIMER timer,
                                 unsigned int ccidx)
@@ -664,6 +694,122 @@ iBSP430timerAlarmCancel_ni (hBSP430timerAlarm alarm)
   return 1;
 }
 
+/* The multiplexed alarm callback for periodic alarms.  This also
+ * identifies periodic alarms to muxAlarm_cb_ni(). */
+static int
+muxPeriodic_cb_ni (hBSP430timerMuxSharedAlarm shared,
+                   hBSP430timerMuxAlarm alarm)
+{
+  hBSP430timerMuxPeriodic pp = (sBSP430timerMuxPeriodic *)(-offsetof(sBSP430timerMuxPeriodic, alarm) + (char *)alarm);
+  return pp->callback_ni(shared, pp);
+}
+
+/* True if alarm a_ is periodic and should be re-armed in place */
+#define MUX_ALARM_REARMS(a_) ((muxPeriodic_cb_ni == (a_)->callback_ni)  \
+                              && (0 != ((sBSP430timerMuxPeriodic *)(-offsetof(sBSP430timerMuxPeriodic, alarm) + (char *)(a_)))->interval_tck))
+
+/* Advance the setting of a due periodic alarm according to its
+ * policy, recording overruns. */
+static void
+muxPeriodicAdvance_ni (hBSP430timerMuxAlarm alarm,
+                       unsigned long now_tck)
+{
+  hBSP430timerMuxPeriodic pp = (sBSP430timerMuxPeriodic *)(-offsetof(sBSP430timerMuxPeriodic, alarm) + (char *)alarm);
+  unsigned long late_tck = now_tck - alarm->setting_tck;
+  unsigned long missed = 0;
+
+  if (late_tck >= pp->interval_tck) {
+    missed = late_tck / pp->interval_tck;
+  }
+  pp->periods_ni = 1;
+  if (eBSP430timerMuxPeriodicPolicy_BURST == pp->policy) {
+    /* Each catch-up invocation accounts for one missed boundary. */
+    if (0 != missed) {
+      ++pp->overruns_ni;
+    }
+    alarm->setting_tck += pp->interval_tck;
+    return;
+  }
+  pp->overruns_ni += missed;
+  if (eBSP430timerMuxPeriodicPolicy_COALESCE == pp->policy) {
+    pp->periods_ni += missed;
+  }
+  alarm->setting_tck += (missed + 1) * pp->interval_tck;
+}
+
+#if (configBSP430_TIMER_MUX_ALARM_HEAP - 0)
+
+/* True if alarm a_ is due before alarm b_ */
+#define MUX_ALARM_BEFORE(a_, b_) (0 > (long)((a_)->setting_tck - (b_)->setting_tck))
+
+static BSP430_CORE_INLINE
+void
+muxHeapPlace_ni (hBSP430timerMuxSharedAlarm sap,
+                 unsigned int idx,
+                 hBSP430timerMuxAlarm alarm)
+{
+  sap->heap[idx] = alarm;
+  alarm->heap_idx = idx;
+}
+
+/* Store alarm at or above idx, moving later parents down. */
+static void
+muxHeapSiftUp_ni (hBSP430timerMuxSharedAlarm sap,
+                  unsigned int idx,
+                  hBSP430timerMuxAlarm alarm)
+{
+  while (0 < idx) {
+    unsigned int parent = (idx - 1) / 2;
+    if (! MUX_ALARM_BEFORE(alarm, sap->heap[parent])) {
+      break;
+    }
+    muxHeapPlace_ni(sap, idx, sap->heap[parent]);
+    idx = parent;
+  }
+  muxHeapPlace_ni(sap, idx, alarm);
+}
+
+/* Store alarm at or below idx, moving earlier children up. */
+static void
+muxHeapSiftDown_ni (hBSP430timerMuxSharedAlarm sap,
+                    unsigned int idx,
+                    hBSP430timerMuxAlarm alarm)
+{
+  const unsigned int count = sap->heap_count;
+
+  while (1) {
+    unsigned int child = 2 * idx + 1;
+    if (child >= count) {
+      break;
+    }
+    if (((child + 1) < count) && MUX_ALARM_BEFORE(sap->heap[child + 1], sap->heap[child])) {
+      ++child;
+    }
+    if (! MUX_ALARM_BEFORE(sap->heap[child], alarm)) {
+      break;
+    }
+    muxHeapPlace_ni(sap, idx, sap->heap[child]);
+    idx = child;
+  }
+  muxHeapPlace_ni(sap, idx, alarm);
+}
+
+/* Remove the alarm at idx, filling the hole with the last alarm. */
+static void
+muxHeapRemove_ni (hBSP430timerMuxSharedAlarm sap,
+                  unsigned int idx)
+{
+  hBSP430timerMuxAlarm last = sap->heap[--sap->heap_count];
+
+  if (idx < sap->heap_count) {
+    if ((0 < idx) && MUX_ALARM_BEFORE(last, sap->heap[(idx - 1) / 2])) {
+      muxHeapSiftUp_ni(sap, idx, last);
+    } else {
+      muxHeapSiftDown_ni(sap, idx, last);
+    }
+  }
+}
+
 /* The capture/compare callback registered for enabled alarms.  It is
  * responsible for clearing the alarm and invoking the user-provided
  * callback. */
@@ -672,32 +818,108 @@ muxAlarm_cb_ni (hBSP430timerAlarm alarm)
 {
   hBSP430timerMuxSharedAlarm sap = (sBSP430timerMuxSharedAlarm *)(-offsetof(sBSP430timerMuxSharedAlarm, dedicated) + (char *)alarm);
   unsigned long now_tck = ulBSP430timerCounter_ni(sap->dedicated.timer, NULL);
-  hBSP430timerMuxAlarm fired = sap->alarms;
-  hBSP430timerMuxAlarm * ap = &sap->alarms;
+  hBSP430timerMuxAlarm fired = NULL;
+  hBSP430timerMuxAlarm * ap = &fired;
   int rv = 0;
 
-  while (NULL != *ap) {
-    if (0 < ((long)((*ap)->setting_tck) - (long)now_tck)) {
+  /* Collect the due alarms before invoking any callback, since
+   * callbacks may add alarms that are already due.  Periodic alarms
+   * are re-armed in place and invoked immediately; the dedicated
+   * alarm is reprogrammed once when all due alarms are handled. */
+  vBSP430timerMuxAlarmBegin_ni(sap);
+  while (0 < sap->heap_count) {
+    hBSP430timerMuxAlarm first = sap->heap[0];
+    if (0 < ((long)(first->setting_tck) - (long)now_tck)) {
       break;
     }
-    ap = &(*ap)->next;
-  }
-  sap->alarms = *ap;
-  if (sap->alarms) {
-    (void)timerAlarmSet_ni(&sap->dedicated, sap->alarms->setting_tck, 1);
-  }
-  if (fired != sap->alarms) {
-    *ap = NULL;
-    while (NULL != fired) {
-      hBSP430timerMuxAlarm notify = fired;
-      fired = notify->next;
-      notify->next = NULL;
-      rv |= notify->callback_ni(sap, notify);
+    if (MUX_ALARM_REARMS(first)) {
+      muxPeriodicAdvance_ni(first, now_tck);
+      muxHeapSiftDown_ni(sap, 0, first);
+      rv |= first->callback_ni(sap, first);
+      continue;
     }
+    muxHeapRemove_ni(sap, 0);
+    *ap = first;
+    ap = &first->next;
+  }
+  *ap = NULL;
+  (void)iBSP430timerMuxAlarmCommit_ni(sap);
+  while (NULL != fired) {
+    hBSP430timerMuxAlarm notify = fired;
+    fired = notify->next;
+    notify->next = NULL;
+    rv |= notify->callback_ni(sap, notify);
   }
   return rv;
 }
 
+#else /* configBSP430_TIMER_MUX_ALARM_HEAP */
+
+/* Insert the alarm into the sequence after any alarm that should
+ * fire at or before the time of the new alarm. */
+static void
+muxListInsert_ni (hBSP430timerMuxSharedAlarm sap,
+                  hBSP430timerMuxAlarm alarm,
+                  unsigned long now_tck)
+{
+  hBSP430timerMuxAlarm * np = &sap->alarms;
+  long delay_tck = alarm->setting_tck - now_tck;
+
+  while (NULL != *np) {
+    long next_delay_tck = (*np)->setting_tck - now_tck;
+    if (next_delay_tck > delay_tck) {
+      break;
+    }
+    np = &(*np)->next;
+  }
+  alarm->next = *np;
+  *np = alarm;
+}
+
+/* The capture/compare callback registered for enabled alarms.  It is
+ * responsible for clearing the alarm and invoking the user-provided
+ * callback. */
+static int
+muxAlarm_cb_ni (hBSP430timerAlarm alarm)
+{
+  hBSP430timerMuxSharedAlarm sap = (sBSP430timerMuxSharedAlarm *)(-offsetof(sBSP430timerMuxSharedAlarm, dedicated) + (char *)alarm);
+  unsigned long now_tck = ulBSP430timerCounter_ni(sap->dedicated.timer, NULL);
+  hBSP430timerMuxAlarm fired = NULL;
+  hBSP430timerMuxAlarm * ap = &fired;
+  int rv = 0;
+
+  /* Periodic alarms are moved directly from the head to their next
+   * position and invoked immediately; others are collected and
+   * invoked after the dedicated alarm has been reprogrammed once. */
+  vBSP430timerMuxAlarmBegin_ni(sap);
+  while (NULL != sap->alarms) {
+    hBSP430timerMuxAlarm first = sap->alarms;
+    if (0 < ((long)(first->setting_tck) - (long)now_tck)) {
+      break;
+    }
+    sap->alarms = first->next;
+    if (MUX_ALARM_REARMS(first)) {
+      muxPeriodicAdvance_ni(first, now_tck);
+      muxListInsert_ni(sap, first, now_tck);
+      rv |= first->callback_ni(sap, first);
+      continue;
+    }
+    *ap = first;
+    ap = &first->next;
+  }
+  *ap = NULL;
+  (void)iBSP430timerMuxAlarmCommit_ni(sap);
+  while (NULL != fired) {
+    hBSP430timerMuxAlarm notify = fired;
+    fired = notify->next;
+    notify->next = NULL;
+    rv |= notify->callback_ni(sap, notify);
+  }
+  return rv;
+}
+
+#endif /* configBSP430_TIMER_MUX_ALARM_HEAP */
+
 hBSP430timerMuxSharedAlarm
 hBSP430timerMuxAlarmStartup (sBSP430timerMuxSharedAlarm * shared,
                              tBSP430periphHandle periph,
@@ -743,31 +965,68 @@ iBSP430timerMuxAlarmShutdown (hBSP430timerMuxSharedAlarm shared)
   return rc;
 }
 
+#if (configBSP430_TIMER_MUX_ALARM_HEAP - 0)
+
 int
 iBSP430timerMuxAlarmAdd_ni (hBSP430timerMuxSharedAlarm shared,
                             hBSP430timerMuxAlarm alarm)
 {
-  int rc;
+  int rc = 0;
 
-  rc = iBSP430timerAlarmCancel_ni(&shared->dedicated);
-  if (0 <= rc) {
-    hBSP430timerMuxAlarm * np = &shared->alarms;
-    hBSP430halTIMER timer = shared->dedicated.timer;
-    unsigned long now_tck = ulBSP430timerCounter_ni(timer, NULL);
-    long delay_tck = alarm->setting_tck - now_tck;
+  if (BSP430_TIMER_MUX_ALARM_HEAP_CAPACITY <= shared->heap_count) {
+    return -1;
+  }
+  muxHeapSiftUp_ni(shared, shared->heap_count++, alarm);
+  /* The dedicated alarm need change only if the new alarm is the
+   * first to fire. */
+  if ((0 == alarm->heap_idx) && (! shared->batch_ni)) {
+    rc = iBSP430timerAlarmCancel_ni(&shared->dedicated);
+    if (0 <= rc) {
+      rc = timerAlarmSet_ni(&shared->dedicated, alarm->setting_tck, 1);
+    }
+  }
+  return rc;
+}
 
-    /* Insert the alarm into the sequence after any alarm that should
-     * fire at or before the time of the new alarm. */
-    while (NULL != *np) {
-      long next_delay_tck = (*np)->setting_tck - now_tck;
-      if (next_delay_tck > delay_tck) {
-        break;
-      }
-      np = &(*np)->next;
+int
+iBSP430timerMuxAlarmRemove_ni (hBSP430timerMuxSharedAlarm shared,
+                               hBSP430timerMuxAlarm alarm)
+{
+  unsigned int idx = alarm->heap_idx;
+  int rc = 0;
+
+  if ((idx >= shared->heap_count) || (alarm != shared->heap[idx])) {
+    return rc;
+  }
+  muxHeapRemove_ni(shared, idx);
+  if ((0 == idx) && (! shared->batch_ni)) {
+    rc = iBSP430timerAlarmCancel_ni(&shared->dedicated);
+    if ((0 <= rc) && (0 < shared->heap_count)) {
+      rc = timerAlarmSet_ni(&shared->dedicated, shared->heap[0]->setting_tck, 1);
+    } else if (0 < rc) {
+      rc = 0;
+    }
+  }
+  return rc;
+}
+
+#else /* configBSP430_TIMER_MUX_ALARM_HEAP */
+
+int
+iBSP430timerMuxAlarmAdd_ni (hBSP430timerMuxSharedAlarm shared,
+                            hBSP430timerMuxAlarm alarm)
+{
+  int rc = 0;
+
+  if (! shared->batch_ni) {
+    rc = iBSP430timerAlarmCancel_ni(&shared->dedicated);
+  }
+  if (0 <= rc) {
+    muxListInsert_ni(shared, alarm, ulBSP430timerCounter_ni(shared->dedicated.timer, NULL));
+    rc = 0;
+    if (! shared->batch_ni) {
+      rc = timerAlarmSet_ni(&shared->dedicated, shared->alarms->setting_tck, 1);
     }
-    alarm->next = *np;
-    *np = alarm;
-    rc = timerAlarmSet_ni(&shared->dedicated, shared->alarms->setting_tck, 1);
   }
   return rc;
 }
@@ -776,9 +1035,11 @@ int
 iBSP430timerMuxAlarmRemove_ni (hBSP430timerMuxSharedAlarm shared,
                                hBSP430timerMuxAlarm alarm)
 {
-  int rc;
+  int rc = 0;
 
-  rc = iBSP430timerAlarmCancel_ni(&shared->dedicated);
+  if (! shared->batch_ni) {
+    rc = iBSP430timerAlarmCancel_ni(&shared->dedicated);
+  }
   if (0 <= rc) {
     hBSP430timerMuxAlarm * np = &shared->alarms;
     while (NULL != *np) {
@@ -789,13 +1050,56 @@ iBSP430timerMuxAlarmRemove_ni (hBSP430timerMuxSharedAlarm shared,
       np = &(*np)->next;
     }
     rc = 0;
-    if (NULL != shared->alarms) {
+    if ((NULL != shared->alarms) && (! shared->batch_ni)) {
       rc = timerAlarmSet_ni(&shared->dedicated, shared->alarms->setting_tck, 1);
     }
   }
   return rc;
 }
 
+#endif /* configBSP430_TIMER_MUX_ALARM_HEAP */
+
+int
+iBSP430timerMuxAlarmCommit_ni (hBSP430timerMuxSharedAlarm shared)
+{
+#if (configBSP430_TIMER_MUX_ALARM_HEAP - 0)
+  hBSP430timerMuxAlarm first = (0 < shared->heap_count) ? shared->heap[0] : NULL;
+#else /* configBSP430_TIMER_MUX_ALARM_HEAP */
+  hBSP430timerMuxAlarm first = shared->alarms;
+#endif /* configBSP430_TIMER_MUX_ALARM_HEAP */
+  int rc;
+
+  shared->batch_ni = 0;
+  if ((NULL != first)
+      && (BSP430_TIMER_ALARM_FLAG_SET & shared->dedicated.flags)
+      && (first->setting_tck == shared->dedicated.setting_tck)) {
+    return 0;
+  }
+  rc = iBSP430timerAlarmCancel_ni(&shared->dedicated);
+  if (0 <= rc) {
+    rc = 0;
+    if (NULL != first) {
+      rc = timerAlarmSet_ni(&shared->dedicated, first->setting_tck, 1);
+    }
+  }
+  return rc;
+}
+
+int
+iBSP430timerMuxPeriodicAdd_ni (hBSP430timerMuxSharedAlarm shared,
+                               hBSP430timerMuxPeriodic periodic,
+                               unsigned long setting_tck)
+{
+  if (NULL == periodic->callback_ni) {
+    return -1;
+  }
+  periodic->alarm.setting_tck = setting_tck;
+  periodic->alarm.callback_ni = muxPeriodic_cb_ni;
+  periodic->overruns_ni = 0;
+  periodic->periods_ni = 1;
+  return iBSP430timerMuxAlarmAdd_ni(shared, &periodic->alarm);
+}
+
 static int
 pulsecap_isr (const struct sBSP430halISRIndexedChainNode * cb,
               void * context,
@@ -89,26 +89,6 @@ peripheralConfigFlag (unsigned char ctl0)
   return 0;
 }
 
-struct sBSP430usciHPLAux {
-  /** Pointer to the interrupt enable register for the peripheral */
-  volatile unsigned char * const iep;
-
-  /** Pointer to the interrupt flag register for the peripheral */
-  volatile unsigned char * const ifgp;
-
-  /** Bit within *iep and *ifgp used to denote an RX interrupt */
-  unsigned char const rx_bit;
-
-  /** Bit within *iep and *ifgp used to denote a TX interrupt */
-  unsigned char const tx_bit;
-
-  /** I2C own address register (USCI_Bx only) */
-  volatile unsigned int * i2coap;
-
-  /** I2C slave address register (USCI_Bx only) */
-  volatile unsigned int * i2csap;
-};
-
 #define HAL_HPL_IS_USCI_A(hal_) (NULL == SERIAL_HAL_HPLAUX(hal_)->i2coap)
 #define HAL_HPL_IS_USCI_B(hal_) (NULL != SERIAL_HAL_HPLAUX(hal_)->i2coap)
 
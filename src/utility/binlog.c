@@ -0,0 +1,246 @@
+/* Copyright 2014, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/binlog.h>
+#include <string.h>
+#if (BSP430_BINLOG_CHANMUX_ID - 0)
+#include <bsp430/utility/chanmux.h>
+#endif /* BSP430_BINLOG_CHANMUX_ID */
+
+#if (BSP430_CONSOLE - 0)
+
+/* Start of the format string section, provided by the linker */
+extern const char __start_bsp430_binlog[];
+
+/* Maximum length of a varint holding a 64-bit value */
+#define VARINT_MAX_OCTETS 10
+
+/* Upper bound on octets encoded for one conversion: the value plus
+ * a star width and a star precision. */
+#define CONVERSION_MAX_OCTETS (3 * VARINT_MAX_OCTETS)
+
+#if ((BSP430_BINLOG_RECORD_LENGTH < (1 + VARINT_MAX_OCTETS))     \
+     || (16384 <= BSP430_BINLOG_RECORD_LENGTH))
+#error BSP430_BINLOG_RECORD_LENGTH out of range
+#endif /* BSP430_BINLOG_RECORD_LENGTH */
+
+#if (BSP430_BINLOG_CHANMUX_ID - 0)
+#if (BSP430_CHANMUX_MAX_PAYLOAD < BSP430_BINLOG_RECORD_LENGTH)
+#error BSP430_BINLOG_RECORD_LENGTH exceeds BSP430_CHANMUX_MAX_PAYLOAD
+#endif /* BSP430_BINLOG_RECORD_LENGTH */
+/* Records are assembled at the payload offset of a frame buffer, which
+ * has room for the frame octets that follow the payload. */
+#define RECORD_OFFSET BSP430_CHANMUX_PAYLOAD_OFFSET
+#define RECORD_TRAILER (BSP430_CHANMUX_FRAME_OVERHEAD - BSP430_CHANMUX_PAYLOAD_OFFSET)
+#else /* BSP430_BINLOG_CHANMUX_ID */
+#define RECORD_OFFSET 0
+#define RECORD_TRAILER 0
+#endif /* BSP430_BINLOG_CHANMUX_ID */
+
+static uint8_t *
+encode_ul (uint8_t * bp,
+           unsigned long v)
+{
+  while (0x80 <= v) {
+    *bp++ = 0x80 | (uint8_t)v;
+    v >>= 7;
+  }
+  *bp++ = (uint8_t)v;
+  return bp;
+}
+
+static uint8_t *
+encode_ull (uint8_t * bp,
+            unsigned long long v)
+{
+  while (0x80 <= v) {
+    *bp++ = 0x80 | (uint8_t)v;
+    v >>= 7;
+  }
+  *bp++ = (uint8_t)v;
+  return bp;
+}
+
+static uint8_t *
+encode_zz (uint8_t * bp,
+           long v)
+{
+  return encode_ul(bp, ((unsigned long)v << 1) ^ (unsigned long)(v >> (8 * sizeof(v) - 1)));
+}
+
+/* Write a complete record, which begins at RECORD_OFFSET in buffer, to
+ * the console with interrupts disabled so output from interrupt
+ * handlers cannot be placed within it. */
+static int
+emit_record (uint8_t * buffer,
+             size_t len)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  int rv;
+
+#if (BSP430_BINLOG_CHANMUX_ID - 0)
+  len = uiBSP430chanmuxEncodeFrame(buffer, BSP430_BINLOG_CHANMUX_ID, len);
+#endif /* BSP430_BINLOG_CHANMUX_ID */
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rv = cputoctets(buffer, len);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return rv;
+}
+
+int
+iBSP430binlogv (const char * fmt,
+                va_list ap)
+{
+  uint8_t buffer[RECORD_OFFSET + BSP430_BINLOG_RECORD_LENGTH + CONVERSION_MAX_OCTETS + RECORD_TRAILER];
+  uint8_t * const record = buffer + RECORD_OFFSET;
+  uint8_t * const ebuffer = record + BSP430_BINLOG_RECORD_LENGTH;
+  uint8_t * bp = record;
+  const char * fp = fmt;
+
+  if (! hBSP430console()) {
+    return 0;
+  }
+  *bp++ = BSP430_BINLOG_RECORD_MARKER;
+  bp = encode_ul(bp, fmt - __start_bsp430_binlog);
+  while (*fp) {
+    int nlong = 0;
+    char c;
+
+    if ('%' != *fp++) {
+      continue;
+    }
+    if ('%' == *fp) {
+      ++fp;
+      continue;
+    }
+    /* The buffer has room past ebuffer for one conversion, so
+     * encoding proceeds without checks and the record is abandoned
+     * afterwards if it went too far. */
+    while (('-' == *fp) || ('+' == *fp) || (' ' == *fp)
+           || ('#' == *fp) || ('0' == *fp)) {
+      ++fp;
+    }
+    if ('*' == *fp) {
+      ++fp;
+      bp = encode_zz(bp, va_arg(ap, int));
+    } else {
+      while (('0' <= *fp) && (*fp <= '9')) {
+        ++fp;
+      }
+    }
+    if ('.' == *fp) {
+      ++fp;
+      if ('*' == *fp) {
+        ++fp;
+        bp = encode_zz(bp, va_arg(ap, int));
+      } else {
+        while (('0' <= *fp) && (*fp <= '9')) {
+          ++fp;
+        }
+      }
+    }
+    while ('h' == *fp) {
+      ++fp;
+    }
+    while ('l' == *fp) {
+      ++nlong;
+      ++fp;
+    }
+    c = *fp++;
+    if (('d' == c) || ('i' == c)) {
+      if (1 < nlong) {
+        long long v = va_arg(ap, long long);
+        bp = encode_ull(bp, ((unsigned long long)v << 1) ^ (unsigned long long)(v >> 63));
+      } else if (nlong) {
+        bp = encode_zz(bp, va_arg(ap, long));
+      } else {
+        bp = encode_zz(bp, va_arg(ap, int));
+      }
+    } else if (('u' == c) || ('x' == c) || ('X' == c) || ('o' == c)) {
+      if (1 < nlong) {
+        bp = encode_ull(bp, va_arg(ap, unsigned long long));
+      } else if (nlong) {
+        bp = encode_ul(bp, va_arg(ap, unsigned long));
+      } else {
+        bp = encode_ul(bp, va_arg(ap, unsigned int));
+      }
+    } else if ('c' == c) {
+      bp = encode_ul(bp, (unsigned char)va_arg(ap, int));
+    } else if ('p' == c) {
+      bp = encode_ul(bp, (uintptr_t)va_arg(ap, void *));
+    } else if ('s' == c) {
+      const char * sp = va_arg(ap, const char *);
+      size_t len = 0;
+      size_t avail;
+
+      /* A null pointer is logged as an empty string.  Otherwise the
+       * string is truncated to the space left after its length, which
+       * in a record this short takes at most two octets. */
+      if (sp) {
+        len = strlen(sp);
+      }
+      avail = (bp < ebuffer) ? (ebuffer - bp) : 0;
+      avail = (2 < avail) ? (avail - 2) : 0;
+      if (len > avail) {
+        len = avail;
+      }
+      bp = encode_ul(bp, len);
+      if (0 < len) {
+        memcpy(bp, sp, len);
+        bp += len;
+      }
+    } else {
+      /* Unsupported conversion, or end of string.  The host stops
+       * decoding here too. */
+      break;
+    }
+    if (bp > ebuffer) {
+      return -1;
+    }
+  }
+  return emit_record(buffer, bp - record);
+}
+
+int
+iBSP430binlog (const char * fmt,
+               ...)
+{
+  int rv;
+  va_list ap;
+
+  va_start(ap, fmt);
+  rv = iBSP430binlogv(fmt, ap);
+  va_end(ap);
+  return rv;
+}
+
+#endif /* BSP430_CONSOLE */
@@ -0,0 +1,352 @@
+/* Copyright 2014, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/chanmux.h>
+#include <string.h>
+
+#if (BSP430_CONSOLE - 0)
+
+#if (250 < BSP430_CHANMUX_MAX_PAYLOAD)
+#error BSP430_CHANMUX_MAX_PAYLOAD exceeds 250
+#endif /* BSP430_CHANMUX_MAX_PAYLOAD */
+
+/* Channel identifier, payload, and CRC */
+#define RAW_FRAME_MAX (1 + BSP430_CHANMUX_MAX_PAYLOAD + 2)
+
+/* Registered channels */
+static sBSP430chanmuxChannel * channels;
+
+/* Size of the stack buffer in which a transmitted frame is built */
+#define TX_FRAME_MAX (BSP430_CHANMUX_MAX_PAYLOAD + BSP430_CHANMUX_FRAME_OVERHEAD)
+
+/* Encoded frame being received, and its length.  A negative length
+ * indicates console text is being received; a length beyond the
+ * buffer indicates an overlong frame is being discarded. */
+static uint8_t rx_frame[RAW_FRAME_MAX + 1];
+static int rx_len = -1;
+
+static sBSP430chanmuxStatistics stats;
+
+static sBSP430chanmuxChannel *
+find_channel (uint8_t id)
+{
+  sBSP430chanmuxChannel * cp = channels;
+
+  while (cp && (cp->id != id)) {
+    cp = cp->next;
+  }
+  return cp;
+}
+
+int
+iBSP430chanmuxRegister (sBSP430chanmuxChannel * chan)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  uint16_t capacity = uiBSP430ringCapacity(&chan->tx_ring);
+  int rv = -1;
+
+  if ((0 == chan->id)
+      || (! BSP430_RING_VALID_CAPACITY(capacity))) {
+    return rv;
+  }
+  BSP430_CORE_DISABLE_INTERRUPT();
+  do {
+    if (find_channel(chan->id)) {
+      break;
+    }
+    vBSP430ringReset(&chan->tx_ring);
+    chan->tx_dropped = 0;
+    chan->tx_frames = 0;
+    chan->rx_frames = 0;
+    chan->next = channels;
+    channels = chan;
+    rv = 0;
+  } while (0);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return rv;
+}
+
+int
+iBSP430chanmuxUnregister (sBSP430chanmuxChannel * chan)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  sBSP430chanmuxChannel * * cpp;
+  int rv = -1;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  cpp = &channels;
+  while (*cpp && (*cpp != chan)) {
+    cpp = &(*cpp)->next;
+  }
+  if (*cpp) {
+    *cpp = chan->next;
+    chan->next = NULL;
+    vBSP430ringReset(&chan->tx_ring);
+    rv = 0;
+  }
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return rv;
+}
+
+int
+iBSP430chanmuxWrite (sBSP430chanmuxChannel * chan,
+                     const uint8_t * data,
+                     size_t len)
+{
+  uint16_t n = uiBSP430ringWriteOctets(&chan->tx_ring, chan->tx_buffer, data, len);
+
+  if (n < len) {
+    BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+
+    BSP430_CORE_DISABLE_INTERRUPT();
+    chan->tx_dropped += len - n;
+    BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  }
+  return n;
+}
+
+/* Because the unencoded frame is shorter than 254 octets the COBS
+ * encoding has no overhead beyond the initial code: each zero octet is
+ * replaced by the distance to the next zero octet (or the end of the
+ * frame), and the octet preceding the frame holds the distance to the
+ * first. */
+size_t
+uiBSP430chanmuxEncodeFrame (uint8_t * frame,
+                            uint8_t id,
+                            size_t len)
+{
+  uint8_t * const sp = frame + 2;
+  uint8_t * const ep = sp + 1 + len + 2;
+  uint8_t * codep = frame + 1;
+  uint16_t crc = 0xFFFF;
+  uint8_t * p;
+
+  sp[0] = id;
+  for (p = sp; p < ep - 2; ++p) {
+    crc = uiBSP430chanmuxCRCUpdate(crc, *p);
+  }
+  ep[-2] = crc & 0xFF;
+  ep[-1] = crc >> 8;
+  for (p = sp; p < ep; ++p) {
+    if (0 == *p) {
+      *codep = p - codep;
+      codep = p;
+    }
+  }
+  *codep = ep - codep;
+  frame[0] = BSP430_CHANMUX_DELIMITER;
+  *ep = BSP430_CHANMUX_DELIMITER;
+  return 1 + ep - frame;
+}
+
+/* Complete the frame whose payload of len octets has been placed in
+ * frame, and write it to the console with interrupts disabled so
+ * output from interrupt handlers cannot be placed within it. */
+static int
+emit_frame (uint8_t * frame,
+            uint8_t id,
+            size_t len)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  int rv;
+
+  len = uiBSP430chanmuxEncodeFrame(frame, id, len);
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rv = cputoctets(frame, len);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return rv;
+}
+
+int
+iBSP430chanmuxSendFrame (uint8_t id,
+                         const uint8_t * data,
+                         size_t len)
+{
+  uint8_t frame[TX_FRAME_MAX];
+
+  if (BSP430_CHANMUX_MAX_PAYLOAD < len) {
+    return -1;
+  }
+  memcpy(frame + BSP430_CHANMUX_PAYLOAD_OFFSET, data, len);
+  return emit_frame(frame, id, len);
+}
+
+int
+iBSP430chanmuxSendMemory (uint8_t id,
+                          const uint8_t * dp,
+                          size_t len,
+                          unsigned long base)
+{
+  uint8_t frame[TX_FRAME_MAX];
+  uint8_t * const fp = frame + BSP430_CHANMUX_PAYLOAD_OFFSET;
+  int rv = 0;
+
+  while (0 < len) {
+    size_t n = len;
+
+    if ((BSP430_CHANMUX_MAX_PAYLOAD - 4) < n) {
+      n = BSP430_CHANMUX_MAX_PAYLOAD - 4;
+    }
+    fp[0] = base;
+    fp[1] = base >> 8;
+    fp[2] = base >> 16;
+    fp[3] = base >> 24;
+    memcpy(fp + 4, dp, n);
+    (void)emit_frame(frame, id, 4 + n);
+    dp += n;
+    base += n;
+    len -= n;
+    ++rv;
+  }
+  return rv;
+}
+
+int
+iBSP430chanmuxFlush (void)
+{
+  uint8_t frame[TX_FRAME_MAX];
+  sBSP430chanmuxChannel * cp;
+  int frames;
+  int rv = 0;
+
+  do {
+    frames = 0;
+    for (cp = channels; cp; cp = cp->next) {
+      uint16_t n = uiBSP430ringReadOctets(&cp->tx_ring, cp->tx_buffer, frame + BSP430_CHANMUX_PAYLOAD_OFFSET, BSP430_CHANMUX_MAX_PAYLOAD);
+      if (0 < n) {
+        (void)emit_frame(frame, cp->id, n);
+        ++cp->tx_frames;
+        ++frames;
+      }
+    }
+    rv += frames;
+  } while (0 < frames);
+  return rv;
+}
+
+int
+iBSP430chanmuxDecodeFrame (uint8_t * frame,
+                           size_t len)
+{
+  size_t ip = 0;
+  size_t op = 0;
+  uint16_t crc = 0xFFFF;
+
+  while (ip < len) {
+    uint8_t code = frame[ip++];
+    uint8_t i;
+
+    if (0 == code) {
+      return -1;
+    }
+    for (i = 1; i < code; ++i) {
+      if (ip >= len) {
+        return -1;
+      }
+      frame[op++] = frame[ip++];
+    }
+    if ((0xFF != code) && (ip < len)) {
+      frame[op++] = 0;
+    }
+  }
+  if (3 > op) {
+    return -1;
+  }
+  for (ip = 0; ip < op - 2; ++ip) {
+    crc = uiBSP430chanmuxCRCUpdate(crc, frame[ip]);
+  }
+  if (crc != (frame[op - 2] | (frame[op - 1] << 8))) {
+    return -2;
+  }
+  return op - 3;
+}
+
+int
+iBSP430chanmuxRxFilter (int c)
+{
+  sBSP430chanmuxChannel * cp;
+  int len;
+
+  if (0 > rx_len) {
+    if (BSP430_CHANMUX_DELIMITER == c) {
+      rx_len = 0;
+      return -1;
+    }
+    return c;
+  }
+  if (BSP430_CHANMUX_DELIMITER != c) {
+    if (rx_len < (int)sizeof(rx_frame)) {
+      rx_frame[rx_len] = c;
+    }
+    if (rx_len <= (int)sizeof(rx_frame)) {
+      ++rx_len;
+    }
+    return -1;
+  }
+  /* Consecutive delimiters: the first ended a frame (or was
+   * spurious), the second starts one. */
+  if (0 == rx_len) {
+    return -1;
+  }
+  len = rx_len;
+  rx_len = -1;
+  if ((int)sizeof(rx_frame) < len) {
+    ++stats.rx_framing_errors;
+    return -1;
+  }
+  len = iBSP430chanmuxDecodeFrame(rx_frame, len);
+  if (-2 == len) {
+    ++stats.rx_crc_errors;
+  } else if (0 > len) {
+    ++stats.rx_framing_errors;
+  } else if (NULL == (cp = find_channel(rx_frame[0]))) {
+    ++stats.rx_unknown_channel;
+  } else {
+    ++cp->rx_frames;
+    if (cp->rx_callback) {
+      cp->rx_callback(cp, rx_frame + 1, len);
+    }
+  }
+  return -1;
+}
+
+void
+vBSP430chanmuxStatistics (sBSP430chanmuxStatistics * sp,
+                          int reset)
+{
+  *sp = stats;
+  if (reset) {
+    memset(&stats, 0, sizeof(stats));
+  }
+}
+
+#endif /* BSP430_CONSOLE */
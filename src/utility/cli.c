@@ -40,9 +40,13 @@
 #include <bsp430/platform.h>
 #include <bsp430/utility/cli.h>
 #include <bsp430/utility/console.h>
+#if (configBSP430_UPTIME - 0)
+#include <bsp430/utility/uptime.h>
+#endif /* configBSP430_UPTIME */
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <limits.h>
 
 static iBSP430cliDiagnosticFunction diagnosticFunction = &iBSP430cliNullDiagnostic;
 
@@ -141,6 +145,37 @@ xBSP430cliNextQToken (const char ** commandp,
   return rv;
 }
 
+#if (configBSP430_CLI_COMMAND_INDEX - 0)
+static const sBSP430cliCommandIndex * commandIndexes_;
+static unsigned int nCommandIndexes_;
+
+void
+vBSP430cliSetCommandIndexes (const sBSP430cliCommandIndex * indexes,
+                             unsigned int count)
+{
+  if (NULL == indexes) {
+    count = 0;
+  }
+  commandIndexes_ = indexes;
+  nCommandIndexes_ = count;
+}
+
+static const sBSP430cliCommandIndex *
+findCommandIndex_ (const sBSP430cliCommand * cmds)
+{
+  const sBSP430cliCommandIndex * ip = commandIndexes_;
+  const sBSP430cliCommandIndex * const eip = ip + nCommandIndexes_;
+
+  while (ip < eip) {
+    if (ip->head == cmds) {
+      return ip;
+    }
+    ++ip;
+  }
+  return NULL;
+}
+#endif /* configBSP430_CLI_COMMAND_INDEX */
+
 int
 iBSP430cliMatchCommand (const sBSP430cliCommand * cmds,
                         const char * command,
@@ -163,6 +198,39 @@ iBSP430cliMatchCommand (const sBSP430cliCommand * cmds,
     *argstr_lenp = command_len;
   }
   nmatches = 0;
+#if (configBSP430_CLI_COMMAND_INDEX - 0)
+  {
+    const sBSP430cliCommandIndex * ip = findCommandIndex_(cmds);
+
+    if (ip) {
+      const sBSP430cliCommand * const * sp = ip->sorted;
+      const sBSP430cliCommand * const * const esp = sp + ip->count;
+      unsigned int lo = 0;
+      unsigned int hi = ip->count;
+
+      /* Locate the first command with a key that does not sort below
+       * the token.  All commands having the token as a prefix follow
+       * it contiguously. */
+      while (lo < hi) {
+        unsigned int mid = lo + (hi - lo) / 2;
+        if (0 > strncmp(sp[mid]->key, key, len)) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      sp += lo;
+      while ((sp < esp) && (0 == strncmp(key, (*sp)->key, len))) {
+        ++nmatches;
+        if (0 != match_callback) {
+          match_callback->callback(match_callback, *sp);
+        }
+        match = *sp++;
+      }
+      cmds = NULL;
+    }
+  }
+#endif /* configBSP430_CLI_COMMAND_INDEX */
   while (cmds) {
     if (0 == strncmp(key, cmds->key, len)) {
       ++nmatches;
@@ -249,6 +317,107 @@ iBSP430cliExecuteCommand (const sBSP430cliCommand * cmds,
   return processSubcommand_(NULL, cmds, param, command, strlen(command), NULL, NULL);
 }
 
+/* If sp begins a quoted token as recognized by xBSP430cliNextQToken(),
+ * return the position following its end quote; otherwise NULL.  The
+ * token must end within the line, and its end quote must be followed
+ * by space or by the end of the command. */
+static const char *
+script_quoted_end_ (const char * sp,
+                    const char * ep)
+{
+  const char quote = *sp++;
+
+  while ((sp < ep) && *sp && ('\n' != *sp) && (quote != *sp)) {
+    ++sp;
+  }
+  if ((sp >= ep) || (quote != *sp)) {
+    return NULL;
+  }
+  ++sp;
+  if ((sp < ep) && *sp && (';' != *sp) && ! isspace((unsigned char)*sp)) {
+    return NULL;
+  }
+  return sp;
+}
+
+int
+iBSP430cliExecuteScript (const sBSP430cliCommand * cmds,
+                         void * param,
+                         const char * script,
+                         size_t script_len,
+                         unsigned int flags,
+                         sBSP430cliScriptCallback * callback)
+{
+  const char * const escript = script + script_len;
+  int ncommands = 0;
+  int first_error = 0;
+  int rv;
+
+  while ((script < escript) && *script) {
+    const char * command;
+    size_t command_len;
+    char command_text[BSP430_CLI_SCRIPT_COMMAND_LENGTH + 1];
+
+    /* Skip leading space, including empty lines */
+    if (isspace((unsigned char)*script) || (';' == *script)) {
+      ++script;
+      continue;
+    }
+    /* Discard comments through the end of the line */
+    if ('#' == *script) {
+      while ((script < escript) && *script && ('\n' != *script)) {
+        ++script;
+      }
+      continue;
+    }
+    /* Find the end of the command */
+    command = script;
+    while ((script < escript) && *script && ('\n' != *script) && (';' != *script)) {
+      /* As in xBSP430cliNextQToken() a quote is special only where it
+       * begins a token */
+      if ((('\'' == *script) || ('"' == *script))
+          && ((command == script) || isspace((unsigned char)script[-1]))) {
+        const char * qe = script_quoted_end_(script, escript);
+
+        if (NULL != qe) {
+          script = qe;
+          continue;
+        }
+      }
+      ++script;
+    }
+    command_len = script - command;
+    while ((0 < command_len)
+           && isspace((unsigned char)command[command_len-1])) {
+      --command_len;
+    }
+
+    if (callback && callback->start) {
+      callback->start(callback, command, command_len);
+    }
+    /* Handlers may ignore the argument length, so each is given a
+     * terminated copy of its command. */
+    if (BSP430_CLI_SCRIPT_COMMAND_LENGTH < command_len) {
+      rv = -eBSP430_CLI_ERR_Invalid;
+    } else {
+      memcpy(command_text, command, command_len);
+      command_text[command_len] = 0;
+      rv = processSubcommand_(NULL, cmds, param, command_text, command_len, NULL, NULL);
+    }
+    if (callback && callback->complete) {
+      callback->complete(callback, command, command_len, rv);
+    }
+    ++ncommands;
+    if ((0 > rv) && (0 == first_error)) {
+      first_error = rv;
+      if (! (BSP430_CLI_SCRIPT_CONTINUE & flags)) {
+        break;
+      }
+    }
+  }
+  return first_error ? first_error : ncommands;
+}
+
 int
 iBSP430cliParseCommand (const sBSP430cliCommand * cmds,
                         void * param,
@@ -271,48 +440,229 @@ iBSP430cliHandlerSimple (sBSP430cliCommandLink * chain,
   return ((iBSP430cliSimpleHandler)chain->cmd->param.simple_handler)(argstr);
 }
 
-#define GEN_STORE_EXTRACTED_VALUE(tag_,type_,strtov_,maxvalstr_)        \
+/* Multiply the accumulated value by the radix and add a digit,
+ * returning nonzero if the result does not fit.  Shifts are used so
+ * no multiplication support is required. */
+static int
+accumulate_digit_ (unsigned long * vp,
+                   unsigned int radix,
+                   unsigned int digit)
+{
+  unsigned long v = *vp;
+
+  switch (radix) {
+    case 2:
+      if (v >> (8 * sizeof(v) - 1)) {
+        return -1;
+      }
+      v <<= 1;
+      break;
+    case 8:
+      if (v >> (8 * sizeof(v) - 3)) {
+        return -1;
+      }
+      v <<= 3;
+      break;
+    case 16:
+      if (v >> (8 * sizeof(v) - 4)) {
+        return -1;
+      }
+      v <<= 4;
+      break;
+    default:
+      if ((ULONG_MAX / 10) < v) {
+        return -1;
+      }
+      v = (v << 3) + (v << 1);
+      break;
+  }
+  v += digit;
+  if (v < digit) {
+    return -1;
+  }
+  *vp = v;
+  return 0;
+}
+
+/* Parse the magnitude and sign of a number, scaling by 10^scale.  See
+ * iBSP430cliParseUL() for the syntax. */
+static int
+parse_number_ (const char * sp,
+               size_t len,
+               unsigned int scale,
+               int * negp,
+               unsigned long * vp)
+{
+  const char * ep = sp + len;
+  unsigned int radix = 10;
+  unsigned long v = 0;
+  int in_fraction = 0;
+  int ndigits = 0;
+
+  *negp = 0;
+  if ((sp < ep) && (('-' == *sp) || ('+' == *sp))) {
+    *negp = ('-' == *sp++);
+  }
+  if ((sp < ep) && ('k' == ep[-1])) {
+    scale += 3;
+    --ep;
+  } else if ((sp < ep) && ('M' == ep[-1])) {
+    scale += 6;
+    --ep;
+  }
+  if (((sp + 1) < ep) && ('0' == *sp)) {
+    if (('x' == sp[1]) || ('X' == sp[1])) {
+      radix = 16;
+      sp += 2;
+    } else if (('b' == sp[1]) || ('B' == sp[1])) {
+      radix = 2;
+      sp += 2;
+    } else if (('0' <= sp[1]) && (sp[1] <= '9')) {
+      radix = 8;
+      ++sp;
+      ++ndigits;
+    }
+  }
+  while (sp < ep) {
+    int c = *sp++;
+    unsigned int digit;
+
+    if (('.' == c) && (10 == radix) && (! in_fraction)) {
+      in_fraction = 1;
+      continue;
+    }
+    if (('0' <= c) && (c <= '9')) {
+      digit = c - '0';
+    } else if (('a' <= c) && (c <= 'f')) {
+      digit = 10 + c - 'a';
+    } else if (('A' <= c) && (c <= 'F')) {
+      digit = 10 + c - 'A';
+    } else {
+      return -eBSP430_CLI_ERR_Invalid;
+    }
+    if (digit >= radix) {
+      return -eBSP430_CLI_ERR_Invalid;
+    }
+    ++ndigits;
+    if (in_fraction) {
+      if (0 == scale) {
+        /* Digits beyond the available precision must be zero */
+        if (0 != digit) {
+          return -eBSP430_CLI_ERR_Invalid;
+        }
+        continue;
+      }
+      --scale;
+    }
+    if (accumulate_digit_(&v, radix, digit)) {
+      return -eBSP430_CLI_ERR_Range;
+    }
+  }
+  if (0 == ndigits) {
+    return -eBSP430_CLI_ERR_Invalid;
+  }
+  while (scale--) {
+    if (accumulate_digit_(&v, 10, 0)) {
+      return -eBSP430_CLI_ERR_Range;
+    }
+  }
+  *vp = v;
+  return 0;
+}
+
+/* Parse a number and verify that it lies within [-max_neg, max_pos] */
+static int
+parse_bounded_ (const char * sp,
+                size_t len,
+                unsigned int scale,
+                unsigned long max_pos,
+                unsigned long max_neg,
+                int * negp,
+                unsigned long * vp)
+{
+  int rv = parse_number_(sp, len, scale, negp, vp);
+
+  if (0 == rv) {
+    if (0 == *vp) {
+      *negp = 0;
+    }
+    if (*vp > (*negp ? max_neg : max_pos)) {
+      rv = -eBSP430_CLI_ERR_Range;
+    }
+  }
+  return rv;
+}
+
+#define GEN_PARSE_VALUE(tag_,type_,max_pos_,max_neg_)                   \
+  int                                                                   \
+  iBSP430cliParse##tag_ (const char * text,                             \
+                         size_t len,                                    \
+                         type_ * destp)                                 \
+  {                                                                     \
+    unsigned long v;                                                    \
+    int neg;                                                            \
+    int rv = parse_bounded_(text, len, 0, max_pos_, max_neg_, &neg, &v); \
+                                                                        \
+    if (0 == rv) {                                                      \
+      *destp = neg ? -(type_)(v - 1) - 1 : (type_)v;                    \
+    }                                                                   \
+    return rv;                                                          \
+  }
+
+GEN_PARSE_VALUE(UI,unsigned int,UINT_MAX,0)
+GEN_PARSE_VALUE(UL,unsigned long int,ULONG_MAX,0)
+GEN_PARSE_VALUE(I,int,INT_MAX,1UL + INT_MAX)
+GEN_PARSE_VALUE(L,long int,LONG_MAX,1UL + LONG_MAX)
+#undef GEN_PARSE_VALUE
+
+int
+iBSP430cliParseFixed (const char * text,
+                      size_t len,
+                      unsigned int frac_digits,
+                      long * destp)
+{
+  unsigned long v;
+  int neg;
+  int rv = parse_bounded_(text, len, frac_digits, LONG_MAX, 1UL + LONG_MAX, &neg, &v);
+
+  if (0 == rv) {
+    *destp = neg ? -(long)(v - 1) - 1 : (long)v;
+  }
+  return rv;
+}
+
+#define GEN_STORE_EXTRACTED_VALUE(tag_,type_)                           \
   int                                                                   \
   iBSP430cliStoreExtracted##tag_ (const char * * argstrp,               \
                                   size_t * argstr_lenp,                 \
                                   type_ * destp)                        \
   {                                                                     \
-    char buffer[sizeof(maxvalstr_)];                                    \
-    char * ep;                                                          \
     const char * argstr = *argstrp;                                     \
     size_t argstr_len = *argstr_lenp;                                   \
     const char * vstr;                                                  \
     size_t len;                                                         \
-    type_ v;                                                            \
+    int rv;                                                             \
                                                                         \
     vstr = xBSP430cliNextToken(&argstr, &argstr_len, &len);             \
     if (0 == len) {                                                     \
       return -eBSP430_CLI_ERR_Missing;                                  \
     }                                                                   \
-    if (sizeof(buffer)-1 < len) {                                       \
-      return -eBSP430_CLI_ERR_Invalid;                                  \
-    }                                                                   \
-    memcpy(buffer, vstr, len);                                          \
-    buffer[len] = 0;                                                    \
-    v = strtov_(buffer, &ep, 0);                                        \
-    if (*ep) {                                                          \
-      return -eBSP430_CLI_ERR_Invalid;                                  \
+    rv = iBSP430cliParse##tag_(vstr, len, destp);                       \
+    if (0 != rv) {                                                      \
+      return rv;                                                        \
     }                                                                   \
-    *destp = v;                                                         \
     *argstrp = argstr;                                                  \
     *argstr_lenp = argstr_len;                                          \
     return 0;                                                           \
   }
 
-/* The text representations with the greatest length are the
- * ones that use octal. */
-GEN_STORE_EXTRACTED_VALUE(UI,unsigned int,strtoul,"0177777")
-GEN_STORE_EXTRACTED_VALUE(UL,unsigned long int,strtoul,"037777777777")
-GEN_STORE_EXTRACTED_VALUE(I,int,strtol,"-0100000")
-GEN_STORE_EXTRACTED_VALUE(L,long int,strtol,"-020000000000")
+GEN_STORE_EXTRACTED_VALUE(UI,unsigned int)
+GEN_STORE_EXTRACTED_VALUE(UL,unsigned long int)
+GEN_STORE_EXTRACTED_VALUE(I,int)
+GEN_STORE_EXTRACTED_VALUE(L,long int)
 #undef GEN_STORE_EXTRACTED_VALUE
 
-#define GEN_STORE_VALUE_HANDLER(tag_,type_,strtov_,maxvalstr_)          \
+#define GEN_STORE_VALUE_HANDLER(tag_,type_)                             \
   int                                                                   \
   iBSP430cliHandlerStore##tag_ (struct sBSP430cliCommandLink * chain,   \
                                 void * param,                           \
@@ -326,18 +676,19 @@ GEN_STORE_EXTRACTED_VALUE(L,long int,strtol,"-020000000000")
       return diagnosticFunction(chain, eBSP430_CLI_ERR_Config, argstr, argstr_len); \
     }                                                                   \
     rv = iBSP430cliStoreExtracted##tag_(&argstr, &argstr_len, (type_*)cmd->param.ptr); \
+    if (-eBSP430_CLI_ERR_Range == rv) {                                 \
+      return diagnosticFunction(chain, eBSP430_CLI_ERR_Range, argstr, argstr_len); \
+    }                                                                   \
     if (0 != rv) {                                                      \
       return diagnosticFunction(chain, eBSP430_CLI_ERR_Invalid, argstr, argstr_len); \
     }                                                                   \
     return 0;                                                           \
   }
 
-/* The text representations with the greatest length are the
- * ones that use octal. */
-GEN_STORE_VALUE_HANDLER(UI,unsigned int,strtoul,"0177777")
-GEN_STORE_VALUE_HANDLER(UL,unsigned long int,strtoul,"037777777777")
-GEN_STORE_VALUE_HANDLER(I,int,strtol,"-0100000")
-GEN_STORE_VALUE_HANDLER(L,long int,strtol,"-020000000000")
+GEN_STORE_VALUE_HANDLER(UI,unsigned int)
+GEN_STORE_VALUE_HANDLER(UL,unsigned long int)
+GEN_STORE_VALUE_HANDLER(I,int)
+GEN_STORE_VALUE_HANDLER(L,long int)
 
 #undef GEN_STORE_VALUE_HANDLER
 
@@ -429,11 +780,21 @@ iBSP430cliConsoleDiagnostic (struct sBSP430cliCommandLink * chain,
     case eBSP430_CLI_ERR_Invalid:
       cputtext("Invalid value: ");
       break;
+    case eBSP430_CLI_ERR_Range:
+      cputtext("Value out of range: ");
+      break;
     default:
       cprintf("ERROR %u at: ", errtype);
       break;
   }
-  vBSP430cliConsoleDisplayChain(chain, argstr);
+  /* Display the arguments using their length: within a script they
+   * are not terminated by a NUL. */
+  vBSP430cliConsoleDisplayChain(chain, "");
+  if (0 < argstr_len) {
+    cputchar('(');
+    cputchars(argstr, argstr_len);
+    cputchar(')');
+  }
   if ((0 != cmds)
       && ((eBSP430_CLI_ERR_MultiMatch == errtype)
           || (eBSP430_CLI_ERR_Missing == errtype)
@@ -481,6 +842,57 @@ void vBSP430cliConsoleDisplayHelp (const sBSP430cliCommand * cmd)
   consoleDisplayHelp_(cmd, 0);
 }
 
+struct sConsoleScriptMonitor {
+  sBSP430cliScriptCallback callback; /* must be first */
+#if (configBSP430_UPTIME - 0)
+  unsigned long start_utt;
+#endif /* configBSP430_UPTIME */
+};
+
+static void
+console_script_start (sBSP430cliScriptCallback * self,
+                      const char * command,
+                      size_t command_len)
+{
+  cputtext("> ");
+  cputchars(command, command_len);
+  cputchar('\n');
+#if (configBSP430_UPTIME - 0)
+  ((struct sConsoleScriptMonitor *)self)->start_utt = ulBSP430uptime();
+#endif /* configBSP430_UPTIME */
+}
+
+static void
+console_script_complete (sBSP430cliScriptCallback * self,
+                         const char * command,
+                         size_t command_len,
+                         int rv)
+{
+#if (configBSP430_UPTIME - 0)
+  unsigned long duration_utt = ulBSP430uptime() - ((struct sConsoleScriptMonitor *)self)->start_utt;
+  const char * unit;
+  unsigned int duration = uiBSP430uptimeScaleForDisplay(duration_utt, &unit);
+
+  cprintf("= %d in %u %s\n", rv, duration, unit);
+#else /* configBSP430_UPTIME */
+  cprintf("= %d\n", rv);
+#endif /* configBSP430_UPTIME */
+}
+
+int
+iBSP430cliConsoleExecuteScript (const sBSP430cliCommand * cmds,
+                                void * param,
+                                const char * script,
+                                size_t script_len,
+                                unsigned int flags)
+{
+  struct sConsoleScriptMonitor monitor;
+
+  monitor.callback.start = console_script_start;
+  monitor.callback.complete = console_script_complete;
+  return iBSP430cliExecuteScript(cmds, param, script, script_len, flags, &monitor.callback);
+}
+
 const char *
 xBSP430cliConsoleBuffer (void)
 {
@@ -506,11 +918,283 @@ xBSP430cliConsoleBuffer (void)
 #define KEY_HT '\t'
 #define KEY_KILL_LINE 0x15
 #define KEY_KILL_WORD 0x17
+#define KEY_SEARCH 0x12
+
+#if 0 < BSP430_CLI_CONSOLE_HISTORY_SIZE
+/* Distinguishes a history arena written by this module from
+ * uninitialized or foreign memory. */
+#define HISTORY_MAGIC 0x4C48
+
+/* Entries are a length octet followed by the text, most recent
+ * first.  used is the number of valid octets in data. */
+static struct {
+  unsigned int magic;
+  unsigned int used;
+  unsigned char data[BSP430_CLI_CONSOLE_HISTORY_SIZE];
+} history_ BSP430_CLI_CONSOLE_HISTORY_SECTION;
+
+/* Nonzero once the arena has been validated since reset. */
+static char historyChecked_;
+
+/* Position of the entry currently recalled into the console buffer,
+ * plus one; zero when the buffer does not hold a recalled entry. */
+static unsigned int historyPosition_;
+
+#define HISTORY_PATTERN_SIZE 16
+static char historyPattern_[HISTORY_PATTERN_SIZE];
+static unsigned char historyPatternLen_;
+static char historySearching_;
+
+void
+vBSP430cliConsoleHistoryClear (void)
+{
+  history_.magic = HISTORY_MAGIC;
+  history_.used = 0;
+  historyChecked_ = 1;
+  historyPosition_ = 0;
+}
+
+/* Reset the arena unless it holds a sequence of non-empty entries
+ * that exactly fills the used region. */
+static void
+history_check_ (void)
+{
+  unsigned int off = 0;
+
+  if (historyChecked_) {
+    return;
+  }
+  if ((HISTORY_MAGIC == history_.magic)
+      && (history_.used <= sizeof(history_.data))) {
+    while ((off < history_.used) && (0 < history_.data[off])) {
+      off += 1 + history_.data[off];
+    }
+  }
+  if ((HISTORY_MAGIC != history_.magic) || (off != history_.used)) {
+    vBSP430cliConsoleHistoryClear();
+  }
+  historyChecked_ = 1;
+}
+
+/* Return the offset of entry n, or -1 if there is no such entry. */
+static int
+history_offset_ (unsigned int n)
+{
+  unsigned int off = 0;
+
+  history_check_();
+  while (off < history_.used) {
+    if (0 == n--) {
+      return off;
+    }
+    off += 1 + history_.data[off];
+  }
+  return -1;
+}
+
+const char *
+xBSP430cliConsoleHistoryEntry (unsigned int n,
+                               size_t * lenp)
+{
+  int off = history_offset_(n);
+
+  if (0 > off) {
+    return NULL;
+  }
+  *lenp = history_.data[off];
+  return (const char *)history_.data + off + 1;
+}
+
+/* Remove the entry at off, which is followed by everything older. */
+static void
+history_remove_ (unsigned int off)
+{
+  unsigned int next = off + 1 + history_.data[off];
+
+  memmove(history_.data + off, history_.data + next, history_.used - next);
+  history_.used -= next - off;
+}
+
+static void
+history_record_ (const char * text,
+                 size_t len)
+{
+  int off;
+  unsigned int n;
+
+  while ((0 < len) && isspace((unsigned char)text[len-1])) {
+    --len;
+  }
+  if ((0 == len) || (UCHAR_MAX < len) || (sizeof(history_.data) < (1 + len))) {
+    return;
+  }
+  n = 0;
+  while (0 <= (off = history_offset_(n++))) {
+    if ((len == history_.data[off])
+        && (0 == memcmp(history_.data + off + 1, text, len))) {
+      history_remove_(off);
+      break;
+    }
+  }
+  while (sizeof(history_.data) < (history_.used + 1 + len)) {
+    n = 0;
+    while (0 <= history_offset_(n + 1)) {
+      ++n;
+    }
+    history_remove_(history_offset_(n));
+  }
+  memmove(history_.data + 1 + len, history_.data, history_.used);
+  history_.data[0] = len;
+  memcpy(history_.data + 1, text, len);
+  history_.used += 1 + len;
+}
+
+/* Replace the console buffer with entry n, or empty it if n is
+ * negative. */
+static void
+history_load_ (int n)
+{
+  size_t len = 0;
+  const char * text = NULL;
+
+  if (0 <= n) {
+    text = xBSP430cliConsoleHistoryEntry(n, &len);
+  }
+  cbEnd_ = consoleBuffer_;
+  if (NULL != text) {
+    (void)iBSP430cliConsoleBufferExtend(text, len);
+  }
+  /* Terminate so a caller holding the buffer can repaint it */
+  *cbEnd_ = 0;
+  historyPosition_ = n + 1;
+}
+
+/* Move through the history in response to the final character of a
+ * control sequence: A (up) for older, B (down) for newer. */
+static int
+history_recall_ (int c)
+{
+  unsigned int position = historyPosition_;
+
+  if ('A' == c) {
+    if (0 > history_offset_(position)) {
+      cputchar(KEY_BEL);
+      return 0;
+    }
+    ++position;
+  } else if ('B' == c) {
+    if (0 == position) {
+      cputchar(KEY_BEL);
+      return 0;
+    }
+    --position;
+  } else {
+    return 0;
+  }
+  history_load_((int)position - 1);
+  cputtext("\r\e[K");
+  return eBSP430cliConsole_REPAINT;
+}
+
+/* Return the position of the first entry at or after n that contains
+ * the search pattern, or -1 if there is none. */
+static int
+history_search_ (unsigned int n)
+{
+  const char * text;
+  size_t len;
+
+  while (NULL != (text = xBSP430cliConsoleHistoryEntry(n, &len))) {
+    size_t i;
+
+    for (i = 0; (i + historyPatternLen_) <= len; ++i) {
+      if (0 == memcmp(text + i, historyPattern_, historyPatternLen_)) {
+        return n;
+      }
+    }
+    ++n;
+  }
+  return -1;
+}
+
+static void
+history_search_display_ (void)
+{
+  const char * text = "";
+  size_t len = 0;
+
+  if (0 < historyPosition_) {
+    text = xBSP430cliConsoleHistoryEntry(historyPosition_ - 1, &len);
+  }
+  cprintf("\r\e[K(search '%.*s'): ", historyPatternLen_, historyPattern_);
+  cputchars(text, len);
+}
+
+static int cb_process_key_ (int c);
+
+/* Apply one keystroke during incremental search. */
+static int
+history_search_key_ (int c)
+{
+  int n;
+  int rv = 0;
+
+  if (KEY_SEARCH == c) {
+    n = history_search_(historyPosition_);
+    if (0 > n) {
+      cputchar(KEY_BEL);
+      return 0;
+    }
+    historyPosition_ = n + 1;
+  } else if (KEY_BS == c) {
+    if (0 == historyPatternLen_) {
+      cputchar(KEY_BEL);
+      return 0;
+    }
+    --historyPatternLen_;
+    historyPosition_ = 1 + history_search_(0);
+  } else if ((' ' <= c) && (0x7F != c)) {
+    if (sizeof(historyPattern_) <= historyPatternLen_) {
+      cputchar(KEY_BEL);
+      return 0;
+    }
+    historyPattern_[historyPatternLen_++] = c;
+    n = history_search_((0 < historyPosition_) ? (historyPosition_ - 1) : 0);
+    if (0 > n) {
+      --historyPatternLen_;
+      cputchar(KEY_BEL);
+      return 0;
+    }
+    historyPosition_ = n + 1;
+  } else {
+    historySearching_ = 0;
+    if ((KEY_BEL == c) || (0 == historyPosition_)) {
+      historyPosition_ = 0;
+    } else {
+      history_load_(historyPosition_ - 1);
+    }
+    if (KEY_CR != c) {
+      cputtext("\r\e[K");
+      rv |= eBSP430cliConsole_REPAINT;
+    }
+    if (KEY_BEL != c) {
+      rv |= cb_process_key_(c);
+    }
+    return rv;
+  }
+  history_search_display_();
+  return rv;
+}
+
+#endif /* BSP430_CLI_CONSOLE_HISTORY_SIZE */
 
 void
 vBSP430cliConsoleBufferClear (void)
 {
   cbEnd_ = NULL;
+#if 0 < BSP430_CLI_CONSOLE_HISTORY_SIZE
+  historyPosition_ = 0;
+#endif /* BSP430_CLI_CONSOLE_HISTORY_SIZE */
 }
 
 int
@@ -527,59 +1211,82 @@ iBSP430cliConsoleBufferExtend (const char * text,
   return (cbEnd_ - in_cb);
 }
 
-int
-iBSP430cliConsoleBufferProcessInput ()
+/* Whether printable input should be echoed here.  In line mode the
+ * console receive handler has already done so. */
+#define CB_ECHO_INPUT (! (configBSP430_CONSOLE_RX_LINE_MODE - 0))
+
+/* Apply one keystroke to the console buffer, returning the
+ * eBSP430cliConsole flags that should terminate processing. */
+static int
+cb_process_key_ (int c)
 {
-  int rv;
-  int c;
+  int rv = 0;
 
-  rv = 0;
-  if (NULL == cbEnd_) {
-    cbEnd_ = consoleBuffer_;
+#if 0 < BSP430_CLI_CONSOLE_HISTORY_SIZE
+  if (historySearching_) {
+    return history_search_key_(c);
   }
-  while (0 <= ((c = cgetchar()))) {
-    if (KEY_BS == c) {
-      if (cbEnd_ == consoleBuffer_) {
-        cputchar(KEY_BEL);
-      } else {
-        --cbEnd_;
-        cputtext("\b \b");
-      }
+#endif /* BSP430_CLI_CONSOLE_HISTORY_SIZE */
+  if (KEY_BS == c) {
+    if (cbEnd_ == consoleBuffer_) {
+      cputchar(KEY_BEL);
+    } else {
+      --cbEnd_;
+      cputtext("\b \b");
+    }
 #if (configBSP430_CLI_COMMAND_COMPLETION - 0)
-    } else if (KEY_HT == c) {
-      rv |= eBSP430cliConsole_DO_COMPLETION;
-      break;
+  } else if (KEY_HT == c) {
+    rv |= eBSP430cliConsole_DO_COMPLETION;
 #endif /* configBSP430_CLI_COMMAND_COMPLETION */
-    } else if (KEY_ESC == c) {
-      rv |= eBSP430cliConsole_PROCESS_ESCAPE;
-      break;
-    } else if (KEY_FF == c) {
-      cputchar(c);
-      rv |= eBSP430cliConsole_REPAINT;
-      break;
-    } else if (KEY_CR == c) {
+  } else if (KEY_ESC == c) {
+    rv |= eBSP430cliConsole_PROCESS_ESCAPE;
+#if 0 < BSP430_CLI_CONSOLE_HISTORY_SIZE
+  } else if (KEY_SEARCH == c) {
+    if (0 > history_offset_(0)) {
+      cputchar(KEY_BEL);
+    } else {
+      historySearching_ = 1;
+      historyPatternLen_ = 0;
+      historyPosition_ = 1;
+      history_search_display_();
+    }
+#endif /* BSP430_CLI_CONSOLE_HISTORY_SIZE */
+  } else if (KEY_FF == c) {
+    cputchar(c);
+    rv |= eBSP430cliConsole_REPAINT;
+  } else if (KEY_CR == c) {
+    if (CB_ECHO_INPUT) {
       cputchar('\n');
-      rv |= eBSP430cliConsole_READY;
-      break;
-    } else if (KEY_KILL_LINE == c) {
-      cprintf("\e[%uD\e[K", (unsigned int)(cbEnd_ - consoleBuffer_));
-      cbEnd_ = consoleBuffer_;
-      *cbEnd_ = 0;
-    } else if (KEY_KILL_WORD == c) {
-      char * kp = cbEnd_;
-      while (--kp > consoleBuffer_ && isspace((unsigned char)*kp)) {
+    }
+#if 0 < BSP430_CLI_CONSOLE_HISTORY_SIZE
+    history_record_(consoleBuffer_, cbEnd_ - consoleBuffer_);
+    historyPosition_ = 0;
+#endif /* BSP430_CLI_CONSOLE_HISTORY_SIZE */
+    rv |= eBSP430cliConsole_READY;
+  } else if ((KEY_KILL_LINE == c) || (KEY_KILL_WORD == c)) {
+    char * kp = consoleBuffer_;
+
+    if (KEY_KILL_WORD == c) {
+      kp = cbEnd_;
+      while ((kp > consoleBuffer_) && isspace((unsigned char)kp[-1])) {
+        --kp;
       }
-      while (--kp > consoleBuffer_ && !isspace((unsigned char)*kp)) {
+      while ((kp > consoleBuffer_) && !isspace((unsigned char)kp[-1])) {
+        --kp;
       }
-      ++kp;
+    }
+    /* A zero count would still move the cursor */
+    if (kp != cbEnd_) {
       cprintf("\e[%uD\e[K", (unsigned int)(cbEnd_ - kp));
-      cbEnd_ = kp;
-      *cbEnd_ = 0;
+    }
+    cbEnd_ = kp;
+    *cbEnd_ = 0;
+  } else {
+    if ((1+cbEnd_) >= (consoleBuffer_ + sizeof(consoleBuffer_))) {
+      cputchar(KEY_BEL);
     } else {
-      if ((1+cbEnd_) >= (consoleBuffer_ + sizeof(consoleBuffer_))) {
-        cputchar(KEY_BEL);
-      } else {
-        *cbEnd_++ = c;
+      *cbEnd_++ = c;
+      if (CB_ECHO_INPUT) {
         cputchar(c);
       }
     }
@@ -587,6 +1294,60 @@ iBSP430cliConsoleBufferProcessInput ()
   return rv;
 }
 
+int
+iBSP430cliConsoleBufferProcessInput ()
+{
+  int rv;
+  int c;
+
+  rv = 0;
+  if (NULL == cbEnd_) {
+    cbEnd_ = consoleBuffer_;
+  }
+#if (configBSP430_CONSOLE_RX_LINE_MODE - 0)
+  /* The receive handler has done the per-character editing.  Runs of
+   * printable text are appended as a block; control characters are
+   * handled individually. */
+  while (0 == rv) {
+    BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+    const uint8_t * dp;
+    int n;
+    int np = 0;
+
+    BSP430_CORE_DISABLE_INTERRUPT();
+    n = iBSP430consoleRxContiguous_ni(&dp);
+    while ((np < n) && (' ' <= dp[np]) && (0x7F != dp[np])) {
+      ++np;
+    }
+#if 0 < BSP430_CLI_CONSOLE_HISTORY_SIZE
+    /* Search text is edited one keystroke at a time */
+    if (historySearching_) {
+      np = 0;
+    }
+#endif /* BSP430_CLI_CONSOLE_HISTORY_SIZE */
+    if (0 < np) {
+      (void)iBSP430cliConsoleBufferExtend((const char *)dp, np);
+      vBSP430consoleRxConsume_ni(np);
+    } else if (0 < n) {
+      c = *dp;
+      vBSP430consoleRxConsume_ni(1);
+    }
+    BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+    if (0 == n) {
+      break;
+    }
+    if (0 == np) {
+      rv |= cb_process_key_(c);
+    }
+  }
+#else /* configBSP430_CONSOLE_RX_LINE_MODE */
+  while ((0 == rv) && (0 <= ((c = cgetchar())))) {
+    rv |= cb_process_key_(c);
+  }
+#endif /* configBSP430_CONSOLE_RX_LINE_MODE */
+  return rv;
+}
+
 int
 iBSP430cliConsoleBufferConsumeEscape (int flags)
 {
@@ -603,6 +1364,11 @@ iBSP430cliConsoleBufferConsumeEscape (int flags)
         flags &= ~eBSP430cliConsole_PROCESS_ESCAPE;
         flags |= eBSP430cliConsole_IN_ESCAPE;
       } else if ((64 <= c) && (c <= 126)) {
+#if 0 < BSP430_CLI_CONSOLE_HISTORY_SIZE
+        if (flags & eBSP430cliConsole_IN_ESCAPE) {
+          flags |= history_recall_(c);
+        }
+#endif /* BSP430_CLI_CONSOLE_HISTORY_SIZE */
         flags &= ~eBSP430cliConsole_ANY_ESCAPE;
         break;
       }
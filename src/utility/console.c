@@ -39,23 +39,32 @@
 
 #include <bsp430/platform.h>
 #include <bsp430/utility/console.h>
+#include <bsp430/utility/ring.h>
+#include <bsp430/utility/xtoa.h>
+#if (configBSP430_UPTIME - 0)
+#include <bsp430/utility/uptime.h>
+#endif /* configBSP430_UPTIME */
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+#include <bsp430/periph/dma.h>
+#endif /* configBSP430_CONSOLE_TX_DMA */
 #include <stdio.h>
 #include <stdarg.h>
 #include <stdlib.h>
 #include <ctype.h>
+#include <string.h>
 
 #if (BSP430_CONSOLE - 0)
 /* Inhibit definition if required components were not provided. */
 
+#if (configBSP430_UPTIME_IDLE - 0) && (configBSP430_UPTIME_DELAY - 0)
+/* Register a constraint with the idle manager */
+#define CONSOLE_IDLE_CONSTRAINT 1
+#endif /* configBSP430_UPTIME_IDLE */
+
 #if (BSP430_CONSOLE_USE_EMBTEXTF - 0)
 #define HAVE_EMBTEXTF 1
 #include <embtextf/uprintf.h>
-#include <embtextf/xtoa.h>
 
-#define itoa embtextf_itoa
-#define utoa embtextf_utoa
-#define ltoa embtextf_ltoa
-#define ultoa embtextf_ultoa
 #define vuprintf embtextf_vuprintf
 #elif (BSP430_CORE_TOOLCHAIN_LIBC_MSP430_LIBC - 0)
 /* msp430-libc natively incorporates the same interfaces provided by embtextf. */
@@ -64,34 +73,189 @@
 
 static hBSP430halSERIAL console_hal_;
 
+#if (configBSP430_CONSOLE_RX_LINE_MODE - 0) && ! (BSP430_CONSOLE_RX_BUFFER_SIZE - 0)
+#error configBSP430_CONSOLE_RX_LINE_MODE requires BSP430_CONSOLE_RX_BUFFER_SIZE
+#endif /* configBSP430_CONSOLE_RX_LINE_MODE */
+
 #if (BSP430_CONSOLE_RX_BUFFER_SIZE - 0)
-#if 254 < (BSP430_CONSOLE_RX_BUFFER_SIZE)
-#error BSP430_CONSOLE_RX_BUFFER_SIZE is too large
+#if ! BSP430_RING_VALID_CAPACITY(BSP430_CONSOLE_RX_BUFFER_SIZE)
+#error BSP430_CONSOLE_RX_BUFFER_SIZE must be a power of two no larger than BSP430_RING_MAX_CAPACITY
 #endif /* validate BSP430_CONSOLE_RX_BUFFER_SIZE */
 
 typedef struct sConsoleRxBuffer {
   sBSP430halISRVoidChainNode cb_node;
-  char buffer[BSP430_CONSOLE_RX_BUFFER_SIZE];
-  volatile unsigned char head;
-  volatile unsigned char tail;
+  sBSP430ring ring;
+  uint8_t buffer[BSP430_CONSOLE_RX_BUFFER_SIZE];
   iBSP430consoleRxCallback_ni callback_ni;
+  sBSP430consoleRxStatistics stats;
+#if (configBSP430_CONSOLE_RX_LINE_MODE - 0)
+  /* Ring position following the last character of the line being
+   * assembled.  Characters between the ring head and this position
+   * are not yet visible to the consumer. */
+  uint16_t edit;
+  /* Escape sequence state: one of the RX_ESC_* values */
+  unsigned char esc;
+  /* Nonzero if the previous character was a carriage return */
+  unsigned char last_cr;
+#endif /* configBSP430_CONSOLE_RX_LINE_MODE */
 } sConsoleRxBuffer;
 
+#if (configBSP430_CONSOLE_RX_LINE_MODE - 0)
+
+#define RX_KEY_BS '\b'
+#define RX_KEY_LF '\n'
+#define RX_KEY_CR '\r'
+#define RX_KEY_KILL_LINE 0x15
+#define RX_KEY_KILL_WORD 0x17
+#define RX_KEY_ESC 0x1B
+#define RX_KEY_DEL 0x7F
+
+#define RX_ESC_NONE 0
+#define RX_ESC_STARTED 1
+#define RX_ESC_CSI 2
+
+#if (configBSP430_CONSOLE_RX_LINE_ECHO - 0)
+static void console_rx_echo_ni (const char * sp, int len);
+#define RX_ECHO_NI(sp_, len_) console_rx_echo_ni(sp_, len_)
+#else /* configBSP430_CONSOLE_RX_LINE_ECHO */
+#define RX_ECHO_NI(sp_, len_) do { } while (0)
+#endif /* configBSP430_CONSOLE_RX_LINE_ECHO */
+
+/* Remove the end of the line being assembled, from ring position kp,
+ * and erase the echo of what was removed.  Only printable characters
+ * were echoed. */
+static void
+console_rx_kill_ni (sConsoleRxBuffer * bufp,
+                    uint16_t kp)
+{
+  while (kp != bufp->edit) {
+    --bufp->edit;
+    if (' ' <= bufp->buffer[bufp->edit & bufp->ring.mask]) {
+      RX_ECHO_NI("\b \b", 3);
+    }
+  }
+}
+
+static int
+console_rx_isr_ni (const struct sBSP430halISRVoidChainNode * cb,
+                   void * context)
+{
+  sConsoleRxBuffer * bufp = (sConsoleRxBuffer *)cb;
+  sBSP430halSERIAL * hal = (sBSP430halSERIAL *) context;
+  uint8_t c = hal->rx_byte;
+  int store = 1;
+  int echo = 0;
+  int publish = 0;
+  int rv;
+
+  ++bufp->stats.received;
+  if (RX_ESC_NONE != bufp->esc) {
+    /* Pass the sequence through unedited, ending assembly when it
+     * completes if ESC is a wake character. */
+    if ((RX_ESC_STARTED == bufp->esc) && ('[' == c)) {
+      bufp->esc = RX_ESC_CSI;
+    } else if ((RX_ESC_STARTED == bufp->esc)
+               || ((0x40 <= c) && (c <= 0x7E))) {
+      bufp->esc = RX_ESC_NONE;
+      publish = !!(BSP430_CONSOLE_RX_LINE_WAKE_MASK & (1UL << RX_KEY_ESC));
+    }
+  } else if ((RX_KEY_BS == c) || (RX_KEY_DEL == c)) {
+    if (bufp->edit != bufp->ring.head) {
+      console_rx_kill_ni(bufp, bufp->edit - 1);
+      store = 0;
+    } else {
+      c = RX_KEY_BS;
+      publish = 1;
+    }
+  } else if ((RX_KEY_LF == c) && bufp->last_cr) {
+    store = 0;
+  } else if ((RX_KEY_CR == c) || (RX_KEY_LF == c)) {
+    c = RX_KEY_CR;
+    publish = 1;
+    RX_ECHO_NI("\r\n", 2);
+  } else if ((RX_KEY_KILL_LINE == c) || (RX_KEY_KILL_WORD == c)) {
+    /* The edit and its echo are made here.  A line kill, or a word
+     * kill with nothing to remove here, is also passed through so the
+     * application can edit what it has already received. */
+    uint16_t kp = bufp->ring.head;
+
+    if (RX_KEY_KILL_WORD == c) {
+      kp = bufp->edit;
+      while ((kp != bufp->ring.head)
+             && (' ' == bufp->buffer[(kp - 1) & bufp->ring.mask])) {
+        --kp;
+      }
+      while ((kp != bufp->ring.head)
+             && (' ' != bufp->buffer[(kp - 1) & bufp->ring.mask])) {
+        --kp;
+      }
+      store = (bufp->edit == bufp->ring.head);
+    }
+    console_rx_kill_ni(bufp, kp);
+    publish = store;
+  } else if (RX_KEY_ESC == c) {
+    bufp->esc = RX_ESC_STARTED;
+  } else if (c < 0x20) {
+    publish = !!(BSP430_CONSOLE_RX_LINE_WAKE_MASK & (1UL << c));
+  } else {
+    echo = 1;
+  }
+  bufp->last_cr = (RX_KEY_CR == hal->rx_byte);
+  if (store) {
+    /* If the buffer is full the character is lost, but a line that
+     * ends is still published so the consumer can make room. */
+    uint16_t used = bufp->edit - bufp->ring.tail;
+
+    if (used <= bufp->ring.mask) {
+      bufp->buffer[bufp->edit & bufp->ring.mask] = c;
+      ++bufp->edit;
+      if (bufp->stats.high_water <= used) {
+        bufp->stats.high_water = used + 1;
+      }
+      /* Echo only what was added to the line */
+      if (echo) {
+        RX_ECHO_NI((const char *)&c, 1);
+      }
+    } else {
+      ++bufp->stats.overruns;
+    }
+  }
+  if (! publish) {
+    return BSP430_HAL_ISR_CALLBACK_BREAK_CHAIN;
+  }
+  vBSP430ringProduce(&bufp->ring, bufp->edit - bufp->ring.head);
+  if (NULL != bufp->callback_ni) {
+    rv = bufp->callback_ni();
+  } else {
+    rv = BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+  }
+  rv |= BSP430_HAL_ISR_CALLBACK_BREAK_CHAIN;
+  return rv;
+}
+
+#else /* configBSP430_CONSOLE_RX_LINE_MODE */
+
 static int
 console_rx_isr_ni (const struct sBSP430halISRVoidChainNode * cb,
                    void * context)
 {
   sConsoleRxBuffer * bufp = (sConsoleRxBuffer *)cb;
   sBSP430halSERIAL * hal = (sBSP430halSERIAL *) context;
-  unsigned char head = bufp->head;
   int rv;
 
-  bufp->buffer[head] = hal->rx_byte;
-  head = (head + 1) % (sizeof(bufp->buffer) / sizeof(*bufp->buffer));
-  if (head == bufp->tail) {
-    bufp->tail = (bufp->tail + 1) % (sizeof(bufp->buffer) / sizeof(*bufp->buffer));
+  /* On overflow discard the oldest character.  This is safe although
+   * we are not the consumer, because the consumer holds interrupts
+   * disabled while it reads. */
+  ++bufp->stats.received;
+  if (iBSP430ringFull(&bufp->ring)) {
+    vBSP430ringConsume(&bufp->ring, 1);
+    ++bufp->stats.overruns;
+  }
+  bufp->buffer[uiBSP430ringHeadSlot(&bufp->ring)] = hal->rx_byte;
+  vBSP430ringProduce(&bufp->ring, 1);
+  if (bufp->stats.high_water < uiBSP430ringCount(&bufp->ring)) {
+    bufp->stats.high_water = uiBSP430ringCount(&bufp->ring);
   }
-  bufp->head = head;
   if (NULL != bufp->callback_ni) {
     rv = bufp->callback_ni();
   } else {
@@ -101,8 +265,11 @@ console_rx_isr_ni (const struct sBSP430halISRVoidChainNode * cb,
   return rv;
 }
 
+#endif /* configBSP430_CONSOLE_RX_LINE_MODE */
+
 static sConsoleRxBuffer rx_buffer_ = {
   .cb_node = { .callback_ni = console_rx_isr_ni },
+  .ring = BSP430_RING_INITIALIZER(BSP430_CONSOLE_RX_BUFFER_SIZE),
 };
 
 void
@@ -111,26 +278,148 @@ vBSP430consoleSetRxCallback_ni (iBSP430consoleRxCallback_ni cb)
   rx_buffer_.callback_ni = cb;
 }
 
+int
+iBSP430consoleRxContiguous_ni (const uint8_t ** datap)
+{
+  *datap = rx_buffer_.buffer + uiBSP430ringTailSlot(&rx_buffer_.ring);
+  return uiBSP430ringContiguousCount(&rx_buffer_.ring);
+}
+
+void
+vBSP430consoleRxConsume_ni (int len)
+{
+  vBSP430ringConsume(&rx_buffer_.ring, len);
+}
+
+int
+iBSP430consoleRxStatistics_ni (sBSP430consoleRxStatistics * sp,
+                               int reset)
+{
+  *sp = rx_buffer_.stats;
+  if (reset) {
+    memset(&rx_buffer_.stats, 0, sizeof(rx_buffer_.stats));
+  }
+  return 0;
+}
+
+#else /* BSP430_CONSOLE_RX_BUFFER_SIZE */
+
+int
+iBSP430consoleRxStatistics_ni (sBSP430consoleRxStatistics * sp,
+                               int reset)
+{
+  return -1;
+}
+
 #endif /* BSP430_CONSOLE_RX_BUFFER_SIZE */
 
 #if (BSP430_CONSOLE_TX_BUFFER_SIZE - 0)
-#if 254 < (BSP430_CONSOLE_TX_BUFFER_SIZE)
-#error BSP430_CONSOLE_TX_BUFFER_SIZE is too large
+#if ! BSP430_RING_VALID_CAPACITY(BSP430_CONSOLE_TX_BUFFER_SIZE)
+#error BSP430_CONSOLE_TX_BUFFER_SIZE must be a power of two no larger than BSP430_RING_MAX_CAPACITY
 #endif /* validate BSP430_CONSOLE_TX_BUFFER_SIZE */
 
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+#if ! (configBSP430_HAL_DMA - 0)
+#error configBSP430_CONSOLE_TX_DMA requires configBSP430_HAL_DMA
+#endif /* configBSP430_HAL_DMA */
+#ifndef BSP430_CONSOLE_TX_DMA_TSEL
+#error configBSP430_CONSOLE_TX_DMA requires BSP430_CONSOLE_TX_DMA_TSEL
+#endif /* BSP430_CONSOLE_TX_DMA_TSEL */
+#if BSP430_DMA_NUM_CHANNELS <= (BSP430_CONSOLE_TX_DMA_CHANNEL)
+#error BSP430_CONSOLE_TX_DMA_CHANNEL is not a valid DMA channel
+#endif /* validate BSP430_CONSOLE_TX_DMA_CHANNEL */
+#endif /* configBSP430_CONSOLE_TX_DMA */
+
 typedef struct sConsoleTxBuffer {
   sBSP430halISRVoidChainNode cb_node;
-  char buffer[BSP430_CONSOLE_TX_BUFFER_SIZE];
-  volatile unsigned char head;
-  volatile unsigned char tail;
+  sBSP430ring ring;
+  uint8_t buffer[BSP430_CONSOLE_TX_BUFFER_SIZE];
   volatile int wake_available;
+  /* Queue of descriptors referencing data to be transmitted in place */
+  sBSP430consoleTxDescriptor * volatile desc_head;
+  sBSP430consoleTxDescriptor * desc_tail;
+  /* Number of octets of desc_head that have been transmitted */
+  volatile size_t desc_offset;
+  /* Behavior when the buffer is full */
+  unsigned char policy;
+  sBSP430consoleTxStatistics stats;
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+  /* Callback for completion of the DMA transfer of a span */
+  sBSP430halISRIndexedChainNode dma_cb_node;
+  /* Number of octets currently being transferred by DMA, beginning at
+   * the ring tail or at desc_offset within desc_head.  Zero if the
+   * channel is idle. */
+  volatile size_t dma_span;
+  /* Nonzero if the current span comes from desc_head */
+  volatile unsigned char dma_desc;
+#endif /* configBSP430_CONSOLE_TX_DMA */
 } sConsoleTxBuffer;
 
-/* Calculate the number of bytes available in the buffer given the
- * head and tail indexes. */
-#define TX_BUFFER_AVAILABLE_(bp_,h_,t_) (((h_) >= (t_))                 \
-                                         ? (sizeof((bp_)->buffer) + (t_) - (h_) - 1) \
-                                         : ((t_) - (h_) - 1))
+/* True if neither the buffer nor the descriptor queue has data
+ * waiting to be transmitted. */
+#define TX_BUFFER_IDLE_(bp_) (iBSP430ringEmpty(&(bp_)->ring) && (NULL == (bp_)->desc_head))
+
+/* Determine whether a task waiting for space in the transmit buffer
+ * should be woken, now that the buffer has been drained.  Returns
+ * BSP430_HAL_ISR_CALLBACK_EXIT_LPM if so. */
+static int
+console_tx_wake_ni (sConsoleTxBuffer * bufp)
+{
+  int wake_available = bufp->wake_available;
+
+  if (0 == wake_available) {
+    return 0;
+  }
+  /* If somebody wants to know when there's space available and the
+   * buffer is empty, well, there's never going to be any more space
+   * than the whole buffer. */
+  if (TX_BUFFER_IDLE_(bufp)
+      || ((0 < wake_available)
+          && (uiBSP430ringSpace(&bufp->ring) >= wake_available))) {
+    bufp->wake_available = 0;
+    return BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+  }
+  return 0;
+}
+
+/* Remove the completed descriptor at the head of the queue and
+ * notify its owner. */
+static int
+console_tx_desc_retire_ni (sConsoleTxBuffer * bufp)
+{
+  sBSP430consoleTxDescriptor * dp = bufp->desc_head;
+
+  bufp->desc_head = dp->next_;
+  if (NULL == bufp->desc_head) {
+    bufp->desc_tail = NULL;
+  }
+  bufp->desc_offset = 0;
+  dp->busy_ = 0;
+  if (NULL == dp->callback_ni) {
+    return BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+  }
+  return dp->callback_ni(dp);
+}
+
+/* Return the descriptor from which the next octet is to be taken, or
+ * a null pointer if the next octet comes from the buffer.  Empty
+ * descriptors reached along the way are retired, with their callback
+ * flags accumulated in *rvp. */
+static sBSP430consoleTxDescriptor *
+console_tx_desc_ni (sConsoleTxBuffer * bufp,
+                    int * rvp)
+{
+  sBSP430consoleTxDescriptor * dp;
+
+  while ((NULL != (dp = bufp->desc_head))
+         && (dp->mark_ == bufp->ring.tail)) {
+    if (bufp->desc_offset < dp->len) {
+      return dp;
+    }
+    *rvp |= console_tx_desc_retire_ni(bufp);
+  }
+  return NULL;
+}
 
 static int
 console_tx_isr_ni (const struct sBSP430halISRVoidChainNode * cb,
@@ -138,55 +427,330 @@ console_tx_isr_ni (const struct sBSP430halISRVoidChainNode * cb,
 {
   sConsoleTxBuffer * bufp = (sConsoleTxBuffer *)cb;
   sBSP430halSERIAL * hal = (sBSP430halSERIAL *) context;
-  unsigned char tail = bufp->tail;
-  unsigned char head = bufp->head;
-  int wake_available;
+  sBSP430consoleTxDescriptor * dp;
   int rv = 0;
 
+  ++bufp->stats.interrupts;
   /* If there's data available here, store it and mark that we have
-   * done so. */
-  if (head != tail) {
-    hal->tx_byte = bufp->buffer[tail];
+   * done so.  Descriptor data takes precedence once the buffer has
+   * drained to the point where the descriptor was queued. */
+  dp = console_tx_desc_ni(bufp, &rv);
+  if (NULL != dp) {
+    hal->tx_byte = dp->data[bufp->desc_offset];
+    ++bufp->stats.transmitted;
     rv |= BSP430_HAL_ISR_CALLBACK_BREAK_CHAIN;
-    bufp->tail = tail = (tail + 1) % (sizeof(bufp->buffer) / sizeof(*bufp->buffer));
+    if (++bufp->desc_offset == dp->len) {
+      rv |= console_tx_desc_retire_ni(bufp);
+    }
+  } else if (! iBSP430ringEmpty(&bufp->ring)) {
+    hal->tx_byte = bufp->buffer[uiBSP430ringTailSlot(&bufp->ring)];
+    ++bufp->stats.transmitted;
+    rv |= BSP430_HAL_ISR_CALLBACK_BREAK_CHAIN;
+    vBSP430ringConsume(&bufp->ring, 1);
   }
-  wake_available = bufp->wake_available;
-  if (head == tail) {
+  if (TX_BUFFER_IDLE_(bufp)) {
     /* Ran out of data.  Turn off the interrupt infrastructure. */
     rv |= BSP430_HAL_ISR_CALLBACK_DISABLE_INTERRUPT;
-    /* If somebody wants to know when there's space available, well,
-     * there's never going to be any more space than the whole
-     * buffer. */
-    if (0 != wake_available) {
-      bufp->wake_available = 0;
-      rv |= BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+#if (CONSOLE_IDLE_CONSTRAINT - 0)
+    /* Wake an idle sleeper so it can pick a deeper mode. */
+    rv |= BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+#endif /* CONSOLE_IDLE_CONSTRAINT */
+  }
+  rv |= console_tx_wake_ni(bufp);
+  return rv;
+}
+
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+
+#define CONSOLE_TX_DMA_HPL_CH (BSP430_HAL_DMA->hpl->ch + BSP430_CONSOLE_TX_DMA_CHANNEL)
+
+/* Return nonzero if the transmit interrupt flag of the serial
+ * peripheral is set, i.e. it can accept another octet. */
+static int
+console_tx_dma_uart_ready_ni (hBSP430halSERIAL hal)
+{
+#if (configBSP430_SERIAL_USE_USCI - 0)
+  if (BSP430_SERIAL_HAL_HPL_VARIANT_IS_USCI(hal)) {
+    return *hal->hpl_aux.usci->ifgp & hal->hpl_aux.usci->tx_bit;
+  }
+#endif /* configBSP430_SERIAL_USE_USCI */
+#if (configBSP430_SERIAL_USE_USCI5 - 0)
+  if (BSP430_SERIAL_HAL_HPL_VARIANT_IS_USCI5(hal)) {
+    return hal->hpl.usci5->ifg & UCTXIFG;
+  }
+#endif /* configBSP430_SERIAL_USE_USCI5 */
+#if (configBSP430_SERIAL_USE_EUSCI - 0)
+  if (BSP430_SERIAL_HAL_HPL_VARIANT_IS_EUSCIA(hal)) {
+    return hal->hpl.euscia->ifg & UCTXIFG;
+  }
+#endif /* configBSP430_SERIAL_USE_EUSCI */
+  return 0;
+}
+
+/* Hand the next contiguous span of queued data to the DMA channel,
+ * if the channel is idle and there is data to be transmitted.  The
+ * span comes from a descriptor if one is pending at the tail of the
+ * buffer, and otherwise extends from the tail to the head or the end
+ * of the buffer storage, stopping at the mark of the first queued
+ * descriptor so the descriptor is started when the span completes.
+ * Returns the flags from retiring any empty descriptors. */
+static int
+console_tx_dma_start_ni (sConsoleTxBuffer * bufp)
+{
+  volatile sBSP430hplDMAchannel * chp = CONSOLE_TX_DMA_HPL_CH;
+  sBSP430consoleTxDescriptor * dp;
+  const uint8_t * sp;
+  size_t span;
+  int rv = 0;
+
+  if (0 != bufp->dma_span) {
+    return rv;
+  }
+  dp = console_tx_desc_ni(bufp, &rv);
+  if (NULL != dp) {
+    sp = dp->data + bufp->desc_offset;
+    span = dp->len - bufp->desc_offset;
+    if (0xFFFF < span) {
+      span = 0xFFFF;
     }
-  } else if (0 < wake_available) {
-    int available = TX_BUFFER_AVAILABLE_(bufp, head, tail);
+  } else if (! iBSP430ringEmpty(&bufp->ring)) {
+    sp = bufp->buffer + uiBSP430ringTailSlot(&bufp->ring);
+    span = uiBSP430ringContiguousCount(&bufp->ring);
+    if (NULL != bufp->desc_head) {
+      uint16_t to_mark = bufp->desc_head->mark_ - bufp->ring.tail;
+
+      if (span > to_mark) {
+        span = to_mark;
+      }
+    }
+  } else {
+    return rv;
+  }
+  bufp->dma_desc = (NULL != dp);
+  bufp->dma_span = span;
+  chp->sa = (uintptr_t)sp;
+  chp->sz = span;
+  chp->ctl |= DMAEN;
+  /* The channel is triggered by the rising edge of the UART transmit
+   * flag.  If the flag was set before the channel was enabled no edge
+   * will come, so request the first transfer.  A transfer triggered
+   * after the flag is read completes before the next instruction, so
+   * it is seen in the size register. */
+  if (console_tx_dma_uart_ready_ni(console_hal_)
+      && (chp->ctl & DMAEN)
+      && (span == chp->sz)) {
+    chp->ctl |= DMAREQ;
+  }
+  return rv;
+}
+
+/* Account for completion of the span that was in progress. */
+static int
+console_tx_dma_complete_ni (sConsoleTxBuffer * bufp)
+{
+  size_t span = bufp->dma_span;
+  int rv = 0;
 
-    if (available >= wake_available) {
-      bufp->wake_available = 0;
-      rv |= BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+  console_hal_->num_tx += span;
+  bufp->stats.transmitted += span;
+  if (bufp->dma_desc) {
+    bufp->desc_offset += span;
+    if (bufp->desc_offset == bufp->desc_head->len) {
+      rv = console_tx_desc_retire_ni(bufp);
     }
+  } else {
+    vBSP430ringConsume(&bufp->ring, span);
   }
+  bufp->dma_span = 0;
   return rv;
 }
 
+static int
+console_tx_dma_isr_ni (const struct sBSP430halISRIndexedChainNode * cb,
+                       void * context,
+                       int idx)
+{
+  sConsoleTxBuffer * bufp = (sConsoleTxBuffer *)((char *)cb - offsetof(sConsoleTxBuffer, dma_cb_node));
+  int rv;
+
+  /* The transfer for the span is complete: release its storage and
+   * start the next one. */
+  ++bufp->stats.interrupts;
+  rv = console_tx_dma_complete_ni(bufp);
+  rv |= console_tx_dma_start_ni(bufp);
+#if (CONSOLE_IDLE_CONSTRAINT - 0)
+  if (TX_BUFFER_IDLE_(bufp)) {
+    /* Wake an idle sleeper so it can pick a deeper mode. */
+    rv |= BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
+  }
+#endif /* CONSOLE_IDLE_CONSTRAINT */
+  return rv | console_tx_wake_ni(bufp);
+}
+
+/* Start the drain of the transmit buffer */
+#define CONSOLE_TX_WAKEUP_NI(uart_) (void)console_tx_dma_start_ni(&tx_buffer_)
+
+#else /* configBSP430_CONSOLE_TX_DMA */
+
+#define CONSOLE_TX_WAKEUP_NI(uart_) vBSP430serialWakeupTransmit_rh(uart_)
+
+#endif /* configBSP430_CONSOLE_TX_DMA */
+
 static sConsoleTxBuffer tx_buffer_ = {
   .cb_node = { .callback_ni = console_tx_isr_ni },
+  .ring = BSP430_RING_INITIALIZER(BSP430_CONSOLE_TX_BUFFER_SIZE),
+  .policy = eBSP430consoleTxPolicy_BLOCK,
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+  .dma_cb_node = { .callback_ni = console_tx_dma_isr_ni },
+#endif /* configBSP430_CONSOLE_TX_DMA */
 };
 
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+
+/* Return the address of the transmit buffer register of the serial
+ * peripheral, for use as a DMA destination. */
+static uintptr_t
+console_tx_dma_da (hBSP430halSERIAL hal)
+{
+#if (configBSP430_SERIAL_USE_USCI - 0)
+  if (BSP430_SERIAL_HAL_HPL_VARIANT_IS_USCI(hal)) {
+    return (uintptr_t)&hal->hpl.usci->txbuf;
+  }
+#endif /* configBSP430_SERIAL_USE_USCI */
+#if (configBSP430_SERIAL_USE_USCI5 - 0)
+  if (BSP430_SERIAL_HAL_HPL_VARIANT_IS_USCI5(hal)) {
+    return (uintptr_t)&hal->hpl.usci5->txbuf;
+  }
+#endif /* configBSP430_SERIAL_USE_USCI5 */
+#if (configBSP430_SERIAL_USE_EUSCI - 0)
+  if (BSP430_SERIAL_HAL_HPL_VARIANT_IS_EUSCIA(hal)) {
+    return (uintptr_t)&hal->hpl.euscia->txbuf;
+  }
+#endif /* configBSP430_SERIAL_USE_EUSCI */
+  return 0;
+}
+
+/* Configure the DMA channel to copy octets from the transmit buffer
+ * to the UART whenever it is ready to accept one, and hook the
+ * completion callback.  Returns -1 if the UART cannot be used. */
+static int
+console_tx_dma_configure_ni (hBSP430halSERIAL hal)
+{
+  volatile sBSP430hplDMA * const dma = BSP430_HAL_DMA->hpl;
+  volatile sBSP430hplDMAchannel * chp = CONSOLE_TX_DMA_HPL_CH;
+  uintptr_t da = console_tx_dma_da(hal);
+
+  if (0 == da) {
+    return -1;
+  }
+  chp->ctl = 0;
+#if (BSP430_CORE_FAMILY_IS_5XX - 0)
+  /* 5xx family: five-bit trigger selects, two per control word */
+  {
+    volatile unsigned int * tselp = &dma->ctl0 + (BSP430_CONSOLE_TX_DMA_CHANNEL / 2);
+    const unsigned int shift = 8 * (BSP430_CONSOLE_TX_DMA_CHANNEL % 2);
+    *tselp = (*tselp & ~(0x1F << shift)) | ((BSP430_CONSOLE_TX_DMA_TSEL) << shift);
+  }
+#if defined(DMARMWDIS)
+  /* Don't let a transfer corrupt an in-progress read-modify-write */
+  dma->ctl4 |= DMARMWDIS;
+#endif /* DMARMWDIS */
+#else /* BSP430_CORE_FAMILY_IS_5XX */
+  /* Earlier families: four-bit trigger selects in DMACTL0 */
+  {
+    const unsigned int shift = 4 * BSP430_CONSOLE_TX_DMA_CHANNEL;
+    dma->ctl0 = (dma->ctl0 & ~(0x0F << shift)) | ((BSP430_CONSOLE_TX_DMA_TSEL) << shift);
+  }
+#endif /* BSP430_CORE_FAMILY_IS_5XX */
+  chp->da = da;
+  /* Edge triggered: the family user's guides (SLAU144, SLAU208 and
+   * SLAU367, "Initiating DMA Transfers") allow level-sensitive
+   * triggers only with the external DMAE0 trigger. */
+  chp->ctl = DMADT_0 | DMASRCINCR_3 | DMADSTBYTE | DMASRCBYTE | DMAIE;
+  tx_buffer_.dma_span = 0;
+  BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRIndexedChainNode, BSP430_HAL_DMA->ch_cbchain_ni[BSP430_CONSOLE_TX_DMA_CHANNEL], tx_buffer_.dma_cb_node, next_ni);
+  return 0;
+}
+
+/* Wait for any in-progress span to complete, account for it, and
+ * unhook the completion callback.  Anything remaining in the buffer
+ * is left there. */
+static void
+console_tx_dma_deconfigure_ni (void)
+{
+  volatile sBSP430hplDMAchannel * chp = CONSOLE_TX_DMA_HPL_CH;
+
+  while (chp->ctl & DMAEN) {
+    ;
+  }
+  chp->ctl &= ~(DMAIE | DMAIFG);
+  if (tx_buffer_.dma_span) {
+    (void)console_tx_dma_complete_ni(&tx_buffer_);
+  }
+  BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRIndexedChainNode, BSP430_HAL_DMA->ch_cbchain_ni[BSP430_CONSOLE_TX_DMA_CHANNEL], tx_buffer_.dma_cb_node, next_ni);
+}
+
+#endif /* configBSP430_CONSOLE_TX_DMA */
+
+/* Discard the oldest octet in the buffer, if it is not already being
+ * transmitted.  Returns nonzero if an octet was discarded. */
+static int
+console_tx_discard_oldest_ni (sConsoleTxBuffer * bufp)
+{
+  sBSP430consoleTxDescriptor * dp;
+  uint16_t tail = bufp->ring.tail;
+
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+  if (bufp->dma_span && (! bufp->dma_desc)) {
+    return 0;
+  }
+#endif /* configBSP430_CONSOLE_TX_DMA */
+  /* Descriptors queued ahead of the discarded octet remain ahead of
+   * its successor. */
+  for (dp = bufp->desc_head; NULL != dp; dp = dp->next_) {
+    if (dp->mark_ == tail) {
+      dp->mark_ = tail + 1;
+    }
+  }
+  vBSP430ringConsume(&bufp->ring, 1);
+  return 1;
+}
+
 static int
 console_tx_queue (hBSP430halSERIAL uart, uint8_t c)
 {
   BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
   sConsoleTxBuffer * bufp = &tx_buffer_;
+  int rv = c;
+#if (configBSP430_UPTIME - 0)
+  unsigned long blocked_utt = 0;
+#endif /* configBSP430_UPTIME */
+  int blocked = 0;
 
   BSP430_CORE_DISABLE_INTERRUPT();
   while (1) {
-    unsigned char head = bufp->head;
-    unsigned char next_head = (head + 1) % (sizeof(bufp->buffer)/sizeof(*bufp->buffer));
-    if (next_head == bufp->tail) {
+    int was_idle;
+    unsigned int used;
+
+    if (iBSP430ringFull(&bufp->ring)) {
+      if ((eBSP430consoleTxPolicy_DROP_NEWEST == bufp->policy)
+          || ((eBSP430consoleTxPolicy_OVERWRITE_OLDEST == bufp->policy)
+              && (! console_tx_discard_oldest_ni(bufp)))) {
+        ++bufp->stats.dropped;
+        rv = -1;
+        break;
+      }
+      if (eBSP430consoleTxPolicy_OVERWRITE_OLDEST == bufp->policy) {
+        ++bufp->stats.dropped;
+        continue;
+      }
+      if (! blocked) {
+        blocked = 1;
+        ++bufp->stats.blocked;
+#if (configBSP430_UPTIME - 0)
+        blocked_utt = ulBSP430uptime_ni();
+#endif /* configBSP430_UPTIME */
+      }
       if (0 == bufp->wake_available) {
         bufp->wake_available = 1;
       }
@@ -197,15 +761,26 @@ console_tx_queue (hBSP430halSERIAL uart, uint8_t c)
       BSP430_CORE_DISABLE_INTERRUPT();
       continue;
     }
-    bufp->buffer[head] = c;
-    bufp->head = next_head;
-    if (head == bufp->tail) {
-      vBSP430serialWakeupTransmit_rh(uart);
+    was_idle = iBSP430ringEmpty(&bufp->ring);
+    bufp->buffer[uiBSP430ringHeadSlot(&bufp->ring)] = c;
+    vBSP430ringProduce(&bufp->ring, 1);
+    ++bufp->stats.queued;
+    used = uiBSP430ringCount(&bufp->ring);
+    if (bufp->stats.high_water < used) {
+      bufp->stats.high_water = used;
+    }
+    if (was_idle) {
+      CONSOLE_TX_WAKEUP_NI(uart);
     }
     break;
   }
+#if (configBSP430_UPTIME - 0)
+  if (blocked) {
+    bufp->stats.blocked_utt += ulBSP430uptime_ni() - blocked_utt;
+  }
+#endif /* configBSP430_UPTIME */
   BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
-  return c;
+  return rv;
 }
 
 static int (* uartTransmit) (hBSP430halSERIAL uart, uint8_t c);
@@ -218,6 +793,82 @@ static int (* uartTransmit) (hBSP430halSERIAL uart, uint8_t c);
 
 #endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
 
+#if (CONSOLE_IDLE_CONSTRAINT - 0)
+/* Return nonzero if the UART is still shifting out an octet. */
+static int
+console_uart_busy_ni (hBSP430halSERIAL hal)
+{
+#if (configBSP430_SERIAL_USE_USCI - 0)
+  if (BSP430_SERIAL_HAL_HPL_VARIANT_IS_USCI(hal)) {
+    return hal->hpl.usci->stat & UCBUSY;
+  }
+#endif /* configBSP430_SERIAL_USE_USCI */
+#if (configBSP430_SERIAL_USE_USCI5 - 0)
+  if (BSP430_SERIAL_HAL_HPL_VARIANT_IS_USCI5(hal)) {
+    return hal->hpl.usci5->stat & UCBUSY;
+  }
+#endif /* configBSP430_SERIAL_USE_USCI5 */
+#if (configBSP430_SERIAL_USE_EUSCI - 0)
+  if (BSP430_SERIAL_HAL_HPL_VARIANT_IS_EUSCIA(hal)) {
+    return hal->hpl.euscia->statw & UCBUSY;
+  }
+#endif /* configBSP430_SERIAL_USE_EUSCI */
+  return 0;
+}
+
+/* Tell the idle manager to keep the UART clock running while there is
+ * data to be transmitted, including the final octets still in the
+ * shift register. */
+static int
+console_idle_level_ni (const sBSP430uptimeIdleConstraint * cp)
+{
+#if (BSP430_CONSOLE_TX_BUFFER_SIZE - 0)
+  if ((console_tx_queue == uartTransmit) && (! TX_BUFFER_IDLE_(&tx_buffer_))) {
+    return 0;
+  }
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+  if (console_uart_busy_ni(console_hal_)) {
+    return 0;
+  }
+  return BSP430_UPTIME_IDLE_LEVELS - 1;
+}
+
+static sBSP430uptimeIdleConstraint console_idle_ = {
+  .level_ni = console_idle_level_ni,
+};
+#endif /* CONSOLE_IDLE_CONSTRAINT */
+
+#if (configBSP430_CONSOLE_RX_LINE_MODE - 0) && (configBSP430_CONSOLE_RX_LINE_ECHO - 0)
+/* Echo line edits from the receive interrupt handler, which must not
+ * wait for space in the transmission buffer. */
+static void
+console_rx_echo_ni (const char * sp,
+                    int len)
+{
+  hBSP430halSERIAL uart = console_hal_;
+
+  if (! uart) {
+    return;
+  }
+#if (BSP430_CONSOLE_TX_BUFFER_SIZE - 0)
+  if (console_tx_queue == uartTransmit) {
+    sConsoleTxBuffer * bufp = &tx_buffer_;
+    int was_idle = iBSP430ringEmpty(&bufp->ring);
+    uint16_t n = uiBSP430ringWriteOctets(&bufp->ring, bufp->buffer, (const uint8_t *)sp, len);
+
+    bufp->stats.queued += n;
+    if (n && was_idle) {
+      CONSOLE_TX_WAKEUP_NI(uart);
+    }
+    return;
+  }
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+  while (0 < len--) {
+    iBSP430uartTxByte_rh(uart, *sp++);
+  }
+}
+#endif /* configBSP430_CONSOLE_RX_LINE_MODE && configBSP430_CONSOLE_RX_LINE_ECHO */
+
 /* Optimized version used inline.  Assumes that the uart is not
  * null. */
 static BSP430_CORE_INLINE
@@ -322,123 +973,148 @@ cputchars (const char * cp,
   return emit_chars(cp, len, uart);
 }
 
-#if HAVE_EMBTEXTF
 int
-cputi (int n, int radix)
+cputoctets (const uint8_t * dp,
+            size_t len)
 {
-  char buffer[sizeof("-32767")];
-  return emit_text(itoa(n, buffer, radix), console_hal_);
+  hBSP430halSERIAL uart = console_hal_;
+  const uint8_t * const edp = dp + len;
+
+  if (! uart) {
+    return 0;
+  }
+  while (dp < edp) {
+    UART_TRANSMIT(uart, *dp++);
+  }
+  return len;
 }
 
 int
-cputu (unsigned int n, int radix)
+iBSP430consoleWriteDescriptors (sBSP430consoleTxDescriptor * dps,
+                                unsigned int count)
 {
-  char buffer[sizeof("65535")];
-  return emit_text(utoa(n, buffer, radix), console_hal_);
+  hBSP430halSERIAL uart = console_hal_;
+  sBSP430consoleTxDescriptor * dp;
+  sBSP430consoleTxDescriptor * const edp = dps + count;
+  int rv = 0;
+
+  if (! uart) {
+    return -1;
+  }
+  if (0 == count) {
+    return rv;
+  }
+#if (BSP430_CONSOLE_TX_BUFFER_SIZE - 0)
+  if (console_tx_queue == uartTransmit) {
+    BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+    sConsoleTxBuffer * bufp = &tx_buffer_;
+
+    BSP430_CORE_DISABLE_INTERRUPT();
+    do {
+      /* Link the descriptors, and mark them to follow whatever is in
+       * the buffer now. */
+      for (dp = dps; dp < edp; ++dp) {
+        dp->next_ = dp + 1;
+        dp->mark_ = bufp->ring.head;
+        dp->busy_ = 1;
+        rv += dp->len;
+      }
+      dps[count-1].next_ = NULL;
+      if (NULL == bufp->desc_tail) {
+        bufp->desc_head = dps;
+      } else {
+        bufp->desc_tail->next_ = dps;
+      }
+      bufp->desc_tail = dps + count - 1;
+      bufp->stats.queued += rv;
+      CONSOLE_TX_WAKEUP_NI(uart);
+    } while (0);
+    BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+    return rv;
+  }
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+  for (dp = dps; dp < edp; ++dp) {
+    rv += iBSP430uartTxData_rh(uart, dp->data, dp->len);
+    if (NULL != dp->callback_ni) {
+      BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+      BSP430_CORE_DISABLE_INTERRUPT();
+      (void)dp->callback_ni(dp);
+      BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+    }
+  }
+  return rv;
 }
 
 int
-cputl (long n, int radix)
+iBSP430consoleTxDescriptorWait_ni (const sBSP430consoleTxDescriptor * dp)
 {
-  char buffer[sizeof("-2147483647")];
-  return emit_text(ltoa(n, buffer, radix), console_hal_);
+  int rv = 0;
+
+  while (dp->busy_) {
+    rv = 1;
+    /* Sleep until a descriptor completion or something else wakes
+     * us up.  Then immediately disable the interrupts as that
+     * probably was not done during wakeup. */
+    BSP430_CORE_LPM_ENTER_NI(LPM0_bits);
+    BSP430_CORE_DISABLE_INTERRUPT();
+  }
+  return rv;
 }
 
 int
-cputul (unsigned long n, int radix)
+cputi (int n, int radix)
 {
-  char buffer[sizeof("4294967295")];
-  return emit_text(ultoa(n, buffer, radix), console_hal_);
+  char buffer[sizeof("-32767")];
+  return emit_text(xBSP430xtoaInt(n, buffer, radix), console_hal_);
 }
 
 int
-vcprintf (const char * fmt, va_list ap)
+cputu (unsigned int n, int radix)
 {
-  /* Fail fast if printing is disabled */
-  if (! console_hal_) {
-    return 0;
-  }
-  return vuprintf(emit_char, fmt, ap);
+  char buffer[sizeof("177777")];
+  return emit_text(xBSP430xtoaUInt(n, buffer, radix), console_hal_);
 }
 
-#elif (BSP430_CORE_TOOLCHAIN_LIBC_NEWLIB - 0)
-
-#define XTOA_T(INT_T)                                                   \
-static char *                                                           \
-xtoa_##INT_T (INT_T sval,                                               \
-              char * str,                                               \
-              int radix,                                                \
-              int signedp)                                              \
-{                                                                       \
-  unsigned INT_T uval;                                                  \
-  unsigned int uradix = radix;                                          \
-  char *sp = str;                                                       \
-  char *sp2;                                                            \
-                                                                        \
-  /* If signed, store sign at start of buffer for negative base-10 values */ \
-  if (signedp && (10 == uradix) && (0 > sval)) {                        \
-    *sp++ = '-';                                                        \
-    uval = -sval;                                                       \
-  } else {                                                              \
-    uval = sval;                                                        \
-  }                                                                     \
-  sp2 = sp;                                                             \
-                                                                        \
-  do {                                                                  \
-    unsigned int rem = uval % uradix;                                   \
-    uval /= uradix;                                                     \
-    if (10 > rem) {                                                     \
-      *sp++ = '0' + rem;                                                \
-    } else {                                                            \
-      *sp++ = 'A' + rem - 10;                                           \
-    }                                                                   \
-  } while (0 < uval);                                                   \
-                                                                        \
-  /* Mark end of string */                                              \
-  *sp-- = 0;                                                            \
-                                                                        \
-  /* Reverse string contents (excluding sign) in place */               \
-  while (sp2 < sp) {                                                    \
-    char tmp = *sp2;                                                    \
-    *sp2++ = *sp;                                                       \
-    *sp-- = tmp;                                                        \
-  }                                                                     \
-                                                                        \
-  return str;                                                           \
-}
-
-XTOA_T(int)
-
 int
-cputi (int n, int radix)
+cputl (long n, int radix)
 {
-  char buffer[sizeof("-32767")];
-  return emit_text(xtoa_int(n, buffer, radix, 1), console_hal_);
+  char buffer[BSP430_XTOA_LONG_BUFFER_SIZE];
+  return emit_text(xBSP430xtoaLong(n, buffer, radix), console_hal_);
 }
 
 int
-cputu (unsigned int n, int radix)
+cputul (unsigned long n, int radix)
 {
-  char buffer[sizeof("65535")];
-  return emit_text(xtoa_int((int)n, buffer, radix, 0), console_hal_);
+  char buffer[BSP430_XTOA_LONG_BUFFER_SIZE];
+  return emit_text(xBSP430xtoaULong(n, buffer, radix), console_hal_);
 }
 
-XTOA_T(long)
+#if (configBSP430_CONSOLE_XTOA_PRINTF - 0)
 
 int
-cputl (long n, int radix)
+vcprintf (const char * fmt, va_list ap)
 {
-  char buffer[sizeof("-2147483647")];
-  return emit_text(xtoa_long(n, buffer, radix, 1), console_hal_);
+  /* Fail fast if printing is disabled */
+  if (! console_hal_) {
+    return 0;
+  }
+  return iBSP430xtoaVuprintf(emit_char, fmt, ap);
 }
 
+#elif HAVE_EMBTEXTF
+
 int
-cputul (unsigned long n, int radix)
+vcprintf (const char * fmt, va_list ap)
 {
-  char buffer[sizeof("4294967295")];
-  return emit_text(xtoa_long((long)n, buffer, radix, 0), console_hal_);
+  /* Fail fast if printing is disabled */
+  if (! console_hal_) {
+    return 0;
+  }
+  return vuprintf(emit_char, fmt, ap);
 }
 
+#elif (BSP430_CORE_TOOLCHAIN_LIBC_NEWLIB - 0)
+
 int
 vcprintf (const char * fmt, va_list ap)
 {
@@ -450,9 +1126,10 @@ vcprintf (const char * fmt, va_list ap)
   return vprintf(fmt, ap);
 }
 
-#endif /* HAVE_EMBTEXTF */
+#endif /* configBSP430_CONSOLE_XTOA_PRINTF */
 
-#if ((BSP430_CONSOLE_USE_EMBTEXTF - 0)                  \
+#if ((configBSP430_CONSOLE_XTOA_PRINTF - 0)           \
+     || (BSP430_CONSOLE_USE_EMBTEXTF - 0)               \
      || (BSP430_CORE_TOOLCHAIN_LIBC_MSP430_LIBC - 0)    \
      || (BSP430_CORE_TOOLCHAIN_LIBC_NEWLIB - 0))
 
@@ -488,10 +1165,10 @@ console_getchar_ (int do_pop)
 
   BSP430_CORE_DISABLE_INTERRUPT();
   do {
-    if (rx_buffer_.head != rx_buffer_.tail) {
-      rv = rx_buffer_.buffer[rx_buffer_.tail];
+    if (! iBSP430ringEmpty(&rx_buffer_.ring)) {
+      rv = rx_buffer_.buffer[uiBSP430ringTailSlot(&rx_buffer_.ring)];
       if (do_pop) {
-        rx_buffer_.tail = (rx_buffer_.tail + 1) & ((sizeof(rx_buffer_.buffer) / sizeof(*rx_buffer_.buffer)) - 1);
+        vBSP430ringConsume(&rx_buffer_.ring, 1);
       }
     }
   } while (0);
@@ -530,25 +1207,44 @@ iBSP430consoleTransmitUseInterrupts_ni (int enablep)
 {
 #if (BSP430_CONSOLE_TX_BUFFER_SIZE - 0)
   if (enablep) {
+    if ((eBSP430consoleTxPolicy_BLOCK > enablep)
+        || (eBSP430consoleTxPolicy_OVERWRITE_OLDEST < enablep)) {
+      return -1;
+    }
     if (uartTransmit != console_tx_queue) {
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+      /* Stay with direct writes if the channel can't feed this UART */
+      if (0 != console_tx_dma_configure_ni(console_hal_)) {
+        return -1;
+      }
+      uartTransmit = console_tx_queue;
+      vBSP430serialFlush_ni(console_hal_);
+#else /* configBSP430_CONSOLE_TX_DMA */
       uartTransmit = console_tx_queue;
       vBSP430serialFlush_ni(console_hal_);
       iBSP430serialSetHold_rh(console_hal_, 1);
       BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRVoidChainNode, console_hal_->tx_cbchain_ni, tx_buffer_.cb_node, next_ni);
       iBSP430serialSetHold_rh(console_hal_, 0);
-      if (tx_buffer_.head != tx_buffer_.tail) {
-        vBSP430serialWakeupTransmit_rh(console_hal_);
+#endif /* configBSP430_CONSOLE_TX_DMA */
+      if (! TX_BUFFER_IDLE_(&tx_buffer_)) {
+        CONSOLE_TX_WAKEUP_NI(console_hal_);
       }
     }
+    tx_buffer_.policy = enablep;
   } else {
     if (uartTransmit != iBSP430uartTxByte_rh) {
       uartTransmit = iBSP430uartTxByte_rh;
       /* This flushes any character currently in the UART; it does not
        * flush anything left in the transmission buffer. */
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+      console_tx_dma_deconfigure_ni();
+      vBSP430serialFlush_ni(console_hal_);
+#else /* configBSP430_CONSOLE_TX_DMA */
       vBSP430serialFlush_ni(console_hal_);
       iBSP430serialSetHold_rh(console_hal_, 1);
       BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRVoidChainNode, console_hal_->tx_cbchain_ni, tx_buffer_.cb_node, next_ni);
       iBSP430serialSetHold_rh(console_hal_, 0);
+#endif /* configBSP430_CONSOLE_TX_DMA */
     }
   }
   return 0;
@@ -557,6 +1253,21 @@ iBSP430consoleTransmitUseInterrupts_ni (int enablep)
 #endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
 }
 
+int
+iBSP430consoleTxStatistics_ni (sBSP430consoleTxStatistics * sp,
+                               int reset)
+{
+#if (BSP430_CONSOLE_TX_BUFFER_SIZE - 0)
+  *sp = tx_buffer_.stats;
+  if (reset) {
+    memset(&tx_buffer_.stats, 0, sizeof(tx_buffer_.stats));
+  }
+  return 0;
+#else /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+  return -1;
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
+}
+
 int
 iBSP430consoleInitialize (void)
 {
@@ -579,15 +1290,24 @@ iBSP430consoleInitialize (void)
 #if (BSP430_CONSOLE_RX_BUFFER_SIZE - 0)
     /* Associate the callback before opening the device, so the
      * interrupts are enabled properly. */
-    rx_buffer_.head = rx_buffer_.tail = 0;
+    vBSP430ringReset(&rx_buffer_.ring);
+#if (configBSP430_CONSOLE_RX_LINE_MODE - 0)
+    rx_buffer_.edit = 0;
+    rx_buffer_.esc = RX_ESC_NONE;
+    rx_buffer_.last_cr = 0;
+#endif /* configBSP430_CONSOLE_RX_LINE_MODE */
     BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRVoidChainNode, hal->rx_cbchain_ni, rx_buffer_.cb_node, next_ni);
 #endif /* BSP430_CONSOLE_RX_BUFFER_SIZE */
 
 #if (BSP430_CONSOLE_TX_BUFFER_SIZE - 0)
     uartTransmit = console_tx_queue;
     tx_buffer_.wake_available = 0;
-    tx_buffer_.head = tx_buffer_.tail = 0;
+    vBSP430ringReset(&tx_buffer_.ring);
+    tx_buffer_.desc_head = tx_buffer_.desc_tail = NULL;
+    tx_buffer_.desc_offset = 0;
+#if ! (configBSP430_CONSOLE_TX_DMA - 0)
     BSP430_HAL_ISR_CALLBACK_LINK_NI(sBSP430halISRVoidChainNode, hal->tx_cbchain_ni, tx_buffer_.cb_node, next_ni);
+#endif /* configBSP430_CONSOLE_TX_DMA */
 #endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
 
     /* Attempt to configure and install the console */
@@ -608,6 +1328,16 @@ iBSP430consoleInitialize (void)
 #endif /* BSP430_CONSOLE_RX_BUFFER_SIZE */
       break;
     }
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+    /* The DMA channel can only be configured once the UART is known
+     * to be available. */
+    if (0 != console_tx_dma_configure_ni(console_hal_)) {
+      uartTransmit = iBSP430uartTxByte_rh;
+    }
+#endif /* configBSP430_CONSOLE_TX_DMA */
+#if (CONSOLE_IDLE_CONSTRAINT - 0)
+    (void)iBSP430uptimeIdleConstraintRegister_ni(&console_idle_);
+#endif /* CONSOLE_IDLE_CONSTRAINT */
 #if (BSP430_PLATFORM_SPIN_FOR_JUMPER - 0)
     vBSP430platformSpinForJumper_ni();
 #endif /* BSP430_PLATFORM_SPIN_FOR_JUMPER */
@@ -629,12 +1359,31 @@ iBSP430consoleDeconfigure (void)
   }
   BSP430_CORE_DISABLE_INTERRUPT();
   do {
+#if (configBSP430_CONSOLE_TX_DMA - 0)
+    /* Let any in-progress transfer complete before the UART is
+     * turned off. */
+    if (uartTransmit == console_tx_queue) {
+      console_tx_dma_deconfigure_ni();
+    }
+#endif /* configBSP430_CONSOLE_TX_DMA */
+#if (CONSOLE_IDLE_CONSTRAINT - 0)
+    (void)iBSP430uptimeIdleConstraintUnregister_ni(&console_idle_);
+#endif /* CONSOLE_IDLE_CONSTRAINT */
     rv = iBSP430serialClose(console_hal_);
 #if (BSP430_CONSOLE_RX_BUFFER_SIZE - 0)
     BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRVoidChainNode, console_hal_->rx_cbchain_ni, rx_buffer_.cb_node, next_ni);
 #endif /* BSP430_CONSOLE_RX_BUFFER_SIZE */
 #if (BSP430_CONSOLE_TX_BUFFER_SIZE - 0)
+#if ! (configBSP430_CONSOLE_TX_DMA - 0)
     BSP430_HAL_ISR_CALLBACK_UNLINK_NI(sBSP430halISRVoidChainNode, console_hal_->tx_cbchain_ni, tx_buffer_.cb_node, next_ni);
+#endif /* configBSP430_CONSOLE_TX_DMA */
+    /* Anything still queued will never be transmitted; release the
+     * descriptors so nobody waits on them forever. */
+    while (NULL != tx_buffer_.desc_head) {
+      tx_buffer_.desc_head->busy_ = 0;
+      tx_buffer_.desc_head = tx_buffer_.desc_head->next_;
+    }
+    tx_buffer_.desc_tail = NULL;
 #endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
 #if (BSP430_SERIAL_ENABLE_RESOURCE - 0)
     (void)iBSP430resourceRelease_ni(&console_hal_->resource, &console_hal_);
@@ -650,27 +1399,30 @@ iBSP430consoleWaitForTxSpace_ni (int want_available)
 {
   int rv = 0;
 #if (BSP430_CONSOLE_TX_BUFFER_SIZE - 0)
-  if (((int)sizeof(tx_buffer_.buffer) - 1) < want_available) {
+#if (configBSP430_UPTIME - 0)
+  unsigned long wait_utt = 0;
+#endif /* configBSP430_UPTIME */
+
+  if ((int)uiBSP430ringCapacity(&tx_buffer_.ring) < want_available) {
     return -1;
   }
   while (1) {
-    int available;
-    unsigned char head = tx_buffer_.head;
-    unsigned char tail = tx_buffer_.tail;
-
     if (0 > want_available) {
-      if (head == tail) {
-        break;
-      }
-    } else {
-      available = TX_BUFFER_AVAILABLE_(&tx_buffer_, head, tail);
-      if (available >= want_available) {
+      if (TX_BUFFER_IDLE_(&tx_buffer_)) {
         break;
       }
+    } else if (uiBSP430ringSpace(&tx_buffer_.ring) >= want_available) {
+      break;
     }
     if (0 == tx_buffer_.wake_available) {
       tx_buffer_.wake_available = want_available;
     }
+    if (0 == rv) {
+      ++tx_buffer_.stats.waits;
+#if (configBSP430_UPTIME - 0)
+      wait_utt = ulBSP430uptime_ni();
+#endif /* configBSP430_UPTIME */
+    }
     rv = 1;
     /* Sleep until the tx callback indicates space is available or
      * something else wakes us up.  Then immediately disable the
@@ -678,6 +1430,11 @@ iBSP430consoleWaitForTxSpace_ni (int want_available)
     BSP430_CORE_LPM_ENTER_NI(LPM0_bits);
     BSP430_CORE_DISABLE_INTERRUPT();
   }
+#if (configBSP430_UPTIME - 0)
+  if (rv) {
+    tx_buffer_.stats.wait_utt += ulBSP430uptime_ni() - wait_utt;
+  }
+#endif /* configBSP430_UPTIME */
 #endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
   return rv;
 }
@@ -687,72 +1444,202 @@ iBSP430consoleFlush (void)
 {
   BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
   int rv;
+#if (BSP430_CONSOLE_TX_BUFFER_SIZE - 0) && (configBSP430_UPTIME - 0)
+  unsigned long flush_utt;
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE && configBSP430_UPTIME */
 
   if (! console_hal_) {
     return 0;
   }
   BSP430_CORE_DISABLE_INTERRUPT();
   do {
+#if (BSP430_CONSOLE_TX_BUFFER_SIZE - 0) && (configBSP430_UPTIME - 0)
+    flush_utt = ulBSP430uptime_ni();
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE && configBSP430_UPTIME */
     rv = iBSP430consoleWaitForTxSpace_ni(-1);
     vBSP430serialFlush_ni(console_hal_);
+#if (BSP430_CONSOLE_TX_BUFFER_SIZE - 0)
+    ++tx_buffer_.stats.flushes;
+#if (configBSP430_UPTIME - 0)
+    flush_utt = ulBSP430uptime_ni() - flush_utt;
+    tx_buffer_.stats.flush_utt += flush_utt;
+    if (tx_buffer_.stats.flush_max_utt < flush_utt) {
+      tx_buffer_.stats.flush_max_utt = flush_utt;
+    }
+#endif /* configBSP430_UPTIME */
+#endif /* BSP430_CONSOLE_TX_BUFFER_SIZE */
   } while (0);
   BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
   return rv;
 }
 
+static const char hex_digits_[] = "0123456789abcdef";
+
 void
 vBSP430consoleDisplayOctets (const uint8_t * dp,
                              size_t len)
 {
   const uint8_t * const edp = dp + len;
+  char text[16 * 3];
+
+  /* Format a block of octets at a time and emit it in one write */
   while (dp < edp) {
-    cprintf("%02x", *dp++);
-    if (dp < edp) {
-      cputchar(' ');
-    }
+    char * tp = text;
+
+    do {
+      *tp++ = hex_digits_[*dp >> 4];
+      *tp++ = hex_digits_[*dp & 0x0F];
+      if (++dp < edp) {
+        *tp++ = ' ';
+      }
+    } while ((dp < edp) && (tp < (text + sizeof(text))));
+    (void)cputchars(text, tp - text);
   }
 }
 
+#if (configBSP430_CONSOLE_USE_ONLCR - 0)
+#define DISPLAY_NEWLINE_ "\r\n"
+#else /* configBSP430_CONSOLE_USE_ONLCR */
+#define DISPLAY_NEWLINE_ "\n"
+#endif /* configBSP430_CONSOLE_USE_ONLCR */
+
+/* Longest segment of vBSP430consoleDisplayMemory output: newline,
+ * address, sixteen octets with a gap after the eighth, the octets as
+ * text, and the final newline. */
+#define DISPLAY_MEMORY_LINE_SIZE ((sizeof(DISPLAY_NEWLINE_) - 1) + 9 + (16 * 3) + 1 + 2 + 16 + (sizeof(DISPLAY_NEWLINE_) - 1))
+
+/* Template for a complete aligned row of vBSP430consoleDisplayMemory
+ * output: everything but the address, octet values, and text is
+ * fixed. */
+static const char display_row_template_[] =
+  DISPLAY_NEWLINE_ "00000000 "
+  " 00 00 00 00 00 00 00 00  00 00 00 00 00 00 00 00  ";
+
+/* Offset within display_row_template_ of the address */
+#define DISPLAY_ROW_ADDRESS_OFFSET (sizeof(DISPLAY_NEWLINE_) - 1)
+
+/* Offset within display_row_template_ of the first octet value */
+#define DISPLAY_ROW_OCTET_OFFSET (DISPLAY_ROW_ADDRESS_OFFSET + 10)
+
+static char
+display_char (uint8_t c)
+{
+  /* isprint() is a function call into the C library */
+  return ((' ' <= c) && (c < 0x7F)) ? c : '.';
+}
+
+/* Format a complete aligned row of 16 octets into lp */
+static char *
+display_full_row (char * lp,
+                  const uint8_t * dp,
+                  unsigned long base)
+{
+  char * hp;
+  int i;
+
+  memcpy(lp, display_row_template_, sizeof(display_row_template_) - 1);
+  hp = lp + DISPLAY_ROW_ADDRESS_OFFSET + 7;
+  for (i = 0; i < 8; ++i) {
+    *hp-- = hex_digits_[0x0F & (unsigned int)base];
+    base >>= 4;
+  }
+  hp = lp + DISPLAY_ROW_OCTET_OFFSET;
+  for (i = 0; i < 16; ++i) {
+    hp[0] = hex_digits_[dp[i] >> 4];
+    hp[1] = hex_digits_[dp[i] & 0x0F];
+    hp += (7 == i) ? 4 : 3;
+  }
+  lp += sizeof(display_row_template_) - 1;
+  for (i = 0; i < 16; ++i) {
+    *lp++ = display_char(dp[i]);
+  }
+  return lp;
+}
+
+/* Block until the console has finished with a descriptor */
+static void
+display_wait (const sBSP430consoleTxDescriptor * dp)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  (void)iBSP430consoleTxDescriptorWait_ni(dp);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+}
+
 void
 vBSP430consoleDisplayMemory (const uint8_t * dp,
                              size_t len,
                              unsigned long base)
 {
   const uint8_t * const edp = dp + len;
-  const uint8_t * adp = dp;
+  sBSP430consoleTxDescriptor desc[2] = { { 0 } };
+  char line[2][DISPLAY_MEMORY_LINE_SIZE];
+  int li = 0;
 
-  while (dp < edp) {
-    if (0 == (base & 0x0F)) {
-      if (adp < dp) {
-        cputtext("  ");
-        while (adp < dp) {
-          cputchar(isprint(*adp) ? *adp : '.');
-          ++adp;
+  /* Each line is formatted into one of two buffers and handed to the
+   * console by reference, so one line is formatted while the previous
+   * one is being transmitted. */
+  do {
+    const uint8_t * adp = dp;
+    char * lp = line[li];
+    int i;
+
+    display_wait(desc + li);
+    if ((0 == (base & 0x0F)) && (16 <= (edp - dp))) {
+      lp = display_full_row(lp, dp, base);
+      dp += 16;
+      base += 16;
+    } else if (dp < edp) {
+      if (0 == (base & 0x0F)) {
+        memcpy(lp, DISPLAY_NEWLINE_, sizeof(DISPLAY_NEWLINE_) - 1);
+        lp += sizeof(DISPLAY_NEWLINE_) - 1;
+        for (i = 28; 0 <= i; i -= 4) {
+          *lp++ = hex_digits_[0x0F & (base >> i)];
         }
+        *lp++ = ' ';
       }
-      adp = dp;
-      cprintf("\n%08lx ", base);
-    } else if (0 == (base & 0x07)) {
-      cputchar(' ');
-    }
-    cprintf(" %02x", *dp++);
-    ++base;
-  }
-  if (adp < dp) {
-    while (base & 0x0F) {
-      if (0 == (base & 0x07)) {
-        cputchar(' ');
+      do {
+        if ((0 != (base & 0x0F)) && (0 == (base & 0x07))) {
+          *lp++ = ' ';
+        }
+        *lp++ = ' ';
+        *lp++ = hex_digits_[*dp >> 4];
+        *lp++ = hex_digits_[*dp & 0x0F];
+        ++dp;
+        ++base;
+      } while ((dp < edp) && (0 != (base & 0x0F)));
+      if (dp == edp) {
+        while (base & 0x0F) {
+          if (0 == (base & 0x07)) {
+            *lp++ = ' ';
+          }
+          *lp++ = ' ';
+          *lp++ = ' ';
+          *lp++ = ' ';
+          ++base;
+        }
+      }
+      *lp++ = ' ';
+      *lp++ = ' ';
+      while (adp < dp) {
+        *lp++ = display_char(*adp++);
       }
-      cprintf("   ");
-      ++base;
     }
-    cputtext("  ");
-    while (adp < dp) {
-      cputchar(isprint(*adp) ? *adp : '.');
-      ++adp;
+    if (dp == edp) {
+      memcpy(lp, DISPLAY_NEWLINE_, sizeof(DISPLAY_NEWLINE_) - 1);
+      lp += sizeof(DISPLAY_NEWLINE_) - 1;
     }
-  }
-  cputchar('\n');
+    desc[li].data = (const uint8_t *)line[li];
+    desc[li].len = lp - line[li];
+    (void)iBSP430consoleWriteDescriptors(desc + li, 1);
+    li = ! li;
+  } while (dp < edp);
+
+  /* The lines are on the stack: wait until the console is done with
+   * them. */
+  display_wait(desc + 0);
+  display_wait(desc + 1);
 }
 
 #if (BSP430_CORE_TOOLCHAIN_LIBC_NEWLIB - 0)
@@ -32,22 +32,31 @@
 #include <bsp430/platform.h>
 #include <bsp430/utility/event.h>
 #include <bsp430/utility/uptime.h>
+#include <bsp430/utility/ring.h>
 #include <string.h>
 
-#if (BSP430_EVENT_RECORD_NUM_SUPPORTED > 255)
+#if (BSP430_EVENT_TAG_NUM_SUPPORTED > 255)
 #error Too many event tags
-#endif /* BSP430_EVENT_RECORD_NUM_SUPPORTED */
-#if (BSP430_EVENT_RECORD_NUM_SUPPORTED > 255)
-#error Too many event records
+#endif /* BSP430_EVENT_TAG_NUM_SUPPORTED */
+#if ! BSP430_RING_VALID_CAPACITY(BSP430_EVENT_RECORD_NUM_SUPPORTED)
+#error BSP430_EVENT_RECORD_NUM_SUPPORTED must be a power of two no larger than BSP430_RING_MAX_CAPACITY
 #endif /* BSP430_EVENT_RECORD_NUM_SUPPORTED */
 
 unsigned char nBSP430eventTagConfig_;
 sBSP430eventTagConfig xBSP430eventTagConfig_[BSP430_EVENT_TAG_NUM_SUPPORTED];
 
+/* Record i is stored in slot i modulo the capacity.  event_head is
+ * the number of records ever produced and is written only by
+ * producers, which run with interrupts disabled and so never overlap
+ * each other.  event_tail is the index of the next record to be
+ * consumed and is written only by the consumer.  Producers overwrite
+ * the oldest slot without regard to the consumer, which detects from
+ * event_head that records it has not read were replaced. */
+#define EVENT_RECORD_MASK (BSP430_EVENT_RECORD_NUM_SUPPORTED - 1)
 static volatile sBSP430eventTagRecord xBSP430eventRecord[BSP430_EVENT_RECORD_NUM_SUPPORTED];
-static volatile size_t event_lost_count;
-static volatile uint8_t event_head;
-static volatile uint8_t event_tail;
+static volatile uint16_t event_head;
+static uint16_t event_tail;
+static size_t event_lost_count;
 volatile unsigned int uiBSP430eventFlags_v_;
 
 unsigned int
@@ -92,6 +101,9 @@ ucBSP430eventTagAllocate (const char * id)
     }
     cp->id = id;
     cp->seqno = 0;
+#if (configBSP430_EVENT_TAG_STATS - 0)
+    memset(&cp->stats_, 0, sizeof(cp->stats_));
+#endif /* configBSP430_EVENT_TAG_STATS */
     rc = (cp - xBSP430eventTagConfig_);
     ++nBSP430eventTagConfig_;
   } while (0);
@@ -99,20 +111,134 @@ ucBSP430eventTagAllocate (const char * id)
   return rc;
 }
 
-#define EVENT_COUNT() ((event_head > event_tail) ? (event_head - event_tail) : (event_tail - event_head))
-#define EVENT_EMPTY() (event_head == event_tail)
-#define EVENT_INCREMENT_PTR(_p) do {                    \
-    if (++(_p) == BSP430_EVENT_RECORD_NUM_SUPPORTED) {  \
-      _p = 0;                                           \
-    }                                                   \
-  } while (0)
+#if (configBSP430_UPTIME_DELAY - 0)
+unsigned int
+uiBSP430eventFlagsWait (unsigned int mask,
+                        unsigned long deadline_utt,
+                        unsigned int lpm_bits)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  unsigned int rv;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  do {
+    /* lBSP430uptimeSleepUntil() returns with interrupts disabled when
+     * invoked with them disabled, so each test of the flags is
+     * atomic with the sleep that follows it.  It returns a
+     * non-positive value once the deadline is reached, or immediately
+     * if the delay alarm cannot be used. */
+    while ((0 == (rv = (mask & uiBSP430eventFlags_v_)))
+           && (0 < lBSP430uptimeSleepUntil(deadline_utt, lpm_bits))) {
+    }
+    if (0 == rv) {
+      rv = mask & uiBSP430eventFlags_v_;
+    }
+    uiBSP430eventFlags_v_ &= ~rv;
+  } while (0);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return rv;
+}
+#endif /* configBSP430_UPTIME_DELAY */
+
+#if (configBSP430_EVENT_TAG_STATS - 0)
+/* The histogram bucket for an interval: floor(log2(interval_utt)),
+ * with zero in bucket 0, limited to the last bucket. */
+static unsigned int
+stats_bucket (unsigned long interval_utt)
+{
+  unsigned int b = 0;
+  unsigned int w = (unsigned int)interval_utt;
+
+  if (interval_utt >> 16) {
+    b = 16;
+    w = (unsigned int)(interval_utt >> 16);
+  }
+  if (w >> 8) {
+    b += 8;
+    w >>= 8;
+  }
+  if (w >> 4) {
+    b += 4;
+    w >>= 4;
+  }
+  if (w >> 2) {
+    b += 2;
+    w >>= 2;
+  }
+  if (w >> 1) {
+    b += 1;
+  }
+  if (BSP430_EVENT_TAG_STATS_BUCKETS <= b) {
+    b = BSP430_EVENT_TAG_STATS_BUCKETS - 1;
+  }
+  return b;
+}
+
+static void
+stats_update_ni (sBSP430eventTagStats * sp,
+                 unsigned long timestamp_utt)
+{
+  if (sp->has_last) {
+    unsigned long interval_utt = timestamp_utt - sp->last_utt;
+    unsigned int * hp = sp->histogram + stats_bucket(interval_utt);
+
+    if ((0 == sp->intervals) || (interval_utt < sp->interval_min_utt)) {
+      sp->interval_min_utt = interval_utt;
+    }
+    if (interval_utt > sp->interval_max_utt) {
+      sp->interval_max_utt = interval_utt;
+    }
+    sp->interval_sum_utt += interval_utt;
+    ++sp->intervals;
+    if (0 != (unsigned int)~*hp) {
+      ++*hp;
+    }
+  }
+  sp->last_utt = timestamp_utt;
+  sp->has_last = 1;
+  ++sp->events;
+}
+
+int
+iBSP430eventTagGetStats (unsigned char tag,
+                         sBSP430eventTagStats * sp,
+                         int reset)
+{
+  sBSP430eventTagConfig * cp;
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+
+  if (tag >= nBSP430eventTagConfig_) {
+    return -1;
+  }
+  cp = xBSP430eventTagConfig_ + tag;
+  BSP430_CORE_DISABLE_INTERRUPT();
+  do {
+    if (sp) {
+      *sp = cp->stats_;
+    }
+    if (reset) {
+      unsigned long last_utt = cp->stats_.last_utt;
+      unsigned char has_last = cp->stats_.has_last;
+
+      memset(&cp->stats_, 0, sizeof(cp->stats_));
+      cp->stats_.last_utt = last_utt;
+      cp->stats_.has_last = has_last;
+    }
+  } while (0);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return 0;
+}
+#endif /* configBSP430_EVENT_TAG_STATS */
 
 const volatile sBSP430eventTagRecord *
 xBSP430eventRecordEvent_ni (unsigned char tag,
                             unsigned char flags,
                             const uBSP430eventAnyType * up)
 {
-  volatile sBSP430eventTagRecord * ep = xBSP430eventRecord + event_head;
+  uint16_t index = event_head;
+  volatile sBSP430eventTagRecord * ep;
+
+  ep = xBSP430eventRecord + (index & EVENT_RECORD_MASK);
   ep->tag = tag;
   ep->flags = flags;
   if (up) {
@@ -123,58 +249,73 @@ xBSP430eventRecordEvent_ni (unsigned char tag,
   ep->timestamp_utt = ulBSP430uptime_ni();
   if (tag < nBSP430eventTagConfig_) {
     ep->seqno = xBSP430eventTagConfig_[tag].seqno++;
+#if (configBSP430_EVENT_TAG_STATS - 0)
+    stats_update_ni(&xBSP430eventTagConfig_[tag].stats_, ep->timestamp_utt);
+#endif /* configBSP430_EVENT_TAG_STATS */
   }
   vBSP430eventFlagsSet_ni(uiBSP430eventFlag_EventRecord);
-  EVENT_INCREMENT_PTR(event_head);
-  if (event_head == event_tail) {
-    EVENT_INCREMENT_PTR(event_tail);
-    ++event_lost_count;
-  }
+  event_head = index + 1;
   return ep;
 }
 
+/* Discard unread records that producers have overwritten or may be
+ * overwriting, given head as the number of records produced. */
+static void
+event_skip_overwritten (uint16_t head)
+{
+  uint16_t pending = head - event_tail;
+
+  if (BSP430_EVENT_RECORD_NUM_SUPPORTED < pending) {
+    event_lost_count += pending - BSP430_EVENT_RECORD_NUM_SUPPORTED;
+    event_tail = head - BSP430_EVENT_RECORD_NUM_SUPPORTED;
+  }
+}
+
 int
 iBSP430eventTagGetRecords (sBSP430eventTagRecord * evts,
                            int len)
 {
-  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
   int nevt = 0;
 
   if (0 == len) {
     return len;
   }
-  BSP430_CORE_DISABLE_INTERRUPT();
-  do {
-    if (0 != event_lost_count) {
-      memset(evts, 0, sizeof(*evts));
-      evts->tag = ucBSP430eventTag_LostEventRecord;
-      evts->u.sz = event_lost_count;
-      event_lost_count = 0;
-      ++nevt;
-    }
-    while ((nevt < len) && !EVENT_EMPTY()) {
-      evts[nevt++] = xBSP430eventRecord[event_tail];
-      EVENT_INCREMENT_PTR(event_tail);
-    }
-    if (!EVENT_EMPTY()) {
-      vBSP430eventFlagsSet_ni(uiBSP430eventFlag_EventRecord);
+  event_skip_overwritten(event_head);
+  if (0 != event_lost_count) {
+    memset(evts, 0, sizeof(*evts));
+    evts->tag = ucBSP430eventTag_LostEventRecord;
+    evts->u.sz = event_lost_count;
+    event_lost_count = 0;
+    ++nevt;
+  }
+  while ((nevt < len) && (event_tail != event_head)) {
+    uint16_t head;
+
+    evts[nevt] = xBSP430eventRecord[event_tail & EVENT_RECORD_MASK];
+    /* A producer that interrupted the copy may have replaced the
+     * record.  If so discard it and stop, so the loss is reported
+     * ahead of the records that follow it. */
+    head = event_head;
+    if (BSP430_EVENT_RECORD_NUM_SUPPORTED < (uint16_t)(head - event_tail)) {
+      event_skip_overwritten(head);
+      break;
     }
-  } while (0);
-  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+    ++event_tail;
+    ++nevt;
+  }
+  if ((0 != event_lost_count) || (event_tail != event_head)) {
+    vBSP430eventFlagsSet(uiBSP430eventFlag_EventRecord);
+  }
   return nevt;
 }
 
 static int
 periodic_callback_ni (sBSP430timerMuxSharedAlarm * shared,
-                      sBSP430timerMuxAlarm * alarm)
+                      sBSP430timerMuxPeriodic * periodic)
 {
-  sBSP430eventPeriodicConfig * cfg = (sBSP430eventPeriodicConfig *)alarm;
+  sBSP430eventPeriodicConfig * cfg = (sBSP430eventPeriodicConfig *)periodic;
   uBSP430eventAnyType u;
 
-  if (cfg->interval_tck) {
-    alarm->setting_tck += cfg->interval_tck;
-    (void)iBSP430timerMuxAlarmAdd_ni(shared, alarm);
-  }
   u.p = cfg;
   xBSP430eventRecordEvent_ni(cfg->tag, cfg->flags, &u);
   return BSP430_HAL_ISR_CALLBACK_EXIT_LPM;
@@ -185,14 +326,15 @@ iBSP430eventPeriodicAdd_ni (hBSP430timerMuxSharedAlarm shared,
                             hBSP430eventPeriodicConfig cfg,
                             unsigned long setting_tck)
 {
-  cfg->alarm_.setting_tck = setting_tck;
-  cfg->alarm_.callback_ni = periodic_callback_ni;
-  return iBSP430timerMuxAlarmAdd_ni(shared, &cfg->alarm_);
+  cfg->periodic_.interval_tck = cfg->interval_tck;
+  cfg->periodic_.policy = cfg->policy;
+  cfg->periodic_.callback_ni = periodic_callback_ni;
+  return iBSP430timerMuxPeriodicAdd_ni(shared, &cfg->periodic_, setting_tck);
 }
 
 int
 iBSP430eventPeriodicRemove_ni (hBSP430timerMuxSharedAlarm shared,
                                hBSP430eventPeriodicConfig cfg)
 {
-  return iBSP430timerMuxAlarmRemove_ni(shared, &cfg->alarm_);
+  return iBSP430timerMuxPeriodicRemove_ni(shared, &cfg->periodic_);
 }
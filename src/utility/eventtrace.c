@@ -0,0 +1,140 @@
+/* Copyright 2014, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/eventtrace.h>
+#include <bsp430/utility/uptime.h>
+#include <string.h>
+
+static uint8_t *
+encode_ul (uint8_t * bp,
+           unsigned long v)
+{
+  while (0x80 <= v) {
+    *bp++ = 0x80 | (uint8_t)v;
+    v >>= 7;
+  }
+  *bp++ = (uint8_t)v;
+  return bp;
+}
+
+/* The timestamp to be recorded for evts[0].  Lost-record markers have
+ * none, so inherit it from a neighbor. */
+static unsigned long
+record_timestamp_ (const sBSP430eventTraceEncoder * enc,
+                   const sBSP430eventTagRecord * evts,
+                   int nevts)
+{
+  const sBSP430eventTagRecord * const epe = evts + nevts;
+
+  if (ucBSP430eventTag_LostEventRecord != evts->tag) {
+    return evts->timestamp_utt;
+  }
+  if (enc->synchronized) {
+    return enc->last_utt;
+  }
+  while (++evts < epe) {
+    if (ucBSP430eventTag_LostEventRecord != evts->tag) {
+      return evts->timestamp_utt;
+    }
+  }
+  return ulBSP430uptime();
+}
+
+void
+vBSP430eventTraceReset (sBSP430eventTraceEncoder * enc)
+{
+  memset(enc, 0, sizeof(*enc));
+}
+
+int
+iBSP430eventTraceEncode (sBSP430eventTraceEncoder * enc,
+                         const sBSP430eventTagRecord * evts,
+                         int nevts,
+                         uint8_t * buf,
+                         size_t * lenp)
+{
+  uint8_t * bp = buf;
+  uint8_t * const ebp = buf + *lenp;
+  int nenc = 0;
+
+  while (nenc < nevts) {
+    const sBSP430eventTagRecord * ep = evts + nenc;
+    unsigned long ts_utt = record_timestamp_(enc, ep, nevts - nenc);
+
+    if (! enc->synchronized) {
+      if ((ebp - bp) < BSP430_EVENTTRACE_SYNC_MAX_LENGTH) {
+        break;
+      }
+      *bp++ = BSP430_EVENTTRACE_CONTROL;
+      *bp++ = BSP430_EVENTTRACE_CONTROL_SYNC;
+      bp = encode_ul(bp, ulBSP430uptimeConversionFrequency_Hz());
+      bp = encode_ul(bp, (uint32_t)ts_utt);
+      enc->last_utt = ts_utt;
+      enc->synchronized = 1;
+    }
+    while (enc->tags_described < nBSP430eventTagConfig_) {
+      const sBSP430eventTagConfig * tcp = hBSP430eventTagLookup(enc->tags_described);
+      size_t idlen = strlen(tcp->id);
+
+      if (BSP430_EVENTTRACE_TAG_ID_MAX < idlen) {
+        idlen = BSP430_EVENTTRACE_TAG_ID_MAX;
+      }
+      if ((size_t)(ebp - bp) < (4 + idlen)) {
+        break;
+      }
+      *bp++ = BSP430_EVENTTRACE_CONTROL;
+      *bp++ = BSP430_EVENTTRACE_CONTROL_TAG;
+      *bp++ = enc->tags_described;
+      *bp++ = idlen;
+      memcpy(bp, tcp->id, idlen);
+      bp += idlen;
+      ++enc->tags_described;
+    }
+    if ((enc->tags_described < nBSP430eventTagConfig_)
+        || ((ebp - bp) < BSP430_EVENTTRACE_RECORD_MAX_LENGTH)) {
+      break;
+    }
+    *bp++ = ep->tag;
+    *bp++ = ep->flags;
+    bp = encode_ul(bp, (uint32_t)(ts_utt - enc->last_utt));
+    bp = encode_ul(bp, ep->seqno);
+    bp = encode_ul(bp, ep->u.ul);
+    enc->last_utt = ts_utt;
+    ++nenc;
+  }
+  *lenp = bp - buf;
+  if ((0 == nenc) && (0 == *lenp) && (0 < nevts)) {
+    return -1;
+  }
+  return nenc;
+}
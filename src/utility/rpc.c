@@ -0,0 +1,315 @@
+/* Copyright 2014, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/rpc.h>
+#include <limits.h>
+#include <string.h>
+
+/* State for a depth-first walk of the command hierarchy.  The visitor
+ * is invoked on each command with the link chain leading to it, and
+ * returns nonzero to end the walk. */
+typedef struct sWalk {
+  int (* visit) (struct sWalk * wp,
+                 sBSP430cliCommandLink * link);
+  unsigned int id;
+  unsigned int target;
+  uint8_t * rp;
+  uint8_t * erp;
+} sWalk;
+
+static int
+walk_ (sWalk * wp,
+       sBSP430cliCommandLink * parent,
+       const sBSP430cliCommand * cmds)
+{
+  sBSP430cliCommandLink link;
+  int rv;
+
+  link.link = parent;
+  link.command_set = cmds;
+  while (cmds) {
+    link.cmd = cmds;
+    rv = wp->visit(wp, &link);
+    if (rv) {
+      return rv;
+    }
+    ++wp->id;
+    if (cmds->child) {
+      rv = walk_(wp, &link, cmds->child);
+      if (rv) {
+        return rv;
+      }
+    }
+    cmds = cmds->next;
+  }
+  return 0;
+}
+
+/* Append the full name of each command from the target onwards, until
+ * the response is full. */
+static int
+visit_list_ (sWalk * wp,
+             sBSP430cliCommandLink * link)
+{
+  sBSP430cliCommandLink * lp;
+  size_t len = 0;
+  uint8_t * np;
+
+  if (wp->id < wp->target) {
+    return 0;
+  }
+  for (lp = link; lp; lp = lp->link) {
+    len += strlen(lp->cmd->key) + (len ? 1 : 0);
+  }
+  if ((255 < len) || ((size_t)(wp->erp - wp->rp) < (2 + len))) {
+    return 1;
+  }
+  *wp->rp++ = BSP430_RPC_TLV_NAME;
+  *wp->rp++ = len;
+  wp->rp += len;
+  /* Keys are stored from the innermost command backwards */
+  np = wp->rp;
+  for (lp = link; lp; lp = lp->link) {
+    size_t klen = strlen(lp->cmd->key);
+    if (np != wp->rp) {
+      *--np = ' ';
+    }
+    np -= klen;
+    memcpy(np, lp->cmd->key, klen);
+  }
+  return 0;
+}
+
+/* Context for a call, shared with the visitor that locates the
+ * command */
+static const uint8_t * arg_;
+static void * param_;
+static int status_;
+static char text_[BSP430_RPC_TEXT_LENGTH + 1];
+
+static void
+put_int_ (sWalk * wp,
+          uint8_t type,
+          unsigned long value,
+          size_t len)
+{
+  *wp->rp++ = type;
+  *wp->rp++ = len;
+  while (len--) {
+    *wp->rp++ = value;
+    value >>= 8;
+  }
+}
+
+/* Store an integer argument through one of the standard store
+ * handlers, and return the resulting value of the variable. */
+static int
+call_store_ (sWalk * wp,
+             const sBSP430cliCommand * cmd)
+{
+  iBSP430cliHandlerFunction h = cmd->handler;
+  void * ptr = cmd->param.ptr;
+  int is_signed = (iBSP430cliHandlerStoreI == h) || (iBSP430cliHandlerStoreL == h);
+  int is_long = (iBSP430cliHandlerStoreL == h) || (iBSP430cliHandlerStoreUL == h);
+
+  if (arg_) {
+    size_t vlen = arg_[1];
+    const uint8_t * vp = arg_ + 2 + vlen;
+    unsigned long uv = 0;
+    long sv;
+
+    if (! (((BSP430_RPC_TLV_INT == arg_[0]) || (BSP430_RPC_TLV_UINT == arg_[0]))
+           && ((1 == vlen) || (2 == vlen) || (4 == vlen)))) {
+      return -eBSP430_CLI_ERR_Invalid;
+    }
+    while (vp > (arg_ + 2)) {
+      uv = (uv << 8) | *--vp;
+    }
+    if ((BSP430_RPC_TLV_INT == arg_[0]) && (vlen < sizeof(uv))
+        && (vp[vlen - 1] & 0x80)) {
+      uv |= ~0UL << (8 * vlen);
+    }
+    sv = (long)uv;
+    if (BSP430_RPC_TLV_INT == arg_[0]) {
+      if ((! is_signed) && (0 > sv)) {
+        return -eBSP430_CLI_ERR_Range;
+      }
+      if ((! is_long) && (is_signed
+                          ? ((INT_MIN > sv) || (INT_MAX < sv))
+                          : ((unsigned long)UINT_MAX < uv))) {
+        return -eBSP430_CLI_ERR_Range;
+      }
+    } else {
+      unsigned long max = is_long
+                          ? (is_signed ? (unsigned long)LONG_MAX : ULONG_MAX)
+                          : (is_signed ? (unsigned long)INT_MAX : (unsigned long)UINT_MAX);
+      if (max < uv) {
+        return -eBSP430_CLI_ERR_Range;
+      }
+    }
+    if (iBSP430cliHandlerStoreI == h) {
+      *(int *)ptr = (int)sv;
+    } else if (iBSP430cliHandlerStoreUI == h) {
+      *(unsigned int *)ptr = (unsigned int)uv;
+    } else if (iBSP430cliHandlerStoreL == h) {
+      *(long *)ptr = sv;
+    } else {
+      *(unsigned long *)ptr = uv;
+    }
+  }
+  if (iBSP430cliHandlerStoreI == h) {
+    put_int_(wp, BSP430_RPC_TLV_INT, (unsigned long)(long)*(int *)ptr, sizeof(int));
+  } else if (iBSP430cliHandlerStoreUI == h) {
+    put_int_(wp, BSP430_RPC_TLV_UINT, *(unsigned int *)ptr, sizeof(unsigned int));
+  } else if (iBSP430cliHandlerStoreL == h) {
+    put_int_(wp, BSP430_RPC_TLV_INT, (unsigned long)*(long *)ptr, sizeof(long));
+  } else {
+    put_int_(wp, BSP430_RPC_TLV_UINT, *(unsigned long *)ptr, sizeof(unsigned long));
+  }
+  return 0;
+}
+
+static int
+visit_call_ (sWalk * wp,
+             sBSP430cliCommandLink * link)
+{
+  const sBSP430cliCommand * cmd = link->cmd;
+  iBSP430cliHandlerFunction h = cmd->handler;
+  size_t text_len = 0;
+
+  if (wp->id != wp->target) {
+    return 0;
+  }
+  if (NULL == h) {
+    status_ = -eBSP430_CLI_ERR_Config;
+  } else if ((iBSP430cliHandlerStoreI == h) || (iBSP430cliHandlerStoreUI == h)
+             || (iBSP430cliHandlerStoreL == h) || (iBSP430cliHandlerStoreUL == h)) {
+    status_ = call_store_(wp, cmd);
+  } else if (arg_ && ((BSP430_RPC_TLV_TEXT != arg_[0])
+                      || (BSP430_RPC_TEXT_LENGTH < arg_[1]))) {
+    status_ = -eBSP430_CLI_ERR_Invalid;
+  } else {
+    if (arg_) {
+      text_len = arg_[1];
+      memcpy(text_, arg_ + 2, text_len);
+    }
+    text_[text_len] = 0;
+    status_ = h(link, param_, text_, text_len);
+  }
+  return 1;
+}
+
+int
+iBSP430rpcProcessRequest (const sBSP430cliCommand * cmds,
+                          void * param,
+                          const uint8_t * request,
+                          size_t request_len,
+                          uint8_t * response,
+                          size_t response_size)
+{
+  sWalk walk;
+  uint8_t * status_rp;
+  size_t arg_len;
+
+  if ((BSP430_RPC_HEADER_LENGTH > request_len)
+      || ((BSP430_RPC_HEADER_LENGTH + 6 + sizeof(long)) > response_size)) {
+    return -1;
+  }
+  memset(&walk, 0, sizeof(walk));
+  walk.target = request[2] | (request[3] << 8);
+  walk.rp = response;
+  walk.erp = response + response_size;
+  *walk.rp++ = request[0];
+  *walk.rp++ = BSP430_RPC_OP_RESPONSE | request[1];
+  *walk.rp++ = request[2];
+  *walk.rp++ = request[3];
+
+  if (BSP430_RPC_OP_LIST == request[1]) {
+    walk.visit = visit_list_;
+    (void)walk_(&walk, NULL, cmds);
+    return walk.rp - response;
+  }
+
+  /* Reserve space for the status, which precedes any value */
+  status_rp = walk.rp;
+  walk.rp += 2 + 2;
+  if (BSP430_RPC_OP_CALL != request[1]) {
+    status_ = -eBSP430_CLI_ERR_Invalid;
+  } else {
+    arg_ = NULL;
+    arg_len = request_len - BSP430_RPC_HEADER_LENGTH;
+    if (0 < arg_len) {
+      arg_ = request + BSP430_RPC_HEADER_LENGTH;
+    }
+    status_ = -eBSP430_CLI_ERR_Unrecognized;
+    /* Exactly one well-formed field may follow the header */
+    if (arg_ && ((2 > arg_len) || ((2U + arg_[1]) != arg_len))) {
+      status_ = -eBSP430_CLI_ERR_Invalid;
+    } else {
+      param_ = param;
+      walk.visit = visit_call_;
+      (void)walk_(&walk, NULL, cmds);
+    }
+  }
+  walk.erp = walk.rp;
+  walk.rp = status_rp;
+  put_int_(&walk, BSP430_RPC_TLV_STATUS, (unsigned long)(long)status_, 2);
+  return walk.erp - response;
+}
+
+#if (BSP430_CONSOLE - 0)
+
+static void
+rpc_rx_ (sBSP430chanmuxChannel * chan,
+         const uint8_t * data,
+         size_t len)
+{
+  sBSP430rpcServer * sp = (sBSP430rpcServer *)chan;
+  static uint8_t response[BSP430_CHANMUX_MAX_PAYLOAD];
+  int rv;
+
+  ++sp->requests;
+  rv = iBSP430rpcProcessRequest(sp->cmds, sp->param, data, len, response, sizeof(response));
+  if (0 < rv) {
+    (void)iBSP430chanmuxSendFrame(chan->id, response, rv);
+  }
+}
+
+int
+iBSP430rpcRegister (sBSP430rpcServer * server)
+{
+  server->channel.rx_callback = rpc_rx_;
+  return iBSP430chanmuxRegister(&server->channel);
+}
+
+#endif /* BSP430_CONSOLE */
@@ -305,6 +305,194 @@ iBSP430uptimeDelaySetEnabled_ni (int enablep)
   return rv;
 }
 
+#if (configBSP430_UPTIME_IDLE - 0)
+
+/* Status register bits for each idle level */
+static const unsigned int idle_level_bits_[BSP430_UPTIME_IDLE_LEVELS] = {
+  LPM0_bits, LPM1_bits, LPM2_bits, LPM3_bits, LPM4_bits
+};
+
+/* Number of outstanding holds at each level */
+static unsigned char idle_holds_[BSP430_UPTIME_IDLE_LEVELS];
+
+/* Registered peripheral constraints */
+static sBSP430uptimeIdleConstraint * idle_constraints_;
+
+/* Watched timer alarms; unused slots are null */
+static hBSP430timerAlarm idle_alarms_[BSP430_UPTIME_IDLE_ALARM_MAX];
+
+static sBSP430uptimeIdleResidency idle_residency_;
+
+/* The level of the deepest mode requested by lpm_bits */
+static int
+idleBitsLevel (unsigned int lpm_bits)
+{
+  int level = BSP430_UPTIME_IDLE_LEVELS - 1;
+
+  while ((0 < level)
+         && (idle_level_bits_[level] != (lpm_bits & idle_level_bits_[level]))) {
+    --level;
+  }
+  return level;
+}
+
+unsigned int
+uiBSP430uptimeIdleLevelBits (int level)
+{
+  if (0 > level) {
+    level = 0;
+  } else if (BSP430_UPTIME_IDLE_LEVELS <= level) {
+    level = BSP430_UPTIME_IDLE_LEVELS - 1;
+  }
+  return idle_level_bits_[level];
+}
+
+int
+iBSP430uptimeIdleConstraintRegister_ni (sBSP430uptimeIdleConstraint * cp)
+{
+  cp->next_ni = idle_constraints_;
+  idle_constraints_ = cp;
+  return 0;
+}
+
+int
+iBSP430uptimeIdleConstraintUnregister_ni (sBSP430uptimeIdleConstraint * cp)
+{
+  sBSP430uptimeIdleConstraint ** cpp = &idle_constraints_;
+
+  while (NULL != *cpp) {
+    if (cp == *cpp) {
+      *cpp = cp->next_ni;
+      cp->next_ni = NULL;
+      return 0;
+    }
+    cpp = &(*cpp)->next_ni;
+  }
+  return -1;
+}
+
+void
+vBSP430uptimeIdleHold_ni (int level)
+{
+  if ((0 <= level) && (BSP430_UPTIME_IDLE_LEVELS > level)) {
+    ++idle_holds_[level];
+  }
+}
+
+void
+vBSP430uptimeIdleRelease_ni (int level)
+{
+  if ((0 <= level) && (BSP430_UPTIME_IDLE_LEVELS > level)
+      && (0 < idle_holds_[level])) {
+    --idle_holds_[level];
+  }
+}
+
+int
+iBSP430uptimeIdleWatchAlarm_ni (hBSP430timerAlarm alarm)
+{
+  int i;
+
+  for (i = 0; i < BSP430_UPTIME_IDLE_ALARM_MAX; ++i) {
+    if (NULL == idle_alarms_[i]) {
+      idle_alarms_[i] = alarm;
+      return 0;
+    }
+  }
+  return -1;
+}
+
+int
+iBSP430uptimeIdleUnwatchAlarm_ni (hBSP430timerAlarm alarm)
+{
+  int i;
+
+  for (i = 0; i < BSP430_UPTIME_IDLE_ALARM_MAX; ++i) {
+    if (alarm == idle_alarms_[i]) {
+      idle_alarms_[i] = NULL;
+      return 0;
+    }
+  }
+  return -1;
+}
+
+int
+iBSP430uptimeIdleLevel_ni (unsigned long wake_utt)
+{
+  const sBSP430uptimeIdleConstraint * cp;
+  unsigned long now_utt = ulBSP430uptime_ni();
+  int level = BSP430_UPTIME_IDLE_DEEPEST_LEVEL;
+  int i;
+
+  for (i = 0; i < level; ++i) {
+    if (0 < idle_holds_[i]) {
+      level = i;
+    }
+  }
+  if (BSP430_UPTIME_IDLE_SHALLOW_UTT > (long)(wake_utt - now_utt)) {
+    level = 0;
+  }
+  for (i = 0; (0 < level) && (i < BSP430_UPTIME_IDLE_ALARM_MAX); ++i) {
+    hBSP430timerAlarm ap = idle_alarms_[i];
+    if ((NULL == ap) || (! (BSP430_TIMER_ALARM_FLAG_SET & ap->flags))) {
+      continue;
+    }
+    if (TASSEL_1 != (ap->timer->hpl->ctl & TASSEL_3)) {
+      /* The alarm timer stops if its clock does. */
+      level = 0;
+    } else if ((xBSP430uptimeTIMER_ == ap->timer)
+               && (BSP430_UPTIME_IDLE_SHALLOW_UTT > (long)(ap->setting_tck - now_utt))) {
+      level = 0;
+    }
+  }
+  for (cp = idle_constraints_; (0 < level) && (NULL != cp); cp = cp->next_ni) {
+    int limit = cp->level_ni(cp);
+    if (limit < level) {
+      level = limit;
+    }
+  }
+  if (0 > level) {
+    level = 0;
+  }
+  return level;
+}
+
+long
+lBSP430uptimeIdleUntil (unsigned long wake_utt)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+  long rv;
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  rv = lBSP430uptimeSleepUntil(wake_utt, idle_level_bits_[iBSP430uptimeIdleLevel_ni(wake_utt)]);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+  return rv;
+}
+
+void
+vBSP430uptimeIdleResidency (sBSP430uptimeIdleResidency * sp,
+                            int reset)
+{
+  BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
+
+  BSP430_CORE_DISABLE_INTERRUPT();
+  do {
+    unsigned long now_utt = ulBSP430uptime_ni();
+
+    /* Bring the active time up to date so the snapshot is current. */
+    idle_residency_.awake_utt += now_utt - idle_residency_.last_wake_utt;
+    idle_residency_.last_wake_utt = now_utt;
+    *sp = idle_residency_;
+    if (reset) {
+      memset(&idle_residency_, 0, sizeof(idle_residency_));
+      idle_residency_.last_wake_utt = now_utt;
+    }
+  } while (0);
+  BSP430_CORE_RESTORE_INTERRUPT_STATE(istate);
+}
+
+#endif /* configBSP430_UPTIME_IDLE */
+
 long
 lBSP430uptimeSleepUntil (unsigned long setting_utt,
                          unsigned int lpm_bits)
@@ -312,6 +500,10 @@ lBSP430uptimeSleepUntil (unsigned long setting_utt,
   BSP430_CORE_SAVED_INTERRUPT_STATE(istate);
   long rv = 0;
   int rc;
+#if (configBSP430_UPTIME_IDLE - 0)
+  unsigned long sleep_utt;
+  int level;
+#endif /* configBSP430_UPTIME_IDLE */
 
   BSP430_CORE_DISABLE_INTERRUPT();
   do {
@@ -324,11 +516,27 @@ lBSP430uptimeSleepUntil (unsigned long setting_utt,
     if (0 != rc) {
       break;
     }
+#if (configBSP430_UPTIME_IDLE - 0)
+    /* Do not go deeper than is safe, and record the sleep. */
+    level = iBSP430uptimeIdleLevel_ni(setting_utt);
+    if (level < idleBitsLevel(lpm_bits)) {
+      lpm_bits = (lpm_bits & ~LPM4_bits) | idle_level_bits_[level];
+    } else {
+      level = idleBitsLevel(lpm_bits);
+    }
+    sleep_utt = ulBSP430uptime_ni();
+    idle_residency_.awake_utt += sleep_utt - idle_residency_.last_wake_utt;
+#endif /* configBSP430_UPTIME_IDLE */
     /* Sleep until the alarm goes off, or something else wakes us up.
      * Immediately disable the interrupts in the unlikely event the
      * interrupt return enabled them. */
     BSP430_CORE_LPM_ENTER_NI(lpm_bits);
     BSP430_CORE_DISABLE_INTERRUPT();
+#if (configBSP430_UPTIME_IDLE - 0)
+    idle_residency_.last_wake_utt = ulBSP430uptime_ni();
+    idle_residency_.sleep_utt[level] += idle_residency_.last_wake_utt - sleep_utt;
+    ++idle_residency_.sleeps[level];
+#endif /* configBSP430_UPTIME_IDLE */
 
     /* Cancel the alarm if it hasn't fired yet. */
     if (! (delayAlarm_.flags & DELAY_ALARM_FIRED)) {
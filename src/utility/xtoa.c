@@ -0,0 +1,568 @@
+/* Copyright 2014, Peter A. Bigot
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ * * Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ *
+ * * Neither the name of the software nor the names of its contributors may be
+ *   used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <bsp430/platform.h>
+#include <bsp430/utility/xtoa.h>
+#include <string.h>
+
+/* Flags recognized by iBSP430xtoaVuprintf */
+#define FL_LEFT 0x01
+#define FL_ZERO 0x02
+#define FL_PLUS 0x04
+#define FL_SPACE 0x08
+#define FL_ALT 0x10
+
+#if (configBSP430_XTOA_USE_RECIPROCAL - 0)
+
+static const char digit_pairs[] =
+  "0001020304050607080910111213141516171819"
+  "2021222324252627282930313233343536373839"
+  "4041424344454647484950515253545556575859"
+  "6061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+/* Store the four digits of g, which must be less than 10000, in the
+ * octets preceding ep.  g/100 is computed as (g * 0x147B) >> 19, which
+ * is exact over that range. */
+static char *
+put_group (unsigned int g,
+           char * ep)
+{
+  unsigned int hi = ((unsigned long)g * 0x147BU) >> 19;
+  const char * pp = digit_pairs + 2 * (g - hi * 100U);
+
+  *--ep = pp[1];
+  *--ep = pp[0];
+  pp = digit_pairs + 2 * hi;
+  *--ep = pp[1];
+  *--ep = pp[0];
+  return ep;
+}
+
+/* Copy the digits ending before ep to dp, less leading zeros. */
+static unsigned int
+strip_copy (char * sp,
+            char * ep,
+            char * dp)
+{
+  unsigned int n;
+
+  while (('0' == *sp) && (sp < (ep - 1))) {
+    ++sp;
+  }
+  n = ep - sp;
+  memcpy(dp, sp, n);
+  return n;
+}
+
+static unsigned int
+ulong_decimal (unsigned long value,
+               char * dp)
+{
+  char tmp[12];
+  char * const ep = tmp + sizeof(tmp);
+  char * sp = ep;
+
+  while (10000UL <= value) {
+    /* value / 10000 is (value * 0xD1B71759) >> 45 for all 32-bit
+     * values.  The widening multiply uses MPY32. */
+    unsigned long q = (unsigned long)(((unsigned long long)value * 0xD1B71759UL) >> 45);
+    sp = put_group(value - q * 10000UL, sp);
+    value = q;
+  }
+  sp = put_group(value, sp);
+  return strip_copy(sp, ep, dp);
+}
+
+static unsigned int
+uint_decimal (unsigned int value,
+              char * dp)
+{
+  char tmp[5];
+  char * const ep = tmp + sizeof(tmp);
+  char * sp;
+  char top = '0';
+
+  while (10000U <= value) {
+    value -= 10000U;
+    ++top;
+  }
+  sp = put_group(value, ep);
+  *--sp = top;
+  return strip_copy(sp, ep, dp);
+}
+
+#else /* configBSP430_XTOA_USE_RECIPROCAL */
+
+static const unsigned long pow10_ul[] = {
+  100000000UL, 10000000UL, 1000000UL, 100000UL, 10000UL, 1000UL, 100UL, 10UL
+};
+
+static const unsigned int pow10_ui[] = {
+  1000U, 100U, 10U
+};
+
+/* Each digit is obtained by subtracting 8, 4, 2, and 1 times the
+ * power of ten for its position.  The leading digit of a 32-bit
+ * (16-bit) value is at most 4 (6), and is obtained by repeated
+ * subtraction. */
+#define SUBTRACT_DIGIT(TYPE_, value_, p1_, d_) do {     \
+    TYPE_ p2 = (p1_) + (p1_);                           \
+    TYPE_ p4 = p2 + p2;                                 \
+    TYPE_ p8 = p4 + p4;                                 \
+    d_ = '0';                                           \
+    if ((value_) >= p8) {                               \
+      (value_) -= p8;                                   \
+      d_ += 8;                                          \
+    }                                                   \
+    if ((value_) >= p4) {                               \
+      (value_) -= p4;                                   \
+      d_ += 4;                                          \
+    }                                                   \
+    if ((value_) >= p2) {                               \
+      (value_) -= p2;                                   \
+      d_ += 2;                                          \
+    }                                                   \
+    if ((value_) >= (p1_)) {                            \
+      (value_) -= (p1_);                                \
+      d_ += 1;                                          \
+    }                                                   \
+  } while (0)
+
+static unsigned int
+ulong_decimal (unsigned long value,
+               char * dp)
+{
+  char * const dp0 = dp;
+  unsigned int i;
+
+  if (1000000000UL <= value) {
+    char d = '0';
+    do {
+      value -= 1000000000UL;
+      ++d;
+    } while (1000000000UL <= value);
+    *dp++ = d;
+  }
+  for (i = 0; i < sizeof(pow10_ul) / sizeof(*pow10_ul); ++i) {
+    unsigned long p1 = pow10_ul[i];
+    char d;
+
+    if ((dp == dp0) && (value < p1)) {
+      continue;
+    }
+    SUBTRACT_DIGIT(unsigned long, value, p1, d);
+    *dp++ = d;
+  }
+  *dp++ = '0' + (unsigned int)value;
+  return dp - dp0;
+}
+
+static unsigned int
+uint_decimal (unsigned int value,
+              char * dp)
+{
+  char * const dp0 = dp;
+  unsigned int i;
+
+  if (10000U <= value) {
+    char d = '0';
+    do {
+      value -= 10000U;
+      ++d;
+    } while (10000U <= value);
+    *dp++ = d;
+  }
+  for (i = 0; i < sizeof(pow10_ui) / sizeof(*pow10_ui); ++i) {
+    unsigned int p1 = pow10_ui[i];
+    char d;
+
+    if ((dp == dp0) && (value < p1)) {
+      continue;
+    }
+    SUBTRACT_DIGIT(unsigned int, value, p1, d);
+    *dp++ = d;
+  }
+  *dp++ = '0' + value;
+  return dp - dp0;
+}
+
+#endif /* configBSP430_XTOA_USE_RECIPROCAL */
+
+static char
+digit_char (unsigned int d,
+            char alpha)
+{
+  return (10 > d) ? ('0' + d) : (alpha + d - 10);
+}
+
+/* Conversion in radixes other than 10.  Power-of-two radixes use
+ * shift and mask; others use division. */
+#define XTOA_OTHER_T(NAME_, UTYPE_)                                     \
+static unsigned int                                                     \
+NAME_ (UTYPE_ value,                                                    \
+       unsigned int radix,                                              \
+       char alpha,                                                      \
+       char * dp)                                                       \
+{                                                                       \
+  unsigned int n = 0;                                                   \
+  UTYPE_ v;                                                             \
+                                                                        \
+  if (0 == (radix & (radix - 1))) {                                     \
+    unsigned int shift = 0;                                             \
+    unsigned int mask = radix - 1;                                      \
+                                                                        \
+    while ((1U << shift) < radix) {                                     \
+      ++shift;                                                          \
+    }                                                                   \
+    v = value;                                                          \
+    do {                                                                \
+      ++n;                                                              \
+      v >>= shift;                                                      \
+    } while (v);                                                        \
+    dp += n;                                                            \
+    do {                                                                \
+      *--dp = digit_char((unsigned int)value & mask, alpha);            \
+      value >>= shift;                                                  \
+    } while (value);                                                    \
+    return n;                                                           \
+  }                                                                     \
+  v = value;                                                            \
+  do {                                                                  \
+    ++n;                                                                \
+    v /= radix;                                                         \
+  } while (v);                                                          \
+  dp += n;                                                              \
+  do {                                                                  \
+    *--dp = digit_char((unsigned int)(value % radix), alpha);           \
+    value /= radix;                                                     \
+  } while (value);                                                      \
+  return n;                                                             \
+}
+
+XTOA_OTHER_T(ulong_other, unsigned long)
+XTOA_OTHER_T(uint_other, unsigned int)
+
+static unsigned int
+ulong_digits (unsigned long value,
+              unsigned int radix,
+              char alpha,
+              char * dp)
+{
+  if (10 == radix) {
+    return ulong_decimal(value, dp);
+  }
+  return ulong_other(value, radix, alpha, dp);
+}
+
+static unsigned int
+uint_digits (unsigned int value,
+             unsigned int radix,
+             char alpha,
+             char * dp)
+{
+  if (10 == radix) {
+    return uint_decimal(value, dp);
+  }
+  return uint_other(value, radix, alpha, dp);
+}
+
+char *
+xBSP430xtoaULong (unsigned long value,
+                  char * str,
+                  int radix)
+{
+  str[ulong_digits(value, radix, 'A', str)] = 0;
+  return str;
+}
+
+char *
+xBSP430xtoaLong (long value,
+                 char * str,
+                 int radix)
+{
+  char * sp = str;
+  unsigned long uval = value;
+
+  if ((10 == radix) && (0 > value)) {
+    *sp++ = '-';
+    uval = -uval;
+  }
+  sp[ulong_digits(uval, radix, 'A', sp)] = 0;
+  return str;
+}
+
+char *
+xBSP430xtoaUInt (unsigned int value,
+                 char * str,
+                 int radix)
+{
+  str[uint_digits(value, radix, 'A', str)] = 0;
+  return str;
+}
+
+char *
+xBSP430xtoaInt (int value,
+                char * str,
+                int radix)
+{
+  char * sp = str;
+  unsigned int uval = value;
+
+  if ((10 == radix) && (0 > value)) {
+    *sp++ = '-';
+    uval = -uval;
+  }
+  sp[uint_digits(uval, radix, 'A', sp)] = 0;
+  return str;
+}
+
+static int
+emit_repeated (int (* emitc) (int c),
+               int c,
+               int count)
+{
+  int rv = 0;
+
+  while (rv < count) {
+    emitc(c);
+    ++rv;
+  }
+  return rv;
+}
+
+int
+iBSP430xtoaVuprintf (int (* emitc) (int c),
+                     const char * fmt,
+                     va_list ap)
+{
+  int rv = 0;
+
+  while (*fmt) {
+    /* Sufficient for a 32-bit octal value */
+    char digits[sizeof("37777777777")];
+    const char * spec = fmt;
+    const char * prefix = "";
+    const char * body = digits;
+    unsigned long uval = 0;
+    unsigned int radix = 0;
+    char alpha = 'a';
+    int is_signed = 0;
+    int flags = 0;
+    int width = 0;
+    int precision = -1;
+    int hcount = 0;
+    int is_long = 0;
+    int len;
+    int zeros = 0;
+    int plen;
+    int pad;
+    char c = *fmt++;
+
+    if ('%' != c) {
+      emitc(c);
+      ++rv;
+      continue;
+    }
+    for (; ; ++fmt) {
+      if ('-' == *fmt) {
+        flags |= FL_LEFT;
+      } else if ('0' == *fmt) {
+        flags |= FL_ZERO;
+      } else if ('+' == *fmt) {
+        flags |= FL_PLUS;
+      } else if (' ' == *fmt) {
+        flags |= FL_SPACE;
+      } else if ('#' == *fmt) {
+        flags |= FL_ALT;
+      } else {
+        break;
+      }
+    }
+    if ('*' == *fmt) {
+      ++fmt;
+      width = va_arg(ap, int);
+      if (0 > width) {
+        flags |= FL_LEFT;
+        width = -width;
+      }
+    } else {
+      while (('0' <= *fmt) && (*fmt <= '9')) {
+        width = 10 * width + (*fmt++ - '0');
+      }
+    }
+    if ('.' == *fmt) {
+      ++fmt;
+      precision = 0;
+      if ('*' == *fmt) {
+        ++fmt;
+        precision = va_arg(ap, int);
+        if (0 > precision) {
+          precision = -1;
+        }
+      } else {
+        while (('0' <= *fmt) && (*fmt <= '9')) {
+          precision = 10 * precision + (*fmt++ - '0');
+        }
+      }
+    }
+    while ('h' == *fmt) {
+      ++hcount;
+      ++fmt;
+    }
+    if ('l' == *fmt) {
+      is_long = 1;
+      ++fmt;
+    }
+    c = *fmt++;
+    switch (c) {
+      case '%':
+        digits[0] = '%';
+        len = 1;
+        break;
+      case 'c':
+        digits[0] = va_arg(ap, int);
+        len = 1;
+        break;
+      case 's':
+        body = va_arg(ap, const char *);
+        if (! body) {
+          body = "(null)";
+        }
+        len = 0;
+        while (body[len] && ((0 > precision) || (len < precision))) {
+          ++len;
+        }
+        break;
+      case 'd':
+      case 'i':
+        is_signed = 1;
+        radix = 10;
+        break;
+      case 'u':
+        radix = 10;
+        break;
+      case 'o':
+        radix = 8;
+        break;
+      case 'X':
+        alpha = 'A';
+        /*FALLTHRU*/
+      case 'x':
+        radix = 16;
+        break;
+      case 'p':
+        uval = (uintptr_t)va_arg(ap, void *);
+        radix = 16;
+        flags |= FL_ALT;
+        break;
+      default:
+        /* Unsupported, including a format that ends within a
+         * conversion specification.  Show what remains. */
+        while (*spec) {
+          emitc(*spec++);
+          ++rv;
+        }
+        return rv;
+    }
+    if (0 != radix) {
+      if ('p' == c) {
+        ;
+      } else if (is_signed) {
+        long sval = is_long ? va_arg(ap, long) : va_arg(ap, int);
+
+        if (1 == hcount) {
+          sval = (short)sval;
+        } else if (1 < hcount) {
+          sval = (signed char)sval;
+        }
+        if (0 > sval) {
+          prefix = "-";
+          uval = -(unsigned long)sval;
+        } else {
+          uval = sval;
+          if (flags & FL_PLUS) {
+            prefix = "+";
+          } else if (flags & FL_SPACE) {
+            prefix = " ";
+          }
+        }
+      } else {
+        uval = is_long ? va_arg(ap, unsigned long) : va_arg(ap, unsigned int);
+        if (1 == hcount) {
+          uval = (unsigned short)uval;
+        } else if (1 < hcount) {
+          uval = (unsigned char)uval;
+        }
+      }
+      if ((0 == uval) && (0 == precision)) {
+        len = 0;
+      } else if (0xFFFFUL >= uval) {
+        len = uint_digits((unsigned int)uval, radix, alpha, digits);
+      } else {
+        len = ulong_digits(uval, radix, alpha, digits);
+      }
+      if (flags & FL_ALT) {
+        if ((16 == radix) && (0 != uval)) {
+          prefix = ('A' == alpha) ? "0X" : "0x";
+        } else if ((8 == radix) && ((0 == len) || ('0' != digits[0])) && (precision <= len)) {
+          precision = len + 1;
+        }
+      }
+      if (precision > len) {
+        zeros = precision - len;
+      }
+    }
+    plen = strlen(prefix);
+    pad = width - (plen + zeros + len);
+    if ((0 != radix) && (flags & FL_ZERO) && (! (flags & FL_LEFT)) && (0 > precision) && (0 < pad)) {
+      zeros += pad;
+      pad = 0;
+    }
+    if (! (flags & FL_LEFT)) {
+      rv += emit_repeated(emitc, ' ', pad);
+    }
+    while (*prefix) {
+      emitc(*prefix++);
+      ++rv;
+    }
+    rv += emit_repeated(emitc, '0', zeros);
+    rv += len;
+    while (0 < len--) {
+      emitc(*body++);
+    }
+    if (flags & FL_LEFT) {
+      rv += emit_repeated(emitc, ' ', pad);
+    }
+  }
+  return rv;
+}